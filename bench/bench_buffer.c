@@ -0,0 +1,139 @@
+/**
+ * \brief Benchmark of loading a large file into a buffer and saving it back.
+ *
+ * The file is synthetic text with line lengths typical of source code.  It is
+ * loaded serially and in parallel, and saved with and without a change to
+ * one of its lines.  The best time of several runs is reported.  The page
+ * cache is not dropped, so this measures the library rather than the disk.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ej/buffer.h>
+#include <ej/heap.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_BYTES (256U * 1024U * 1024U)
+#define BENCH_RUNS 3U
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int write_input(const char* path)
+{
+    char* data = (char*)malloc(BENCH_BYTES);
+    if (NULL == data)
+        return 1;
+
+    /* lines of 0 to 79 characters. */
+    uint32_t seed = 2463534242U;
+    for (size_t i = 0U; i < BENCH_BYTES; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        data[i] = (0U == seed % 40U) ? '\n' : 'a' + seed % 26U;
+    }
+    data[BENCH_BYTES - 1U] = '\n';
+
+    FILE* out = fopen(path, "wb");
+    int retval =
+        (NULL == out || BENCH_BYTES != fwrite(data, 1U, BENCH_BYTES, out));
+    if (NULL != out && 0 != fclose(out))
+        retval = 1;
+
+    free(data);
+
+    return retval;
+}
+
+static void report(const char* name, double best)
+{
+    printf("%-24s %8.2f GiB/s\n",
+           name, BENCH_BYTES / best / (1024.0 * 1024.0 * 1024.0));
+}
+
+int main(void)
+{
+    char input[] = "/tmp/ej_bench_buffer_XXXXXX";
+    char output[] = "/tmp/ej_bench_buffer_XXXXXX";
+    int in_fd = mkstemp(input);
+    int out_fd = mkstemp(output);
+    if (in_fd < 0 || out_fd < 0 || 0 != write_input(input))
+    {
+        fprintf(stderr, "could not write the input file.\n");
+        return 1;
+    }
+    close(in_fd);
+    close(out_fd);
+
+    double serial = 1e30, parallel = 1e30, save = 1e30, save_changed = 1e30;
+    for (unsigned run = 0U; run < BENCH_RUNS; ++run)
+    {
+        heap_t heap;
+        buffer_t buffer;
+        double begin;
+
+        if (0 != heap_init(&heap))
+            return 1;
+
+        begin = now();
+        if (0 != buffer_init_file(&buffer, &heap.alloc, input))
+            return 1;
+        double elapsed = now() - begin;
+        serial = (elapsed < serial) ? elapsed : serial;
+
+        dispose((disposable_t*)&buffer);
+        dispose((disposable_t*)&heap);
+
+        begin = now();
+        if (0 != buffer_init_file_parallel(&buffer, input, 0U))
+            return 1;
+        elapsed = now() - begin;
+        parallel = (elapsed < parallel) ? elapsed : parallel;
+
+        /* unchanged lines are written straight from the mapping. */
+        begin = now();
+        if (0 != buffer_save(&buffer, output, 0U))
+            return 1;
+        elapsed = now() - begin;
+        save = (elapsed < save) ? elapsed : save;
+
+        /* a changed line splits the mapping into two writes. */
+        string_t* line = (string_t*)buffer.lines->head->next->data;
+        if (0 != string_append(line, "!", 1U))
+            return 1;
+
+        begin = now();
+        if (0 != buffer_save(&buffer, output, 0U))
+            return 1;
+        elapsed = now() - begin;
+        save_changed = (elapsed < save_changed) ? elapsed : save_changed;
+
+        dispose((disposable_t*)&buffer);
+    }
+
+    printf("%u MiB, best of %u runs.\n",
+           BENCH_BYTES / (1024U * 1024U), BENCH_RUNS);
+    report("serial load", serial);
+    report("parallel load", parallel);
+    report("atomic save", save);
+    report("atomic save, one change", save_changed);
+
+    unlink(input);
+    unlink(output);
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+/**
+ * \brief Microbenchmark comparing list_t against the sentinel-based clist_t.
+ *
+ * Each run performs the same pseudo-random sequence of edits against both
+ * containers: inserts and removes at a cursor which wanders back and forth,
+ * as an editor does under random edits.  Pushes and pops at either end are
+ * timed separately.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ej/clist.h>
+#include <ej/list.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_LINES 100000U
+#define BENCH_EDITS 2000000U
+
+typedef struct line
+{
+    disposable_t hdr;
+    unsigned val;
+} line_t;
+
+static void line_dispose(disposable_t* disp)
+{
+    (void)disp;
+}
+
+static disposable_t* line_create(unsigned val)
+{
+    line_t* line = (line_t*)malloc(sizeof(line_t));
+    if (NULL == line)
+    {
+        fprintf(stderr, "out of memory.\n");
+        exit(1);
+    }
+
+    line->hdr.dispose = &line_dispose;
+    line->val = val;
+
+    return (disposable_t*)line;
+}
+
+static uint32_t next_random(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return *state = x;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* keep the compiler from discarding the work. */
+static volatile unsigned sink;
+
+static double bench_list_edits(void)
+{
+    list_t list;
+    disposable_t* data;
+    uint32_t seed = 2463534242U;
+
+    list_init(&list);
+    for (unsigned i = 0U; i < BENCH_LINES; ++i)
+        list_push_back(&list, line_create(i));
+
+    double start = now();
+
+    list_node_t* cursor = list.head;
+    for (unsigned i = 0U; i < BENCH_EDITS; ++i)
+    {
+        uint32_t r = next_random(&seed);
+
+        /* move the cursor, wrapping at either end. */
+        if (r & 1U)
+            cursor = (NULL != cursor->next) ? cursor->next : list.head;
+        else
+            cursor = (NULL != cursor->prev) ? cursor->prev : list.tail;
+
+        if (r & 2U)
+        {
+            /* insert a line before the cursor. */
+            list_insert(&list, cursor, line_create(i));
+        }
+        else if (list.size > 1U)
+        {
+            /* delete the line at the cursor. */
+            list_node_t* next =
+                (NULL != cursor->next) ? cursor->next : cursor->prev;
+            list_remove(&list, cursor, &data);
+            sink += ((line_t*)data)->val;
+            free(data);
+            cursor = next;
+        }
+    }
+
+    double elapsed = now() - start;
+
+    dispose((disposable_t*)&list);
+
+    return elapsed;
+}
+
+static double bench_clist_edits(void)
+{
+    clist_t list;
+    disposable_t* data;
+    uint32_t seed = 2463534242U;
+
+    clist_init(&list);
+    for (unsigned i = 0U; i < BENCH_LINES; ++i)
+        clist_push_back(&list, line_create(i));
+
+    double start = now();
+
+    list_node_t* end = clist_end(&list);
+    list_node_t* cursor = clist_begin(&list);
+    for (unsigned i = 0U; i < BENCH_EDITS; ++i)
+    {
+        uint32_t r = next_random(&seed);
+
+        /* move the cursor, skipping over the sentinel. */
+        if (r & 1U)
+            cursor = (end != cursor->next) ? cursor->next : end->next;
+        else
+            cursor = (end != cursor->prev) ? cursor->prev : end->prev;
+
+        if (r & 2U)
+        {
+            /* insert a line before the cursor. */
+            clist_insert(&list, cursor, line_create(i));
+        }
+        else if (list.size > 1U)
+        {
+            /* delete the line at the cursor. */
+            list_node_t* next = (end != cursor->next) ? cursor->next
+                                                      : cursor->prev;
+            clist_remove(&list, cursor, &data);
+            sink += ((line_t*)data)->val;
+            free(data);
+            cursor = next;
+        }
+    }
+
+    double elapsed = now() - start;
+
+    dispose((disposable_t*)&list);
+
+    return elapsed;
+}
+
+static double bench_list_ends(void)
+{
+    list_t list;
+    disposable_t* data;
+    uint32_t seed = 2463534242U;
+
+    list_init(&list);
+
+    double start = now();
+
+    for (unsigned i = 0U; i < BENCH_EDITS; ++i)
+    {
+        uint32_t r = next_random(&seed);
+
+        if (r & 1U)
+            list_push_front(&list, line_create(i));
+        else
+            list_push_back(&list, line_create(i));
+
+        if (r & 2U)
+        {
+            if (0 == ((r & 4U) ? list_pop_front(&list, &data)
+                               : list_pop_back(&list, &data)))
+            {
+                sink += ((line_t*)data)->val;
+                free(data);
+            }
+        }
+    }
+
+    double elapsed = now() - start;
+
+    dispose((disposable_t*)&list);
+
+    return elapsed;
+}
+
+static double bench_clist_ends(void)
+{
+    clist_t list;
+    disposable_t* data;
+    uint32_t seed = 2463534242U;
+
+    clist_init(&list);
+
+    double start = now();
+
+    for (unsigned i = 0U; i < BENCH_EDITS; ++i)
+    {
+        uint32_t r = next_random(&seed);
+
+        if (r & 1U)
+            clist_push_front(&list, line_create(i));
+        else
+            clist_push_back(&list, line_create(i));
+
+        if (r & 2U)
+        {
+            if (0 == ((r & 4U) ? clist_pop_front(&list, &data)
+                               : clist_pop_back(&list, &data)))
+            {
+                sink += ((line_t*)data)->val;
+                free(data);
+            }
+        }
+    }
+
+    double elapsed = now() - start;
+
+    dispose((disposable_t*)&list);
+
+    return elapsed;
+}
+
+int main(void)
+{
+    printf("%-24s %12s %12s\n", "workload", "list_t", "clist_t");
+
+    double list_time = bench_list_edits();
+    double clist_time = bench_clist_edits();
+    printf(
+        "%-24s %10.1fms %10.1fms\n", "random edits",
+        list_time * 1e3, clist_time * 1e3);
+
+    list_time = bench_list_ends();
+    clist_time = bench_clist_ends();
+    printf(
+        "%-24s %10.1fms %10.1fms\n", "push/pop at ends",
+        list_time * 1e3, clist_time * 1e3);
+
+    return 0;
+}
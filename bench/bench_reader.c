@@ -0,0 +1,131 @@
+/**
+ * \brief Microbenchmark of newline scanning and UTF-8 validation throughput
+ * at each SIMD level.
+ *
+ * The input is synthetic text with line lengths typical of source code.  Each
+ * level scans the whole input several times, and the best time is reported.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ej/reader.h>
+#include <ej/string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_BYTES (256U * 1024U * 1024U)
+#define BENCH_RUNS 5U
+
+static const char* level_names[SIMD_LEVEL_COUNT] = {
+    "scalar", "sse2", "sse4", "avx2" };
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* keep the compiler from discarding the work. */
+static volatile size_t sink;
+
+static double bench_scan(simd_level_t level, const char* data, size_t size)
+{
+    size_t ends[READER_BATCH_LINES];
+    size_t crlf = 0U;
+    size_t lines = 0U;
+    size_t start = 0U;
+    size_t count;
+
+    double begin = now();
+    do
+    {
+        count =
+            newline_scan_level(
+                level, data, size, start, ends, READER_BATCH_LINES, &crlf);
+        lines += count;
+        if (count > 0U)
+            start = ends[count - 1U] + 1U;
+    } while (READER_BATCH_LINES == count);
+    double elapsed = now() - begin;
+
+    sink = lines + crlf;
+
+    return elapsed;
+}
+
+static double bench_validate(simd_level_t level, const char* data, size_t size)
+{
+    size_t offset = 0U;
+
+    double begin = now();
+    int retval = utf8_validate_level(level, data, size, &offset);
+    double elapsed = now() - begin;
+
+    sink = (size_t)retval + offset;
+
+    return elapsed;
+}
+
+static void bench_report(
+    const char* name, double (*bench)(simd_level_t, const char*, size_t),
+    const char* data, size_t size)
+{
+    printf("%s of %zu MiB, best of %u runs.\n",
+           name, size / (1024U * 1024U), BENCH_RUNS);
+
+    for (int level = 0; level <= (int)simd_level(); ++level)
+    {
+        double best = 1e30;
+        for (unsigned run = 0U; run < BENCH_RUNS; ++run)
+        {
+            double elapsed = bench((simd_level_t)level, data, size);
+            if (elapsed < best)
+                best = elapsed;
+        }
+
+        printf("%-8s %8.2f GiB/s\n", level_names[level],
+               size / best / (1024.0 * 1024.0 * 1024.0));
+    }
+}
+
+int main(void)
+{
+    char* data = (char*)malloc(BENCH_BYTES);
+    if (NULL == data)
+    {
+        fprintf(stderr, "out of memory.\n");
+        return 1;
+    }
+
+    /* lines of 0 to 79 characters. */
+    uint32_t seed = 2463534242U;
+    for (size_t i = 0U; i < BENCH_BYTES; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        data[i] = (0U == seed % 40U) ? '\n' : 'a' + seed % 26U;
+    }
+
+    bench_report("newline scan", &bench_scan, data, BENCH_BYTES);
+
+    /* sprinkle in two byte sequences for validation. */
+    for (size_t i = 0U; i + 1U < BENCH_BYTES; i += 64U)
+    {
+        data[i] = (char)0xC3;
+        data[i + 1U] = (char)0xA9;
+    }
+
+    bench_report("utf-8 validation", &bench_validate, data, BENCH_BYTES);
+
+    free(data);
+
+    return 0;
+}
@@ -0,0 +1,436 @@
+/**
+ * \brief This header defines the allocator interface.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_ALLOCATOR_HEADER_GUARD
+# define EJ_ALLOCATOR_HEADER_GUARD
+
+#include <ej/disposable.h>
+#include <stdbool.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* forward decls */
+struct allocator;
+
+/**
+ * \brief Allocate size bytes from the allocator.
+ *
+ * \returns the memory, or NULL on failure.
+ */
+typedef void* (*allocator_allocate_method_t)(
+    struct allocator* alloc, size_t size);
+
+/**
+ * \brief Return memory to the allocator.
+ */
+typedef void (*allocator_release_method_t)(
+    struct allocator* alloc, void* ptr);
+
+/**
+ * \brief Ensure that the next count allocations of size bytes will succeed.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+typedef int (*allocator_reserve_method_t)(
+    struct allocator* alloc, size_t size, size_t count);
+
+/**
+ * \brief Allocate count allocations of size bytes as one contiguous run, each
+ * stride bytes after the last.  Each allocation is released on its own.
+ *
+ * \returns the first allocation, or NULL on failure.
+ */
+typedef void* (*allocator_allocate_run_method_t)(
+    struct allocator* alloc, size_t size, size_t count, size_t* stride);
+
+/**
+ * \brief Get the number of bytes held for an allocation.
+ *
+ * \returns the size of the allocation as recorded in the statistics.
+ */
+typedef size_t (*allocator_measure_method_t)(
+    struct allocator* alloc, const void* ptr);
+
+/**
+ * \brief The number of size classes in the allocation histogram.  Class 0
+ * counts allocations of up to 16 bytes, and each following class doubles the
+ * upper bound.  The last class counts everything larger.
+ */
+#define ALLOCATOR_SIZE_CLASSES 16U
+
+/**
+ * \brief Allocation tags attribute an allocator's live memory to the kind of
+ * structure using it.
+ */
+typedef enum allocator_tag
+{
+    /** \brief Memory allocated without a tag. */
+    ALLOCATOR_TAG_UNTAGGED = 0,
+
+    /** \brief Linked list nodes. */
+    ALLOCATOR_TAG_LIST_NODE,
+
+    /** \brief Values owned by a list, such as the lines of a buffer. */
+    ALLOCATOR_TAG_LIST_DATA,
+
+    /** \brief Undo and redo records. */
+    ALLOCATOR_TAG_COMMAND,
+
+    /** \brief The out of line storage of long strings. */
+    ALLOCATOR_TAG_STRING,
+
+    ALLOCATOR_TAG_COUNT
+} allocator_tag_t;
+
+/**
+ * \brief Allocation statistics for a single allocator.
+ *
+ * Live bytes count the memory that the allocator holds on behalf of its
+ * callers, as measured by the backend; for instance, a pool counts its whole
+ * object size, and an arena keeps counting released allocations until it is
+ * dispose()d, because it can't reuse them.  The high-water mark is the peak of
+ * live bytes.  The size class histogram counts every allocation ever made.
+ * Saved bytes count the memory that callers avoided allocating by choosing a
+ * compact encoding, such as a delta command in place of whole lines.
+ */
+typedef struct allocator_stats
+{
+    size_t live_bytes;
+    size_t high_water_bytes;
+    size_t live_count;
+    size_t total_count;
+    size_t failed_count;
+    size_t size_class_count[ALLOCATOR_SIZE_CLASSES];
+    size_t tag_live_bytes[ALLOCATOR_TAG_COUNT];
+    size_t tag_live_count[ALLOCATOR_TAG_COUNT];
+    size_t saved_bytes;
+} allocator_stats_t;
+
+/**
+ * \brief Allocator interface.
+ *
+ * An allocator is a disposable structure with methods to allocate and release
+ * memory.  dispose()ing an allocator releases every allocation it still holds
+ * at once, so that structures allocated from it need not be released one by
+ * one.  The reserve, allocate_run, and measure methods are optional and may
+ * be NULL.
+ *
+ * Backends which set stats_enabled record each allocation and release in
+ * stats via allocator_stats_allocated() and allocator_stats_released().  A
+ * backend which also sets measure is shared between threads, and records them
+ * via allocator_stats_allocated_shared() and allocator_stats_released_shared()
+ * instead; allocation tags are then attributed by the measured size of each
+ * allocation, rather than by the change in live bytes, and no runs are
+ * allocated.  The system allocator
+ * is such a backend, which measures with malloc_usable_size(), so its
+ * statistics cover every user of malloc() through it in the process.  A
+ * \ref heap_t or an \ref arena_t measures memory for a single owner.
+ *
+ * Allocators other than the system allocator are not thread safe.
+ */
+typedef struct allocator
+{
+    disposable_t hdr;
+    allocator_allocate_method_t allocate;
+    allocator_release_method_t release;
+    allocator_reserve_method_t reserve;
+    allocator_allocate_run_method_t allocate_run;
+    allocator_measure_method_t measure;
+    allocator_stats_t stats;
+    bool stats_enabled;
+} allocator_t;
+
+/**
+ * \brief Get the system allocator, which allocates via malloc() and releases
+ * via free().
+ *
+ * The system allocator is a static singleton.  dispose()ing it does nothing.
+ *
+ * \returns the system allocator.
+ */
+allocator_t* allocator_system(void);
+
+/**
+ * \brief Allocate size bytes from the given allocator.
+ *
+ * \param alloc             The allocator from which memory is allocated.
+ * \param size              The number of bytes to allocate.
+ *
+ * \returns the memory, suitably aligned for any pointer or size_t, or NULL on
+ *          failure.
+ */
+void* allocator_allocate(allocator_t* alloc, size_t size);
+
+/**
+ * \brief Allocate size bytes from the given allocator, attributing them to the
+ * given tag.  The memory must be released with allocator_release_tagged()
+ * using the same tag.
+ *
+ * \param alloc             The allocator from which memory is allocated.
+ * \param size              The number of bytes to allocate.
+ * \param tag               The tag to which the memory is attributed.
+ *
+ * \returns the memory, or NULL on failure.
+ */
+void* allocator_allocate_tagged(
+    allocator_t* alloc, size_t size, allocator_tag_t tag);
+
+/**
+ * \brief Allocate count allocations of size bytes from the given allocator as
+ * one contiguous run, attributing them to the given tag.  Allocation i starts
+ * i * stride bytes after the first, and each must be released on its own with
+ * allocator_release_tagged() using the same tag.
+ *
+ * Allocators that do not support runs always fail, so callers fall back to
+ * allocating one at a time.
+ *
+ * \param alloc             The allocator from which memory is allocated.
+ * \param size              The size of each allocation.
+ * \param count             The number of allocations, which must not be 0.
+ * \param stride            Set to the distance between allocations.
+ * \param tag               The tag to which the memory is attributed.
+ *
+ * \returns the first allocation, or NULL on failure.
+ */
+void* allocator_allocate_run_tagged(
+    allocator_t* alloc, size_t size, size_t count, size_t* stride,
+    allocator_tag_t tag);
+
+/**
+ * \brief Return memory to the allocator from which it was allocated.
+ *
+ * This method assumes that the memory was allocated from this allocator; it
+ * is extremely important that the caller ensures that this is true.  NULL is
+ * ignored.
+ *
+ * \param alloc             The allocator to which memory is returned.
+ * \param ptr               The memory to release.
+ */
+void allocator_release(allocator_t* alloc, void* ptr);
+
+/**
+ * \brief Return memory allocated with allocator_allocate_tagged() to the
+ * allocator.  NULL is ignored.
+ *
+ * \param alloc             The allocator to which memory is returned.
+ * \param ptr               The memory to release.
+ * \param tag               The tag with which the memory was allocated.
+ */
+void allocator_release_tagged(
+    allocator_t* alloc, void* ptr, allocator_tag_t tag);
+
+/**
+ * \brief Ensure that the next count allocations of size bytes from this
+ * allocator will succeed, so that a batch can be allocated atomically and,
+ * where the backend supports it, contiguously.
+ *
+ * Allocators that do not support reservation always succeed.
+ *
+ * \param alloc             The allocator in which room is reserved.
+ * \param size              The size of each allocation.
+ * \param count             The number of allocations.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int allocator_reserve(allocator_t* alloc, size_t size, size_t count);
+
+/**
+ * \brief Get the statistics for an allocator.  The statistics remain owned by
+ * the allocator and are updated as it is used.  They are all zero for an
+ * allocator which does not keep statistics.
+ *
+ * \param alloc             The allocator to query.
+ *
+ * \returns the allocator's statistics.
+ */
+const allocator_stats_t* allocator_stats(const allocator_t* alloc);
+
+/**
+ * \brief Get the histogram size class for an allocation of the given size.
+ *
+ * \param size              The size of the allocation.
+ *
+ * \returns the size class.
+ */
+static inline size_t allocator_size_class(size_t size)
+{
+    size_t size_class = 0U;
+
+    for (size_t bound = 16U;
+         size > bound && size_class < ALLOCATOR_SIZE_CLASSES - 1U;
+         bound <<= 1)
+    {
+        ++size_class;
+    }
+
+    return size_class;
+}
+
+/**
+ * \brief Record an allocation of the given number of bytes.  Called by
+ * backends which keep statistics.
+ *
+ * \param alloc             The allocator.
+ * \param bytes             The number of bytes now held for the caller.
+ */
+static inline void allocator_stats_allocated(allocator_t* alloc, size_t bytes)
+{
+    allocator_stats_t* stats = &alloc->stats;
+
+    stats->live_bytes += bytes;
+    if (stats->live_bytes > stats->high_water_bytes)
+        stats->high_water_bytes = stats->live_bytes;
+
+    ++stats->live_count;
+    ++stats->total_count;
+    ++stats->size_class_count[allocator_size_class(bytes)];
+}
+
+/**
+ * \brief Record the release of the given number of bytes.  Called by backends
+ * which keep statistics.
+ *
+ * \param alloc             The allocator.
+ * \param bytes             The number of bytes no longer held.
+ */
+static inline void allocator_stats_released(allocator_t* alloc, size_t bytes)
+{
+    alloc->stats.live_bytes -= bytes;
+    --alloc->stats.live_count;
+}
+
+/**
+ * \brief Record an allocation of the given number of bytes atomically.  Called
+ * by backends which are shared between threads.
+ *
+ * \param alloc             The allocator.
+ * \param bytes             The number of bytes now held for the caller.
+ */
+static inline void allocator_stats_allocated_shared(
+    allocator_t* alloc, size_t bytes)
+{
+    allocator_stats_t* stats = &alloc->stats;
+
+    size_t live =
+        __atomic_add_fetch(&stats->live_bytes, bytes, __ATOMIC_RELAXED);
+    size_t high = __atomic_load_n(&stats->high_water_bytes, __ATOMIC_RELAXED);
+    while (live > high &&
+           !__atomic_compare_exchange_n(
+               &stats->high_water_bytes, &high, live, true, __ATOMIC_RELAXED,
+               __ATOMIC_RELAXED))
+    {
+    }
+
+    __atomic_add_fetch(&stats->live_count, 1U, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->total_count, 1U, __ATOMIC_RELAXED);
+    __atomic_add_fetch(
+        &stats->size_class_count[allocator_size_class(bytes)], 1U,
+        __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Record the release of the given number of bytes atomically.  Called
+ * by backends which are shared between threads.
+ *
+ * \param alloc             The allocator.
+ * \param bytes             The number of bytes no longer held.
+ */
+static inline void allocator_stats_released_shared(
+    allocator_t* alloc, size_t bytes)
+{
+    __atomic_sub_fetch(&alloc->stats.live_bytes, bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&alloc->stats.live_count, 1U, __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Clear the live statistics after a backend releases everything in
+ * bulk.  The high-water mark, the histogram, and the saved bytes are kept.
+ *
+ * \param alloc             The allocator.
+ */
+static inline void allocator_stats_cleared(allocator_t* alloc)
+{
+    allocator_stats_t* stats = &alloc->stats;
+
+    stats->live_bytes = 0U;
+    stats->live_count = 0U;
+    for (size_t i = 0U; i < ALLOCATOR_TAG_COUNT; ++i)
+    {
+        stats->tag_live_bytes[i] = 0U;
+        stats->tag_live_count[i] = 0U;
+    }
+}
+
+/**
+ * \brief Add the live statistics of another allocator whose memory has been
+ * handed over to this one.  The high-water mark is raised if needed, and the
+ * histogram and totals are combined.
+ *
+ * \param alloc             The allocator taking over the memory.
+ * \param other             The statistics of the allocator giving it up.
+ */
+static inline void allocator_stats_adopted(
+    allocator_t* alloc, const allocator_stats_t* other)
+{
+    allocator_stats_t* stats = &alloc->stats;
+
+    stats->live_bytes += other->live_bytes;
+    if (stats->live_bytes > stats->high_water_bytes)
+        stats->high_water_bytes = stats->live_bytes;
+
+    stats->live_count += other->live_count;
+    stats->total_count += other->total_count;
+    stats->failed_count += other->failed_count;
+    for (size_t i = 0U; i < ALLOCATOR_SIZE_CLASSES; ++i)
+    {
+        stats->size_class_count[i] += other->size_class_count[i];
+    }
+
+    for (size_t i = 0U; i < ALLOCATOR_TAG_COUNT; ++i)
+    {
+        stats->tag_live_bytes[i] += other->tag_live_bytes[i];
+        stats->tag_live_count[i] += other->tag_live_count[i];
+    }
+
+    stats->saved_bytes += other->saved_bytes;
+}
+
+/**
+ * \brief Record that a caller saved the given number of bytes by allocating a
+ * compact encoding of its data.  Allocators which keep no statistics ignore
+ * this.
+ *
+ * \param alloc             The allocator.
+ * \param bytes             The number of bytes saved.
+ */
+static inline void allocator_stats_saved(allocator_t* alloc, size_t bytes)
+{
+    if (!alloc->stats_enabled)
+        return;
+
+    if (NULL != alloc->measure)
+        __atomic_add_fetch(&alloc->stats.saved_bytes, bytes, __ATOMIC_RELAXED);
+    else
+        alloc->stats.saved_bytes += bytes;
+}
+
+/**
+ * \brief Model checking property for an allocator.
+ */
+#define PROP_VALID_ALLOCATOR(alloc) \
+    (NULL != (alloc) && \
+     PROP_VALID_DISPOSABLE(&(alloc)->hdr) && \
+     NULL != (alloc)->allocate && \
+     NULL != (alloc)->release)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_ALLOCATOR_HEADER_GUARD*/
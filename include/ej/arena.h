@@ -0,0 +1,108 @@
+/**
+ * \brief This header defines the arena type: a bump allocator which releases
+ * everything at once.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_ARENA_HEADER_GUARD
+# define EJ_ARENA_HEADER_GUARD
+
+#include <ej/allocator.h>
+#include <ej/disposable.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * An arena chunk is a contiguous block of memory from which allocations are
+ * carved.  Chunks are chained together so that they can be released in bulk
+ * when the arena is dispose()d.  The allocations follow this header, which
+ * records their usable size and is padded so that they are maximally aligned.
+ */
+typedef union arena_chunk
+{
+    struct
+    {
+        union arena_chunk* next;
+        size_t size;
+    } link;
+    max_align_t align;
+} arena_chunk_t;
+
+/**
+ * An arena is an \ref allocator_t which carves allocations sequentially out of
+ * large chunks.  Releasing an individual allocation does nothing; instead,
+ * every chunk is released together when the arena is dispose()d.  This makes
+ * allocation a pointer bump and teardown of a large structure O(chunks)
+ * rather than O(allocations).
+ */
+typedef struct arena
+{
+    allocator_t alloc;
+    size_t chunk_size;
+    arena_chunk_t* chunks;
+    unsigned char* bump;
+    unsigned char* bump_end;
+
+    size_t chunk_count;
+} arena_t;
+
+/**
+ * \brief The arena_init method creates a new empty arena.
+ *
+ * No chunk is allocated until the first allocation is requested.  Requests
+ * larger than the chunk size are given a chunk of their own.
+ *
+ * \param arena             The arena to initialize.
+ * \param chunk_size        The usable size of each chunk.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int arena_init(arena_t* arena, size_t chunk_size);
+
+/**
+ * \brief The arena_adopt method moves every chunk of the other arena into this
+ * one, so that memory allocated from the other arena is released when this
+ * arena is dispose()d.  The other arena is left empty.
+ *
+ * This lets several threads each fill an arena of their own without locking,
+ * and then hand the results to a single owner.  The other arena's statistics
+ * are added to this arena's.
+ *
+ * \param arena             The arena which takes ownership of the chunks.
+ * \param other             The arena to empty.
+ */
+void arena_adopt(arena_t* arena, arena_t* other);
+
+/**
+ * \brief The arena_owns method checks whether memory was carved from one of
+ * the arena's chunks.
+ *
+ * This walks the chunks, so it costs time in proportion to their number.
+ *
+ * \param arena             The arena.
+ * \param ptr               The memory.
+ *
+ * \returns true if the memory is in one of the arena's chunks.
+ */
+bool arena_owns(const arena_t* arena, const void* ptr);
+
+/**
+ * \brief Model checking property for an arena.
+ */
+#define PROP_VALID_ARENA(arena) \
+    (NULL != (arena) && \
+     PROP_VALID_ALLOCATOR(&(arena)->alloc) && \
+     (arena)->chunk_size > 0U && \
+     (arena)->bump <= (arena)->bump_end)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_ARENA_HEADER_GUARD*/
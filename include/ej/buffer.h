@@ -10,27 +10,176 @@
 # define EJ_BUFFER_HEADER_GUARD
 
 #include <ej/allocator.h>
-#include <ej/commandfwd.h>
+#include <ej/arena.h>
+#include <ej/command.h>
 #include <ej/disposable.h>
 #include <ej/list.h>
-#include <ej/stack.h>
+#include <ej/ostree.h>
+#include <ej/reader.h>
 #include <ej/string.h>
+#include <ej/ulist.h>
 
 #ifdef   __cplusplus
 extern "C" {
 #endif /*__cplusplus*/
 
 /**
- * A buffer contains a linked list of strings, a command stack, and a command
- * queue.
+ * \brief The smallest chunk of a file that a parallel load gives a worker.
+ */
+#define BUFFER_PARALLEL_MIN_CHUNK (256U * 1024U)
+
+/**
+ * \brief The chunk size of the arenas used by a parallel load.
+ */
+#define BUFFER_PARALLEL_ARENA_CHUNK (1024U * 1024U)
+
+/**
+ * \brief Save flag: write to a temporary file, fsync() it, and rename() it
+ * over the destination, so that the destination is never partially written.
+ */
+#define BUFFER_SAVE_ATOMIC 0x01U
+
+/**
+ * \brief The most lines, or runs of unchanged lines, written by one writev().
+ * This is no more than the IOV_MAX of the supported platforms.
+ */
+#define BUFFER_SAVE_BATCH 1024U
+
+/**
+ * \brief The default size of the regions of a lazily loaded file.
+ */
+#define BUFFER_LAZY_REGION_SIZE (64U * 1024U * 1024U)
+
+/**
+ * \brief The default number of commands between the checkpoints of a
+ * \ref buffer_history_t.
+ */
+#define BUFFER_HISTORY_INTERVAL 256U
+
+/**
+ * \brief The chunk size of the arena of a \ref buffer_history_t.
+ */
+#define BUFFER_HISTORY_ARENA_CHUNK (1024U * 1024U)
+
+/**
+ * \brief The most lines in one chunk of a \ref buffer_checkpoint_t.
+ */
+#define BUFFER_CHECKPOINT_CHUNK 1024U
+
+/**
+ * \brief The number of chunks of the previous checkpoint which are searched
+ * for one that the next run of lines can share.
+ */
+#define BUFFER_CHECKPOINT_LOOKAHEAD 16U
+
+/**
+ * A buffer region stands in for a run of lines of a lazily loaded file which
+ * have not been parsed yet.  It covers whole lines of the buffer's source:
+ * size bytes starting at offset, which is the start of a line.  Only the last
+ * region of a file may end without a newline.
+ */
+typedef struct buffer_region
+{
+    disposable_t hdr;
+    size_t offset;
+    size_t size;
+    size_t number;
+} buffer_region_t;
+
+/**
+ * \brief The line index of a lazily loaded file, which is private to the
+ * buffer.
+ */
+typedef struct buffer_index buffer_index_t;
+
+/**
+ * A checkpoint chunk holds a run of the lines of a checkpoint.  A line is
+ * kept as a \ref command_line_t which views text that never changes, either
+ * in the buffer's source or in the history's arena; a region is kept with a
+ * NULL data and its number as the length.  The lines follow this header in
+ * the same allocation.
+ */
+typedef struct buffer_checkpoint_chunk
+{
+    size_t count;
+    command_line_t* lines;
+} buffer_checkpoint_chunk_t;
+
+/**
+ * A checkpoint records the lines of a buffer when its undo stack was depth
+ * commands deep, along with a mark for that depth and the time of the command
+ * on top, or 0 if there was none.  A chunk which holds the same lines as a
+ * chunk of the previous checkpoint is shared with it, so a checkpoint costs
+ * memory in proportion to the lines changed since the last one; those are the
+ * bytes it took from the history's arena.
+ */
+typedef struct buffer_checkpoint
+{
+    struct buffer_checkpoint* prev;
+    size_t depth;
+    uint64_t mark;
+    uint64_t time;
+    size_t chunk_count;
+    buffer_checkpoint_chunk_t** chunks;
+    size_t bytes;
+} buffer_checkpoint_t;
+
+/**
+ * A buffer history keeps checkpoints of the buffer every interval commands,
+ * newest first, so that reaching a distant state of the buffer costs at most
+ * restoring a checkpoint and replaying the commands after it.  Everything it
+ * holds comes from its arena, which is released when it is dispose()d.
+ *
+ * The arena can't release what dropped checkpoints took from it, so those
+ * bytes are counted as dropped, and once they are most of the arena, the
+ * checkpoints which are left, and the text the buffer's lines view, are
+ * copied into a new arena, which replaces the old one.
+ */
+typedef struct buffer_history
+{
+    disposable_t hdr;
+    arena_t arena;
+    size_t interval;
+    buffer_checkpoint_t* last;
+
+    size_t checkpoint_count;
+    size_t chunk_count;
+    size_t shared_count;
+    size_t copied_bytes;
+    size_t replay_count;
+    size_t dropped_bytes;
+    size_t compact_count;
+} buffer_history_t;
+
+/**
+ * A buffer contains a linked list of \ref string_t lines, a command stack, and
+ * a command queue.  A buffer created in arena mode also owns the arena from
+ * which all of these are allocated.  A buffer opened from a file may also own
+ * the reader whose mapping its lines view, and a lazily loaded buffer owns
+ * the index of its regions.  A buffer with an undo stack may keep a history of
+ * checkpoints, to jump through it quickly.
+ *
+ * A buffer opened from a file records whether its lines ended with CRLF, so
+ * that buffer_save() can write them the same way.
+ *
+ * After buffer_unroll(), the lines are kept in the unrolled list chunks
+ * instead, and lines is NULL.  After buffer_tree_init(), tree indexes the
+ * nodes of the line list by their position.
  */
 typedef struct buffer
 {
     disposable_t hdr;
     allocator_t* allocator;
     list_t* lines;
+    ulist_t* chunks;
+    ostree_t* tree;
     command_stack_t* undo_commands;
     command_queue_t* redo_commands;
+    arena_t* arena;
+    reader_t* source;
+    buffer_index_t* index;
+    buffer_history_t* history;
+    bool crlf;
 } buffer_t;
 
 /**
@@ -39,7 +188,15 @@ typedef struct buffer
  *
  * Buffer takes ownership of the line list, the command stack, and the command
  * queue. It will dispose() these when done, and it assumes that the allocator
- * can free these items.
+ * can free these items.  The command stack and the command queue may be NULL
+ * if the buffer does not track undo or redo.
+ *
+ * When the buffer creates its own empty line list, both the list and its
+ * lines belong to the allocator.  With an \ref arena_t, the whole buffer can
+ * then be released at once by dispose()ing the arena after the buffer.  The
+ * statistics of the allocator measure the buffer's memory; those of the
+ * shared system allocator include every other user of it, so a buffer whose
+ * memory is measured alone is given a \ref heap_t or an arena of its own.
  *
  * \param buffer            The buffer to initialize;
  * \param allocator         The allocator to use for allocating lines and
@@ -58,6 +215,364 @@ int buffer_init(
     buffer_t* buffer, allocator_t* allocator, list_t* lines,
     command_stack_t* undo_commands, command_queue_t* redo_commands);
 
+/**
+ * Initialize a buffer in arena mode, in which the lines, the list nodes, and
+ * the command records all come from the given arena, and the buffer owns that
+ * arena.
+ *
+ * Disposing a buffer in arena mode releases the arena's chunks in bulk rather
+ * than releasing each line and node.  The line list is NOT walked, so lines in
+ * an arena mode buffer must not own any resources outside of the arena; their
+ * dispose methods are not called.  The command stack and command queue are
+ * still dispose()d, so that they can release any external resources, but
+ * their memory is reclaimed with the arena.  So is a source reader, which is
+ * dispose()d first so that it can release its mapping.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param arena             The arena to own, which must have been allocated
+ *                          via malloc().
+ * \param lines             The lines to assign to this buffer, which must use
+ *                          the arena for nodes and data, or NULL to create an
+ *                          empty buffer.
+ * \param undo_commands     A command stack allocated from the arena, or NULL.
+ * \param redo_commands     A command queue allocated from the arena, or NULL.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure, in which case the caller retains ownership of the arena.
+ */
+int buffer_init_arena(
+    buffer_t* buffer, arena_t* arena, list_t* lines,
+    command_stack_t* undo_commands, command_queue_t* redo_commands);
+
+/**
+ * Initialize a buffer with the lines of the file at the given path, without
+ * copying them.
+ *
+ * The file is memory mapped, and each line is a \ref string_t view of the
+ * mapping, which is copied into storage of its own when it is first changed.
+ * Opening a file only costs a scan of its contents and a string and a node per
+ * line, and the pages of the file are clean, so memory grows with the edits
+ * made rather than the size of the file.  The buffer owns the mapping and
+ * releases it after its lines.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param allocator         The allocator for the lines, the line list, and
+ *                          the reader.
+ * \param path              The path of the file to open.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure, including if the file is not valid UTF-8.
+ */
+int buffer_init_file(
+    buffer_t* buffer, allocator_t* allocator, const char* path);
+
+/**
+ * Initialize a buffer in arena mode with the lines of the file at the given
+ * path, which are found by several threads at once.
+ *
+ * The file is memory mapped without being read, and then split at newlines
+ * into one chunk per worker.  Each worker validates its chunk's UTF-8 and
+ * builds a list of views of its lines, allocating the nodes and strings from
+ * an arena of its own, so that the workers never contend on an allocator.
+ * The worker arenas are then adopted by the buffer's arena, and the lists are
+ * spliced together in order.  Small files use fewer workers, so that each has
+ * at least \ref BUFFER_PARALLEL_MIN_CHUNK bytes to scan.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param path              The path of the file to open.
+ * \param workers           The number of threads to use, or 0 to use one per
+ *                          online processor.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure, including if the file is not valid UTF-8.
+ */
+int buffer_init_file_parallel(
+    buffer_t* buffer, const char* path, size_t workers);
+
+/**
+ * Initialize a buffer with the file at the given path, parsing its lines only
+ * when they are needed.
+ *
+ * The file is memory mapped without being read, and split at newlines into
+ * regions of about region_size bytes, each of which is a single
+ * \ref buffer_region_t in the line list.  A background thread counts the
+ * lines of each region in turn.  A region is parsed into \ref string_t views,
+ * and its UTF-8 is validated, only when buffer_materialize() is called on it,
+ * as buffer_line_at() does.  Opening a file, and reaching any line of it,
+ * therefore costs time and memory in proportion to the regions touched rather
+ * than the size of the file.  Only the first line is read up front, to decide
+ * whether the lines are saved with CRLF.
+ *
+ * Until every region is materialized, the line list holds both lines and
+ * regions, which buffer_is_region() tells apart, and its size counts each
+ * region once.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param allocator         The allocator for the lines, the regions, the line
+ *                          list, the reader, and the index.
+ * \param path              The path of the file to open.
+ * \param region_size       The size of each region, or 0 for
+ *                          \ref BUFFER_LAZY_REGION_SIZE.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure.
+ */
+int buffer_init_file_lazy(
+    buffer_t* buffer, allocator_t* allocator, const char* path,
+    size_t region_size);
+
+/**
+ * \brief Dispose of a region.
+ *
+ * A region owns nothing, so this does nothing; regions are recognized by
+ * this dispose method.
+ *
+ * \param disp              The region to dispose.
+ */
+void buffer_region_dispose(disposable_t* disp);
+
+/**
+ * \brief Return true if the given value in a buffer's line list is a
+ * \ref buffer_region_t rather than a \ref string_t.
+ *
+ * \param value             The value to check.
+ */
+static inline bool buffer_is_region(const disposable_t* value)
+{
+    return &buffer_region_dispose == value->dispose;
+}
+
+/**
+ * Replace the region at the given node of a lazily loaded buffer with the
+ * lines it covers, which view the buffer's source.
+ *
+ * \param buffer            The buffer.
+ * \param node              The node holding the region, which is released.
+ * \param first             Set to the node of the region's first line.
+ *
+ * \returns 0 on success, or non-zero on failure, including if the region is
+ *          not valid UTF-8, in which case the region is left in place.
+ */
+int buffer_materialize(
+    buffer_t* buffer, list_node_t* node, list_node_t** first);
+
+/**
+ * Find the line at the given zero-based index, materializing the region which
+ * holds it if need be.
+ *
+ * The lines of any region before the line which the background thread has not
+ * yet counted are counted on this thread.  A buffer indexed by
+ * buffer_tree_init() finds the line in O(log n); otherwise, the line list is
+ * walked from its head.
+ *
+ * \param buffer            The buffer.
+ * \param index             The index of the line.
+ * \param node              Set to the node of the line.
+ *
+ * \returns 0 on success, or non-zero if the index is out of bounds, the
+ *          region holding the line could not be materialized, or the buffer
+ *          keeps its lines in an unrolled list, which has no nodes.
+ */
+int buffer_line_at(buffer_t* buffer, size_t index, list_node_t** node);
+
+/**
+ * Index the nodes of the buffer's line list with an order statistic tree, so
+ * that buffer_line_at(), buffer_replace(), and buffer_undo() find a line by
+ * its number in O(log n) rather than by walking the list.
+ *
+ * The tree is built in O(n log n), and then kept in step with every change
+ * made through the buffer's methods, at the cost of a tree node and an entry
+ * per line.  The lines must only be changed through those methods while the
+ * buffer keeps a tree.  Unrolling the buffer releases the tree.
+ *
+ * \param buffer            The buffer, which must not be lazily loaded or
+ *                          unrolled.
+ *
+ * \returns 0 on success, or non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_tree_init(buffer_t* buffer);
+
+/**
+ * Move the lines of the buffer into an unrolled list, which holds the
+ * pointers to several lines in each chunk.
+ *
+ * Whole-buffer passes, such as buffer_save() and buffer_checkpoint(), then
+ * touch one chunk per \ref ULIST_CHUNK_CAPACITY lines rather than one node per
+ * line.  Lines are still replaced, undone, and restored from checkpoints as
+ * before, but the buffer has no list nodes, so buffer_line_at() fails, and
+ * the tree of a buffer indexed by buffer_tree_init() is released.  The lines
+ * are moved as they are, without being copied.
+ *
+ * \param buffer            The buffer, which must not be lazily loaded, and
+ *                          whose line list must release its lines to the
+ *                          buffer's allocator.
+ *
+ * \returns 0 on success, or non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_unroll(buffer_t* buffer);
+
+/**
+ * Replace count lines of the buffer, starting at the given zero-based line,
+ * with new_count new lines.  A count of 0 inserts the new lines before line,
+ * which may be the number of lines in the buffer to append them, and a
+ * new_count of 0 deletes the lines.
+ *
+ * If the buffer has an undo command stack, a command recording the change is
+ * pushed onto it, where it may be merged with the change before it.  Either
+ * the whole change is made and recorded, or none of it is.  A buffer which
+ * keeps a history takes a checkpoint once enough commands have been pushed.
+ *
+ * \param buffer            The buffer to change.
+ * \param line              The index of the first line to replace.
+ * \param count             The number of lines to replace.
+ * \param lines             The new lines, which must be valid UTF-8.
+ * \param new_count         The number of new lines.
+ *
+ * \returns 0 on success and non-zero on failure, including if the lines to be
+ *          replaced are not all in the buffer.
+ */
+int buffer_replace(
+    buffer_t* buffer, size_t line, size_t count, const command_line_t* lines,
+    size_t new_count);
+
+/**
+ * Make the change which a command records, or take it back.
+ *
+ * A \ref COMMAND_TYPE_REPLACE command replaces whole lines.  A
+ * \ref COMMAND_TYPE_DELTA command rebuilds each of its lines from the bytes
+ * around its change, and fails unless the line holds the bytes it replaces.
+ *
+ * \param buffer            The buffer to change.
+ * \param cmd               The command.
+ * \param undo              true to take the change back, and false to make it.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_apply(buffer_t* buffer, const command_t* cmd, bool undo);
+
+/**
+ * Undo the most recent change to the buffer, popping its command from the
+ * undo command stack.
+ *
+ * \param buffer            The buffer to change.
+ *
+ * \returns 0 on success, or non-zero if there is nothing to undo or the
+ *          change could not be undone, in which case the buffer and the stack
+ *          are unchanged.
+ */
+int buffer_undo(buffer_t* buffer);
+
+/**
+ * Keep a history of checkpoints of the buffer, one every interval commands,
+ * starting with one of the buffer as it is now.
+ *
+ * Each checkpoint records every line of the buffer, without copying those
+ * which view text that never changes.  A line which owns its text is copied
+ * into the history once, and then becomes a view of that copy, so that later
+ * checkpoints share it too.  Runs of lines which are the same as in the
+ * previous checkpoint share its chunks, so an unchanged part of the buffer
+ * costs nothing.  Checkpoints are taken by buffer_replace(), and undoing a
+ * change drops those which are newer than the stack.  Once dropped
+ * checkpoints hold most of the history's arena, what is left is compacted
+ * into a new one.  The undo stack must only be changed through the buffer's
+ * methods while it keeps a history.
+ *
+ * \param buffer            The buffer, which must have an undo stack.
+ * \param interval          The number of commands between checkpoints, or 0
+ *                          for \ref BUFFER_HISTORY_INTERVAL.
+ *
+ * \returns 0 on success, or non-zero on failure, including if the buffer has
+ *          no undo stack or already keeps a history.
+ */
+int buffer_history_init(buffer_t* buffer, size_t interval);
+
+/**
+ * Take a checkpoint of the buffer now, unless one was taken at this depth of
+ * the undo stack.  The undo stack is sealed, so that no later command is
+ * merged into the state the checkpoint records.
+ *
+ * \param buffer            The buffer, which must keep a history.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_checkpoint(buffer_t* buffer);
+
+/**
+ * Undo changes until the undo stack is depth commands deep.
+ *
+ * With a history, the nearest checkpoint at or below that depth is restored,
+ * and only the commands between it and depth are made again, unless undoing
+ * the changes one at a time is cheaper.  Either way, the commands above depth
+ * are discarded.
+ *
+ * \param buffer            The buffer to change.
+ * \param depth             The depth of the undo stack to return to.
+ *
+ * \returns 0 on success, or non-zero on failure, including if the stack is not
+ *          that deep, in which case the buffer is left at a depth between
+ *          depth and where it started, which matches its undo stack.
+ */
+int buffer_undo_to(buffer_t* buffer, size_t depth);
+
+/**
+ * Undo every change made after the given time, as for an editor's
+ * :earlier command.  A run of merged changes is undone only if it began after
+ * the time.
+ *
+ * \param buffer            The buffer to change.
+ * \param time              The time, in milliseconds since the epoch.
+ *
+ * \returns 0 on success and non-zero on failure, as for buffer_undo_to().
+ */
+int buffer_undo_until(buffer_t* buffer, uint64_t time);
+
+/**
+ * Save the lines of a buffer to the file at the given path, each followed by
+ * the buffer's line ending: CRLF if the file it was opened from used CRLF, and
+ * a newline otherwise.
+ *
+ * The lines are gathered into batches of iovecs which point at their own
+ * storage, and each batch is written with a single writev(), so nothing is
+ * copied.  A run of lines which still view the buffer's source, along with
+ * the line endings between them, is written as one iovec, so saving an
+ * unchanged region costs no more than writing it, and an unchanged file is
+ * written back byte for byte.
+ *
+ * With \ref BUFFER_SAVE_ATOMIC, the lines are written to a temporary file in
+ * the same directory, which is fsync()ed and renamed over the destination,
+ * and the directory is then fsync()ed.  The destination keeps its permissions.
+ * A buffer with a source is always saved atomically, as truncating its own
+ * file would pull the mapping out from under its lines.  The regions of a
+ * lazily loaded buffer are written from the mapping byte for byte.
+ *
+ * \param buffer            The buffer to save.
+ * \param path              The path of the file to write.
+ * \param flags             Zero, or \ref BUFFER_SAVE_ATOMIC.
+ *
+ * \returns 0 if the buffer was saved, or non-zero on failure, in which case
+ *          an atomic save leaves the destination untouched.
+ */
+int buffer_save(const buffer_t* buffer, const char* path, unsigned int flags);
+
+/**
+ * \brief Model checking property for a buffer.
+ */
+#define PROP_VALID_BUFFER(buffer) \
+    (NULL != (buffer) && \
+     PROP_VALID_ALLOCATOR((buffer)->allocator) && \
+     (NULL == (buffer)->chunks ? \
+        PROP_VALID_LIST((buffer)->lines) : \
+        (NULL == (buffer)->lines && PROP_VALID_ULIST((buffer)->chunks))) && \
+     (NULL == (buffer)->history || NULL != (buffer)->undo_commands) && \
+     (NULL == (buffer)->tree || \
+      (NULL == (buffer)->index && NULL == (buffer)->chunks)) && \
+     (NULL == (buffer)->arena || \
+      &(buffer)->arena->alloc == (buffer)->allocator))
+
 #ifdef   __cplusplus
 }
 #endif /*__cplusplus*/
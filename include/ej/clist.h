@@ -0,0 +1,256 @@
+/**
+ * \brief This header defines the circular list type: a doubly-linked list
+ * threaded through a sentinel node.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_CLIST_HEADER_GUARD
+# define EJ_CLIST_HEADER_GUARD
+
+#include <ej/allocator.h>
+#include <ej/disposable.h>
+#include <ej/list.h>
+#include <ej/pool.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * A circular list has the same semantics as \ref list_t, but its nodes form a
+ * ring through a sentinel node embedded in the list itself.  The first node
+ * follows the sentinel and the last node precedes it, so no node's next or
+ * prev pointer is ever NULL, and inserting or removing a node is the same
+ * straight-line pointer update wherever the node is.
+ *
+ * The sentinel's data is always NULL.  Iteration runs from clist_begin() until
+ * clist_end() is reached.  Because the ring points back into the list, a
+ * clist_t must not be copied or moved by value once it is initialized.
+ *
+ * Nodes are \ref list_node_t instances, so the same pools can back either
+ * kind of list.  As with \ref list_t, nodes come from the node allocator and
+ * data values are released to the data allocator.
+ */
+typedef struct clist
+{
+    disposable_t hdr;
+    list_node_t sentinel;
+
+    size_t size;
+    allocator_t* node_alloc;
+    allocator_t* data_alloc;
+} clist_t;
+
+/**
+ * \brief The clist_init method creates a new empty circular list.
+ *
+ * \param list          The list to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_init(clist_t* list);
+
+/**
+ * \brief The clist_init_pool method creates a new empty circular list whose
+ * nodes are allocated from the given node pool.
+ *
+ * The pool must have an object size of at least sizeof(list_node_t), and it
+ * must outlive this list.
+ *
+ * \param list          The list to initialize.
+ * \param pool          The pool from which nodes are allocated.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_init_pool(clist_t* list, pool_t* pool);
+
+/**
+ * \brief The clist_init_allocator method creates a new empty circular list
+ * whose nodes are allocated from, and whose data values are released to, the
+ * given allocator, which must outlive this list.
+ *
+ * \param list          The list to initialize.
+ * \param alloc         The allocator which owns the nodes and data.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_init_allocator(clist_t* list, allocator_t* alloc);
+
+/**
+ * \brief Get the first node of the list, or clist_end() if it is empty.
+ *
+ * \param list          The list to query.
+ */
+static inline list_node_t* clist_begin(clist_t* list)
+{
+    return list->sentinel.next;
+}
+
+/**
+ * \brief Get the sentinel node, which follows the last node of the list.
+ *
+ * \param list          The list to query.
+ */
+static inline list_node_t* clist_end(clist_t* list)
+{
+    return &list->sentinel;
+}
+
+/**
+ * \brief The clist_push_front method pushes a data value onto the front of the
+ * list.  The ownership of this data is transferred to the list and may be
+ * dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_push_front(clist_t* list, disposable_t* data);
+
+/**
+ * \brief The clist_push_back method pushes a data value onto the back of the
+ * list.  The ownership of this data is transferred to the list and may be
+ * dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_push_back(clist_t* list, disposable_t* data);
+
+/**
+ * \brief The clist_pop_front method pops a data value off of the front of the
+ * list.  The ownership of this data is transferred to the caller who is
+ * responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_pop_front(clist_t* list, disposable_t** data);
+
+/**
+ * \brief The clist_pop_back method pops a data value off of the back of the
+ * list.  The ownership of this data is transferred to the caller who is
+ * responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_pop_back(clist_t* list, disposable_t** data);
+
+/**
+ * \brief The clist_insert method will insert the given data value BEFORE the
+ * given node in the list.  Inserting before clist_end() appends the value to
+ * the back of the list.  This method assumes that the provided node is part
+ * of the list; it is extremely important that the caller ensures that this is
+ * true.  The ownership of this data is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node before which this data is inserted.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_insert(clist_t* list, list_node_t* node, disposable_t* data);
+
+/**
+ * \brief The clist_append method will append the given data value AFTER the
+ * given node in the list.  Appending after clist_end() pushes the value onto
+ * the front of the list.  This method assumes that the provided node is part
+ * of the list; it is extremely important that the caller ensures that this is
+ * true.  The ownership of this data is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node after which this data is appended.
+ * \param data          The data to append.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_append(clist_t* list, list_node_t* node, disposable_t* data);
+
+/**
+ * \brief The clist_remove method will remove the given node from the list,
+ * returning the data value to be dispose()d and free()d by the caller.  This
+ * method assumes that the provided node is part of the list and is not
+ * clist_end(); it is extremely important that the caller ensures that this is
+ * true.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node to be removed.
+ * \param data          Pointer to the data pointer returned to the caller.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_remove(clist_t* list, list_node_t* node, disposable_t** data);
+
+/**
+ * \brief The clist_splice method will splice two lists into one.  After this
+ * method is called, the x list will contain all nodes, and the y list will be
+ * empty.  Both lists must share the same allocators.
+ *
+ * \param x             The x list to splice with the values from the y list.
+ * \param y             The y list to destructively splice.
+ */
+void clist_splice(clist_t* x, clist_t* y);
+
+/**
+ * \brief The clist_split method will split the list on the given node.  The
+ * original list x will contain all entries BEFORE the node, and the new y list
+ * will contain this node and all entries AFTER this node.  It is expected that
+ * the y list is empty, node belongs to the original x list, and both lists
+ * share the same allocators.  Splitting on clist_end() leaves y empty.
+ *
+ * The size of the y list is found by walking inward from both ends of x at
+ * once, so this method touches at most half of the nodes in x.
+ *
+ * \param x             The x list to split.
+ * \param node          The node on which the list is split.
+ * \param y             The y list to receive node and every node after it.
+ */
+void clist_split(clist_t* x, list_node_t* node, clist_t* y);
+
+/**
+ * \brief Model checking property for an empty circular list.
+ */
+#define PROP_VALID_CLIST_EMPTY(list) \
+    (NULL != (list) && \
+     (list)->size == 0U && \
+     &(list)->sentinel == (list)->sentinel.next && \
+     &(list)->sentinel == (list)->sentinel.prev)
+
+/**
+ * \brief Model checking property for a non-empty circular list.
+ */
+#define PROP_VALID_CLIST_NOT_EMPTY(list) \
+    (NULL != (list) && \
+     (list)->size > 0U && \
+     NULL != (list)->sentinel.next && \
+     NULL != (list)->sentinel.prev && \
+     &(list)->sentinel != (list)->sentinel.next && \
+     &(list)->sentinel != (list)->sentinel.prev)
+
+/**
+ * \brief Model checking property for a circular list.
+ */
+#define PROP_VALID_CLIST(list) \
+    (PROP_VALID_CLIST_EMPTY(list) || PROP_VALID_CLIST_NOT_EMPTY(list))
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_CLIST_HEADER_GUARD*/
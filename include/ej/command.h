@@ -0,0 +1,591 @@
+/**
+ * \brief This header defines commands, which record changes to a buffer so
+ * that they can be undone, and the command stacks which hold them.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_COMMAND_HEADER_GUARD
+# define EJ_COMMAND_HEADER_GUARD
+
+#include <ej/allocator.h>
+#include <ej/commandfwd.h>
+#include <ej/disposable.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief A command which replaces a run of lines with other lines.
+ */
+#define COMMAND_TYPE_REPLACE 1U
+
+/**
+ * \brief A command which changes a byte range of each of a run of lines.
+ */
+#define COMMAND_TYPE_DELTA 2U
+
+/**
+ * \brief The size of the write buffer of a \ref command_log_t.
+ */
+#define COMMAND_LOG_BUFFER_SIZE (64U * 1024U)
+
+/**
+ * \brief The number of bytes on either side of a command which are mapped
+ * along with it when a \ref command_log_t reads it from its file, so that
+ * reading one command after another seldom maps the file again.
+ */
+#define COMMAND_LOG_MAP_SIZE (1024U * 1024U)
+
+/**
+ * \brief The default number of bytes of commands which a
+ * \ref command_tiered_t keeps in memory.
+ */
+#define COMMAND_TIERED_HOT_SIZE (16U * 1024U * 1024U)
+
+/**
+ * \brief The most bytes of commands which a \ref command_tiered_t spills in
+ * one compressed block, unless a single command is bigger.
+ */
+#define COMMAND_TIERED_BLOCK_SIZE (256U * 1024U)
+
+/**
+ * \brief The most bytes which command_lz_compress() writes for size bytes.
+ */
+#define COMMAND_LZ_BOUND(size) ((size) + (size) / 255U + 16U)
+
+/**
+ * A command line refers to the text of a line, without its newline.
+ */
+typedef struct command_line
+{
+    const char* data;
+    size_t length;
+} command_line_t;
+
+/**
+ * A command is a self-contained record of a change to a buffer, which holds
+ * everything needed both to make the change and to undo it.  It contains no
+ * pointers, so it can be copied, written to a file, and mapped back in as is.
+ *
+ * A \ref COMMAND_TYPE_REPLACE command replaces the old_count lines starting
+ * at line with new_count lines.  Doing it replaces the old lines with the new
+ * ones, and undoing it replaces the new lines with the old ones.  This header
+ * is followed by the length of each old line and then each new line, as
+ * 32-bit values, then by the old_bytes bytes of the old lines, and then by
+ * the bytes of the new lines.  The record is padded to a multiple of 8 bytes,
+ * and size counts all of it.  The time is when the command was made, in
+ * milliseconds since the epoch.
+ *
+ * A \ref COMMAND_TYPE_DELTA command changes old_count lines in place, and its
+ * new_count is the same.  Only the part of each line which changed is kept:
+ * the lengths are those of the bytes removed from each line and then of the
+ * bytes inserted, and they are followed by the offset of the change in each
+ * line, before the text of the removed and inserted bytes.
+ */
+typedef struct command
+{
+    uint64_t size;
+    uint64_t line;
+    uint64_t time;
+    uint64_t old_bytes;
+    uint32_t type;
+    uint32_t old_count;
+    uint32_t new_count;
+    uint32_t flags;
+} command_t;
+
+/* forward decls */
+struct command_stack;
+
+typedef int (*command_stack_push_method_t)(
+    struct command_stack* stack, const command_t* cmd);
+
+typedef const command_t* (*command_stack_peek_method_t)(
+    struct command_stack* stack);
+
+typedef int (*command_stack_pop_method_t)(struct command_stack* stack);
+
+typedef int (*command_stack_replace_method_t)(
+    struct command_stack* stack, const command_t* cmd);
+
+typedef uint64_t (*command_stack_mark_method_t)(struct command_stack* stack);
+
+typedef const command_t* (*command_stack_next_method_t)(
+    struct command_stack* stack, uint64_t* mark);
+
+typedef int (*command_stack_truncate_method_t)(
+    struct command_stack* stack, uint64_t mark);
+
+/**
+ * A command stack holds the commands which can be undone, most recent last.
+ * It is an interface, which implementations embed as their first member, so
+ * that commands can be kept in memory or in a file.
+ *
+ * A stack can coalesce a command with the one on top of it, so that a run of
+ * small edits is undone in one step; see command_stack_coalesce().  A sealed
+ * stack starts a new command with the next push.
+ *
+ * A mark names a depth of the stack, so that the commands above it can be
+ * read oldest first, and the stack can be cut back to it in one step; see
+ * command_stack_mark().
+ *
+ * The replace method swaps the command on top for a copy of another, and
+ * leaves the stack unchanged if it fails, so that a merge never loses the
+ * command it was merged into.
+ */
+struct command_stack
+{
+    disposable_t hdr;
+    command_stack_push_method_t push;
+    command_stack_peek_method_t peek;
+    command_stack_pop_method_t pop;
+    command_stack_replace_method_t replace;
+    command_stack_mark_method_t mark;
+    command_stack_next_method_t next;
+    command_stack_truncate_method_t truncate;
+    size_t count;
+
+    uint64_t coalesce_ms;
+    size_t coalesce_bytes;
+    bool sealed;
+    size_t merge_count;
+};
+
+/**
+ * A memory command stack entry holds a copy of a command, and links to the
+ * entries below and above it.
+ */
+typedef struct command_mem_entry
+{
+    struct command_mem_entry* prev;
+    struct command_mem_entry* next;
+    union
+    {
+        command_t cmd;
+        max_align_t align;
+    } u;
+} command_mem_entry_t;
+
+/**
+ * A memory command stack keeps a copy of each command, allocated from an
+ * allocator, on a doubly linked chain.  A mark is the address of the entry
+ * on top at the time, or 0 for the bottom of the stack.
+ */
+typedef struct command_mem_stack
+{
+    command_stack_t stack;
+    allocator_t* alloc;
+    command_mem_entry_t* bottom;
+    command_mem_entry_t* top;
+} command_mem_stack_t;
+
+/**
+ * A command log is a command stack kept in an append-only file, so that an
+ * editing session of any length uses the same amount of memory.
+ *
+ * Each command is written followed by its size, which links it to the
+ * command below it, so the log is its own index.  Pushed commands are
+ * gathered in a write buffer, which is written out when it fills up.  The
+ * command on top is read from the write buffer or, once written, through a
+ * read-only mapping of the part of the file which holds it and the commands
+ * around it.  Popping a command only moves the end of the log back; the next
+ * push overwrites it.  A mark is the offset of the end of the log at the time,
+ * and the command after a mark starts there.
+ *
+ * Bytes [0, flushed) of the log are in the file, and bytes [flushed, end)
+ * are in the write buffer.
+ */
+typedef struct command_log
+{
+    command_stack_t stack;
+    int fd;
+    uint64_t end;
+    uint64_t flushed;
+    unsigned char* buffer;
+
+    void* map;
+    uint64_t map_offset;
+    size_t map_size;
+
+    uint64_t write_count;
+    uint64_t map_count;
+} command_log_t;
+
+/**
+ * A tiered block records a block of commands spilled by a
+ * \ref command_tiered_t: where it is in the file, the depth of its first
+ * command, how many commands it holds, and its size before and after it was
+ * compressed.
+ */
+typedef struct command_tiered_block
+{
+    uint64_t offset;
+    size_t depth;
+    size_t count;
+    size_t size;
+    size_t packed;
+} command_tiered_block_t;
+
+/**
+ * A tiered command stack keeps the most recent commands in memory, and spills
+ * the oldest to a file once they take more than hot_limit bytes, so that an
+ * editing session of any length uses a bounded amount of memory, while the
+ * changes undone most often are undone without touching the file.
+ *
+ * The hot commands are copies on a doubly linked chain, as in a
+ * \ref command_mem_stack_t.  The cold ones are spilled from the bottom of the
+ * chain, in blocks of up to \ref COMMAND_TIERED_BLOCK_SIZE bytes, or half the
+ * limit if that is smaller.  Each block is compressed with
+ * command_lz_compress() and appended to the spill file.  When undoing reaches
+ * the cold commands, the last block is read back, becomes hot again, and is
+ * cut from the file.  Reading the commands above a mark decompresses the
+ * block which holds them into a cache, and leaves the block in the file.  A
+ * mark is the depth of the stack at the time.
+ *
+ * The time taken by each spill and each reload is kept, in nanoseconds, along
+ * with the number of bytes spilled before and after they were compressed.
+ */
+typedef struct command_tiered
+{
+    command_stack_t stack;
+    allocator_t* alloc;
+    size_t hot_limit;
+    size_t hot_bytes;
+    size_t hot_count;
+    command_mem_entry_t* bottom;
+    command_mem_entry_t* top;
+
+    int fd;
+    uint64_t end;
+    command_tiered_block_t* blocks;
+    size_t block_count;
+    size_t block_capacity;
+    size_t cold_count;
+
+    command_mem_entry_t* cursor;
+    size_t cursor_depth;
+    unsigned char* cache;
+    size_t cache_capacity;
+    size_t cache_block;
+    size_t cache_offset;
+    size_t cache_depth;
+
+    uint64_t spill_count;
+    uint64_t spill_bytes;
+    uint64_t spill_packed_bytes;
+    uint64_t spill_ns;
+    uint64_t spill_max_ns;
+    uint64_t reload_count;
+    uint64_t reload_ns;
+    uint64_t reload_max_ns;
+} command_tiered_t;
+
+/**
+ * \brief The command_create method creates a command which replaces the given
+ * old lines, starting at line, with the given new lines.
+ *
+ * When as many lines are replaced as replace them, and only the changed part
+ * of each line makes a smaller record, a \ref COMMAND_TYPE_DELTA command is
+ * created, and the bytes saved are recorded in the allocator's statistics.
+ * Otherwise, a \ref COMMAND_TYPE_REPLACE command holds a copy of every line.
+ *
+ * \param cmd           Set to the command, which must be released to the
+ *                      allocator with \ref ALLOCATOR_TAG_COMMAND.
+ * \param alloc         The allocator for the command.
+ * \param line          The zero-based index of the first line replaced.
+ * \param old_lines     The lines which are replaced.
+ * \param old_count     The number of lines which are replaced.
+ * \param new_lines     The lines which replace them.
+ * \param new_count     The number of lines which replace them.
+ *
+ * \returns 0 on success and non-zero on failure, including if a line is 4 GiB
+ *          or longer.
+ */
+int command_create(
+    command_t** cmd, allocator_t* alloc, size_t line,
+    const command_line_t* old_lines, size_t old_count,
+    const command_line_t* new_lines, size_t new_count);
+
+/**
+ * \brief Get the lengths of a command's old lines, which are followed by the
+ * lengths of its new lines.
+ *
+ * \param cmd           The command.
+ */
+static inline const uint32_t* command_lengths(const command_t* cmd)
+{
+    return (const uint32_t*)(cmd + 1);
+}
+
+/**
+ * \brief Get the text of a command's old lines, which is followed by the text
+ * of its new lines.
+ *
+ * \param cmd           The command.
+ */
+static inline const char* command_text(const command_t* cmd)
+{
+    size_t offsets = (COMMAND_TYPE_DELTA == cmd->type) ? cmd->old_count : 0U;
+
+    return
+        (const char*)(
+            command_lengths(cmd) + cmd->old_count + cmd->new_count +
+            offsets);
+}
+
+/**
+ * \brief Get the offsets of the changes to the lines of a
+ * \ref COMMAND_TYPE_DELTA command.
+ *
+ * \param cmd           The command.
+ */
+static inline const uint32_t* command_offsets(const command_t* cmd)
+{
+    return command_lengths(cmd) + cmd->old_count + cmd->new_count;
+}
+
+/**
+ * \brief Get the text of a command's new lines.
+ *
+ * \param cmd           The command.
+ */
+static inline const char* command_new_text(const command_t* cmd)
+{
+    return command_text(cmd) + cmd->old_bytes;
+}
+
+/**
+ * \brief The command_merge method creates a command which has the effect of
+ * the first command followed by the second, if they are compatible.
+ *
+ * The second command is compatible if it replaces exactly the lines which the
+ * first one left, such as a line edited twice, if it changes some of them in
+ * place, or if it inserts lines just after them, such as lines appended one
+ * after another.  Two deltas to the same line are compatible if the changes
+ * touch or overlap, as keystrokes do.  The merged command replaces the first
+ * command's old lines, and has the first command's time.
+ *
+ * \param merged        Set to the merged command, which must be released to
+ *                      the allocator with \ref ALLOCATOR_TAG_COMMAND.
+ * \param alloc         The allocator for the merged command.
+ * \param first         The earlier command.
+ * \param second        The later command.
+ * \param max_bytes     The largest size of the merged command.
+ *
+ * \returns 0 if the commands were merged, or non-zero if they are not
+ *          compatible, the merged command would be larger than max_bytes, or
+ *          it could not be allocated.
+ */
+int command_merge(
+    command_t** merged, allocator_t* alloc, const command_t* first,
+    const command_t* second, size_t max_bytes);
+
+/**
+ * \brief The command_stack_push method pushes a copy of the command onto the
+ * stack.
+ *
+ * If the stack coalesces commands and is not sealed, a command made within
+ * the time window of the command on top, and compatible with it, is merged
+ * into it instead, as by command_merge(), so the count is unchanged.
+ *
+ * \param stack         The stack.
+ * \param cmd           The command to copy.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the stack is
+ *          unchanged.
+ */
+int command_stack_push(command_stack_t* stack, const command_t* cmd);
+
+/**
+ * \brief The command_stack_peek method returns the command on top of the
+ * stack, which remains valid until the stack is next changed or peeked at.
+ *
+ * \param stack         The stack.
+ *
+ * \returns the command, or NULL if the stack is empty or it can't be read.
+ */
+const command_t* command_stack_peek(command_stack_t* stack);
+
+/**
+ * \brief The command_stack_pop method removes the command on top of the
+ * stack, and seals the stack, so that a command pushed after an undo is never
+ * merged into an earlier one.
+ *
+ * \param stack         The stack.
+ *
+ * \returns 0 on success and non-zero if the stack is empty.
+ */
+int command_stack_pop(command_stack_t* stack);
+
+/**
+ * \brief The command_stack_mark method returns a mark for the current depth
+ * of the stack, which stays valid while the commands below it are on the
+ * stack.
+ *
+ * \param stack         The stack.
+ *
+ * \returns the mark.
+ */
+uint64_t command_stack_mark(command_stack_t* stack);
+
+/**
+ * \brief The command_stack_next method returns the command just above a mark,
+ * and moves the mark past it, so that the commands above a mark can be read
+ * oldest first.  The command remains valid until the stack is next changed or
+ * read.
+ *
+ * \param stack         The stack.
+ * \param mark          The mark, which is moved past the command.
+ *
+ * \returns the command, or NULL if the mark is the top of the stack or the
+ *          command can't be read.
+ */
+const command_t* command_stack_next(command_stack_t* stack, uint64_t* mark);
+
+/**
+ * \brief The command_stack_truncate method removes every command above a
+ * mark, and seals the stack.
+ *
+ * \param stack         The stack.
+ * \param mark          The mark.
+ * \param count         The number of commands below the mark.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_stack_truncate(
+    command_stack_t* stack, uint64_t mark, size_t count);
+
+/**
+ * \brief The command_stack_coalesce method sets the window within which a
+ * pushed command is merged into the command on top of the stack.
+ *
+ * Commands are merged while the later one is made no more than window_ms
+ * milliseconds after the first command of the run, and the merged command is
+ * no larger than max_bytes.  A max_bytes of 0, the default, turns coalescing
+ * off.
+ *
+ * \param stack         The stack.
+ * \param window_ms     The time window, in milliseconds.
+ * \param max_bytes     The size window, in bytes.
+ */
+void command_stack_coalesce(
+    command_stack_t* stack, uint64_t window_ms, size_t max_bytes);
+
+/**
+ * \brief The command_stack_seal method ends the run of commands being merged,
+ * so that the next command pushed is kept on its own.  An editor seals the
+ * stack when the cursor moves, or when it leaves insert mode.
+ *
+ * \param stack         The stack.
+ */
+void command_stack_seal(command_stack_t* stack);
+
+/**
+ * \brief The command_mem_stack_init method creates an empty command stack
+ * whose commands are copied into memory from the given allocator.
+ *
+ * \param stack         The stack to initialize.
+ * \param alloc         The allocator for the commands.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_mem_stack_init(command_mem_stack_t* stack, allocator_t* alloc);
+
+/**
+ * \brief The command_log_init method creates an empty command stack in the
+ * file at the given path, which is created or truncated.  The file is left
+ * in place when the log is dispose()d.
+ *
+ * \param log           The log to initialize.
+ * \param path          The path of the log file.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_log_init(command_log_t* log, const char* path);
+
+/**
+ * \brief The command_tiered_init method creates an empty command stack which
+ * keeps up to hot_limit bytes of its most recent commands in memory from the
+ * given allocator, and spills the rest to the file at the given path.  The
+ * file is created or truncated, and then unlinked at once, so that it never
+ * outlives the stack.
+ *
+ * \param tiered        The stack to initialize.
+ * \param alloc         The allocator for the commands kept in memory.
+ * \param path          The path of the spill file.
+ * \param hot_limit     The most bytes of commands to keep in memory, or 0 for
+ *                      \ref COMMAND_TIERED_HOT_SIZE.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_tiered_init(
+    command_tiered_t* tiered, allocator_t* alloc, const char* path,
+    size_t hot_limit);
+
+/**
+ * \brief The command_lz_compress method compresses bytes with a small LZ77
+ * coder, which finds repeats through a hash of the next four bytes.  It is
+ * made for the text of commands, and favors speed over ratio.
+ *
+ * The output is a series of sequences, each a token whose high and low
+ * nibbles are the number of literals and the length of the match less four,
+ * the literals, and the match's 16-bit little-endian offset.  A nibble of 15
+ * is extended by bytes which are added to it, up to and including the first
+ * which is not 255.  The last sequence holds only literals.
+ *
+ * \param dst           The compressed bytes are written here.
+ * \param src           The bytes to compress.
+ * \param size          The number of bytes to compress.
+ *
+ * \returns the number of bytes written, which is at most
+ *          COMMAND_LZ_BOUND(size).
+ */
+size_t command_lz_compress(void* dst, const void* src, size_t size);
+
+/**
+ * \brief The command_lz_decompress method decompresses the bytes written by
+ * command_lz_compress().
+ *
+ * \param dst           The decompressed bytes are written here.
+ * \param size          The number of bytes which were compressed.
+ * \param src           The compressed bytes.
+ * \param packed        The number of compressed bytes.
+ *
+ * \returns 0 on success, or non-zero if the compressed bytes are damaged or
+ *          do not decompress to exactly size bytes.
+ */
+int command_lz_decompress(
+    void* dst, size_t size, const void* src, size_t packed);
+
+/**
+ * \brief Model checking property for a command.
+ */
+#define PROP_VALID_COMMAND(cmd) \
+    (NULL != (cmd) && \
+     0U == (cmd)->size % 8U && \
+     (cmd)->size >= sizeof(command_t) + (cmd)->old_bytes)
+
+/**
+ * \brief Model checking property for a command stack.
+ */
+#define PROP_VALID_COMMAND_STACK(stack) \
+    (NULL != (stack) && \
+     NULL != (stack)->hdr.dispose && \
+     NULL != (stack)->push && \
+     NULL != (stack)->peek && \
+     NULL != (stack)->pop && \
+     NULL != (stack)->replace && \
+     NULL != (stack)->mark && \
+     NULL != (stack)->next && \
+     NULL != (stack)->truncate)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_COMMAND_HEADER_GUARD*/
@@ -0,0 +1,31 @@
+/**
+ * \brief Forward declarations for the command types.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_COMMANDFWD_HEADER_GUARD
+# define EJ_COMMANDFWD_HEADER_GUARD
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * A command stack holds the commands which can be undone.  Like every other
+ * ej structure, it begins with a disposable header.
+ */
+typedef struct command_stack command_stack_t;
+
+/**
+ * A command queue holds the commands which can be redone.  Like every other
+ * ej structure, it begins with a disposable header.
+ */
+typedef struct command_queue command_queue_t;
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_COMMANDFWD_HEADER_GUARD*/
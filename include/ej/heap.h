@@ -0,0 +1,69 @@
+/**
+ * \brief This header defines the heap type: a malloc() backed allocator which
+ * keeps statistics.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_HEAP_HEADER_GUARD
+# define EJ_HEAP_HEADER_GUARD
+
+#include <ej/allocator.h>
+#include <ej/disposable.h>
+#include <stddef.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * A heap block header precedes each allocation.  It records the size of the
+ * allocation and links every live block together, so that the heap can
+ * release them in bulk.  It is padded so that allocations are maximally
+ * aligned.
+ */
+typedef union heap_block
+{
+    struct
+    {
+        union heap_block* next;
+        union heap_block* prev;
+        size_t size;
+    } link;
+    max_align_t align;
+} heap_block_t;
+
+/**
+ * A heap is an \ref allocator_t which allocates each request individually via
+ * malloc(), like the system allocator, but which belongs to a single owner.
+ * This lets it keep exact statistics for the memory it hands out, and release
+ * every outstanding allocation when it is dispose()d.
+ */
+typedef struct heap
+{
+    allocator_t alloc;
+    heap_block_t* blocks;
+} heap_t;
+
+/**
+ * \brief The heap_init method creates a new empty heap.
+ *
+ * \param heap              The heap to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int heap_init(heap_t* heap);
+
+/**
+ * \brief Model checking property for a heap.
+ */
+#define PROP_VALID_HEAP(heap) \
+    (NULL != (heap) && \
+     PROP_VALID_ALLOCATOR(&(heap)->alloc))
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_HEAP_HEADER_GUARD*/
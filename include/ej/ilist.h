@@ -0,0 +1,211 @@
+/**
+ * \brief This header defines the intrusive list type: a doubly-linked list
+ * whose links are embedded in the data it holds.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_ILIST_HEADER_GUARD
+# define EJ_ILIST_HEADER_GUARD
+
+#include <ej/disposable.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * An intrusive list node is embedded in a disposable data structure.  Unlike
+ * \ref list_node_t, it is never allocated by the list; the list simply links
+ * the structures that contain these nodes together.
+ */
+typedef struct ilist_node
+{
+    struct ilist_node* next;
+    struct ilist_node* prev;
+} ilist_node_t;
+
+/**
+ * An intrusive linked list holds the head and tail for the list, as well as
+ * the offset of the \ref ilist_node_t within each disposable data structure.
+ */
+typedef struct ilist
+{
+    disposable_t hdr;
+    ilist_node_t* head;
+    ilist_node_t* tail;
+
+    size_t size;
+    size_t offset;
+} ilist_t;
+
+/**
+ * \brief Get the data structure containing the given intrusive list node.
+ *
+ * \param node          The intrusive list node.
+ * \param type          The type of the data structure.
+ * \param member        The name of the \ref ilist_node_t member.
+ */
+#define ILIST_ENTRY(node, type, member) \
+    ((type*)((char*)(node) - offsetof(type, member)))
+
+/**
+ * \brief The ilist_init method creates a new empty intrusive linked list.
+ *
+ * Each data structure placed in this list must be disposable, and it must
+ * embed an \ref ilist_node_t at the given offset, as returned by offsetof().
+ *
+ * \param list          The list to initialize.
+ * \param offset        The offset of the \ref ilist_node_t within each data
+ *                      structure.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ilist_init(ilist_t* list, size_t offset);
+
+/**
+ * \brief The ilist_push_front method pushes a node onto the front of the
+ * linked list.  The ownership of the data structure containing this node is
+ * transferred to the list and may be dispose()d and free()d if the list is
+ * dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param node          The embedded node to push onto the list.
+ */
+void ilist_push_front(ilist_t* list, ilist_node_t* node);
+
+/**
+ * \brief The ilist_push_back method pushes a node onto the back of the linked
+ * list.  The ownership of the data structure containing this node is
+ * transferred to the list and may be dispose()d and free()d if the list is
+ * dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param node          The embedded node to push onto the list.
+ */
+void ilist_push_back(ilist_t* list, ilist_node_t* node);
+
+/**
+ * \brief The ilist_pop_front method pops a node off of the front of the
+ * linked list.  The ownership of the data structure containing this node is
+ * transferred to the caller who is responsible for dispose()ing and free()ing
+ * it.
+ *
+ * If the list is empty, a non-zero value is returned.
+ *
+ * \param list          The list to modify.
+ * \param node          A pointer to the node pointer set to the popped node.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ilist_pop_front(ilist_t* list, ilist_node_t** node);
+
+/**
+ * \brief The ilist_pop_back method pops a node off of the back of the linked
+ * list.  The ownership of the data structure containing this node is
+ * transferred to the caller who is responsible for dispose()ing and free()ing
+ * it.
+ *
+ * If the list is empty, a non-zero value is returned.
+ *
+ * \param list          The list to modify.
+ * \param node          A pointer to the node pointer set to the popped node.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ilist_pop_back(ilist_t* list, ilist_node_t** node);
+
+/**
+ * \brief The ilist_insert method will insert the given node BEFORE the
+ * position node in the list.  This method assumes that the position node is
+ * part of the list; it is extremely important that the caller ensures that
+ * this is true.  The ownership of the data structure containing the new node
+ * is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param pos           The list node before which the node is inserted.
+ * \param node          The embedded node to insert.
+ */
+void ilist_insert(ilist_t* list, ilist_node_t* pos, ilist_node_t* node);
+
+/**
+ * \brief The ilist_append method will append the given node AFTER the
+ * position node in the list.  This method assumes that the position node is
+ * part of the list; it is extremely important that the caller ensures that
+ * this is true.  The ownership of the data structure containing the new node
+ * is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param pos           The list node after which the node is appended.
+ * \param node          The embedded node to append.
+ */
+void ilist_append(ilist_t* list, ilist_node_t* pos, ilist_node_t* node);
+
+/**
+ * \brief The ilist_remove method will remove the given node from the list.
+ * This method assumes that the provided node is part of the list; it is
+ * extremely important that the caller ensures that this is true.  The
+ * ownership of the data structure containing this node is transferred to the
+ * caller who is responsible for dispose()ing and free()ing it.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node to be removed.
+ */
+void ilist_remove(ilist_t* list, ilist_node_t* node);
+
+/**
+ * \brief The ilist_splice method will splice two lists into one.  After this
+ * method is called, the x list will contain all nodes, and the y list will be
+ * empty.  Both lists must have the same node offset.
+ *
+ * \param x             The x list to splice with the values from the y list.
+ * \param y             The y list to destructively splice.
+ */
+void ilist_splice(ilist_t* x, ilist_t* y);
+
+/**
+ * \brief The ilist_split method will split the list on the given node.  The
+ * original list x will contain all entries BEFORE the node, and the new y list
+ * will contain this node and all entries AFTER this node.  It is expected that
+ * the y list is empty, node belongs to the original x list, and both lists
+ * have the same node offset.
+ *
+ * \param x             The x list to split, which will contain all values
+ *                      BEFORE node after this operation is complete.
+ * \param node          The node on which the list is split.
+ * \param y             The y list to receive half of the list, starting with
+ *                      node, and all nodes AFTER node after this operation is
+ *                      complete.
+ */
+void ilist_split(ilist_t* x, ilist_node_t* node, ilist_t* y);
+
+/**
+ * \brief Model checking property for an empty intrusive list.
+ */
+#define PROP_VALID_ILIST_EMPTY(list) \
+    (NULL != (list) && \
+     (list)->size == 0U && \
+     NULL == (list)->head && \
+     NULL == (list)->tail)
+
+/**
+ * \brief Model checking property for a non-empty intrusive list.
+ */
+#define PROP_VALID_ILIST_NOT_EMPTY(list) \
+    (NULL != (list) && \
+     (list)->size > 0U && \
+     NULL != (list)->head && \
+     NULL != (list)->tail)
+
+/**
+ * \brief Model checking property for an intrusive list.
+ */
+#define PROP_VALID_ILIST(list) \
+    (PROP_VALID_ILIST_EMPTY(list) || PROP_VALID_ILIST_NOT_EMPTY(list))
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_ILIST_HEADER_GUARD*/
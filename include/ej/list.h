@@ -8,7 +8,9 @@
 #ifndef  EJ_LIST_HEADER_GUARD
 # define EJ_LIST_HEADER_GUARD
 
+#include <ej/allocator.h>
 #include <ej/disposable.h>
+#include <ej/pool.h>
 
 #ifdef   __cplusplus
 extern "C" {
@@ -27,7 +29,15 @@ typedef struct list_node
 } list_node_t;
 
 /**
- * A linked list holds the head and tail for the list.
+ * A linked list holds the head and tail for the list, as well as the
+ * allocators which own its nodes and its data values.  Nodes are allocated
+ * from and released to the node allocator.  When the list releases a data
+ * value it owns, that value is dispose()d and then released to the data
+ * allocator; wherever this interface says that data is free()d, it is
+ * released to this allocator.  Nodes are attributed to
+ * \ref ALLOCATOR_TAG_LIST_NODE and values to \ref ALLOCATOR_TAG_LIST_DATA in
+ * the allocators' statistics.  Both are the system allocator unless the list
+ * was created with a different one.
  */
 typedef struct list
 {
@@ -36,6 +46,8 @@ typedef struct list
     list_node_t* tail;
 
     size_t size;
+    allocator_t* node_alloc;
+    allocator_t* data_alloc;
 } list_t;
 
 /**
@@ -47,6 +59,40 @@ typedef struct list
  */
 int list_init(list_t* list);
 
+/**
+ * \brief The list_init_pool method creates a new empty linked list whose nodes
+ * are allocated from the given node pool.  Data values are released to the
+ * system allocator.
+ *
+ * The pool may be shared between several lists; nodes can only be moved
+ * between lists that share the same allocators.  The pool must have an object
+ * size of at least sizeof(list_node_t), and it must outlive this list.
+ *
+ * \param list          The list to initialize.
+ * \param pool          The pool from which nodes are allocated.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int list_init_pool(list_t* list, pool_t* pool);
+
+/**
+ * \brief The list_init_allocator method creates a new empty linked list whose
+ * nodes are allocated from, and whose data values are released to, the given
+ * allocator.
+ *
+ * Data values pushed onto this list must be allocated from this allocator.
+ * If the allocator releases everything in bulk when it is dispose()d, as an
+ * \ref arena_t does, then the list and all of its values can be discarded
+ * together by dispose()ing the allocator.  The allocator must outlive this
+ * list.
+ *
+ * \param list          The list to initialize.
+ * \param alloc         The allocator which owns the nodes and data.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int list_init_allocator(list_t* list, allocator_t* alloc);
+
 /**
  * \brief The list_push_front method pushes a data value onto the front of the
  * linked list.  The ownership of this data is transferred to the list and may
@@ -71,6 +117,26 @@ int list_push_front(list_t* list, disposable_t* data);
  */
 int list_push_back(list_t* list, disposable_t* data);
 
+/**
+ * \brief The list_push_back_many method pushes count data values onto the
+ * back of the linked list, in order.  The ownership of this data is
+ * transferred to the list and may be dispose()d and free()d if deleted or if
+ * the list is dispose()d.
+ *
+ * The new nodes are allocated and linked together before they are spliced
+ * onto the list, so either every value is pushed or, on failure, none are and
+ * the list is unchanged.  A node allocator which supports runs, such as a
+ * pool, carves every node from one contiguous block at once.  Otherwise the
+ * nodes are reserved up front, so an arena still places them side by side.
+ *
+ * \param list          The list to modify.
+ * \param data          The array of count data items to push onto the list.
+ * \param count         The number of data items.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int list_push_back_many(list_t* list, disposable_t** data, size_t count);
+
 /**
  * \brief The list_pop_front method pops a data value off of the front of the
  * linked list.  The ownership of this data is transferred to the caller who is
@@ -150,7 +216,7 @@ int list_remove(list_t* list, list_node_t* node, disposable_t** data);
 /**
  * \brief The list_splice method will splice two lists into one.  After this
  * method is called, the x list will contain all nodes, and the y list will be
- * empty.
+ * empty.  Both lists must share the same allocators.
  *
  * \param x             The x list to splice with the values from the y list.
  * \param y             The y list to destructively splice.
@@ -161,7 +227,13 @@ void list_splice(list_t* x, list_t* y);
  * \brief The list_split method will split the list on the given node.  The
  * original list x will contain all entries BEFORE the node, and the new y list
  * will contain this node and all entries AFTER this node.  It is expected that
- * the y list is empty, and node belongs to the original x list.
+ * the y list is empty, node belongs to the original x list, and both lists
+ * share the same allocators.
+ *
+ * The position of node is found by counting from node toward both ends of the
+ * list at once, so this method runs in time proportional to the distance from
+ * node to the nearer end of the list.  Callers that already know the position
+ * of node should use list_split_at() instead.
  *
  * \param x             The x list to split, which will contain all values
  *                      BEFORE node after this operation is complete.
@@ -172,6 +244,83 @@ void list_splice(list_t* x, list_t* y);
  */
 void list_split(list_t* x, list_node_t* node, list_t* y);
 
+/**
+ * \brief The list_split_at method will split the list on the given node, whose
+ * zero-based position in x is supplied by the caller.  The original list x
+ * will contain all entries BEFORE the node, and the new y list will contain
+ * this node and all entries AFTER this node.  It is expected that the y list
+ * is empty, node belongs to the original x list at the given index, and both
+ * lists share the same allocators.
+ *
+ * Because the caller supplies the index, the sizes of both lists are updated
+ * without walking either list, so this method runs in constant time.  The
+ * index is trusted rather than checked: if node is not at that position, the
+ * nodes are still divided correctly, but the sizes of x and y are wrong, and
+ * both lists are invalid from then on.  It is extremely important that the
+ * caller ensures that the index is correct.
+ *
+ * \param x             The x list to split, which will contain all values
+ *                      BEFORE node after this operation is complete.
+ * \param node          The node on which the list is split.
+ * \param index         The zero-based position of node in x, which must be
+ *                      less than the size of x.
+ * \param y             The y list to receive half of the list, starting with
+ *                      node, and all nodes AFTER node after this operation is
+ *                      complete.
+ */
+void list_split_at(list_t* x, list_node_t* node, size_t index, list_t* y);
+
+/**
+ * \brief The list_remove_range method will remove the contiguous run of nodes
+ * from first through last from the list, moving them into the empty removed
+ * list in constant time.  This method assumes that first and last are part of
+ * the list, that first does not come after last, and that count is the number
+ * of nodes in the run; it is extremely important that the caller ensures that
+ * this is true.  Both lists must share the same allocators.  The ownership of
+ * the run is transferred to the removed list.
+ *
+ * \param list          The list to modify.
+ * \param first         The first node of the run to be removed.
+ * \param last          The last node of the run to be removed.
+ * \param count         The number of nodes from first through last.
+ * \param removed       The empty list which receives the run.
+ */
+void list_remove_range(
+    list_t* list, list_node_t* first, list_node_t* last, size_t count,
+    list_t* removed);
+
+/**
+ * \brief The list_move_range method will move the contiguous run of nodes
+ * from first through last so that it follows the dest node, in constant time.
+ * If dest is NULL, then the run is moved to the front of the list.  This
+ * method assumes that first, last, and dest are part of the list, that first
+ * does not come after last, and that dest is not part of the run; it is
+ * extremely important that the caller ensures that this is true.
+ *
+ * \param list          The list to modify.
+ * \param first         The first node of the run to be moved.
+ * \param last          The last node of the run to be moved.
+ * \param dest          The node after which the run is placed, or NULL to
+ *                      place the run at the front of the list.
+ */
+void list_move_range(
+    list_t* list, list_node_t* first, list_node_t* last, list_node_t* dest);
+
+/**
+ * \brief The list_insert_list method will insert every node of the other list
+ * BEFORE the given node in the list, in constant time.  If node is NULL, then
+ * the nodes are appended to the end of the list.  This method assumes that the
+ * provided node is part of the list; it is extremely important that the
+ * caller ensures that this is true.  Both lists must share the same
+ * allocators.  After this method is called, the other list will be empty.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node before which the nodes are inserted, or
+ *                      NULL to append them.
+ * \param other         The list whose nodes are destructively inserted.
+ */
+void list_insert_list(list_t* list, list_node_t* node, list_t* other);
+
 /**
  * \brief Model checking property for an empty list.
  */
@@ -0,0 +1,423 @@
+/**
+ * \brief This header defines ej::list, a typed C++ wrapper over list_t.
+ *
+ * The wrapper owns its list_t and tears it down in its destructor.  Values are
+ * disposed through a Disposer functor chosen at compile time, so that element
+ * disposal and traversal can be inlined rather than dispatched through each
+ * value's hdr.dispose pointer.  Dispatching through hdr.dispose is available,
+ * but must be asked for with \ref hdr_disposer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_LIST_HPP_HEADER_GUARD
+# define EJ_LIST_HPP_HEADER_GUARD
+
+#ifndef  __cplusplus
+# error "ej/list.hpp requires a C++ compiler."
+#endif /*__cplusplus*/
+
+#include <cstddef>
+#include <ej/list.h>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace ej {
+
+/**
+ * \brief The default disposer calls ej_dispose(T*), which is found by argument
+ * dependent lookup, so it must be declared alongside T before the list is
+ * used.  The call is direct, so the compiler can inline it.
+ *
+ * Specialize this template, or pass a different functor to \ref list, to
+ * dispose of a type some other way.
+ */
+template <typename T>
+struct disposer
+{
+    void operator()(T* value) const noexcept
+    {
+        ej_dispose(value);
+    }
+};
+
+/**
+ * \brief A disposer which calls the value's dispose method through its
+ * disposable header, for types whose values are disposed in different ways.
+ * Each call is indirect, so it can't be inlined.
+ */
+template <typename T>
+struct hdr_disposer
+{
+    void operator()(T* value) const noexcept
+    {
+        dispose(&value->hdr);
+    }
+};
+
+/**
+ * \brief A typed, move-only owner of a list_t whose values are T instances.
+ *
+ * T must be a standard layout type whose first member is a disposable_t named
+ * hdr, so that a T* can be stored in the list as a disposable_t*.  Every value
+ * added to the list must be allocated from the list's data allocator, which
+ * is the system allocator unless one is given, as the list releases each
+ * value to it after the Disposer has been called on it.
+ */
+template <typename T, typename Disposer = disposer<T>>
+class list
+{
+    static_assert(
+        std::is_standard_layout<T>::value,
+        "list values must be standard layout types.");
+    static_assert(
+        offsetof(T, hdr) == 0, "list values must begin with a disposable_t.");
+
+public:
+    template <bool Const>
+    class basic_iterator
+    {
+        friend class list;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const T*, T*>::type pointer;
+        typedef typename std::conditional<Const, const T&, T&>::type
+            reference;
+
+        basic_iterator() noexcept
+            : node(nullptr), owner(nullptr)
+        {
+        }
+
+        /* an iterator converts to a const_iterator. */
+        template <bool OtherConst,
+                  typename = typename std::enable_if<
+                      Const && !OtherConst>::type>
+        basic_iterator(const basic_iterator<OtherConst>& that) noexcept
+            : node(that.node), owner(that.owner)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return *reinterpret_cast<pointer>(node->data);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return reinterpret_cast<pointer>(node->data);
+        }
+
+        basic_iterator& operator++() noexcept
+        {
+            node = node->next;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            basic_iterator tmp(*this);
+            node = node->next;
+            return tmp;
+        }
+
+        /* decrementing end() yields the last value. */
+        basic_iterator& operator--() noexcept
+        {
+            node = (nullptr == node) ? owner->tail : node->prev;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept
+        {
+            basic_iterator tmp(*this);
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const basic_iterator& that) const noexcept
+        {
+            return node == that.node;
+        }
+
+        bool operator!=(const basic_iterator& that) const noexcept
+        {
+            return node != that.node;
+        }
+
+        /**
+         * \brief Get the underlying list node, or nullptr for end().
+         */
+        list_node_t* native_node() const noexcept
+        {
+            return node;
+        }
+
+    private:
+        basic_iterator(list_node_t* n, const list_t* o) noexcept
+            : node(n), owner(o)
+        {
+        }
+
+        template <bool> friend class basic_iterator;
+
+        list_node_t* node;
+        const list_t* owner;
+    };
+
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+
+    /**
+     * \brief Create an empty list whose nodes and values belong to the system
+     * allocator.
+     */
+    list() noexcept
+    {
+        list_init(&impl);
+    }
+
+    /**
+     * \brief Create an empty list whose nodes are allocated from the given
+     * pool, which must outlive this list.
+     *
+     * \throws std::bad_alloc if the pool's objects are too small for nodes.
+     */
+    explicit list(pool_t* pool)
+    {
+        if (0 != list_init_pool(&impl, pool))
+            throw std::bad_alloc();
+    }
+
+    /**
+     * \brief Create an empty list whose nodes and values belong to the given
+     * allocator, which must outlive this list.
+     *
+     * \throws std::bad_alloc if the list could not be initialized.
+     */
+    explicit list(allocator_t* alloc)
+    {
+        if (0 != list_init_allocator(&impl, alloc))
+            throw std::bad_alloc();
+    }
+
+    list(const list&) = delete;
+    list& operator=(const list&) = delete;
+
+    /**
+     * \brief Take ownership of every value in that list, leaving it empty.
+     */
+    list(list&& that) noexcept
+        : impl(that.impl)
+    {
+        that.reset();
+    }
+
+    list& operator=(list&& that) noexcept
+    {
+        if (this != &that)
+        {
+            clear();
+            impl = that.impl;
+            that.reset();
+        }
+
+        return *this;
+    }
+
+    ~list()
+    {
+        clear();
+    }
+
+    iterator begin() noexcept { return iterator(impl.head, &impl); }
+    iterator end() noexcept { return iterator(nullptr, &impl); }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(impl.head, &impl);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(nullptr, &impl);
+    }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_type size() const noexcept { return impl.size; }
+    bool empty() const noexcept { return 0U == impl.size; }
+
+    T& front() noexcept { return *value(impl.head); }
+    T& back() noexcept { return *value(impl.tail); }
+    const T& front() const noexcept { return *value(impl.head); }
+    const T& back() const noexcept { return *value(impl.tail); }
+
+    /**
+     * \brief Push a value onto the front of the list, taking ownership of it.
+     *
+     * \throws std::bad_alloc if a node could not be allocated, in which case
+     *         the caller retains ownership of the value.
+     */
+    void push_front(T* value)
+    {
+        if (0 != list_push_front(&impl, header(value)))
+            throw std::bad_alloc();
+    }
+
+    /**
+     * \brief Push a value onto the back of the list, taking ownership of it.
+     *
+     * \throws std::bad_alloc if a node could not be allocated, in which case
+     *         the caller retains ownership of the value.
+     */
+    void push_back(T* value)
+    {
+        if (0 != list_push_back(&impl, header(value)))
+            throw std::bad_alloc();
+    }
+
+    /**
+     * \brief Insert a value before pos, taking ownership of it.  Inserting
+     * before end() appends the value.
+     *
+     * \returns an iterator to the new value.
+     *
+     * \throws std::bad_alloc if a node could not be allocated, in which case
+     *         the caller retains ownership of the value.
+     */
+    iterator insert(const_iterator pos, T* value)
+    {
+        int retval =
+            (nullptr == pos.node)
+                ? list_push_back(&impl, header(value))
+                : list_insert(&impl, pos.node, header(value));
+        if (0 != retval)
+            throw std::bad_alloc();
+
+        return iterator(
+            (nullptr == pos.node) ? impl.tail : pos.node->prev, &impl);
+    }
+
+    /**
+     * \brief Pop the front value, transferring its ownership to the caller.
+     *
+     * \returns the value, or nullptr if the list is empty.
+     */
+    T* pop_front() noexcept
+    {
+        disposable_t* data;
+        return (0 == list_pop_front(&impl, &data)) ? value(data) : nullptr;
+    }
+
+    /**
+     * \brief Pop the back value, transferring its ownership to the caller.
+     *
+     * \returns the value, or nullptr if the list is empty.
+     */
+    T* pop_back() noexcept
+    {
+        disposable_t* data;
+        return (0 == list_pop_back(&impl, &data)) ? value(data) : nullptr;
+    }
+
+    /**
+     * \brief Dispose of and free the value at pos, and remove it from the
+     * list.
+     *
+     * \returns an iterator to the value that followed it.
+     */
+    iterator erase(const_iterator pos) noexcept
+    {
+        list_node_t* next = pos.node->next;
+        disposable_t* data;
+
+        list_remove(&impl, pos.node, &data);
+        destroy(value(data));
+
+        return iterator(next, &impl);
+    }
+
+    /**
+     * \brief Move every value from that list onto the back of this one.  Both
+     * lists must share the same allocators.
+     */
+    void splice(list& that) noexcept
+    {
+        list_splice(&impl, &that.impl);
+    }
+
+    /**
+     * \brief Dispose of and free every value in the list.
+     *
+     * This walks the nodes directly, calling the Disposer on each value, rather
+     * than dispose()ing the underlying list_t.
+     */
+    void clear() noexcept
+    {
+        list_node_t* node = impl.head;
+        while (nullptr != node)
+        {
+            list_node_t* next = node->next;
+
+            destroy(value(node->data));
+            allocator_release_tagged(
+                impl.node_alloc, node, ALLOCATOR_TAG_LIST_NODE);
+
+            node = next;
+        }
+
+        impl.head = impl.tail = nullptr;
+        impl.size = 0U;
+    }
+
+    /**
+     * \brief Get the underlying list_t, for use with the C interface.  The
+     * list remains owned by this wrapper.
+     */
+    list_t* native() noexcept { return &impl; }
+    const list_t* native() const noexcept { return &impl; }
+
+private:
+    static T* value(disposable_t* data) noexcept
+    {
+        return reinterpret_cast<T*>(data);
+    }
+
+    static T* value(list_node_t* node) noexcept
+    {
+        return value(node->data);
+    }
+
+    static disposable_t* header(T* value) noexcept
+    {
+        return reinterpret_cast<disposable_t*>(value);
+    }
+
+    void destroy(T* value) noexcept
+    {
+        Disposer()(value);
+        allocator_release_tagged(
+            impl.data_alloc, value, ALLOCATOR_TAG_LIST_DATA);
+    }
+
+    /* empty this list without touching the values it held. */
+    void reset() noexcept
+    {
+        impl.head = impl.tail = nullptr;
+        impl.size = 0U;
+    }
+
+    list_t impl;
+};
+
+} /* namespace ej */
+
+#endif /*EJ_LIST_HPP_HEADER_GUARD*/
@@ -0,0 +1,208 @@
+/**
+ * \brief This header defines the order statistic tree type: a balanced binary
+ * tree of data values addressed by their position.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_OSTREE_HEADER_GUARD
+# define EJ_OSTREE_HEADER_GUARD
+
+#include <ej/disposable.h>
+#include <stdint.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * An order statistic tree node contains pointers to its left and right
+ * subtrees, the number of values in the subtree rooted at this node, a random
+ * heap priority used to keep the tree balanced, and a pointer to the data for
+ * this node, which is a disposable instance.
+ *
+ * The tree is ordered by position rather than by key: every value in the left
+ * subtree comes before this node's value, and every value in the right subtree
+ * comes after it.
+ */
+typedef struct ostree_node
+{
+    struct ostree_node* left;
+    struct ostree_node* right;
+    size_t size;
+    uint32_t priority;
+    disposable_t* data;
+} ostree_node_t;
+
+/**
+ * An order statistic tree holds the root of the tree and the state of the
+ * generator used to assign node priorities.
+ */
+typedef struct ostree
+{
+    disposable_t hdr;
+    ostree_node_t* root;
+    uint32_t seed;
+} ostree_t;
+
+/**
+ * \brief The ostree_visitor_t callback is called for each value visited by
+ * ostree_visit().
+ *
+ * \param context       The user context passed to ostree_visit().
+ * \param index         The position of this value in the tree.
+ * \param data          The value at this position.
+ *
+ * \returns 0 to continue visiting, or non-zero to stop.
+ */
+typedef int (*ostree_visitor_t)(
+    void* context, size_t index, disposable_t* data);
+
+/**
+ * \brief The ostree_init method creates a new empty order statistic tree.
+ *
+ * \param tree          The tree to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ostree_init(ostree_t* tree);
+
+/**
+ * \brief The ostree_size method returns the number of values in the tree.
+ *
+ * \param tree          The tree to query.
+ *
+ * \returns the number of values in the tree.
+ */
+size_t ostree_size(const ostree_t* tree);
+
+/**
+ * \brief The ostree_at method finds the value at the given zero-based
+ * position in O(log n) time.  The ownership of this data remains with the
+ * tree.
+ *
+ * \param tree          The tree to search.
+ * \param index         The position of the value to find.
+ * \param data          A pointer to the data pointer set to the value.
+ *
+ * \returns 0 on success and non-zero if the index is out of bounds.
+ */
+int ostree_at(const ostree_t* tree, size_t index, disposable_t** data);
+
+/**
+ * \brief The ostree_insert method inserts the given data value so that it
+ * has the given zero-based position, shifting the value at that position and
+ * all values after it back by one, in O(log n) time.  An index equal to the
+ * size of the tree appends the value.  The ownership of this data is
+ * transferred to the tree and may be dispose()d and free()d if deleted or if
+ * the tree is dispose()d.
+ *
+ * \param tree          The tree to modify.
+ * \param index         The position at which to insert the value.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ostree_insert(ostree_t* tree, size_t index, disposable_t* data);
+
+/**
+ * \brief The ostree_push_back method appends the given data value to the end
+ * of the tree.  The ownership of this data is transferred to the tree.
+ *
+ * \param tree          The tree to modify.
+ * \param data          The data to append.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ostree_push_back(ostree_t* tree, disposable_t* data);
+
+/**
+ * \brief The ostree_remove method removes the value at the given zero-based
+ * position in O(log n) time, returning the data value to be dispose()d and
+ * free()d by the caller.
+ *
+ * \param tree          The tree to modify.
+ * \param index         The position of the value to remove.
+ * \param data          Pointer to the data pointer returned to the caller.
+ *
+ * \returns 0 on success and non-zero if the index is out of bounds.
+ */
+int ostree_remove(ostree_t* tree, size_t index, disposable_t** data);
+
+/**
+ * \brief The ostree_remove_range method moves the count values starting at
+ * the given zero-based position from the tree into the empty y tree in
+ * O(log n) time.  The ownership of these values is transferred to y.
+ *
+ * \param tree          The tree to modify.
+ * \param index         The position of the first value to remove.
+ * \param count         The number of values to remove.
+ * \param y             The empty tree which receives the removed values.
+ *
+ * \returns 0 on success and non-zero if the range is out of bounds.
+ */
+int ostree_remove_range(
+    ostree_t* tree, size_t index, size_t count, ostree_t* y);
+
+/**
+ * \brief The ostree_splice method will splice two trees into one in
+ * O(log n) time.  After this method is called, the x tree will contain all
+ * values, with the values of y following the values of x, and the y tree will
+ * be empty.
+ *
+ * \param x             The x tree to splice with the values from the y tree.
+ * \param y             The y tree to destructively splice.
+ */
+void ostree_splice(ostree_t* x, ostree_t* y);
+
+/**
+ * \brief The ostree_split method will split the tree at the given zero-based
+ * position in O(log n) time.  The original tree x will contain all values
+ * BEFORE the position, and the new y tree will contain the value at this
+ * position and all values AFTER it.  It is expected that the y tree is empty.
+ * An index greater than or equal to the size of x leaves y empty.
+ *
+ * \param x             The x tree to split.
+ * \param index         The position at which the tree is split.
+ * \param y             The y tree to receive the values from index onward.
+ */
+void ostree_split(ostree_t* x, size_t index, ostree_t* y);
+
+/**
+ * \brief The ostree_visit method calls the visitor for up to count values in
+ * order, starting at the given zero-based position.  Reaching the starting
+ * position costs O(log n), and each additional value costs amortized O(1).
+ *
+ * \param tree          The tree to visit.
+ * \param index         The position of the first value to visit.
+ * \param count         The maximum number of values to visit.
+ * \param visitor       The visitor to call for each value.
+ * \param context       The user context to pass to the visitor.
+ *
+ * \returns 0 if every value was visited, or the non-zero value returned by
+ *          the visitor that stopped the visit.
+ */
+int ostree_visit(
+    const ostree_t* tree, size_t index, size_t count, ostree_visitor_t visitor,
+    void* context);
+
+/**
+ * \brief Model checking property for an order statistic tree.
+ */
+#define PROP_VALID_OSTREE(tree) \
+    (NULL != (tree) && \
+     (NULL == (tree)->root || (tree)->root->size > 0U))
+
+/**
+ * \brief Model checking property for an empty order statistic tree.
+ */
+#define PROP_VALID_OSTREE_EMPTY(tree) \
+    (NULL != (tree) && \
+     NULL == (tree)->root)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_OSTREE_HEADER_GUARD*/
@@ -0,0 +1,154 @@
+/**
+ * \brief This header defines the pool type: a fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_POOL_HEADER_GUARD
+# define EJ_POOL_HEADER_GUARD
+
+#include <ej/allocator.h>
+#include <ej/disposable.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * A pool slab is a contiguous block of memory holding objects_per_slab
+ * objects.  Slabs are chained together so that they can be released in bulk
+ * when the pool is dispose()d.  The objects follow this header.
+ */
+typedef struct pool_slab
+{
+    struct pool_slab* next;
+} pool_slab_t;
+
+/**
+ * A released pool object is threaded onto the pool's free list using its own
+ * storage.
+ */
+typedef struct pool_free_object
+{
+    struct pool_free_object* next;
+} pool_free_object_t;
+
+/**
+ * A pool hands out fixed-size objects from contiguous slabs.  Released objects
+ * are recycled through a free list, and all slabs are released together when
+ * the pool is dispose()d.
+ *
+ * A slab allocated by pool_reserve() or pool_allocate_run() which is not yet
+ * in use is kept as the spare, and is carved from once the current slab is
+ * exhausted.
+ *
+ * A pool is also an \ref allocator_t, which satisfies any request of up to
+ * object_size bytes.
+ */
+typedef struct pool
+{
+    allocator_t alloc;
+    size_t object_size;
+    size_t objects_per_slab;
+    pool_slab_t* slabs;
+    pool_free_object_t* free_list;
+    size_t free_count;
+    unsigned char* bump;
+    unsigned char* bump_end;
+    unsigned char* spare;
+    unsigned char* spare_end;
+
+    size_t slab_count;
+    size_t live_count;
+} pool_t;
+
+/**
+ * \brief The pool_init method creates a new empty object pool.
+ *
+ * The object size is rounded up so that every object handed out by this pool
+ * is pointer aligned.  No slab is allocated until the first object is
+ * requested.
+ *
+ * \param pool              The pool to initialize.
+ * \param object_size       The size of each object in this pool.
+ * \param objects_per_slab  The number of objects to carve from each slab.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int pool_init(pool_t* pool, size_t object_size, size_t objects_per_slab);
+
+/**
+ * \brief The pool_allocate method returns an object from the pool.
+ *
+ * Recycled objects are preferred.  Otherwise, the object is carved from the
+ * current slab, then from the spare slab, and a new slab is allocated if both
+ * are exhausted.  The object is owned by the pool and must be returned via
+ * pool_release() or reclaimed when the pool is dispose()d.
+ *
+ * \param pool              The pool from which the object is allocated.
+ *
+ * \returns the object, or NULL if a new slab could not be allocated.
+ */
+void* pool_allocate(pool_t* pool);
+
+/**
+ * \brief The pool_reserve method ensures that the next count calls to
+ * pool_allocate() will succeed without allocating another slab.
+ *
+ * Recycled objects and the unused objects of the current and spare slabs all
+ * count towards the reservation.  If they fall short, a single new slab large
+ * enough for the rest becomes the spare, and the unused objects of the old
+ * spare are moved to the free list.  The current slab is left as it is.
+ *
+ * \param pool              The pool in which room is reserved.
+ * \param count             The number of objects to reserve.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int pool_reserve(pool_t* pool, size_t count);
+
+/**
+ * \brief The pool_allocate_run method returns count objects which lie one after
+ * another in the same slab, each object_size bytes after the last.
+ *
+ * The run is carved from the current slab if it fits, then from the spare
+ * slab.  Otherwise a new slab of at least count objects is allocated, and its
+ * unused objects become the spare.  Each object is owned by the pool and is
+ * returned via pool_release() on its own.
+ *
+ * \param pool              The pool from which the objects are allocated.
+ * \param count             The number of objects, which must not be 0.
+ *
+ * \returns the first object, or NULL if a new slab could not be allocated.
+ */
+void* pool_allocate_run(pool_t* pool, size_t count);
+
+/**
+ * \brief The pool_release method returns an object to the pool's free list.
+ *
+ * This method assumes that the object was allocated from this pool; it is
+ * extremely important that the caller ensures that this is true.
+ *
+ * \param pool              The pool to which the object is returned.
+ * \param object            The object to return.
+ */
+void pool_release(pool_t* pool, void* object);
+
+/**
+ * \brief Model checking property for a pool.
+ */
+#define PROP_VALID_POOL(pool) \
+    (NULL != (pool) && \
+     PROP_VALID_ALLOCATOR(&(pool)->alloc) && \
+     (pool)->object_size >= sizeof(pool_free_object_t) && \
+     (pool)->objects_per_slab > 0U && \
+     (pool)->bump <= (pool)->bump_end && \
+     (pool)->spare <= (pool)->spare_end && \
+     (NULL == (pool)->free_list) == (0U == (pool)->free_count))
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_POOL_HEADER_GUARD*/
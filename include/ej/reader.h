@@ -0,0 +1,249 @@
+/**
+ * \brief This header defines the reader type, which splits the contents of a
+ * file into lines.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_READER_HEADER_GUARD
+# define EJ_READER_HEADER_GUARD
+
+#include <ej/disposable.h>
+#include <ej/list.h>
+#include <ej/simd.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The maximum number of lines returned in a single batch.
+ */
+#define READER_BATCH_LINES 512U
+
+/**
+ * A reader line refers to a line within the reader's contents.  The length
+ * excludes the line's newline, and its carriage return if the line ends with
+ * a CRLF sequence.
+ */
+typedef struct reader_line
+{
+    const char* data;
+    size_t length;
+} reader_line_t;
+
+/**
+ * A reader batch holds up to \ref READER_BATCH_LINES consecutive lines.
+ */
+typedef struct reader_batch
+{
+    size_t count;
+    reader_line_t lines[READER_BATCH_LINES];
+} reader_batch_t;
+
+/**
+ * A reader holds the contents of a file and the position of the next line to
+ * be read.  It counts the lines read so far, as well as how many of them end
+ * with CRLF, so that the file's line ending convention can be detected in the
+ * same pass that finds the lines.
+ *
+ * The contents are checked with utf8_validate() when the reader is created,
+ * unless it is created by reader_init_mmap_unchecked(), in which case
+ * validated is false.  If they are not valid UTF-8, valid_utf8 is false and
+ * invalid_offset is the offset of the first invalid sequence.  Such contents
+ * can't be read into strings, but their lines can still be read in batches by
+ * a binary-safe caller.
+ */
+typedef struct reader
+{
+    disposable_t hdr;
+    const char* data;
+    size_t size;
+    size_t offset;
+    simd_level_t level;
+    bool owned;
+    bool mapped;
+    bool validated;
+    bool valid_utf8;
+    size_t invalid_offset;
+
+    size_t line_count;
+    size_t crlf_count;
+} reader_t;
+
+/**
+ * \brief The newline_scan method finds the offsets of up to max_ends newline
+ * characters in data, starting at offset start, using the best supported SIMD
+ * level.
+ *
+ * To find more newlines after a full scan, scan again starting one byte after
+ * the last newline found.
+ *
+ * \param data          The bytes to scan.
+ * \param size          The number of bytes.
+ * \param start         The offset at which to start scanning.
+ * \param ends          The array which receives the newline offsets.
+ * \param max_ends      The capacity of the ends array.
+ * \param crlf_count    Incremented for each newline found which is preceded
+ *                      by a carriage return.
+ *
+ * \returns the number of newlines found.
+ */
+size_t newline_scan(
+    const char* data, size_t size, size_t start, size_t* ends,
+    size_t max_ends, size_t* crlf_count);
+
+/**
+ * \brief The newline_scan_level method is newline_scan(), using the best
+ * implementation at or below the given SIMD level which is also supported by
+ * the running processor.
+ *
+ * \param level         The maximum SIMD level to use.
+ * \param data          The bytes to scan.
+ * \param size          The number of bytes.
+ * \param start         The offset at which to start scanning.
+ * \param ends          The array which receives the newline offsets.
+ * \param max_ends      The capacity of the ends array.
+ * \param crlf_count    Incremented for each newline found which is preceded
+ *                      by a carriage return.
+ *
+ * \returns the number of newlines found.
+ */
+size_t newline_scan_level(
+    simd_level_t level, const char* data, size_t size, size_t start,
+    size_t* ends, size_t max_ends, size_t* crlf_count);
+
+/**
+ * \brief The reader_init method reads the whole file at the given path into
+ * a new reader.
+ *
+ * \param reader        The reader to initialize.
+ * \param path          The path of the file to read.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init(reader_t* reader, const char* path);
+
+/**
+ * \brief The reader_init_mmap method maps the whole file at the given path
+ * into a new reader, rather than reading it.
+ *
+ * Pages of the file are only read as they are touched, and they are clean, so
+ * the kernel can drop them again under memory pressure.  Changes to the file
+ * while it is mapped are visible through the reader, so the file should not
+ * be changed while it is in use.
+ *
+ * \param reader        The reader to initialize.
+ * \param path          The path of the file to map.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_mmap(reader_t* reader, const char* path);
+
+/**
+ * \brief The reader_init_mmap_unchecked method maps the whole file at the
+ * given path into a new reader, without validating it.
+ *
+ * Nothing in the file is read until it is used, so this costs the same for
+ * any size of file.  The reader's validated and valid_utf8 are false and its
+ * invalid_offset is 0, so it is never mistaken for a validated reader; callers
+ * validate the parts that they use, for instance with reader_init_memory() or
+ * reader_init_range().
+ *
+ * \param reader        The reader to initialize.
+ * \param path          The path of the file to map.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_mmap_unchecked(reader_t* reader, const char* path);
+
+/**
+ * \brief The reader_init_memory method initializes a reader over the given
+ * bytes, which are not copied and must outlive the reader.
+ *
+ * \param reader        The reader to initialize.
+ * \param data          The bytes to read.
+ * \param size          The number of bytes.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_memory(reader_t* reader, const char* data, size_t size);
+
+/**
+ * \brief The reader_init_range method initializes a reader over size bytes of
+ * the parent reader's contents, starting at offset.  The range must begin at
+ * the start of a line and end at the end of a line.  The contents are not
+ * copied, and are only validated again if the parent's first invalid sequence
+ * comes before the range, or if the parent was not validated, so that the
+ * ranges of an unchecked reader can be validated by several threads at once.
+ * The parent must outlive this reader.
+ *
+ * \param reader        The reader to initialize.
+ * \param parent        The reader whose contents are shared.
+ * \param offset        The offset of the range in the parent's contents.
+ * \param size          The number of bytes in the range.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_range(
+    reader_t* reader, const reader_t* parent, size_t offset, size_t size);
+
+/**
+ * \brief The reader_next_batch method reads the next batch of lines.
+ *
+ * Every newline ends a line.  A final line which does not end with a newline
+ * is returned if it is not empty.  The lines refer to the reader's contents,
+ * and remain valid until the reader is dispose()d.
+ *
+ * \param reader        The reader.
+ * \param batch         The batch to fill, which is empty once every line has
+ *                      been read.
+ */
+void reader_next_batch(reader_t* reader, reader_batch_t* batch);
+
+/**
+ * \brief The reader_read_lines method reads every remaining line into a
+ * \ref string_t, and pushes the strings onto the back of the given list a
+ * batch at a time.  The strings are allocated from the list's data allocator.
+ *
+ * \param reader        The reader.
+ * \param list          The list which receives the lines.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the list holds
+ *          the lines read before the failing batch.  This fails without
+ *          reading any lines if the contents are not valid UTF-8.
+ */
+int reader_read_lines(reader_t* reader, list_t* list);
+
+/**
+ * \brief The reader_read_views method is reader_read_lines(), except that each
+ * \ref string_t is a view of the line in the reader's contents rather than a
+ * copy.  The reader must outlive the list, or every string must be changed
+ * first, since changing a view copies it.
+ *
+ * \param reader        The reader.
+ * \param list          The list which receives the lines.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the list holds
+ *          the lines read before the failing batch.  This fails without
+ *          reading any lines if the contents are not valid UTF-8.
+ */
+int reader_read_views(reader_t* reader, list_t* list);
+
+/**
+ * \brief Model checking property for a reader.
+ */
+#define PROP_VALID_READER(reader) \
+    (NULL != (reader) && \
+     (NULL != (reader)->data || 0U == (reader)->size) && \
+     (reader)->offset <= (reader)->size && \
+     (reader)->crlf_count <= (reader)->line_count)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_READER_HEADER_GUARD*/
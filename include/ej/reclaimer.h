@@ -0,0 +1,133 @@
+/**
+ * \brief This header defines the reclaimer type: a background thread that
+ * dispose()s and free()s data structures on behalf of its callers.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_RECLAIMER_HEADER_GUARD
+# define EJ_RECLAIMER_HEADER_GUARD
+
+#include <ej/buffer.h>
+#include <ej/disposable.h>
+#include <ej/list.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * A reclaimer owns a queue of heap-allocated disposable data structures and a
+ * worker thread which dispose()s and free()s each of them in turn.  Tearing
+ * down a large structure this way costs its owner O(1), while the actual work
+ * happens off of the caller's thread.
+ *
+ * The pending count includes every structure which has been queued but not
+ * yet freed, including the one the worker is currently reclaiming.
+ */
+typedef struct reclaimer
+{
+    disposable_t hdr;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t idle;
+    pthread_t thread;
+    list_t queue;
+
+    size_t pending;
+    bool stopping;
+} reclaimer_t;
+
+/**
+ * \brief The reclaimer_init method creates a new reclaimer and starts its
+ * worker thread.
+ *
+ * When the reclaimer is dispose()d, every structure still queued is reclaimed
+ * before the worker thread is joined.
+ *
+ * \param reclaimer     The reclaimer to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_init(reclaimer_t* reclaimer);
+
+/**
+ * \brief The reclaimer_defer method queues the given data structure to be
+ * dispose()d and free()d on the worker thread.  On success, the ownership of
+ * this data is transferred to the reclaimer.  On failure, the caller retains
+ * ownership of it.
+ *
+ * The data structure must have been allocated via malloc(), and its dispose
+ * method must be safe to call from another thread.
+ *
+ * \param reclaimer     The reclaimer to which the data is handed.
+ * \param data          The data structure to reclaim.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_defer(reclaimer_t* reclaimer, disposable_t* data);
+
+/**
+ * \brief The reclaimer_defer_list method detaches every node of the given list
+ * in O(1) and queues them to be dispose()d and free()d on the worker thread.
+ * After this method succeeds, the list is empty and may be reused or
+ * dispose()d as usual.  On failure, the list is unchanged.
+ *
+ * Lists which use any allocator other than the system allocator are rejected,
+ * as other allocators may not be touched from more than one thread.  A buffer
+ * whose lines come from an arena or a heap is handed over whole, together with
+ * its allocator, by reclaimer_defer_buffer() instead.
+ *
+ * \param reclaimer     The reclaimer to which the nodes are handed.
+ * \param list          The list to empty.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_defer_list(reclaimer_t* reclaimer, list_t* list);
+
+/**
+ * \brief The reclaimer_defer_buffer method moves the given buffer, and the
+ * allocator which owns its memory, to the worker thread in O(1), where the
+ * buffer is dispose()d and the allocator is dispose()d and free()d.  After
+ * this method succeeds, the buffer has been handed over and must not be used
+ * or dispose()d.  On failure, the caller retains ownership of both.
+ *
+ * The buffer's allocator must be one that no other thread uses while it is
+ * reclaimed: the arena of a buffer in arena mode, the given owner, or the
+ * system allocator.  Buffers using any other allocator are rejected.
+ *
+ * \param reclaimer     The reclaimer to which the buffer is handed.
+ * \param buffer        The buffer to reclaim.
+ * \param owner         The allocator from which the buffer allocates, which
+ *                      must have been allocated via malloc(), or NULL if the
+ *                      buffer owns its arena or uses the system allocator.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_defer_buffer(
+    reclaimer_t* reclaimer, buffer_t* buffer, allocator_t* owner);
+
+/**
+ * \brief The reclaimer_flush method blocks until every structure queued so far
+ * has been reclaimed.
+ *
+ * \param reclaimer     The reclaimer to flush.
+ */
+void reclaimer_flush(reclaimer_t* reclaimer);
+
+/**
+ * \brief Model checking property for a reclaimer.
+ */
+#define PROP_VALID_RECLAIMER(reclaimer) \
+    (NULL != (reclaimer) && \
+     PROP_VALID_LIST(&(reclaimer)->queue) && \
+     (reclaimer)->pending >= (reclaimer)->queue.size)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_RECLAIMER_HEADER_GUARD*/
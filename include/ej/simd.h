@@ -0,0 +1,60 @@
+/**
+ * \brief This header defines runtime detection of the SIMD instruction sets
+ * used by the scanning routines.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_SIMD_HEADER_GUARD
+# define EJ_SIMD_HEADER_GUARD
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief SIMD_X86 is defined when vectorized x86 routines can be compiled.
+ * They are built with per-function target attributes, so the library itself
+ * does not require any particular instruction set; the routine to use is
+ * chosen at runtime.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__)) && !defined(CBMC)
+# define SIMD_X86
+#endif
+
+/**
+ * The SIMD levels, in increasing order of capability.  A routine asked to use
+ * a level falls back to the best implementation at or below that level.
+ */
+typedef enum simd_level
+{
+    /** \brief Portable byte at a time code. */
+    SIMD_LEVEL_SCALAR = 0,
+
+    /** \brief 16 byte SSE2 vectors. */
+    SIMD_LEVEL_SSE2,
+
+    /** \brief 16 byte vectors with the SSSE3 and SSE4.1 byte shuffles. */
+    SIMD_LEVEL_SSE4,
+
+    /** \brief 32 byte AVX2 vectors. */
+    SIMD_LEVEL_AVX2,
+
+    SIMD_LEVEL_COUNT
+} simd_level_t;
+
+/**
+ * \brief The simd_level method returns the best SIMD level supported by both
+ * this build and the running processor.
+ *
+ * \returns the best supported SIMD level.
+ */
+simd_level_t simd_level(void);
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_SIMD_HEADER_GUARD*/
@@ -0,0 +1,263 @@
+/**
+ * \brief This header defines the string type: a UTF-8 line of text with
+ * inline storage for short lines.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_STRING_HEADER_GUARD
+# define EJ_STRING_HEADER_GUARD
+
+#include <ej/allocator.h>
+#include <ej/disposable.h>
+#include <ej/simd.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The number of bytes that a string can hold without allocating
+ * storage of its own.
+ */
+#define STRING_INLINE_CAPACITY 39U
+
+/**
+ * A string holds a NUL terminated sequence of UTF-8 encoded bytes, along with
+ * its length in bytes and in codepoints.
+ *
+ * Strings of up to \ref STRING_INLINE_CAPACITY bytes are stored in the string
+ * itself.  Longer strings are stored out of line in memory from the string's
+ * allocator.  The capacity is the number of bytes that the current storage
+ * can hold, not counting the NUL terminator; a string is inline exactly when
+ * its capacity is \ref STRING_INLINE_CAPACITY.  Once a string has moved out of
+ * line, it stays there until it is dispose()d.
+ *
+ * A string may instead be a view of bytes that it does not own, such as a
+ * line of a memory mapped file.  A view has a capacity of zero and is not NUL
+ * terminated.  The first change to a view copies its bytes into storage of
+ * its own, so views are copied on write.
+ *
+ * The bytes of a string are always valid UTF-8; the methods which add bytes to
+ * a string validate them first.
+ *
+ * A string is disposable, so it can be stored directly in a \ref list_t.
+ */
+typedef struct string
+{
+    disposable_t hdr;
+    allocator_t* alloc;
+    size_t length;
+    size_t codepoints;
+    size_t capacity;
+    union
+    {
+        const char* view;
+        char* ptr;
+        char buf[STRING_INLINE_CAPACITY + 1];
+    } data;
+} string_t;
+
+/**
+ * \brief The string_init method initializes a string with a copy of the given
+ * bytes.
+ *
+ * \param str           The string to initialize.
+ * \param alloc         The allocator for out of line storage.
+ * \param data          The UTF-8 bytes to copy, which need not be NUL
+ *                      terminated.
+ * \param length        The number of bytes to copy.
+ *
+ * \returns 0 on success and non-zero on failure, including if the bytes are
+ *          not valid UTF-8.
+ */
+int string_init(
+    string_t* str, allocator_t* alloc, const char* data, size_t length);
+
+/**
+ * \brief The string_init_view method initializes a string as a view of the
+ * given bytes, which the caller has already checked with utf8_validate().  The
+ * bytes are not copied, and must outlive the view or the first change to it.
+ *
+ * \param str           The string to initialize.
+ * \param alloc         The allocator for storage, if the view is changed.
+ * \param data          The valid UTF-8 bytes to view.
+ * \param length        The number of bytes.
+ */
+void string_init_view(
+    string_t* str, allocator_t* alloc, const char* data, size_t length);
+
+/**
+ * \brief The string_create method allocates a string from the given allocator
+ * and initializes it with a copy of the given bytes.
+ *
+ * The string is allocated with \ref ALLOCATOR_TAG_LIST_DATA, so that it can be
+ * pushed onto a list whose data allocator is the same allocator; the list
+ * dispose()s and releases it.  Otherwise, the caller must dispose() the string
+ * and then release it with that tag.
+ *
+ * \param str           Pointer to the string pointer set on success.
+ * \param alloc         The allocator for the string and its storage.
+ * \param data          The UTF-8 bytes to copy.
+ * \param length        The number of bytes to copy.
+ *
+ * \returns 0 on success and non-zero on failure, including if the bytes are
+ *          not valid UTF-8.
+ */
+int string_create(
+    string_t** str, allocator_t* alloc, const char* data, size_t length);
+
+/**
+ * \brief The string_create_unchecked method is string_create(), for bytes
+ * which the caller has already checked with utf8_validate().
+ *
+ * \param str           Pointer to the string pointer set on success.
+ * \param alloc         The allocator for the string and its storage.
+ * \param data          The valid UTF-8 bytes to copy.
+ * \param length        The number of bytes to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int string_create_unchecked(
+    string_t** str, allocator_t* alloc, const char* data, size_t length);
+
+/**
+ * \brief The string_reserve method ensures that the string can hold at least
+ * capacity bytes without allocating.  A view is always copied into storage of
+ * its own.
+ *
+ * \param str           The string to modify.
+ * \param capacity      The number of bytes to reserve.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the string is
+ *          unchanged.
+ */
+int string_reserve(string_t* str, size_t capacity);
+
+/**
+ * \brief The string_append method appends a copy of the given bytes to the
+ * end of the string.
+ *
+ * \param str           The string to modify.
+ * \param data          The UTF-8 bytes to append.
+ * \param length        The number of bytes to append.
+ *
+ * \returns 0 on success and non-zero on failure, including if the bytes are
+ *          not valid UTF-8, in which case the string is unchanged.
+ */
+int string_append(string_t* str, const char* data, size_t length);
+
+/**
+ * \brief The string_insert method inserts a copy of the given bytes at the
+ * given byte offset, which must be on a codepoint boundary.
+ *
+ * \param str           The string to modify.
+ * \param offset        The byte offset at which the bytes are inserted.
+ * \param data          The UTF-8 bytes to insert.
+ * \param length        The number of bytes to insert.
+ *
+ * \returns 0 on success and non-zero on failure, including if the bytes are
+ *          not valid UTF-8, in which case the string is unchanged.
+ */
+int string_insert(
+    string_t* str, size_t offset, const char* data, size_t length);
+
+/**
+ * \brief The string_erase method removes count bytes starting at the given
+ * byte offset.  Both ends of the range must be on codepoint boundaries.
+ *
+ * \param str           The string to modify.
+ * \param offset        The byte offset of the first byte to remove.
+ * \param count         The number of bytes to remove.
+ *
+ * \returns 0 on success and non-zero if the range is out of bounds, or if a
+ *          view could not be copied.
+ */
+int string_erase(string_t* str, size_t offset, size_t count);
+
+/**
+ * \brief The utf8_validate method checks that the given bytes are valid
+ * UTF-8, using the best supported SIMD level.
+ *
+ * Overlong encodings, surrogates, codepoints above U+10FFFF, stray
+ * continuation bytes, and truncated sequences are all invalid.
+ *
+ * \param data              The bytes to validate.
+ * \param size              The number of bytes.
+ * \param invalid_offset    Set to the offset of the first invalid sequence
+ *                          if the bytes are not valid UTF-8.
+ *
+ * \returns 0 if the bytes are valid UTF-8, and non-zero otherwise.
+ */
+int utf8_validate(const char* data, size_t size, size_t* invalid_offset);
+
+/**
+ * \brief The utf8_validate_level method is utf8_validate(), using the best
+ * implementation at or below the given SIMD level which is also supported by
+ * the running processor.
+ *
+ * \param level             The maximum SIMD level to use.
+ * \param data              The bytes to validate.
+ * \param size              The number of bytes.
+ * \param invalid_offset    Set to the offset of the first invalid sequence
+ *                          if the bytes are not valid UTF-8.
+ *
+ * \returns 0 if the bytes are valid UTF-8, and non-zero otherwise.
+ */
+int utf8_validate_level(
+    simd_level_t level, const char* data, size_t size,
+    size_t* invalid_offset);
+
+/**
+ * \brief Return true if the string is stored inline.
+ *
+ * \param str           The string to query.
+ */
+static inline bool string_is_inline(const string_t* str)
+{
+    return STRING_INLINE_CAPACITY == str->capacity;
+}
+
+/**
+ * \brief Return true if the string is a view of bytes it does not own.
+ *
+ * \param str           The string to query.
+ */
+static inline bool string_is_view(const string_t* str)
+{
+    return 0U == str->capacity;
+}
+
+/**
+ * \brief Return the bytes of the string, which are NUL terminated unless the
+ * string is a view.  The pointer is valid until the string is next modified.
+ *
+ * \param str           The string to query.
+ */
+static inline const char* string_data(const string_t* str)
+{
+    if (string_is_inline(str))
+        return str->data.buf;
+
+    return string_is_view(str) ? str->data.view : str->data.ptr;
+}
+
+/**
+ * \brief Model checking property for a string.
+ */
+#define PROP_VALID_STRING(str) \
+    (NULL != (str) && \
+     PROP_VALID_ALLOCATOR((str)->alloc) && \
+     (0U == (str)->capacity || \
+      ((str)->capacity >= STRING_INLINE_CAPACITY && \
+       (str)->length <= (str)->capacity)) && \
+     (str)->codepoints <= (str)->length)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_STRING_HEADER_GUARD*/
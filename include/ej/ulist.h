@@ -0,0 +1,254 @@
+/**
+ * \brief This header defines the unrolled list type: a doubly-linked list of
+ * chunks, each of which holds a small array of data values.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_ULIST_HEADER_GUARD
+# define EJ_ULIST_HEADER_GUARD
+
+#include <ej/disposable.h>
+
+#ifdef   __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The number of data values that fit in a single chunk.
+ */
+#define ULIST_CHUNK_CAPACITY 32U
+
+/**
+ * An unrolled list chunk contains pointers to the next and previous chunks,
+ * as well as up to \ref ULIST_CHUNK_CAPACITY data values stored contiguously.
+ * A chunk that is linked into a list is never empty.
+ */
+typedef struct ulist_chunk
+{
+    struct ulist_chunk* next;
+    struct ulist_chunk* prev;
+    size_t count;
+    disposable_t* data[ULIST_CHUNK_CAPACITY];
+} ulist_chunk_t;
+
+/**
+ * An unrolled list holds the head and tail chunks for the list, as well as the
+ * total number of data values in the list.
+ */
+typedef struct ulist
+{
+    disposable_t hdr;
+    ulist_chunk_t* head;
+    ulist_chunk_t* tail;
+
+    size_t size;
+} ulist_t;
+
+/**
+ * A position in an unrolled list refers to a data value by its chunk and its
+ * index within that chunk.  Any operation that modifies a list invalidates all
+ * positions in that list, other than the position returned by that operation.
+ */
+typedef struct ulist_pos
+{
+    ulist_chunk_t* chunk;
+    size_t index;
+} ulist_pos_t;
+
+/**
+ * \brief The ulist_init method creates a new empty unrolled list.
+ *
+ * \param list          The list to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_init(ulist_t* list);
+
+/**
+ * \brief The ulist_push_front method pushes a data value onto the front of the
+ * unrolled list.  The ownership of this data is transferred to the list and
+ * may be dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_push_front(ulist_t* list, disposable_t* data);
+
+/**
+ * \brief The ulist_push_back method pushes a data value onto the back of the
+ * unrolled list.  The ownership of this data is transferred to the list and
+ * may be dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_push_back(ulist_t* list, disposable_t* data);
+
+/**
+ * \brief The ulist_pop_front method pops a data value off of the front of the
+ * unrolled list.  The ownership of this data is transferred to the caller who
+ * is responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_pop_front(ulist_t* list, disposable_t** data);
+
+/**
+ * \brief The ulist_pop_back method pops a data value off of the back of the
+ * unrolled list.  The ownership of this data is transferred to the caller who
+ * is responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_pop_back(ulist_t* list, disposable_t** data);
+
+/**
+ * \brief The ulist_at method finds the position of the data value at the
+ * given zero-based index, walking chunks from whichever end of the list is
+ * closer.
+ *
+ * \param list          The list to search.
+ * \param index         The index of the data value to find.
+ * \param pos           The position to set.
+ *
+ * \returns 0 on success and non-zero if the index is out of bounds.
+ */
+int ulist_at(ulist_t* list, size_t index, ulist_pos_t* pos);
+
+/**
+ * \brief The ulist_insert method will insert the given data value BEFORE the
+ * given position in the list.  This method assumes that the provided position
+ * is valid for this list; it is extremely important that the caller ensures
+ * that this is true.  The ownership of this data is transferred to the list
+ * who is responsible for dispose()ing and free()ing it.
+ *
+ * On success, pos is updated to refer to the newly inserted data value.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position before which this data is inserted.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_insert(ulist_t* list, ulist_pos_t* pos, disposable_t* data);
+
+/**
+ * \brief The ulist_append method will append the given data value AFTER the
+ * given position in the list.  This method assumes that the provided position
+ * is valid for this list; it is extremely important that the caller ensures
+ * that this is true.  The ownership of this data is transferred to the list
+ * who is responsible for dispose()ing and free()ing it.
+ *
+ * On success, pos is updated to refer to the newly appended data value.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position after which this data is appended.
+ * \param data          The data to append.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_append(ulist_t* list, ulist_pos_t* pos, disposable_t* data);
+
+/**
+ * \brief The ulist_remove method will remove the data value at the given
+ * position from the list, returning it to be dispose()d and free()d by the
+ * caller.  This method assumes that the provided position is valid for this
+ * list; it is extremely important that the caller ensures that this is true.
+ *
+ * Sparse neighboring chunks are merged, and empty chunks are released.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position of the data value to be removed.
+ * \param data          Pointer to the data pointer returned to the caller.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_remove(ulist_t* list, const ulist_pos_t* pos, disposable_t** data);
+
+/**
+ * \brief The ulist_splice method will splice two lists into one.  After this
+ * method is called, the x list will contain all chunks, and the y list will be
+ * empty.
+ *
+ * \param x             The x list to splice with the values from the y list.
+ * \param y             The y list to destructively splice.
+ */
+void ulist_splice(ulist_t* x, ulist_t* y);
+
+/**
+ * \brief The ulist_split method will split the list at the given position.
+ * The original list x will contain all entries BEFORE the position, and the
+ * new y list will contain the entry at this position and all entries AFTER
+ * it.  It is expected that the y list is empty, and the position is valid for
+ * the original x list.
+ *
+ * Splitting in the middle of a chunk requires a new chunk, which may fail.
+ * The sizes of the two lists are recomputed from the chunk counts, so this
+ * method touches one chunk per \ref ULIST_CHUNK_CAPACITY entries rather than
+ * every entry.
+ *
+ * \param x             The x list to split, which will contain all values
+ *                      BEFORE pos after this operation is complete.
+ * \param pos           The position at which the list is split.
+ * \param y             The y list to receive half of the list, starting with
+ *                      the value at pos.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_split(ulist_t* x, const ulist_pos_t* pos, ulist_t* y);
+
+/**
+ * \brief Model checking property for an empty unrolled list.
+ */
+#define PROP_VALID_ULIST_EMPTY(list) \
+    (NULL != (list) && \
+     (list)->size == 0U && \
+     NULL == (list)->head && \
+     NULL == (list)->tail)
+
+/**
+ * \brief Model checking property for a non-empty unrolled list.
+ */
+#define PROP_VALID_ULIST_NOT_EMPTY(list) \
+    (NULL != (list) && \
+     (list)->size > 0U && \
+     NULL != (list)->head && \
+     NULL != (list)->tail)
+
+/**
+ * \brief Model checking property for an unrolled list.
+ */
+#define PROP_VALID_ULIST(list) \
+    (PROP_VALID_ULIST_EMPTY(list) || PROP_VALID_ULIST_NOT_EMPTY(list))
+
+/**
+ * \brief Model checking property for a position in an unrolled list.
+ */
+#define PROP_VALID_ULIST_POS(pos) \
+    (NULL != (pos) && \
+     NULL != (pos)->chunk && \
+     (pos)->index < (pos)->chunk->count)
+
+#ifdef   __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*EJ_ULIST_HEADER_GUARD*/
@@ -0,0 +1,17 @@
+CBMC_DIR?=/opt/cbmc
+CBMC?=$(CBMC_DIR)/bin/cbmc
+
+ALL:
+	$(CBMC) --bounds-check --pointer-check --memory-leak-check \
+	--div-by-zero-check --signed-overflow-check --unsigned-overflow-check \
+    --pointer-overflow-check --conversion-check \
+	--conversion-check --trace --stop-on-fail -DCBMC \
+    --object-bits 16 --drop-unused-functions \
+    --unwind 1 \
+    --unwindset ilist_dispose.0:4,ilist_split.0:4 \
+    --unwinding-assertions \
+	-I ../include \
+    ../modelsrc/*c \
+    ../src/ilist/*c \
+    ../src/disposable/*c \
+	ilist_main.c
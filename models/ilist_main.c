@@ -0,0 +1,81 @@
+#include <ej/ilist.h>
+#include <model_check/assert.h>
+#include <stdbool.h>
+
+typedef struct foo
+{
+    disposable_t hdr;
+    ilist_node_t link;
+    int val;
+} foo_t;
+
+static void dispose_foo(disposable_t* disp)
+{
+}
+
+static foo_t* create_foo(int val)
+{
+    foo_t* ret = (foo_t*)malloc(sizeof(foo_t));
+    if (NULL == ret)
+        return ret;
+
+    ret->hdr.dispose = &dispose_foo;
+    ret->val = val;
+
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    ilist_t x, y;
+    ilist_node_t* node;
+    foo_t *f1, *f2, *f3;
+
+    if (0 != ilist_init(&x, offsetof(foo_t, link)))
+    {
+        return 1;
+    }
+
+    if (0 != ilist_init(&y, offsetof(foo_t, link)))
+    {
+        return 2;
+    }
+
+    f1 = create_foo(1);
+    f2 = create_foo(2);
+    f3 = create_foo(3);
+
+    if (NULL == f1 || NULL == f2 || NULL == f3)
+    {
+        if (f1) free(f1);
+        if (f2) free(f2);
+        if (f3) free(f3);
+        return 3;
+    }
+
+    /* build the list f1, f2, f3. */
+    ilist_push_back(&x, &f2->link);
+    ilist_insert(&x, &f2->link, &f1->link);
+    ilist_append(&x, &f2->link, &f3->link);
+
+    /* split and splice it. */
+    ilist_split(&x, &f2->link, &y);
+    ilist_splice(&x, &y);
+
+    /* remove and reinsert the middle node. */
+    ilist_remove(&x, &f2->link);
+    ilist_push_front(&x, &f2->link);
+
+    /* pop and push the back node. */
+    if (0 != ilist_pop_back(&x, &node))
+    {
+        dispose((disposable_t*)&x);
+        return 4;
+    }
+    ilist_push_back(&x, node);
+
+    dispose((disposable_t*)&x);
+    dispose((disposable_t*)&y);
+
+    return 0;
+}
@@ -13,5 +13,7 @@ ALL:
 	-I ../include \
     ../modelsrc/*c \
     ../src/list/*c \
+    ../src/pool/*c \
+    ../src/allocator/*c \
     ../src/disposable/*c \
 	list_append_main.c
@@ -0,0 +1,106 @@
+#include <ej/list.h>
+#include <model_check/assert.h>
+#include <stdbool.h>
+
+typedef struct foo
+{
+    disposable_t hdr;
+    int val;
+} foo_t;
+
+static void dispose_foo(disposable_t* disp)
+{
+}
+
+static foo_t* create_foo(int val)
+{
+    foo_t* ret = (foo_t*)malloc(sizeof(foo_t));
+    if (NULL == ret)
+        return ret;
+
+    ret->hdr.dispose = &dispose_foo;
+    ret->val = val;
+
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    list_t x, y;
+    foo_t *f1, *f2, *f3, *f4, *f5;
+
+    if (0 != list_init(&x) || 0 != list_init(&y))
+    {
+        return 1;
+    }
+
+    f1 = create_foo(1);
+    f2 = create_foo(2);
+    f3 = create_foo(3);
+    f4 = create_foo(4);
+    f5 = create_foo(5);
+
+    if (NULL == f1 || NULL == f2 || NULL == f3 || NULL == f4 || NULL == f5)
+    {
+        if (f1) free(f1);
+        if (f2) free(f2);
+        if (f3) free(f3);
+        if (f4) free(f4);
+        if (f5) free(f5);
+        return 2;
+    }
+
+    if (0 != list_push_back(&x, (disposable_t*)f1))
+    {
+        free(f1); free(f2); free(f3); free(f4); free(f5);
+        dispose((disposable_t*)&x);
+        return 3;
+    }
+
+    if (0 != list_push_back(&x, (disposable_t*)f2))
+    {
+        free(f2); free(f3); free(f4); free(f5);
+        dispose((disposable_t*)&x);
+        return 4;
+    }
+
+    if (0 != list_push_back(&x, (disposable_t*)f3))
+    {
+        free(f3); free(f4); free(f5);
+        dispose((disposable_t*)&x);
+        return 5;
+    }
+
+    if (0 != list_push_back(&x, (disposable_t*)f4))
+    {
+        free(f4); free(f5);
+        dispose((disposable_t*)&x);
+        return 6;
+    }
+
+    if (0 != list_push_back(&x, (disposable_t*)f5))
+    {
+        free(f5);
+        dispose((disposable_t*)&x);
+        return 7;
+    }
+
+    /* split near the head, then rejoin. */
+    list_split(&x, x.head->next, &y);
+    MODEL_ASSERT(1U == x.size && 4U == y.size);
+    list_splice(&x, &y);
+
+    /* split near the tail, then rejoin. */
+    list_split(&x, x.tail->prev, &y);
+    MODEL_ASSERT(3U == x.size && 2U == y.size);
+    list_splice(&x, &y);
+
+    /* split with a known index. */
+    list_split_at(&x, x.head->next->next, 2U, &y);
+    MODEL_ASSERT(2U == x.size && 3U == y.size);
+
+    dispose((disposable_t*)&x);
+    dispose((disposable_t*)&y);
+
+    return 0;
+}
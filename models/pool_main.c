@@ -0,0 +1,105 @@
+#include <ej/list.h>
+#include <ej/pool.h>
+#include <model_check/assert.h>
+#include <stdbool.h>
+
+typedef struct foo
+{
+    disposable_t hdr;
+    int val;
+} foo_t;
+
+static void dispose_foo(disposable_t* disp)
+{
+}
+
+static foo_t* create_foo(int val)
+{
+    foo_t* ret = (foo_t*)malloc(sizeof(foo_t));
+    if (NULL == ret)
+        return ret;
+
+    ret->hdr.dispose = &dispose_foo;
+    ret->val = val;
+
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    pool_t pool;
+    list_t list;
+    foo_t *f1, *f2, *f3;
+
+    if (0 != pool_init(&pool, sizeof(list_node_t), 2))
+    {
+        return 1;
+    }
+
+    if (0 != list_init_pool(&list, &pool))
+    {
+        dispose((disposable_t*)&pool);
+        return 2;
+    }
+
+    f1 = create_foo(1);
+    f2 = create_foo(2);
+    f3 = create_foo(3);
+
+    if (NULL == f1 || NULL == f2 || NULL == f3)
+    {
+        if (f1) free(f1);
+        if (f2) free(f2);
+        if (f3) free(f3);
+        dispose((disposable_t*)&list);
+        dispose((disposable_t*)&pool);
+        return 3;
+    }
+
+    if (0 != list_push_back(&list, (disposable_t*)f1))
+    {
+        free(f1); free(f2); free(f3);
+        dispose((disposable_t*)&list);
+        dispose((disposable_t*)&pool);
+        return 4;
+    }
+
+    if (0 != list_push_back(&list, (disposable_t*)f2))
+    {
+        free(f2); free(f3);
+        dispose((disposable_t*)&list);
+        dispose((disposable_t*)&pool);
+        return 5;
+    }
+
+    /* the third node requires a second slab. */
+    if (0 != list_push_back(&list, (disposable_t*)f3))
+    {
+        free(f3);
+        dispose((disposable_t*)&list);
+        dispose((disposable_t*)&pool);
+        return 6;
+    }
+
+    /* recycle a node through the pool. */
+    disposable_t* data;
+    if (0 != list_pop_front(&list, &data))
+    {
+        dispose((disposable_t*)&list);
+        dispose((disposable_t*)&pool);
+        return 7;
+    }
+
+    if (0 != list_push_back(&list, data))
+    {
+        free(data);
+        dispose((disposable_t*)&list);
+        dispose((disposable_t*)&pool);
+        return 8;
+    }
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&pool);
+
+    return 0;
+}
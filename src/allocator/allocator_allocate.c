@@ -0,0 +1,79 @@
+/**
+ * \brief Allocate memory from an allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/allocator.h>
+
+/**
+ * \brief Allocate size bytes from the given allocator.
+ *
+ * \param alloc             The allocator from which memory is allocated.
+ * \param size              The number of bytes to allocate.
+ *
+ * \returns the memory, suitably aligned for any pointer or size_t, or NULL on
+ *          failure.
+ */
+void* allocator_allocate(allocator_t* alloc, size_t size)
+{
+    return allocator_allocate_tagged(alloc, size, ALLOCATOR_TAG_UNTAGGED);
+}
+
+/**
+ * \brief Allocate size bytes from the given allocator, attributing them to the
+ * given tag.  The memory must be released with allocator_release_tagged()
+ * using the same tag.
+ *
+ * \param alloc             The allocator from which memory is allocated.
+ * \param size              The number of bytes to allocate.
+ * \param tag               The tag to which the memory is attributed.
+ *
+ * \returns the memory, or NULL on failure.
+ */
+void* allocator_allocate_tagged(
+    allocator_t* alloc, size_t size, allocator_tag_t tag)
+{
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(tag < ALLOCATOR_TAG_COUNT);
+
+    if (!alloc->stats_enabled)
+        return alloc->allocate(alloc, size);
+
+    /* other threads move the live bytes of a shared backend. */
+    if (NULL != alloc->measure)
+    {
+        void* ptr = alloc->allocate(alloc, size);
+        if (NULL == ptr)
+        {
+            __atomic_add_fetch(
+                &alloc->stats.failed_count, 1U, __ATOMIC_RELAXED);
+            return NULL;
+        }
+
+        __atomic_add_fetch(
+            &alloc->stats.tag_live_bytes[tag], alloc->measure(alloc, ptr),
+            __ATOMIC_RELAXED);
+        __atomic_add_fetch(
+            &alloc->stats.tag_live_count[tag], 1U, __ATOMIC_RELAXED);
+
+        return ptr;
+    }
+
+    /* the backend records the bytes; attribute whatever it records. */
+    size_t before = alloc->stats.live_bytes;
+
+    void* ptr = alloc->allocate(alloc, size);
+    if (NULL == ptr)
+    {
+        ++alloc->stats.failed_count;
+        return NULL;
+    }
+
+    alloc->stats.tag_live_bytes[tag] += alloc->stats.live_bytes - before;
+    ++alloc->stats.tag_live_count[tag];
+
+    return ptr;
+}
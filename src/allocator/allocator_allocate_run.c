@@ -0,0 +1,57 @@
+/**
+ * \brief Allocate a contiguous run of memory from an allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/allocator.h>
+
+/**
+ * \brief Allocate count allocations of size bytes from the given allocator as
+ * one contiguous run, attributing them to the given tag.  Allocation i starts
+ * i * stride bytes after the first, and each must be released on its own with
+ * allocator_release_tagged() using the same tag.
+ *
+ * Allocators that do not support runs always fail, so callers fall back to
+ * allocating one at a time.
+ *
+ * \param alloc             The allocator from which memory is allocated.
+ * \param size              The size of each allocation.
+ * \param count             The number of allocations, which must not be 0.
+ * \param stride            Set to the distance between allocations.
+ * \param tag               The tag to which the memory is attributed.
+ *
+ * \returns the first allocation, or NULL on failure.
+ */
+void* allocator_allocate_run_tagged(
+    allocator_t* alloc, size_t size, size_t count, size_t* stride,
+    allocator_tag_t tag)
+{
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(0U < count);
+    MODEL_ASSERT(NULL != stride);
+    MODEL_ASSERT(tag < ALLOCATOR_TAG_COUNT);
+
+    if (NULL == alloc->allocate_run)
+        return NULL;
+
+    if (!alloc->stats_enabled)
+        return alloc->allocate_run(alloc, size, count, stride);
+
+    /* the backend records the bytes; attribute whatever it records. */
+    size_t before = alloc->stats.live_bytes;
+
+    void* ptr = alloc->allocate_run(alloc, size, count, stride);
+    if (NULL == ptr)
+    {
+        ++alloc->stats.failed_count;
+        return NULL;
+    }
+
+    alloc->stats.tag_live_bytes[tag] += alloc->stats.live_bytes - before;
+    alloc->stats.tag_live_count[tag] += count;
+
+    return ptr;
+}
@@ -0,0 +1,70 @@
+/**
+ * \brief Release memory to an allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/allocator.h>
+
+/**
+ * \brief Return memory to the allocator from which it was allocated.
+ *
+ * This method assumes that the memory was allocated from this allocator; it
+ * is extremely important that the caller ensures that this is true.  NULL is
+ * ignored.
+ *
+ * \param alloc             The allocator to which memory is returned.
+ * \param ptr               The memory to release.
+ */
+void allocator_release(allocator_t* alloc, void* ptr)
+{
+    allocator_release_tagged(alloc, ptr, ALLOCATOR_TAG_UNTAGGED);
+}
+
+/**
+ * \brief Return memory allocated with allocator_allocate_tagged() to the
+ * allocator.  NULL is ignored.
+ *
+ * \param alloc             The allocator to which memory is returned.
+ * \param ptr               The memory to release.
+ * \param tag               The tag with which the memory was allocated.
+ */
+void allocator_release_tagged(
+    allocator_t* alloc, void* ptr, allocator_tag_t tag)
+{
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(tag < ALLOCATOR_TAG_COUNT);
+
+    if (NULL == ptr)
+        return;
+
+    if (!alloc->stats_enabled)
+    {
+        alloc->release(alloc, ptr);
+        return;
+    }
+
+    /* other threads move the live bytes of a shared backend. */
+    if (NULL != alloc->measure)
+    {
+        __atomic_sub_fetch(
+            &alloc->stats.tag_live_bytes[tag], alloc->measure(alloc, ptr),
+            __ATOMIC_RELAXED);
+        __atomic_sub_fetch(
+            &alloc->stats.tag_live_count[tag], 1U, __ATOMIC_RELAXED);
+
+        alloc->release(alloc, ptr);
+        return;
+    }
+
+    /* the backend records the bytes; take back whatever it released. */
+    size_t before = alloc->stats.live_bytes;
+    size_t before_count = alloc->stats.live_count;
+
+    alloc->release(alloc, ptr);
+
+    alloc->stats.tag_live_bytes[tag] -= before - alloc->stats.live_bytes;
+    alloc->stats.tag_live_count[tag] -= before_count - alloc->stats.live_count;
+}
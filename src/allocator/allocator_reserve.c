@@ -0,0 +1,32 @@
+/**
+ * \brief Reserve room in an allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/allocator.h>
+
+/**
+ * \brief Ensure that the next count allocations of size bytes from this
+ * allocator will succeed, so that a batch can be allocated atomically and,
+ * where the backend supports it, contiguously.
+ *
+ * Allocators that do not support reservation always succeed.
+ *
+ * \param alloc             The allocator in which room is reserved.
+ * \param size              The size of each allocation.
+ * \param count             The number of allocations.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int allocator_reserve(allocator_t* alloc, size_t size, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+
+    if (NULL == alloc->reserve)
+        return 0;
+
+    return alloc->reserve(alloc, size, count);
+}
@@ -0,0 +1,25 @@
+/**
+ * \brief Query the statistics of an allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/allocator.h>
+
+/**
+ * \brief Get the statistics for an allocator.  The statistics remain owned by
+ * the allocator and are updated as it is used.  They are all zero for an
+ * allocator which does not keep statistics.
+ *
+ * \param alloc             The allocator to query.
+ *
+ * \returns the allocator's statistics.
+ */
+const allocator_stats_t* allocator_stats(const allocator_t* alloc)
+{
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+
+    return &alloc->stats;
+}
@@ -0,0 +1,95 @@
+/**
+ * \brief The system allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/allocator.h>
+#include <malloc.h>
+#include <stdlib.h>
+
+/* forward decls */
+static void allocator_system_dispose(disposable_t* disp);
+static void* allocator_system_allocate(allocator_t* alloc, size_t size);
+static void allocator_system_release(allocator_t* alloc, void* ptr);
+static size_t allocator_system_measure(allocator_t* alloc, const void* ptr);
+
+static allocator_t system_allocator = {
+    .hdr = { .dispose = &allocator_system_dispose },
+    .allocate = &allocator_system_allocate,
+    .release = &allocator_system_release,
+    .measure = &allocator_system_measure,
+    .stats_enabled = true,
+};
+
+/**
+ * \brief Get the system allocator, which allocates via malloc() and releases
+ * via free().
+ *
+ * The system allocator is a static singleton.  dispose()ing it does nothing.
+ * It is shared between threads, so it updates its statistics atomically.
+ *
+ * \returns the system allocator.
+ */
+allocator_t* allocator_system(void)
+{
+    return &system_allocator;
+}
+
+/**
+ * \brief The system allocator owns nothing, so there is nothing to dispose.
+ *
+ * \param disp      The system allocator.
+ */
+static void allocator_system_dispose(disposable_t* disp)
+{
+    (void)disp;
+}
+
+/**
+ * \brief Allocate memory via malloc().
+ *
+ * \param alloc     The system allocator.
+ * \param size      The number of bytes to allocate.
+ *
+ * \returns the memory, or NULL on failure.
+ */
+static void* allocator_system_allocate(allocator_t* alloc, size_t size)
+{
+    void* ptr = malloc(size);
+    if (NULL != ptr)
+        allocator_stats_allocated_shared(alloc, malloc_usable_size(ptr));
+
+    return ptr;
+}
+
+/**
+ * \brief Release memory via free().
+ *
+ * \param alloc     The system allocator.
+ * \param ptr       The memory to release.
+ */
+static void allocator_system_release(allocator_t* alloc, void* ptr)
+{
+    allocator_stats_released_shared(alloc, malloc_usable_size(ptr));
+
+    free(ptr);
+}
+
+/**
+ * \brief Measure memory from malloc(), which records the size of each block
+ * itself, so that the system allocator needs no header of its own.
+ *
+ * \param alloc     The system allocator.
+ * \param ptr       The memory to measure.
+ *
+ * \returns the usable size of the memory.
+ */
+static size_t allocator_system_measure(allocator_t* alloc, const void* ptr)
+{
+    (void)alloc;
+
+    return malloc_usable_size((void*)ptr);
+}
@@ -0,0 +1,59 @@
+/**
+ * \brief Move the chunks of one arena into another.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/arena.h>
+
+/**
+ * \brief The arena_adopt method moves every chunk of the other arena into this
+ * one, so that memory allocated from the other arena is released when this
+ * arena is dispose()d.  The other arena is left empty.
+ *
+ * The adopted chunks are linked after this arena's current chunk, so that
+ * allocation continues from the current chunk.
+ *
+ * \param arena             The arena which takes ownership of the chunks.
+ * \param other             The arena to empty.
+ */
+void arena_adopt(arena_t* arena, arena_t* other)
+{
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+    MODEL_ASSERT(PROP_VALID_ARENA(other));
+    MODEL_ASSERT(arena != other);
+
+    if (NULL == other->chunks)
+        return;
+
+    /* find the last of the other arena's chunks. */
+    arena_chunk_t* tail = other->chunks;
+    while (NULL != tail->link.next)
+    {
+        tail = tail->link.next;
+    }
+
+    if (NULL != arena->chunks)
+    {
+        tail->link.next = arena->chunks->link.next;
+        arena->chunks->link.next = other->chunks;
+    }
+    else
+    {
+        arena->chunks = other->chunks;
+    }
+
+    arena->chunk_count += other->chunk_count;
+    allocator_stats_adopted(&arena->alloc, &other->alloc.stats);
+
+    /* the other arena no longer owns anything. */
+    other->chunks = NULL;
+    other->bump = other->bump_end = NULL;
+    other->chunk_count = 0U;
+    allocator_stats_cleared(&other->alloc);
+
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+    MODEL_ASSERT(PROP_VALID_ARENA(other));
+}
@@ -0,0 +1,236 @@
+/**
+ * \brief Initialize an arena.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/arena.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void arena_dispose(disposable_t* disp);
+static void* arena_alloc_allocate(allocator_t* alloc, size_t size);
+static void arena_alloc_release(allocator_t* alloc, void* ptr);
+static int arena_alloc_reserve(allocator_t* alloc, size_t size, size_t count);
+static arena_chunk_t* arena_chunk_create(arena_t* arena, size_t size);
+
+/* every allocation is maximally aligned. */
+#define ARENA_ALIGN (_Alignof(max_align_t))
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1U) & ~(ARENA_ALIGN - 1U))
+
+/**
+ * \brief The arena_init method creates a new empty arena.
+ *
+ * No chunk is allocated until the first allocation is requested.  Requests
+ * larger than the chunk size are given a chunk of their own.
+ *
+ * \param arena             The arena to initialize.
+ * \param chunk_size        The usable size of each chunk.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int arena_init(arena_t* arena, size_t chunk_size)
+{
+    MODEL_ASSERT(NULL != arena);
+
+    if (0U == chunk_size || chunk_size > SIZE_MAX / 2U)
+        return 1;
+
+    /* clear the arena. */
+    memset(arena, 0, sizeof(arena_t));
+
+    /* set our dispose and allocator methods. */
+    arena->alloc.hdr.dispose = &arena_dispose;
+    arena->alloc.allocate = &arena_alloc_allocate;
+    arena->alloc.release = &arena_alloc_release;
+    arena->alloc.reserve = &arena_alloc_reserve;
+    arena->alloc.stats_enabled = true;
+    arena->chunk_size = ARENA_ROUND(chunk_size);
+
+    /* the arena is now valid. */
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of an arena, releasing every chunk in bulk.
+ *
+ * \param disp      The arena to dispose.
+ */
+static void arena_dispose(disposable_t* disp)
+{
+    arena_t* arena = (arena_t*)disp;
+
+    /* we are disposing a valid arena. */
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+
+    arena_chunk_t* i = arena->chunks;
+    while (i != NULL)
+    {
+        arena_chunk_t* tmp = i->link.next;
+
+        free(i);
+
+        i = tmp;
+    }
+
+    arena->chunks = NULL;
+    arena->bump = arena->bump_end = NULL;
+    arena->chunk_count = 0U;
+    allocator_stats_cleared(&arena->alloc);
+}
+
+/**
+ * \brief Carve an allocation from the current chunk, starting a new chunk if
+ * this one is exhausted.
+ *
+ * \param alloc     The arena.
+ * \param size      The number of bytes to allocate.
+ *
+ * \returns the memory, or NULL on failure.
+ */
+static void* arena_alloc_allocate(allocator_t* alloc, size_t size)
+{
+    arena_t* arena = (arena_t*)alloc;
+
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+
+    if (size > SIZE_MAX - ARENA_ALIGN)
+        return NULL;
+
+    size = ARENA_ROUND(size);
+    if (0U == size)
+        size = ARENA_ALIGN;
+
+    /* oversized requests get a chunk of their own. */
+    if (size > arena->chunk_size)
+    {
+        arena_chunk_t* chunk = arena_chunk_create(arena, size);
+        if (NULL == chunk)
+            return NULL;
+
+        /* keep bumping from the current chunk. */
+        if (NULL != arena->chunks)
+        {
+            chunk->link.next = arena->chunks->link.next;
+            arena->chunks->link.next = chunk;
+        }
+        else
+        {
+            chunk->link.next = NULL;
+            arena->chunks = chunk;
+        }
+
+        allocator_stats_allocated(alloc, size);
+
+        return chunk + 1;
+    }
+
+    /* start a new chunk if this one is exhausted. */
+    if ((size_t)(arena->bump_end - arena->bump) < size)
+    {
+        arena_chunk_t* chunk = arena_chunk_create(arena, arena->chunk_size);
+        if (NULL == chunk)
+            return NULL;
+
+        chunk->link.next = arena->chunks;
+        arena->chunks = chunk;
+        arena->bump = (unsigned char*)(chunk + 1);
+        arena->bump_end = arena->bump + arena->chunk_size;
+    }
+
+    void* ptr = arena->bump;
+    arena->bump += size;
+
+    allocator_stats_allocated(alloc, size);
+
+    return ptr;
+}
+
+/**
+ * \brief Individual allocations are never released; the whole arena is
+ * released when it is dispose()d.  Until then, the memory still counts as live
+ * in the arena's statistics, since it can't be reused.
+ *
+ * \param alloc     The arena.
+ * \param ptr       The memory to release.
+ */
+static void arena_alloc_release(allocator_t* alloc, void* ptr)
+{
+    (void)alloc;
+    (void)ptr;
+}
+
+/**
+ * \brief Ensure that count allocations of size bytes can be carved from the
+ * current chunk, so that they are contiguous and can't fail.
+ *
+ * \param alloc     The arena.
+ * \param size      The size of each allocation.
+ * \param count     The number of allocations.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int arena_alloc_reserve(allocator_t* alloc, size_t size, size_t count)
+{
+    arena_t* arena = (arena_t*)alloc;
+
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+
+    if (size > SIZE_MAX - ARENA_ALIGN)
+        return 1;
+
+    size = ARENA_ROUND(size);
+    if (0U == size)
+        size = ARENA_ALIGN;
+
+    if (count > SIZE_MAX / size)
+        return 1;
+
+    size_t total = size * count;
+    if ((size_t)(arena->bump_end - arena->bump) >= total)
+        return 0;
+
+    /* start a chunk large enough for the whole batch. */
+    size_t chunk_size = (total > arena->chunk_size) ? total : arena->chunk_size;
+    arena_chunk_t* chunk = arena_chunk_create(arena, chunk_size);
+    if (NULL == chunk)
+        return 1;
+
+    chunk->link.next = arena->chunks;
+    arena->chunks = chunk;
+    arena->bump = (unsigned char*)(chunk + 1);
+    arena->bump_end = arena->bump + chunk_size;
+
+    return 0;
+}
+
+/**
+ * \brief Allocate a chunk with room for size bytes after its header.  The
+ * caller links it into the chunk chain.
+ *
+ * \param arena     The arena.
+ * \param size      The usable size of the chunk.
+ *
+ * \returns the chunk, or NULL on failure.
+ */
+static arena_chunk_t* arena_chunk_create(arena_t* arena, size_t size)
+{
+    if (size > SIZE_MAX - sizeof(arena_chunk_t))
+        return NULL;
+
+    arena_chunk_t* chunk =
+        (arena_chunk_t*)malloc(sizeof(arena_chunk_t) + size);
+    if (NULL == chunk)
+        return NULL;
+
+    chunk->link.size = size;
+    ++arena->chunk_count;
+
+    return chunk;
+}
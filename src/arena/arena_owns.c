@@ -0,0 +1,36 @@
+/**
+ * \brief Check whether memory belongs to an arena.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/arena.h>
+#include <stdint.h>
+
+/**
+ * \brief The arena_owns method checks whether memory was carved from one of
+ * the arena's chunks.
+ *
+ * This walks the chunks, so it costs time in proportion to their number.
+ *
+ * \param arena             The arena.
+ * \param ptr               The memory.
+ *
+ * \returns true if the memory is in one of the arena's chunks.
+ */
+bool arena_owns(const arena_t* arena, const void* ptr)
+{
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+
+    uintptr_t address = (uintptr_t)ptr;
+    for (const arena_chunk_t* i = arena->chunks; NULL != i; i = i->link.next)
+    {
+        uintptr_t start = (uintptr_t)(i + 1);
+        if (address >= start && address - start < i->link.size)
+            return true;
+    }
+
+    return false;
+}
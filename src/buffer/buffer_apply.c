@@ -0,0 +1,201 @@
+/**
+ * \brief Make or take back the change a command records.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buffer_internal.h"
+
+/* forward decls */
+static int buffer_apply_delta(
+    buffer_t* buffer, const command_t* cmd, bool undo);
+static int buffer_apply_patch(
+    string_t** str, allocator_t* alloc, const string_t* line, size_t offset,
+    const char* cut, size_t cut_length, const char* put, size_t put_length,
+    char** scratch, size_t* scratch_size);
+
+/**
+ * Make the change which a command records, or take it back.
+ *
+ * A \ref COMMAND_TYPE_REPLACE command replaces whole lines.  A
+ * \ref COMMAND_TYPE_DELTA command rebuilds each of its lines from the bytes
+ * around its change, and fails unless the line holds the bytes it replaces.
+ *
+ * \param buffer            The buffer to change.
+ * \param cmd               The command.
+ * \param undo              true to take the change back, and false to make it.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_apply(buffer_t* buffer, const command_t* cmd, bool undo)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(PROP_VALID_COMMAND(cmd));
+
+    if (COMMAND_TYPE_DELTA == cmd->type)
+        return buffer_apply_delta(buffer, cmd, undo);
+
+    if (COMMAND_TYPE_REPLACE != cmd->type)
+        return 1;
+
+    /* the old lines make way for the new ones, or the other way around. */
+    if (undo)
+    {
+        return
+            buffer_splice(
+                buffer, cmd->line, cmd->new_count, command_lengths(cmd),
+                command_text(cmd), cmd->old_count);
+    }
+
+    return
+        buffer_splice(
+            buffer, cmd->line, cmd->old_count,
+            command_lengths(cmd) + cmd->old_count, command_new_text(cmd),
+            cmd->new_count);
+}
+
+/**
+ * \brief Apply a delta command to the lines of the buffer, or take it back.
+ *
+ * Every patched line is built before any line is replaced, so that a failure
+ * leaves the buffer unchanged.
+ *
+ * \param buffer        The buffer.
+ * \param cmd           The \ref COMMAND_TYPE_DELTA command.
+ * \param undo          true to take the change back.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_apply_delta(
+    buffer_t* buffer, const command_t* cmd, bool undo)
+{
+    allocator_t* alloc = buffer_data_alloc(buffer);
+    size_t count = cmd->old_count;
+    const uint32_t* removed = command_lengths(cmd);
+    const uint32_t* inserted = removed + count;
+    const uint32_t* offsets = command_offsets(cmd);
+    const char* old_text = command_text(cmd);
+    const char* new_text = command_new_text(cmd);
+
+    buffer_cursor_t first;
+    if (0 != buffer_find_line(buffer, cmd->line, &first))
+        return 1;
+
+    string_t** lines = (string_t**)malloc(count * sizeof(string_t*));
+    if (NULL == lines)
+        return 1;
+
+    char* scratch = NULL;
+    size_t scratch_size = 0U;
+    size_t built = 0U;
+    int retval = 0;
+    buffer_cursor_t cursor = first;
+    for (; built < count; ++built)
+    {
+        if (buffer_cursor_done(&cursor) ||
+            0 != buffer_cursor_materialize(buffer, &cursor))
+        {
+            retval = 1;
+            break;
+        }
+
+        const char* cut = undo ? new_text : old_text;
+        const char* put = undo ? old_text : new_text;
+        size_t cut_length = undo ? inserted[built] : removed[built];
+        size_t put_length = undo ? removed[built] : inserted[built];
+
+        if (0 !=
+                buffer_apply_patch(
+                    &lines[built], alloc,
+                    (const string_t*)*buffer_cursor_slot(&cursor),
+                    offsets[built], cut, cut_length, put, put_length,
+                    &scratch, &scratch_size))
+        {
+            retval = 1;
+            break;
+        }
+
+        old_text += removed[built];
+        new_text += inserted[built];
+        buffer_cursor_next(&cursor);
+    }
+
+    free(scratch);
+
+    /* swap the patched lines in, or throw them away. */
+    cursor = first;
+    for (size_t i = 0U; i < built; ++i)
+    {
+        disposable_t* data = (disposable_t*)lines[i];
+        if (0 == retval)
+        {
+            disposable_t** slot = buffer_cursor_slot(&cursor);
+            disposable_t* old = *slot;
+            *slot = data;
+            data = old;
+            buffer_cursor_next(&cursor);
+        }
+
+        dispose(data);
+        allocator_release_tagged(alloc, data, ALLOCATOR_TAG_LIST_DATA);
+    }
+
+    free(lines);
+
+    return retval;
+}
+
+/**
+ * \brief Create a copy of a line with cut_length bytes at offset, which must
+ * match cut, replaced by put.
+ *
+ * \param str           Set to the new line.
+ * \param alloc         The allocator for the new line.
+ * \param line          The line.
+ * \param offset        The offset of the change.
+ * \param cut           The bytes the change removes.
+ * \param cut_length    The number of bytes the change removes.
+ * \param put           The bytes the change inserts.
+ * \param put_length    The number of bytes the change inserts.
+ * \param scratch       Scratch space for the new line, which is grown if
+ *                      need be.
+ * \param scratch_size  The size of the scratch space.
+ *
+ * \returns 0 on success, or non-zero if the line does not hold the bytes the
+ *          change removes or the new line could not be created.
+ */
+static int buffer_apply_patch(
+    string_t** str, allocator_t* alloc, const string_t* line, size_t offset,
+    const char* cut, size_t cut_length, const char* put, size_t put_length,
+    char** scratch, size_t* scratch_size)
+{
+    const char* data = string_data(line);
+    if (line->length < offset + cut_length ||
+        0 != memcmp(data + offset, cut, cut_length))
+        return 1;
+
+    size_t tail = line->length - offset - cut_length;
+    size_t length = offset + put_length + tail;
+    if (NULL == *scratch || length > *scratch_size)
+    {
+        char* grown = (char*)realloc(*scratch, length + 1U);
+        if (NULL == grown)
+            return 1;
+
+        *scratch = grown;
+        *scratch_size = length + 1U;
+    }
+
+    memcpy(*scratch, data, offset);
+    memcpy(*scratch + offset, put, put_length);
+    memcpy(*scratch + offset + put_length, data + offset + cut_length, tail);
+
+    /* the change is whole codepoints, so the line is still valid UTF-8. */
+    return string_create_unchecked(str, alloc, *scratch, length);
+}
@@ -0,0 +1,416 @@
+/**
+ * \brief Take a checkpoint of a buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief The state of a checkpoint being built.
+ */
+typedef struct buffer_checkpoint_builder
+{
+    buffer_history_t* history;
+    const buffer_checkpoint_t* prev;
+    size_t next;
+    buffer_checkpoint_chunk_t** chunks;
+    size_t chunk_count;
+    size_t chunk_capacity;
+    command_line_t* scratch;
+    size_t copied;
+} buffer_checkpoint_builder_t;
+
+/* forward decls */
+static command_line_t buffer_checkpoint_entry(const disposable_t* data);
+static bool buffer_checkpoint_same(
+    const command_line_t* x, const command_line_t* y);
+static bool buffer_checkpoint_boundary(const command_line_t* line);
+static int buffer_checkpoint_share(
+    buffer_checkpoint_builder_t* b, buffer_cursor_t* cursor, bool* shared);
+static int buffer_checkpoint_chunk(
+    buffer_checkpoint_builder_t* b, buffer_cursor_t* cursor);
+static int buffer_checkpoint_add(
+    buffer_checkpoint_builder_t* b, buffer_checkpoint_chunk_t* chunk);
+static int buffer_checkpoint_finish(
+    buffer_checkpoint_builder_t* b, const command_stack_t* stack,
+    uint64_t mark, uint64_t time);
+static void buffer_checkpoint_views(
+    buffer_checkpoint_builder_t* b, const buffer_t* buffer);
+
+/**
+ * Take a checkpoint of the buffer now, unless one was taken at this depth of
+ * the undo stack.  The undo stack is sealed, so that no later command is
+ * merged into the state the checkpoint records.
+ *
+ * The lines are gathered into chunks which end after a line picked by a hash
+ * of where its text is, so that the chunks after a change line up with those
+ * of the previous checkpoint again, and can be shared with it.  The lines
+ * which own their text are copied into the history's arena, and only once the
+ * checkpoint is complete do they become views of those copies.
+ *
+ * \param buffer            The buffer, which must keep a history.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_checkpoint(buffer_t* buffer)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL != buffer->history);
+
+    buffer_history_t* history = buffer->history;
+    command_stack_t* stack = buffer->undo_commands;
+
+    command_stack_seal(stack);
+    if (NULL != history->last && history->last->depth == stack->count)
+        return 0;
+
+    const command_t* top = command_stack_peek(stack);
+    uint64_t time = (NULL == top) ? 0U : top->time;
+    uint64_t mark = command_stack_mark(stack);
+
+    const allocator_stats_t* stats = allocator_stats(&history->arena.alloc);
+    size_t live = stats->live_bytes;
+
+    buffer_checkpoint_builder_t b;
+    memset(&b, 0, sizeof(b));
+    b.history = history;
+    b.prev = history->last;
+    b.scratch =
+        (command_line_t*)malloc(
+            BUFFER_CHECKPOINT_CHUNK * sizeof(command_line_t));
+    if (NULL == b.scratch)
+        return 1;
+
+    int retval = 0;
+    buffer_cursor_t cursor;
+    buffer_cursor_first(buffer, &cursor);
+    while (0 == retval && !buffer_cursor_done(&cursor))
+    {
+        bool shared;
+        retval = buffer_checkpoint_share(&b, &cursor, &shared);
+        if (0 == retval && !shared)
+            retval = buffer_checkpoint_chunk(&b, &cursor);
+    }
+
+    if (0 == retval)
+        retval = buffer_checkpoint_finish(&b, stack, mark, time);
+
+    /* the copied lines only change hands once nothing else can fail, and
+     * what a failed checkpoint took from the arena is lost until it is
+     * compacted. */
+    if (0 == retval)
+    {
+        buffer_checkpoint_views(&b, buffer);
+        history->last->bytes = stats->live_bytes - live;
+    }
+    else
+    {
+        history->dropped_bytes += stats->live_bytes - live;
+    }
+
+    free(b.scratch);
+    free(b.chunks);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return retval;
+}
+
+/**
+ * \brief Get the checkpoint entry for a line or a region, without copying it.
+ *
+ * \param data          The line or the region.
+ *
+ * \returns the entry.
+ */
+static command_line_t buffer_checkpoint_entry(const disposable_t* data)
+{
+    command_line_t entry;
+
+    if (buffer_is_region(data))
+    {
+        entry.data = NULL;
+        entry.length = ((const buffer_region_t*)data)->number;
+    }
+    else
+    {
+        const string_t* str = (const string_t*)data;
+        entry.data = string_data(str);
+        entry.length = str->length;
+    }
+
+    return entry;
+}
+
+/**
+ * \brief Check whether two entries are the same line.
+ *
+ * \param x             An entry.
+ * \param y             Another entry.
+ *
+ * \returns true if both refer to the same text, or the same region.
+ */
+static bool buffer_checkpoint_same(
+    const command_line_t* x, const command_line_t* y)
+{
+    return x->data == y->data && x->length == y->length;
+}
+
+/**
+ * \brief Check whether a chunk ends after the given entry.  About one entry
+ * in 64 is picked, by where its text is, and not by where it is in the
+ * buffer.
+ *
+ * \param line          The entry.
+ *
+ * \returns true if a chunk ends after the entry.
+ */
+static bool buffer_checkpoint_boundary(const command_line_t* line)
+{
+    uint64_t hash =
+        ((uint64_t)(uintptr_t)line->data ^ (uint64_t)line->length) *
+        UINT64_C(0x9E3779B97F4A7C15);
+
+    return 0U == (hash >> 58);
+}
+
+/**
+ * \brief Share a chunk of the previous checkpoint, if one of the next few
+ * holds the lines starting at the given cursor.
+ *
+ * \param b             The builder.
+ * \param cursor        The cursor at the next line, which is moved past the
+ *                      lines of a shared chunk.
+ * \param shared        Set to true if a chunk was shared.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_checkpoint_share(
+    buffer_checkpoint_builder_t* b, buffer_cursor_t* cursor, bool* shared)
+{
+    *shared = false;
+    if (NULL == b->prev)
+        return 0;
+
+    size_t end = b->next + BUFFER_CHECKPOINT_LOOKAHEAD;
+    if (end > b->prev->chunk_count)
+        end = b->prev->chunk_count;
+
+    command_line_t first =
+        buffer_checkpoint_entry(*buffer_cursor_slot(cursor));
+    for (size_t k = b->next; k < end; ++k)
+    {
+        buffer_checkpoint_chunk_t* chunk = b->prev->chunks[k];
+        if (!buffer_checkpoint_same(&chunk->lines[0], &first))
+            continue;
+
+        size_t matched = 0U;
+        buffer_cursor_t i = *cursor;
+        while (matched < chunk->count && !buffer_cursor_done(&i))
+        {
+            command_line_t entry =
+                buffer_checkpoint_entry(*buffer_cursor_slot(&i));
+            if (!buffer_checkpoint_same(&chunk->lines[matched], &entry))
+                break;
+
+            ++matched;
+            buffer_cursor_next(&i);
+        }
+
+        if (matched < chunk->count)
+            continue;
+
+        if (0 != buffer_checkpoint_add(b, chunk))
+            return 1;
+
+        ++b->history->shared_count;
+        b->next = k + 1U;
+        *cursor = i;
+        *shared = true;
+
+        return 0;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Build a new chunk from the lines starting at the given cursor,
+ * copying the text of the lines which own it into the history's arena.
+ *
+ * \param b             The builder.
+ * \param cursor        The cursor at the next line, which is moved past the
+ *                      lines of the chunk.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_checkpoint_chunk(
+    buffer_checkpoint_builder_t* b, buffer_cursor_t* cursor)
+{
+    allocator_t* alloc = &b->history->arena.alloc;
+    size_t count = 0U;
+    buffer_cursor_t i = *cursor;
+
+    while (!buffer_cursor_done(&i) && count < BUFFER_CHECKPOINT_CHUNK)
+    {
+        const disposable_t* data = *buffer_cursor_slot(&i);
+        command_line_t entry = buffer_checkpoint_entry(data);
+
+        if (!buffer_is_region(data) &&
+            !string_is_view((const string_t*)data))
+        {
+            /* an empty copy still needs an address of its own. */
+            char* copy =
+                (char*)allocator_allocate(
+                    alloc, (0U == entry.length) ? 1U : entry.length);
+            if (NULL == copy)
+                return 1;
+
+            if (entry.length > 0U)
+                memcpy(copy, entry.data, entry.length);
+
+            entry.data = copy;
+            b->history->copied_bytes += entry.length;
+            ++b->copied;
+        }
+
+        b->scratch[count++] = entry;
+        buffer_cursor_next(&i);
+
+        if (buffer_checkpoint_boundary(&entry))
+            break;
+    }
+
+    buffer_checkpoint_chunk_t* chunk =
+        (buffer_checkpoint_chunk_t*)allocator_allocate(
+            alloc,
+            sizeof(buffer_checkpoint_chunk_t) +
+                count * sizeof(command_line_t));
+    if (NULL == chunk)
+        return 1;
+
+    chunk->count = count;
+    chunk->lines = (command_line_t*)(chunk + 1);
+    memcpy(chunk->lines, b->scratch, count * sizeof(command_line_t));
+
+    if (0 != buffer_checkpoint_add(b, chunk))
+        return 1;
+
+    ++b->history->chunk_count;
+    *cursor = i;
+
+    return 0;
+}
+
+/**
+ * \brief Add a chunk to the checkpoint being built.
+ *
+ * \param b             The builder.
+ * \param chunk         The chunk.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_checkpoint_add(
+    buffer_checkpoint_builder_t* b, buffer_checkpoint_chunk_t* chunk)
+{
+    if (b->chunk_count == b->chunk_capacity)
+    {
+        size_t capacity =
+            (0U == b->chunk_capacity) ? 64U : 2U * b->chunk_capacity;
+        buffer_checkpoint_chunk_t** chunks =
+            (buffer_checkpoint_chunk_t**)realloc(
+                b->chunks, capacity * sizeof(buffer_checkpoint_chunk_t*));
+        if (NULL == chunks)
+            return 1;
+
+        b->chunks = chunks;
+        b->chunk_capacity = capacity;
+    }
+
+    b->chunks[b->chunk_count++] = chunk;
+
+    return 0;
+}
+
+/**
+ * \brief Copy the checkpoint into the history's arena, and make it the last.
+ *
+ * \param b             The builder.
+ * \param stack         The undo stack.
+ * \param mark          The mark of the undo stack.
+ * \param time          The time of the command on top of the stack.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_checkpoint_finish(
+    buffer_checkpoint_builder_t* b, const command_stack_t* stack,
+    uint64_t mark, uint64_t time)
+{
+    allocator_t* alloc = &b->history->arena.alloc;
+    size_t chunks = b->chunk_count * sizeof(buffer_checkpoint_chunk_t*);
+
+    buffer_checkpoint_t* checkpoint =
+        (buffer_checkpoint_t*)allocator_allocate(
+            alloc, sizeof(buffer_checkpoint_t) + chunks);
+    if (NULL == checkpoint)
+        return 1;
+
+    checkpoint->prev = b->history->last;
+    checkpoint->depth = stack->count;
+    checkpoint->mark = mark;
+    checkpoint->time = time;
+    checkpoint->chunk_count = b->chunk_count;
+    checkpoint->chunks = (buffer_checkpoint_chunk_t**)(checkpoint + 1);
+    checkpoint->bytes = 0U;
+    if (chunks > 0U)
+        memcpy(checkpoint->chunks, b->chunks, chunks);
+
+    b->history->last = checkpoint;
+    ++b->history->checkpoint_count;
+
+    return 0;
+}
+
+/**
+ * \brief Make each line which owns its text a view of its copy in the
+ * checkpoint.  Shared chunks hold no such lines, so the copies are found by
+ * walking the lines and the checkpoint together.
+ *
+ * \param b             The builder.
+ * \param buffer        The buffer.
+ */
+static void buffer_checkpoint_views(
+    buffer_checkpoint_builder_t* b, const buffer_t* buffer)
+{
+    allocator_t* alloc = buffer_data_alloc(buffer);
+    size_t pending = b->copied;
+    buffer_cursor_t cursor;
+
+    buffer_cursor_first(buffer, &cursor);
+
+    for (size_t c = 0U; pending > 0U && c < b->chunk_count; ++c)
+    {
+        const buffer_checkpoint_chunk_t* chunk = b->chunks[c];
+        for (size_t i = 0U; pending > 0U && i < chunk->count; ++i)
+        {
+            disposable_t* data = *buffer_cursor_slot(&cursor);
+            string_t* str = (string_t*)data;
+            if (!buffer_is_region(data) && !string_is_view(str))
+            {
+                dispose(data);
+                string_init_view(
+                    str, alloc, chunk->lines[i].data, chunk->lines[i].length);
+                --pending;
+            }
+
+            buffer_cursor_next(&cursor);
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * \brief Release the lines and chunks of an unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Release the lines of an unrolled list, which must not be linked into
+ * a buffer, and then the list's chunks.
+ *
+ * \param list          The list.
+ * \param alloc         The allocator which owns the lines.
+ * \param owned         false if the lines own nothing outside of an arena,
+ *                      so that they are neither dispose()d nor released.
+ */
+void buffer_chunks_release(ulist_t* list, allocator_t* alloc, bool owned)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+
+    disposable_t* data;
+    while (0 == ulist_pop_back(list, &data))
+    {
+        if (owned)
+        {
+            dispose(data);
+            allocator_release_tagged(alloc, data, ALLOCATOR_TAG_LIST_DATA);
+        }
+    }
+
+    dispose((disposable_t*)list);
+}
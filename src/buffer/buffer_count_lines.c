@@ -0,0 +1,42 @@
+/**
+ * \brief Count the lines in a block of data.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Count the lines in size bytes of data.  Every newline ends a line,
+ * and so does the end of the data if the last line has no newline.
+ *
+ * \param level         The SIMD level to scan with.
+ * \param data          The data.
+ * \param size          The number of bytes.
+ *
+ * \returns the number of lines.
+ */
+size_t buffer_count_lines(simd_level_t level, const char* data, size_t size)
+{
+    size_t ends[READER_BATCH_LINES];
+    size_t crlf_count = 0U;
+    size_t lines = 0U;
+    size_t start = 0U;
+    size_t count;
+
+    do
+    {
+        count =
+            newline_scan_level(
+                level, data, size, start, ends, READER_BATCH_LINES,
+                &crlf_count);
+        lines += count;
+        if (count > 0U)
+            start = ends[count - 1U] + 1U;
+    } while (READER_BATCH_LINES == count);
+
+    return (start < size) ? lines + 1U : lines;
+}
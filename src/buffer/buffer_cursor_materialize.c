@@ -0,0 +1,30 @@
+/**
+ * \brief Materialize the region at a buffer cursor.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Materialize the region a cursor refers to, if it is one, leaving the
+ * cursor at the region's first line.
+ *
+ * \param buffer        The buffer.
+ * \param cursor        The cursor, which must refer to a line.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int buffer_cursor_materialize(buffer_t* buffer, buffer_cursor_t* cursor)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    /* an unrolled list never holds regions. */
+    if (NULL == cursor->node || !buffer_is_region(cursor->node->data))
+        return 0;
+
+    return buffer_materialize(buffer, cursor->node, &cursor->node);
+}
@@ -0,0 +1,97 @@
+/**
+ * \brief Find a line of a buffer by its index.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Find the line at the given zero-based index, materializing the
+ * region which holds it if need be.
+ *
+ * \param buffer        The buffer.
+ * \param index         The index of the line.
+ * \param cursor        Set to the line, or to the end of the lines if the
+ *                      index is the number of lines in the buffer.
+ *
+ * \returns 0 on success, or non-zero if the index is past the end of the
+ *          buffer or the region holding the line could not be materialized.
+ */
+int buffer_find_line(buffer_t* buffer, size_t index, buffer_cursor_t* cursor)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    cursor->node = NULL;
+    cursor->chunk = NULL;
+    cursor->index = 0U;
+
+    if (NULL != buffer->chunks)
+    {
+        if (index > buffer->chunks->size)
+            return 1;
+
+        if (index == buffer->chunks->size)
+            return 0;
+
+        ulist_pos_t pos;
+        ulist_at(buffer->chunks, index, &pos);
+        cursor->chunk = pos.chunk;
+        cursor->index = pos.index;
+
+        return 0;
+    }
+
+    /* a tree holds every line, as a lazily loaded buffer has none. */
+    if (NULL != buffer->tree)
+    {
+        disposable_t* entry;
+        if (index == buffer->lines->size)
+            return 0;
+
+        if (0 != ostree_at(buffer->tree, index, &entry))
+            return 1;
+
+        cursor->node = ((const buffer_tree_entry_t*)entry)->node;
+
+        return 0;
+    }
+
+    list_node_t* i = buffer->lines->head;
+    while (NULL != i)
+    {
+        if (!buffer_is_region(i->data))
+        {
+            if (0U == index)
+                break;
+
+            --index;
+            i = i->next;
+            continue;
+        }
+
+        /* skip a region which ends before the line. */
+        const buffer_region_t* region = (const buffer_region_t*)i->data;
+        size_t lines = buffer_index_lines(buffer->index, region->number);
+        if (index >= lines)
+        {
+            index -= lines;
+            i = i->next;
+            continue;
+        }
+
+        /* continue from the region's first line. */
+        if (0 != buffer_materialize(buffer, i, &i))
+            return 1;
+    }
+
+    if (NULL == i && 0U != index)
+        return 1;
+
+    cursor->node = i;
+
+    return 0;
+}
@@ -0,0 +1,519 @@
+/**
+ * \brief Compact the arena of a buffer's history.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Where something in the old arena moves to in the new one.
+ */
+typedef struct buffer_history_move
+{
+    const void* from;
+    void* to;
+    size_t size;
+} buffer_history_move_t;
+
+/**
+ * \brief A set of moves, sorted by where they move from once gathered.
+ */
+typedef struct buffer_history_moves
+{
+    buffer_history_move_t* moves;
+    size_t count;
+    size_t capacity;
+} buffer_history_moves_t;
+
+/* forward decls */
+static int buffer_history_compact_gather(
+    buffer_t* buffer, buffer_checkpoint_t** checkpoints,
+    buffer_history_moves_t* chunks, buffer_history_moves_t* texts);
+static int buffer_history_compact_copy(
+    buffer_history_t* history, buffer_checkpoint_t** checkpoints,
+    buffer_history_moves_t* chunks, buffer_history_moves_t* texts,
+    arena_t* fresh, buffer_checkpoint_t** last);
+static void* buffer_history_compact_chunk(
+    const buffer_checkpoint_chunk_t* chunk, buffer_history_moves_t* texts,
+    allocator_t* alloc);
+static void buffer_history_compact_views(
+    buffer_t* buffer, buffer_history_moves_t* texts);
+static int buffer_history_compact_ranges(
+    const arena_t* arena, buffer_history_moves_t* ranges);
+static bool buffer_history_compact_owned(
+    const buffer_history_moves_t* ranges, const void* ptr);
+static int buffer_history_compact_add(
+    buffer_history_moves_t* set, const void* from, size_t size);
+static void buffer_history_compact_sort(buffer_history_moves_t* set);
+static buffer_history_move_t* buffer_history_compact_find(
+    buffer_history_moves_t* set, const void* from);
+static int buffer_history_compact_compare(const void* x, const void* y);
+
+/**
+ * \brief Copy the checkpoints of a buffer's history, and the text in its arena
+ * which the buffer's lines view, into a new arena, which replaces the old
+ * one.  The views are moved to the copies.
+ *
+ * \param buffer        The buffer, which must keep a history.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the history
+ *          and the lines are unchanged.
+ */
+int buffer_history_compact(buffer_t* buffer)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL != buffer->history);
+
+    buffer_history_t* history = buffer->history;
+    buffer_history_moves_t chunks, texts;
+    memset(&chunks, 0, sizeof(chunks));
+    memset(&texts, 0, sizeof(texts));
+
+    /* the checkpoints are copied oldest first, so each can link to the last. */
+    size_t count = history->checkpoint_count;
+    buffer_checkpoint_t** checkpoints =
+        (buffer_checkpoint_t**)malloc(
+            (count + 1U) * sizeof(buffer_checkpoint_t*));
+    if (NULL == checkpoints)
+        return 1;
+
+    size_t k = count;
+    for (buffer_checkpoint_t* i = history->last; NULL != i; i = i->prev)
+    {
+        checkpoints[--k] = i;
+    }
+
+    arena_t fresh;
+    buffer_checkpoint_t* last = NULL;
+    int retval =
+        buffer_history_compact_gather(buffer, checkpoints, &chunks, &texts);
+    if (0 == retval)
+        retval = arena_init(&fresh, BUFFER_HISTORY_ARENA_CHUNK);
+
+    if (0 == retval)
+    {
+        retval =
+            buffer_history_compact_copy(
+                history, checkpoints, &chunks, &texts, &fresh, &last);
+        if (0 != retval)
+            dispose((disposable_t*)&fresh);
+    }
+
+    /* the lines only move once nothing else can fail. */
+    if (0 == retval)
+    {
+        buffer_history_compact_views(buffer, &texts);
+
+        dispose((disposable_t*)&history->arena);
+        history->arena = fresh;
+        history->last = last;
+        history->dropped_bytes = 0U;
+        ++history->compact_count;
+    }
+
+    free(checkpoints);
+    free(chunks.moves);
+    free(texts.moves);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return retval;
+}
+
+/**
+ * \brief Gather the chunks of the checkpoints, and the text in the arena which
+ * they and the buffer's lines view.
+ *
+ * \param buffer        The buffer.
+ * \param checkpoints   The checkpoints, oldest first.
+ * \param chunks        The set of chunks.
+ * \param texts         The set of texts.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_history_compact_gather(
+    buffer_t* buffer, buffer_checkpoint_t** checkpoints,
+    buffer_history_moves_t* chunks, buffer_history_moves_t* texts)
+{
+    buffer_history_moves_t ranges;
+    memset(&ranges, 0, sizeof(ranges));
+
+    /* every line is checked against the chunks, so they are sorted once. */
+    if (0 != buffer_history_compact_ranges(&buffer->history->arena, &ranges))
+    {
+        free(ranges.moves);
+        return 1;
+    }
+
+    int retval = 0;
+    for (size_t k = 0U; 0 == retval && k < buffer->history->checkpoint_count;
+         ++k)
+    {
+        const buffer_checkpoint_t* checkpoint = checkpoints[k];
+        for (size_t c = 0U; 0 == retval && c < checkpoint->chunk_count; ++c)
+        {
+            retval =
+                buffer_history_compact_add(chunks, checkpoint->chunks[c], 0U);
+        }
+    }
+
+    /* a shared chunk is only read once. */
+    buffer_history_compact_sort(chunks);
+    for (size_t c = 0U; 0 == retval && c < chunks->count; ++c)
+    {
+        const buffer_checkpoint_chunk_t* chunk =
+            (const buffer_checkpoint_chunk_t*)chunks->moves[c].from;
+        for (size_t i = 0U; 0 == retval && i < chunk->count; ++i)
+        {
+            const command_line_t* line = &chunk->lines[i];
+            if (NULL != line->data &&
+                buffer_history_compact_owned(&ranges, line->data))
+            {
+                retval =
+                    buffer_history_compact_add(
+                        texts, line->data, line->length);
+            }
+        }
+    }
+
+    buffer_cursor_t cursor;
+    for (buffer_cursor_first(buffer, &cursor);
+         0 == retval && !buffer_cursor_done(&cursor);
+         buffer_cursor_next(&cursor))
+    {
+        const disposable_t* data = *buffer_cursor_slot(&cursor);
+        const string_t* str = (const string_t*)data;
+        if (!buffer_is_region(data) && string_is_view(str) &&
+            buffer_history_compact_owned(&ranges, string_data(str)))
+        {
+            retval =
+                buffer_history_compact_add(
+                    texts, string_data(str), str->length);
+        }
+    }
+
+    buffer_history_compact_sort(texts);
+    free(ranges.moves);
+
+    return retval;
+}
+
+/**
+ * \brief Copy the checkpoints into the new arena, oldest first, followed by
+ * the text which only the buffer's lines view.  Each chunk and each text is
+ * copied once, however many checkpoints share it.
+ *
+ * \param history       The history.
+ * \param checkpoints   The checkpoints, oldest first.
+ * \param chunks        The set of chunks.
+ * \param texts         The set of texts.
+ * \param fresh         The new arena.
+ * \param last          Set to the copy of the newest checkpoint, or NULL.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_history_compact_copy(
+    buffer_history_t* history, buffer_checkpoint_t** checkpoints,
+    buffer_history_moves_t* chunks, buffer_history_moves_t* texts,
+    arena_t* fresh, buffer_checkpoint_t** last)
+{
+    allocator_t* alloc = &fresh->alloc;
+    const allocator_stats_t* stats = allocator_stats(alloc);
+    buffer_checkpoint_t* prev = NULL;
+
+    for (size_t k = 0U; k < history->checkpoint_count; ++k)
+    {
+        const buffer_checkpoint_t* checkpoint = checkpoints[k];
+        size_t live = stats->live_bytes;
+        size_t size =
+            checkpoint->chunk_count * sizeof(buffer_checkpoint_chunk_t*);
+
+        buffer_checkpoint_t* copy =
+            (buffer_checkpoint_t*)allocator_allocate(
+                alloc, sizeof(buffer_checkpoint_t) + size);
+        if (NULL == copy)
+            return 1;
+
+        memcpy(copy, checkpoint, sizeof(buffer_checkpoint_t));
+        copy->prev = prev;
+        copy->chunks = (buffer_checkpoint_chunk_t**)(copy + 1);
+        for (size_t c = 0U; c < checkpoint->chunk_count; ++c)
+        {
+            buffer_history_move_t* move =
+                buffer_history_compact_find(chunks, checkpoint->chunks[c]);
+            if (NULL == move->to)
+            {
+                move->to =
+                    buffer_history_compact_chunk(
+                        checkpoint->chunks[c], texts, alloc);
+                if (NULL == move->to)
+                    return 1;
+            }
+
+            copy->chunks[c] = (buffer_checkpoint_chunk_t*)move->to;
+        }
+
+        copy->bytes = stats->live_bytes - live;
+        prev = copy;
+    }
+
+    for (size_t t = 0U; t < texts->count; ++t)
+    {
+        buffer_history_move_t* move = &texts->moves[t];
+        if (NULL != move->to)
+            continue;
+
+        /* an empty copy still needs an address of its own. */
+        move->to =
+            allocator_allocate(alloc, (0U == move->size) ? 1U : move->size);
+        if (NULL == move->to)
+            return 1;
+
+        memcpy(move->to, move->from, move->size);
+    }
+
+    *last = prev;
+
+    return 0;
+}
+
+/**
+ * \brief Copy a chunk, copying the text in the old arena which it views unless
+ * an earlier chunk did.
+ *
+ * \param chunk         The chunk.
+ * \param texts         The set of texts.
+ * \param alloc         The new arena.
+ *
+ * \returns the copy, or NULL on failure.
+ */
+static void* buffer_history_compact_chunk(
+    const buffer_checkpoint_chunk_t* chunk, buffer_history_moves_t* texts,
+    allocator_t* alloc)
+{
+    buffer_checkpoint_chunk_t* copy =
+        (buffer_checkpoint_chunk_t*)allocator_allocate(
+            alloc,
+            sizeof(buffer_checkpoint_chunk_t) +
+                chunk->count * sizeof(command_line_t));
+    if (NULL == copy)
+        return NULL;
+
+    copy->count = chunk->count;
+    copy->lines = (command_line_t*)(copy + 1);
+    for (size_t i = 0U; i < chunk->count; ++i)
+    {
+        copy->lines[i] = chunk->lines[i];
+
+        buffer_history_move_t* move =
+            buffer_history_compact_find(texts, chunk->lines[i].data);
+        if (NULL == move)
+            continue;
+
+        if (NULL == move->to)
+        {
+            move->to =
+                allocator_allocate(
+                    alloc, (0U == move->size) ? 1U : move->size);
+            if (NULL == move->to)
+                return NULL;
+
+            memcpy(move->to, move->from, move->size);
+        }
+
+        copy->lines[i].data = (const char*)move->to;
+    }
+
+    return copy;
+}
+
+/**
+ * \brief Move the lines which view text in the old arena to its copies.
+ *
+ * \param buffer        The buffer.
+ * \param texts         The set of texts.
+ */
+static void buffer_history_compact_views(
+    buffer_t* buffer, buffer_history_moves_t* texts)
+{
+    allocator_t* alloc = buffer_data_alloc(buffer);
+    buffer_cursor_t cursor;
+
+    for (buffer_cursor_first(buffer, &cursor); !buffer_cursor_done(&cursor);
+         buffer_cursor_next(&cursor))
+    {
+        disposable_t* data = *buffer_cursor_slot(&cursor);
+        string_t* str = (string_t*)data;
+        if (buffer_is_region(data) || !string_is_view(str))
+            continue;
+
+        buffer_history_move_t* move =
+            buffer_history_compact_find(texts, string_data(str));
+        if (NULL == move)
+            continue;
+
+        size_t length = str->length;
+        dispose(data);
+        string_init_view(str, alloc, (const char*)move->to, length);
+    }
+}
+
+/**
+ * \brief Gather the address ranges of an arena's chunks, sorted by address.
+ *
+ * \param arena         The arena.
+ * \param ranges        The set of ranges, each from the start of a chunk.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_history_compact_ranges(
+    const arena_t* arena, buffer_history_moves_t* ranges)
+{
+    for (const arena_chunk_t* i = arena->chunks; NULL != i; i = i->link.next)
+    {
+        if (0 != buffer_history_compact_add(ranges, i + 1, i->link.size))
+            return 1;
+    }
+
+    buffer_history_compact_sort(ranges);
+
+    return 0;
+}
+
+/**
+ * \brief Check whether memory lies in one of a sorted set of ranges.
+ *
+ * \param ranges        The set of ranges.
+ * \param ptr           The memory.
+ *
+ * \returns true if the memory is in one of the ranges.
+ */
+static bool buffer_history_compact_owned(
+    const buffer_history_moves_t* ranges, const void* ptr)
+{
+    uintptr_t address = (uintptr_t)ptr;
+
+    /* find the first range which starts after the address. */
+    size_t low = 0U, high = ranges->count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2U;
+        if ((uintptr_t)ranges->moves[mid].from <= address)
+            low = mid + 1U;
+        else
+            high = mid;
+    }
+
+    if (0U == low)
+        return false;
+
+    const buffer_history_move_t* range = &ranges->moves[low - 1U];
+
+    return address - (uintptr_t)range->from < range->size;
+}
+
+/**
+ * \brief Add a move from the given address to a set.
+ *
+ * \param set           The set.
+ * \param from          The address.
+ * \param size          The number of bytes to move.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_history_compact_add(
+    buffer_history_moves_t* set, const void* from, size_t size)
+{
+    if (set->count == set->capacity)
+    {
+        size_t capacity = (0U == set->capacity) ? 256U : 2U * set->capacity;
+        buffer_history_move_t* moves =
+            (buffer_history_move_t*)realloc(
+                set->moves, capacity * sizeof(buffer_history_move_t));
+        if (NULL == moves)
+            return 1;
+
+        set->moves = moves;
+        set->capacity = capacity;
+    }
+
+    buffer_history_move_t* move = &set->moves[set->count++];
+    move->from = from;
+    move->to = NULL;
+    move->size = size;
+
+    return 0;
+}
+
+/**
+ * \brief Sort a set by where its moves are from, and merge the moves from the
+ * same address, keeping the largest size.
+ *
+ * \param set           The set.
+ */
+static void buffer_history_compact_sort(buffer_history_moves_t* set)
+{
+    if (0U == set->count)
+        return;
+
+    qsort(
+        set->moves, set->count, sizeof(buffer_history_move_t),
+        &buffer_history_compact_compare);
+
+    size_t out = 0U;
+    for (size_t i = 1U; i < set->count; ++i)
+    {
+        if (set->moves[i].from != set->moves[out].from)
+            set->moves[++out] = set->moves[i];
+        else if (set->moves[i].size > set->moves[out].size)
+            set->moves[out].size = set->moves[i].size;
+    }
+
+    set->count = out + 1U;
+}
+
+/**
+ * \brief Find the move from the given address in a sorted set.
+ *
+ * \param set           The set.
+ * \param from          The address.
+ *
+ * \returns the move, or NULL if there is none.
+ */
+static buffer_history_move_t* buffer_history_compact_find(
+    buffer_history_moves_t* set, const void* from)
+{
+    buffer_history_move_t key;
+    key.from = from;
+
+    if (0U == set->count)
+        return NULL;
+
+    return
+        (buffer_history_move_t*)bsearch(
+            &key, set->moves, set->count, sizeof(buffer_history_move_t),
+            &buffer_history_compact_compare);
+}
+
+/**
+ * \brief Compare two moves by where they are from.
+ *
+ * \param x             A move.
+ * \param y             Another move.
+ *
+ * \returns less than, equal to, or greater than 0 as x is from a lower, the
+ *          same, or a higher address than y.
+ */
+static int buffer_history_compact_compare(const void* x, const void* y)
+{
+    uintptr_t a = (uintptr_t)((const buffer_history_move_t*)x)->from;
+    uintptr_t b = (uintptr_t)((const buffer_history_move_t*)y)->from;
+
+    return (a > b) - (a < b);
+}
@@ -0,0 +1,44 @@
+/**
+ * \brief Drop the checkpoints deeper than the undo stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Drop the checkpoints of a buffer's history which are deeper than the
+ * undo stack now is, counting the bytes they took from the arena as dropped.
+ * The history is compacted once those are most of the arena, and at least a
+ * chunk of it; if that fails, it is tried again after the next drop.
+ *
+ * \param buffer        The buffer.
+ * \param depth         The depth of the undo stack.
+ */
+void buffer_history_drop(buffer_t* buffer, size_t depth)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    buffer_history_t* history = buffer->history;
+    if (NULL == history)
+        return;
+
+    bool dropped = false;
+    while (NULL != history->last && history->last->depth > depth)
+    {
+        history->dropped_bytes += history->last->bytes;
+        history->last = history->last->prev;
+        --history->checkpoint_count;
+        dropped = true;
+    }
+
+    size_t live = allocator_stats(&history->arena.alloc)->live_bytes;
+    if (dropped && history->dropped_bytes >= BUFFER_HISTORY_ARENA_CHUNK &&
+        history->dropped_bytes > live - history->dropped_bytes)
+    {
+        buffer_history_compact(buffer);
+    }
+}
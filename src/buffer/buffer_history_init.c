@@ -0,0 +1,86 @@
+/**
+ * \brief Keep a history of checkpoints of a buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <string.h>
+
+/* forward decls */
+static void buffer_history_dispose(disposable_t* disp);
+
+/**
+ * Keep a history of checkpoints of the buffer, one every interval commands,
+ * starting with one of the buffer as it is now.
+ *
+ * Each checkpoint records every line of the buffer, without copying those
+ * which view text that never changes.  A line which owns its text is copied
+ * into the history once, and then becomes a view of that copy, so that later
+ * checkpoints share it too.  Runs of lines which are the same as in the
+ * previous checkpoint share its chunks, so an unchanged part of the buffer
+ * costs nothing.  Checkpoints are taken by buffer_replace(), and undoing a
+ * change drops those which are newer than the stack.  Once dropped
+ * checkpoints hold most of the history's arena, what is left is compacted
+ * into a new one.  The undo stack must only be changed through the buffer's
+ * methods while it keeps a history.
+ *
+ * \param buffer            The buffer, which must have an undo stack.
+ * \param interval          The number of commands between checkpoints, or 0
+ *                          for \ref BUFFER_HISTORY_INTERVAL.
+ *
+ * \returns 0 on success, or non-zero on failure, including if the buffer has
+ *          no undo stack or already keeps a history.
+ */
+int buffer_history_init(buffer_t* buffer, size_t interval)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    if (NULL == buffer->undo_commands || NULL != buffer->history)
+        return 1;
+
+    buffer_history_t* history =
+        (buffer_history_t*)allocator_allocate(
+            buffer->allocator, sizeof(buffer_history_t));
+    if (NULL == history)
+        return 1;
+
+    memset(history, 0, sizeof(buffer_history_t));
+    history->hdr.dispose = &buffer_history_dispose;
+    history->interval = (0U == interval) ? BUFFER_HISTORY_INTERVAL : interval;
+
+    if (0 != arena_init(&history->arena, BUFFER_HISTORY_ARENA_CHUNK))
+    {
+        allocator_release(buffer->allocator, history);
+        return 1;
+    }
+
+    /* the first checkpoint leaves the lines as they were if it fails. */
+    buffer->history = history;
+    if (0 != buffer_checkpoint(buffer))
+    {
+        buffer->history = NULL;
+        dispose((disposable_t*)history);
+        allocator_release(buffer->allocator, history);
+        return 1;
+    }
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a history, releasing its arena.
+ *
+ * \param disp      The history to dispose.
+ */
+static void buffer_history_dispose(disposable_t* disp)
+{
+    buffer_history_t* history = (buffer_history_t*)disp;
+
+    dispose((disposable_t*)&history->arena);
+    history->last = NULL;
+}
@@ -0,0 +1,37 @@
+/**
+ * \brief Get the line count of a region of a lazily loaded file.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Get the number of lines in the given region, counting them now if
+ * the background thread has not done so yet.
+ *
+ * \param index         The index.
+ * \param number        The number of the region.
+ *
+ * \returns the number of lines in the region.
+ */
+size_t buffer_index_lines(buffer_index_t* index, size_t number)
+{
+    MODEL_ASSERT(number < index->region_count);
+
+    size_t lines = __atomic_load_n(&index->lines[number], __ATOMIC_ACQUIRE);
+    if (BUFFER_INDEX_UNCOUNTED != lines)
+        return lines;
+
+    size_t offset = index->bounds[number];
+    lines =
+        buffer_count_lines(
+            index->level, index->data + offset,
+            index->bounds[number + 1U] - offset);
+    __atomic_store_n(&index->lines[number], lines, __ATOMIC_RELEASE);
+
+    return lines;
+}
@@ -0,0 +1,281 @@
+/**
+ * \brief Initialize a buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void buffer_dispose(disposable_t* disp);
+
+/**
+ * Initialize a buffer from an allocator, a line list, a command stack,
+ * and a command queue.
+ *
+ * Buffer takes ownership of the line list, the command stack, and the command
+ * queue. It will dispose() these when done, and it assumes that the allocator
+ * can free these items.  The command stack and the command queue may be NULL
+ * if the buffer does not track undo or redo.
+ *
+ * When the buffer creates its own empty line list, both the list and its
+ * lines belong to the allocator.  With an \ref arena_t, the whole buffer can
+ * then be released at once by dispose()ing the arena after the buffer.  The
+ * statistics of the allocator measure the buffer's memory; those of the
+ * shared system allocator include every other user of it, so a buffer whose
+ * memory is measured alone is given a \ref heap_t or an arena of its own.
+ *
+ * \param buffer            The buffer to initialize;
+ * \param allocator         The allocator to use for allocating lines and
+ *                          freeing the structures it takes ownership of.
+ * \param lines             The lines to assign to this buffer, or NULL to
+ *                          create an empty buffer.
+ * \param undo_commands     A command stack to use to undo commands applied to
+ *                          the lines in this buffer.
+ * \param redo_commands     A command queue to use to redo commands applied to
+ *                          the lines in this buffer.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure.
+ */
+int buffer_init(
+    buffer_t* buffer, allocator_t* allocator, list_t* lines,
+    command_stack_t* undo_commands, command_queue_t* redo_commands)
+{
+    MODEL_ASSERT(NULL != buffer);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(allocator));
+
+    /* create an empty line list if one wasn't given. */
+    if (NULL == lines)
+    {
+        lines = (list_t*)allocator_allocate(allocator, sizeof(list_t));
+        if (NULL == lines)
+            return 1;
+
+        if (0 != list_init_allocator(lines, allocator))
+        {
+            allocator_release(allocator, lines);
+            return 1;
+        }
+    }
+
+    /* clear the buffer. */
+    memset(buffer, 0, sizeof(buffer_t));
+
+    /* set our dispose method. */
+    buffer->hdr.dispose = &buffer_dispose;
+    buffer->allocator = allocator;
+    buffer->lines = lines;
+    buffer->undo_commands = undo_commands;
+    buffer->redo_commands = redo_commands;
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
+
+/**
+ * Initialize a buffer in arena mode, in which the lines, the list nodes, and
+ * the command records all come from the given arena, and the buffer owns that
+ * arena.
+ *
+ * Disposing a buffer in arena mode releases the arena's chunks in bulk rather
+ * than releasing each line and node.  The line list is NOT walked, so lines in
+ * an arena mode buffer must not own any resources outside of the arena; their
+ * dispose methods are not called.  The command stack and command queue are
+ * still dispose()d, so that they can release any external resources, but
+ * their memory is reclaimed with the arena.  So is a source reader, which is
+ * dispose()d first so that it can release its mapping.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param arena             The arena to own, which must have been allocated
+ *                          via malloc().
+ * \param lines             The lines to assign to this buffer, which must use
+ *                          the arena for nodes and data, or NULL to create an
+ *                          empty buffer.
+ * \param undo_commands     A command stack allocated from the arena, or NULL.
+ * \param redo_commands     A command queue allocated from the arena, or NULL.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure, in which case the caller retains ownership of the arena.
+ */
+int buffer_init_arena(
+    buffer_t* buffer, arena_t* arena, list_t* lines,
+    command_stack_t* undo_commands, command_queue_t* redo_commands)
+{
+    MODEL_ASSERT(NULL != buffer);
+    MODEL_ASSERT(PROP_VALID_ARENA(arena));
+    MODEL_ASSERT(
+        NULL == lines ||
+        (&arena->alloc == lines->node_alloc &&
+         &arena->alloc == lines->data_alloc));
+
+    if (0 !=
+            buffer_init(
+                buffer, &arena->alloc, lines, undo_commands, redo_commands))
+        return 1;
+
+    /* the buffer now owns the arena. */
+    buffer->arena = arena;
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
+
+/**
+ * Initialize a buffer with the lines of the file at the given path, without
+ * copying them.
+ *
+ * The file is memory mapped, and each line is a \ref string_t view of the
+ * mapping, which is copied into storage of its own when it is first changed.
+ * Opening a file only costs a scan of its contents and a string and a node per
+ * line, and the pages of the file are clean, so memory grows with the edits
+ * made rather than the size of the file.  The buffer owns the mapping and
+ * releases it after its lines.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param allocator         The allocator for the lines, the line list, and
+ *                          the reader.
+ * \param path              The path of the file to open.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure, including if the file is not valid UTF-8.
+ */
+int buffer_init_file(
+    buffer_t* buffer, allocator_t* allocator, const char* path)
+{
+    MODEL_ASSERT(NULL != buffer);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(allocator));
+    MODEL_ASSERT(NULL != path);
+
+    /* the buffer creates an empty list, which receives views of the lines. */
+    if (0 != buffer_init(buffer, allocator, NULL, NULL, NULL))
+        return 1;
+
+    reader_t* source =
+        (reader_t*)allocator_allocate(buffer->allocator, sizeof(reader_t));
+    if (NULL == source)
+    {
+        dispose((disposable_t*)buffer);
+        return 1;
+    }
+
+    if (0 != reader_init_mmap(source, path))
+    {
+        allocator_release(buffer->allocator, source);
+        dispose((disposable_t*)buffer);
+        return 1;
+    }
+
+    buffer->source = source;
+
+    if (0 != reader_read_views(source, buffer->lines))
+    {
+        dispose((disposable_t*)buffer);
+        return 1;
+    }
+
+    buffer->crlf = buffer_detect_crlf(source->line_count, source->crlf_count);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a buffer, and release the structures it owns to its
+ * allocator.  In arena mode, the arena is released in bulk instead.
+ *
+ * \param disp      The buffer to dispose.
+ */
+static void buffer_dispose(disposable_t* disp)
+{
+    buffer_t* buffer = (buffer_t*)disp;
+
+    /* we are disposing a valid buffer. */
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    /* the tree's entries are not in the arena. */
+    if (NULL != buffer->tree)
+    {
+        dispose((disposable_t*)buffer->tree);
+        allocator_release(buffer->allocator, buffer->tree);
+    }
+
+    /* the index's thread reads the source, so it is stopped first. */
+    if (NULL != buffer->index)
+    {
+        dispose((disposable_t*)buffer->index);
+        allocator_release(buffer->allocator, buffer->index);
+    }
+
+    if (NULL != buffer->arena)
+    {
+        /* the commands may hold resources outside of the arena. */
+        if (NULL != buffer->undo_commands)
+            dispose((disposable_t*)buffer->undo_commands);
+        if (NULL != buffer->redo_commands)
+            dispose((disposable_t*)buffer->redo_commands);
+
+        /* the lines may view the source, which must still be unmapped. */
+        if (NULL != buffer->source)
+            dispose((disposable_t*)buffer->source);
+
+        /* so may the history, whose own arena is released the same way. */
+        if (NULL != buffer->history)
+            dispose((disposable_t*)buffer->history);
+
+        /* the chunks of an unrolled list are not in the arena. */
+        if (NULL != buffer->chunks)
+            buffer_chunks_release(buffer->chunks, buffer->allocator, false);
+
+        /* everything else is released with the arena's chunks. */
+        dispose((disposable_t*)buffer->arena);
+        free(buffer->arena);
+
+        return;
+    }
+
+    if (NULL != buffer->chunks)
+    {
+        buffer_chunks_release(buffer->chunks, buffer->allocator, true);
+        allocator_release(buffer->allocator, buffer->chunks);
+    }
+    else
+    {
+        dispose((disposable_t*)buffer->lines);
+        allocator_release(buffer->allocator, buffer->lines);
+    }
+
+    if (NULL != buffer->undo_commands)
+    {
+        dispose((disposable_t*)buffer->undo_commands);
+        allocator_release(buffer->allocator, buffer->undo_commands);
+    }
+
+    if (NULL != buffer->redo_commands)
+    {
+        dispose((disposable_t*)buffer->redo_commands);
+        allocator_release(buffer->allocator, buffer->redo_commands);
+    }
+
+    /* the lines may view the history, so it is released after them. */
+    if (NULL != buffer->history)
+    {
+        dispose((disposable_t*)buffer->history);
+        allocator_release(buffer->allocator, buffer->history);
+    }
+
+    /* the lines may view the source, so it is released last. */
+    if (NULL != buffer->source)
+    {
+        dispose((disposable_t*)buffer->source);
+        allocator_release(buffer->allocator, buffer->source);
+    }
+}
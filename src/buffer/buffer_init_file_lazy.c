@@ -0,0 +1,260 @@
+/**
+ * \brief Initialize a buffer from a file whose lines are parsed on demand.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+#include <string.h>
+
+/* forward decls */
+static int buffer_index_create(
+    buffer_index_t** index, allocator_t* alloc, const reader_t* source,
+    size_t region_size);
+static void* buffer_index_run(void* context);
+static void buffer_index_dispose(disposable_t* disp);
+static int buffer_push_regions(buffer_t* buffer);
+
+/**
+ * Initialize a buffer with the file at the given path, parsing its lines only
+ * when they are needed.
+ *
+ * The file is memory mapped without being read, and split at newlines into
+ * regions of about region_size bytes, each of which is a single
+ * \ref buffer_region_t in the line list.  A background thread counts the
+ * lines of each region in turn.  A region is parsed into \ref string_t views,
+ * and its UTF-8 is validated, only when buffer_materialize() is called on it,
+ * as buffer_line_at() does.  Opening a file, and reaching any line of it,
+ * therefore costs time and memory in proportion to the regions touched rather
+ * than the size of the file.  Only the first line is read up front, to decide
+ * whether the lines are saved with CRLF.
+ *
+ * Until every region is materialized, the line list holds both lines and
+ * regions, which buffer_is_region() tells apart, and its size counts each
+ * region once.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param allocator         The allocator for the lines, the regions, the line
+ *                          list, the reader, and the index.
+ * \param path              The path of the file to open.
+ * \param region_size       The size of each region, or 0 for
+ *                          \ref BUFFER_LAZY_REGION_SIZE.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure.
+ */
+int buffer_init_file_lazy(
+    buffer_t* buffer, allocator_t* allocator, const char* path,
+    size_t region_size)
+{
+    MODEL_ASSERT(NULL != buffer);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(allocator));
+    MODEL_ASSERT(NULL != path);
+
+    if (0U == region_size)
+        region_size = BUFFER_LAZY_REGION_SIZE;
+
+    if (0 != buffer_init(buffer, allocator, NULL, NULL, NULL))
+        return 1;
+
+    reader_t* source =
+        (reader_t*)allocator_allocate(buffer->allocator, sizeof(reader_t));
+    if (NULL == source)
+    {
+        dispose((disposable_t*)buffer);
+        return 1;
+    }
+
+    /* nothing is read until a region is needed. */
+    if (0 != reader_init_mmap_unchecked(source, path))
+    {
+        allocator_release(buffer->allocator, source);
+        dispose((disposable_t*)buffer);
+        return 1;
+    }
+
+    buffer->source = source;
+
+    /* only the first line is read now, and it decides the line ending. */
+    const char* newline =
+        (0U == source->size)
+            ? NULL
+            : (const char*)memchr(source->data, '\n', source->size);
+    buffer->crlf =
+        NULL != newline && newline > source->data && '\r' == newline[-1];
+
+    if (0 !=
+            buffer_index_create(
+                &buffer->index, buffer->allocator, source, region_size) ||
+        0 != buffer_push_regions(buffer))
+    {
+        dispose((disposable_t*)buffer);
+        return 1;
+    }
+
+    /* the lines are counted in the background; if that can't start, they
+     * are counted as they are needed instead. */
+    buffer->index->started =
+        0 ==
+            pthread_create(
+                &buffer->index->thread, NULL, &buffer_index_run,
+                buffer->index);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
+
+/**
+ * \brief Create the index of a source, splitting it into regions which end
+ * with newlines.
+ *
+ * \param index         Set to the new index.
+ * \param alloc         The allocator for the index.
+ * \param source        The source to split.
+ * \param region_size   The size of each region.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_index_create(
+    buffer_index_t** index, allocator_t* alloc, const reader_t* source,
+    size_t region_size)
+{
+    /* every region but the last is at least region_size bytes long. */
+    size_t max_regions = source->size / region_size + 1U;
+
+    buffer_index_t* idx =
+        (buffer_index_t*)allocator_allocate(alloc, sizeof(buffer_index_t));
+    if (NULL == idx)
+        return 1;
+
+    memset(idx, 0, sizeof(buffer_index_t));
+    idx->hdr.dispose = &buffer_index_dispose;
+    idx->alloc = alloc;
+    idx->data = source->data;
+    idx->level = source->level;
+    idx->bounds =
+        (size_t*)allocator_allocate(
+            alloc, (max_regions + 1U) * sizeof(size_t));
+    idx->lines =
+        (size_t*)allocator_allocate(alloc, max_regions * sizeof(size_t));
+    if (NULL == idx->bounds || NULL == idx->lines)
+    {
+        dispose((disposable_t*)idx);
+        allocator_release(alloc, idx);
+        return 1;
+    }
+
+    /* each region ends with the first newline after region_size bytes. */
+    size_t offset = 0U;
+    while (offset < source->size)
+    {
+        size_t end = source->size;
+        if (source->size - offset > region_size)
+        {
+            size_t target = offset + region_size - 1U;
+            const char* newline =
+                (const char*)memchr(
+                    source->data + target, '\n', source->size - target);
+            if (NULL != newline)
+                end = (size_t)(newline - source->data) + 1U;
+        }
+
+        idx->bounds[idx->region_count] = offset;
+        idx->lines[idx->region_count] = BUFFER_INDEX_UNCOUNTED;
+        ++idx->region_count;
+        offset = end;
+    }
+
+    idx->bounds[idx->region_count] = source->size;
+    *index = idx;
+
+    return 0;
+}
+
+/**
+ * \brief Add a region to the buffer's line list for each region of its index.
+ *
+ * \param buffer        The buffer.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_push_regions(buffer_t* buffer)
+{
+    const buffer_index_t* index = buffer->index;
+
+    for (size_t i = 0U; i < index->region_count; ++i)
+    {
+        buffer_region_t* region =
+            (buffer_region_t*)allocator_allocate_tagged(
+                buffer->allocator, sizeof(buffer_region_t),
+                ALLOCATOR_TAG_LIST_DATA);
+        if (NULL == region)
+            return 1;
+
+        region->hdr.dispose = &buffer_region_dispose;
+        region->offset = index->bounds[i];
+        region->size = index->bounds[i + 1U] - index->bounds[i];
+        region->number = i;
+
+        if (0 != list_push_back(buffer->lines, (disposable_t*)region))
+        {
+            allocator_release_tagged(
+                buffer->allocator, region, ALLOCATOR_TAG_LIST_DATA);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Count the lines of each region in turn, until every region is
+ * counted or the index is dispose()d.
+ *
+ * \param context   The index.
+ *
+ * \returns NULL.
+ */
+static void* buffer_index_run(void* context)
+{
+    buffer_index_t* index = (buffer_index_t*)context;
+
+    for (size_t i = 0U;
+         i < index->region_count &&
+         !__atomic_load_n(&index->stop, __ATOMIC_ACQUIRE);
+         ++i)
+    {
+        buffer_index_lines(index, i);
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Dispose of an index, stopping its background thread.
+ *
+ * \param disp      The index to dispose.
+ */
+static void buffer_index_dispose(disposable_t* disp)
+{
+    buffer_index_t* index = (buffer_index_t*)disp;
+
+    /* the thread finishes the region it is counting, and then stops. */
+    if (index->started)
+    {
+        __atomic_store_n(&index->stop, 1, __ATOMIC_RELEASE);
+        pthread_join(index->thread, NULL);
+        index->started = false;
+    }
+
+    if (NULL != index->bounds)
+        allocator_release(index->alloc, index->bounds);
+    if (NULL != index->lines)
+        allocator_release(index->alloc, index->lines);
+}
@@ -0,0 +1,301 @@
+/**
+ * \brief Initialize a buffer from a file using several threads.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * \brief The state of a single worker: the range of the file it validates and
+ * reads, and the arena and list it fills.
+ */
+typedef struct buffer_load_worker
+{
+    pthread_t thread;
+    const reader_t* source;
+    size_t offset;
+    size_t size;
+    reader_t range;
+    arena_t arena;
+    list_t lines;
+    allocator_t* view_alloc;
+    int result;
+} buffer_load_worker_t;
+
+/* forward decls */
+static void* buffer_load_worker_run(void* context);
+static size_t buffer_load_worker_count(size_t size, size_t workers);
+static void buffer_load_workers_dispose(
+    buffer_load_worker_t* worker, size_t count);
+
+/**
+ * Initialize a buffer in arena mode with the lines of the file at the given
+ * path, which are found by several threads at once.
+ *
+ * The file is memory mapped without being read, and then split at newlines
+ * into one chunk per worker.  Each worker validates its chunk's UTF-8 and
+ * builds a list of views of its lines, allocating the nodes and strings from
+ * an arena of its own, so that the workers never contend on an allocator.
+ * The worker arenas are then adopted by the buffer's arena, and the lists are
+ * spliced together in order.  Small files use fewer workers, so that each has
+ * at least \ref BUFFER_PARALLEL_MIN_CHUNK bytes to scan.
+ *
+ * \param buffer            The buffer to initialize.
+ * \param path              The path of the file to open.
+ * \param workers           The number of threads to use, or 0 to use one per
+ *                          online processor.
+ *
+ * \returns 0 if this structure was successfully initialized, or non-zero on
+ *          failure, including if the file is not valid UTF-8.
+ */
+int buffer_init_file_parallel(
+    buffer_t* buffer, const char* path, size_t workers)
+{
+    MODEL_ASSERT(NULL != buffer);
+    MODEL_ASSERT(NULL != path);
+
+    arena_t* arena = (arena_t*)malloc(sizeof(arena_t));
+    if (NULL == arena)
+        return 1;
+
+    if (0 != arena_init(arena, BUFFER_PARALLEL_ARENA_CHUNK))
+    {
+        free(arena);
+        return 1;
+    }
+
+    /* the contents are validated by the workers, a range each. */
+    reader_t* source =
+        (reader_t*)allocator_allocate(&arena->alloc, sizeof(reader_t));
+    if (NULL == source || 0 != reader_init_mmap_unchecked(source, path))
+    {
+        dispose((disposable_t*)arena);
+        free(arena);
+        return 1;
+    }
+
+    size_t count = buffer_load_worker_count(source->size, workers);
+    buffer_load_worker_t* worker =
+        (buffer_load_worker_t*)calloc(count, sizeof(buffer_load_worker_t));
+    if (NULL == worker)
+    {
+        dispose((disposable_t*)source);
+        dispose((disposable_t*)arena);
+        free(arena);
+        return 1;
+    }
+
+    /* split the contents into count ranges of whole lines. */
+    size_t ready = 0U;
+    size_t offset = 0U;
+    int retval = 0;
+    for (; ready < count; ++ready)
+    {
+        buffer_load_worker_t* w = &worker[ready];
+        size_t end = source->size;
+        if (ready + 1U < count)
+        {
+            size_t target = (source->size / count) * (ready + 1U);
+            if (target < offset)
+                target = offset;
+
+            const char* newline =
+                (const char*)memchr(
+                    source->data + target, '\n', source->size - target);
+            if (NULL != newline)
+                end = (size_t)(newline - source->data) + 1U;
+        }
+
+        /* the range is empty until the worker validates it. */
+        w->source = source;
+        w->offset = offset;
+        w->size = end - offset;
+        reader_init_memory(&w->range, NULL, 0U);
+        if (0 != arena_init(&w->arena, BUFFER_PARALLEL_ARENA_CHUNK))
+        {
+            dispose((disposable_t*)&w->range);
+            retval = 1;
+            break;
+        }
+
+        if (0 != list_init_allocator(&w->lines, &w->arena.alloc))
+        {
+            dispose((disposable_t*)&w->range);
+            dispose((disposable_t*)&w->arena);
+            retval = 1;
+            break;
+        }
+
+        w->view_alloc = &arena->alloc;
+        offset = end;
+
+        /* the first range is read on this thread, after the others start. */
+        if (ready > 0U &&
+            0 != pthread_create(&w->thread, NULL, &buffer_load_worker_run, w))
+        {
+            dispose((disposable_t*)&w->range);
+            dispose((disposable_t*)&w->arena);
+            retval = 1;
+            break;
+        }
+    }
+
+    if (0 == retval)
+        buffer_load_worker_run(&worker[0]);
+
+    for (size_t i = 1U; i < ready; ++i)
+    {
+        pthread_join(worker[i].thread, NULL);
+    }
+
+    for (size_t i = 0U; 0 == retval && i < count; ++i)
+    {
+        retval = worker[i].result;
+    }
+
+    if (0 != retval ||
+        0 != buffer_init_arena(buffer, arena, NULL, NULL, NULL))
+    {
+        buffer_load_workers_dispose(worker, ready);
+        free(worker);
+        dispose((disposable_t*)source);
+        dispose((disposable_t*)arena);
+        free(arena);
+        return 1;
+    }
+
+    buffer->source = source;
+
+    /* the buffer's arena takes each worker's memory, and the lines follow. */
+    size_t line_count = 0U;
+    size_t crlf_count = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        line_count += worker[i].range.line_count;
+        crlf_count += worker[i].range.crlf_count;
+
+        arena_adopt(arena, &worker[i].arena);
+        worker[i].lines.node_alloc = worker[i].lines.data_alloc =
+            &arena->alloc;
+        list_splice(buffer->lines, &worker[i].lines);
+    }
+
+    buffer->crlf = buffer_detect_crlf(line_count, crlf_count);
+
+    buffer_load_workers_dispose(worker, count);
+    free(worker);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
+
+/**
+ * \brief Validate a worker's range, and read every line of it into its list of
+ * views.
+ *
+ * The strings and nodes are allocated from the worker's arena, but each
+ * string belongs to the buffer's arena, which copies it when it is first
+ * changed, as the worker's arena is emptied once the load is complete.
+ *
+ * \param context   The worker.
+ *
+ * \returns NULL.
+ */
+static void* buffer_load_worker_run(void* context)
+{
+    buffer_load_worker_t* worker = (buffer_load_worker_t*)context;
+    allocator_t* alloc = &worker->arena.alloc;
+    reader_batch_t batch;
+    disposable_t* strings[READER_BATCH_LINES];
+
+    if (0 !=
+            reader_init_range(
+                &worker->range, worker->source, worker->offset,
+                worker->size) ||
+        !worker->range.valid_utf8)
+    {
+        worker->result = 1;
+        return NULL;
+    }
+
+    for (reader_next_batch(&worker->range, &batch); batch.count > 0U;
+         reader_next_batch(&worker->range, &batch))
+    {
+        for (size_t i = 0U; i < batch.count; ++i)
+        {
+            string_t* str =
+                (string_t*)allocator_allocate_tagged(
+                    alloc, sizeof(string_t), ALLOCATOR_TAG_LIST_DATA);
+            if (NULL == str)
+            {
+                worker->result = 1;
+                return NULL;
+            }
+
+            string_init_view(
+                str, worker->view_alloc, batch.lines[i].data,
+                batch.lines[i].length);
+            strings[i] = (disposable_t*)str;
+        }
+
+        /* the arena reclaims the strings if this fails. */
+        if (0 != list_push_back_many(&worker->lines, strings, batch.count))
+        {
+            worker->result = 1;
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Decide how many workers load a file of the given size.
+ *
+ * \param size      The size of the file.
+ * \param workers   The number of workers requested, or 0 for one per online
+ *                  processor.
+ *
+ * \returns the number of workers, which is at least 1.
+ */
+static size_t buffer_load_worker_count(size_t size, size_t workers)
+{
+    if (0U == workers)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (online > 0) ? (size_t)online : 1U;
+    }
+
+    /* each worker should have enough to scan to pay for its thread. */
+    size_t max_workers = size / BUFFER_PARALLEL_MIN_CHUNK + 1U;
+
+    return (workers < max_workers) ? workers : max_workers;
+}
+
+/**
+ * \brief Dispose of the workers' ranges and arenas.  The lines in the
+ * workers' lists are reclaimed with their arenas.
+ *
+ * \param worker    The array of workers.
+ * \param count     The number of workers.
+ */
+static void buffer_load_workers_dispose(
+    buffer_load_worker_t* worker, size_t count)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        dispose((disposable_t*)&worker[i].range);
+        dispose((disposable_t*)&worker[i].arena);
+    }
+}
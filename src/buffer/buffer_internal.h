@@ -0,0 +1,284 @@
+/**
+ * \brief Internal definitions shared by the buffer methods.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_BUFFER_INTERNAL_HEADER_GUARD
+# define EJ_BUFFER_INTERNAL_HEADER_GUARD
+
+#include <ej/buffer.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * \brief The line count of a region which has not been counted yet.
+ */
+#define BUFFER_INDEX_UNCOUNTED SIZE_MAX
+
+/**
+ * The line index of a lazily loaded file holds the bounds of each of its
+ * regions, and the number of lines in each, which a background thread fills
+ * in.  The bounds never change once the index is created; the line counts are
+ * only accessed atomically, as either thread may count a region.  The index
+ * refers to regions by number, so that the regions themselves can be
+ * materialized and released while the thread runs.
+ */
+struct buffer_index
+{
+    disposable_t hdr;
+    allocator_t* alloc;
+    const char* data;
+    simd_level_t level;
+    size_t region_count;
+    size_t* bounds;
+    size_t* lines;
+
+    pthread_t thread;
+    bool started;
+    int stop;
+};
+
+/**
+ * \brief Count the lines in size bytes of data.  Every newline ends a line,
+ * and so does the end of the data if the last line has no newline.
+ *
+ * \param level         The SIMD level to scan with.
+ * \param data          The data.
+ * \param size          The number of bytes.
+ *
+ * \returns the number of lines.
+ */
+size_t buffer_count_lines(simd_level_t level, const char* data, size_t size);
+
+/**
+ * \brief Decide whether a file's lines end with CRLF, given how many of its
+ * lines were read and how many of those ended with CRLF.  Most must.
+ *
+ * \param line_count    The number of lines.
+ * \param crlf_count    The number of lines which ended with CRLF.
+ *
+ * \returns true if the lines end with CRLF.
+ */
+static inline bool buffer_detect_crlf(size_t line_count, size_t crlf_count)
+{
+    return crlf_count > 0U && crlf_count >= line_count - crlf_count;
+}
+
+/**
+ * \brief Get the number of lines in the given region, counting them now if
+ * the background thread has not done so yet.
+ *
+ * \param index         The index.
+ * \param number        The number of the region.
+ *
+ * \returns the number of lines in the region.
+ */
+size_t buffer_index_lines(buffer_index_t* index, size_t number);
+
+/**
+ * An entry of a buffer's tree refers to a node of its line list.  Entries are
+ * allocated with malloc(), as the tree free()s them, and own nothing.
+ */
+typedef struct buffer_tree_entry
+{
+    disposable_t hdr;
+    list_node_t* node;
+} buffer_tree_entry_t;
+
+/**
+ * \brief Append an entry for each node from first up to end to a tree of
+ * list nodes, which is left as it was if this fails.
+ *
+ * \param tree          The tree.
+ * \param first         The first node.
+ * \param end           The node after the last, or NULL.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int buffer_tree_add(ostree_t* tree, list_node_t* first, list_node_t* end);
+
+/**
+ * A buffer cursor refers to a line of a buffer, or to the end of its lines,
+ * by its node when the buffer keeps a list, and by its chunk and index when it
+ * keeps an unrolled list.  Any change to the lines, other than replacing the
+ * value a cursor refers to, invalidates it.
+ */
+typedef struct buffer_cursor
+{
+    list_node_t* node;
+    ulist_chunk_t* chunk;
+    size_t index;
+} buffer_cursor_t;
+
+/**
+ * \brief Get the allocator which owns the lines of a buffer.
+ *
+ * \param buffer        The buffer.
+ *
+ * \returns the allocator.
+ */
+static inline allocator_t* buffer_data_alloc(const buffer_t* buffer)
+{
+    return (NULL == buffer->chunks) ? buffer->lines->data_alloc
+                                    : buffer->allocator;
+}
+
+/**
+ * \brief Set a cursor to the first line of a buffer.
+ *
+ * \param buffer        The buffer.
+ * \param cursor        The cursor.
+ */
+static inline void buffer_cursor_first(
+    const buffer_t* buffer, buffer_cursor_t* cursor)
+{
+    cursor->node = (NULL == buffer->chunks) ? buffer->lines->head : NULL;
+    cursor->chunk = (NULL == buffer->chunks) ? NULL : buffer->chunks->head;
+    cursor->index = 0U;
+}
+
+/**
+ * \brief Check whether a cursor is past the last line.
+ *
+ * \param cursor        The cursor.
+ *
+ * \returns true if the cursor refers to no line.
+ */
+static inline bool buffer_cursor_done(const buffer_cursor_t* cursor)
+{
+    return NULL == cursor->node && NULL == cursor->chunk;
+}
+
+/**
+ * \brief Get the slot holding the value a cursor refers to, which may be
+ * replaced without invalidating the cursor.
+ *
+ * \param cursor        The cursor, which must refer to a line.
+ *
+ * \returns the slot.
+ */
+static inline disposable_t** buffer_cursor_slot(const buffer_cursor_t* cursor)
+{
+    return (NULL != cursor->node) ? &cursor->node->data
+                                  : &cursor->chunk->data[cursor->index];
+}
+
+/**
+ * \brief Move a cursor to the next line.
+ *
+ * \param cursor        The cursor, which must refer to a line.
+ */
+static inline void buffer_cursor_next(buffer_cursor_t* cursor)
+{
+    if (NULL != cursor->node)
+    {
+        cursor->node = cursor->node->next;
+    }
+    else if (++cursor->index == cursor->chunk->count)
+    {
+        cursor->chunk = cursor->chunk->next;
+        cursor->index = 0U;
+    }
+}
+
+/**
+ * \brief Materialize the region a cursor refers to, if it is one, leaving the
+ * cursor at the region's first line.
+ *
+ * \param buffer        The buffer.
+ * \param cursor        The cursor, which must refer to a line.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int buffer_cursor_materialize(buffer_t* buffer, buffer_cursor_t* cursor);
+
+/**
+ * \brief Find the line at the given zero-based index, materializing the
+ * region which holds it if need be.
+ *
+ * \param buffer        The buffer.
+ * \param index         The index of the line.
+ * \param cursor        Set to the line, or to the end of the lines if the
+ *                      index is the number of lines in the buffer.
+ *
+ * \returns 0 on success, or non-zero if the index is past the end of the
+ *          buffer or the region holding the line could not be materialized.
+ */
+int buffer_find_line(buffer_t* buffer, size_t index, buffer_cursor_t* cursor);
+
+/**
+ * \brief Release the lines of an unrolled list, which must not be linked into
+ * a buffer, and then the list's chunks.
+ *
+ * \param list          The list.
+ * \param alloc         The allocator which owns the lines.
+ * \param owned         false if the lines own nothing outside of an arena,
+ *                      so that they are neither dispose()d nor released.
+ */
+void buffer_chunks_release(ulist_t* list, allocator_t* alloc, bool owned);
+
+/**
+ * \brief Replace the remove lines of an unrolled list starting at the given
+ * line with the new lines, which are moved out of their own unrolled list.
+ * As many new lines as old ones are swapped into place; otherwise, the list
+ * is cut around the old lines and the new ones are spliced in, so that only
+ * the chunks at the cuts are touched.
+ *
+ * \param buffer        The buffer, which keeps an unrolled list.
+ * \param line          The index of the first line to replace.
+ * \param remove        The number of lines to replace.
+ * \param first         A cursor at the first line to replace.
+ * \param lines         The new lines, which are replaced by the old ones on
+ *                      success, to be released by the caller.
+ *
+ * \returns 0 on success, or non-zero on failure, in which case the buffer and
+ *          the new lines are unchanged.
+ */
+int buffer_splice_chunks(
+    buffer_t* buffer, size_t line, size_t remove, buffer_cursor_t first,
+    ulist_t* lines);
+
+/**
+ * \brief Replace the remove lines starting at the given line with count new
+ * lines, which are valid UTF-8.  Either the lines are all replaced, or the
+ * buffer is unchanged.
+ *
+ * \param buffer        The buffer.
+ * \param line          The index of the first line to replace.
+ * \param remove        The number of lines to replace.
+ * \param lengths       The lengths of the new lines.
+ * \param text          The text of the new lines, one after another.
+ * \param count         The number of new lines.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int buffer_splice(
+    buffer_t* buffer, size_t line, size_t remove, const uint32_t* lengths,
+    const char* text, size_t count);
+
+/**
+ * \brief Copy the checkpoints of a buffer's history, and the text in its arena
+ * which the buffer's lines view, into a new arena, which replaces the old
+ * one.  The views are moved to the copies.
+ *
+ * \param buffer        The buffer, which must keep a history.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the history
+ *          and the lines are unchanged.
+ */
+int buffer_history_compact(buffer_t* buffer);
+
+/**
+ * \brief Drop the checkpoints of a buffer's history which are deeper than the
+ * undo stack now is, counting the bytes they took from the arena as dropped.
+ * The history is compacted once those are most of the arena, and at least a
+ * chunk of it; if that fails, it is tried again after the next drop.
+ *
+ * \param buffer        The buffer.
+ * \param depth         The depth of the undo stack.
+ */
+void buffer_history_drop(buffer_t* buffer, size_t depth);
+
+#endif /*EJ_BUFFER_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,40 @@
+/**
+ * \brief Find a line of a buffer by its index.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * Find the line at the given zero-based index, materializing the region which
+ * holds it if need be.
+ *
+ * The lines of any region before the line which the background thread has not
+ * yet counted are counted on this thread.
+ *
+ * \param buffer            The buffer.
+ * \param index             The index of the line.
+ * \param node              Set to the node of the line.
+ *
+ * \returns 0 on success, or non-zero if the index is out of bounds, the
+ *          region holding the line could not be materialized, or the buffer
+ *          keeps its lines in an unrolled list, which has no nodes.
+ */
+int buffer_line_at(buffer_t* buffer, size_t index, list_node_t** node)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL != node);
+
+    buffer_cursor_t found;
+    if (NULL != buffer->chunks ||
+        0 != buffer_find_line(buffer, index, &found) || NULL == found.node)
+        return 1;
+
+    *node = found.node;
+
+    return 0;
+}
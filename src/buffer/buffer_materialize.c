@@ -0,0 +1,66 @@
+/**
+ * \brief Parse a region of a lazily loaded buffer into lines.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * Replace the region at the given node of a lazily loaded buffer with the
+ * lines it covers, which view the buffer's source.
+ *
+ * \param buffer            The buffer.
+ * \param node              The node holding the region, which is released.
+ * \param first             Set to the node of the region's first line.
+ *
+ * \returns 0 on success, or non-zero on failure, including if the region is
+ *          not valid UTF-8, in which case the region is left in place.
+ */
+int buffer_materialize(
+    buffer_t* buffer, list_node_t* node, list_node_t** first)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL != buffer->index);
+    MODEL_ASSERT(NULL != node && buffer_is_region(node->data));
+    MODEL_ASSERT(NULL != first);
+
+    buffer_region_t* region = (buffer_region_t*)node->data;
+    reader_t range;
+    list_t lines;
+
+    /* only this region is validated. */
+    reader_init_memory(
+        &range, buffer->source->data + region->offset, region->size);
+
+    list_init_allocator(&lines, buffer->allocator);
+    if (0 != reader_read_views(&range, &lines))
+    {
+        dispose((disposable_t*)&lines);
+        dispose((disposable_t*)&range);
+        return 1;
+    }
+
+    /* the region was counted along the way. */
+    __atomic_store_n(
+        &buffer->index->lines[region->number], range.line_count,
+        __ATOMIC_RELEASE);
+    dispose((disposable_t*)&range);
+
+    /* the lines take the region's place. */
+    *first = lines.head;
+    list_insert_list(buffer->lines, node, &lines);
+    dispose((disposable_t*)&lines);
+
+    disposable_t* data;
+    list_remove(buffer->lines, node, &data);
+    dispose(data);
+    allocator_release_tagged(buffer->allocator, data, ALLOCATOR_TAG_LIST_DATA);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
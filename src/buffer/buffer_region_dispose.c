@@ -0,0 +1,23 @@
+/**
+ * \brief Dispose of a buffer region.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+
+/**
+ * \brief Dispose of a region.
+ *
+ * A region owns nothing, so this does nothing; regions are recognized by
+ * this dispose method.
+ *
+ * \param disp              The region to dispose.
+ */
+void buffer_region_dispose(disposable_t* disp)
+{
+    MODEL_ASSERT(NULL != disp);
+    (void)disp;
+}
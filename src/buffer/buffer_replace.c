@@ -0,0 +1,156 @@
+/**
+ * \brief Replace lines of a buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <stdlib.h>
+#include "buffer_internal.h"
+
+/* forward decls */
+static int buffer_replace_old_lines(
+    buffer_t* buffer, size_t line, size_t count, command_line_t* old_lines);
+static bool buffer_replace_checkpoint_due(
+    const buffer_history_t* history, const command_stack_t* stack);
+
+/**
+ * Replace count lines of the buffer, starting at the given zero-based line,
+ * with new_count new lines.  A count of 0 inserts the new lines before line,
+ * which may be the number of lines in the buffer to append them, and a
+ * new_count of 0 deletes the lines.
+ *
+ * If the buffer has an undo command stack, a command recording the change is
+ * pushed onto it, where it may be merged with the change before it.  Either
+ * the whole change is made and recorded, or none of it is.  A buffer which
+ * keeps a history takes a checkpoint once enough commands have been pushed.
+ *
+ * \param buffer            The buffer to change.
+ * \param line              The index of the first line to replace.
+ * \param count             The number of lines to replace.
+ * \param lines             The new lines, which must be valid UTF-8.
+ * \param new_count         The number of new lines.
+ *
+ * \returns 0 on success and non-zero on failure, including if the lines to be
+ *          replaced are not all in the buffer.
+ */
+int buffer_replace(
+    buffer_t* buffer, size_t line, size_t count, const command_line_t* lines,
+    size_t new_count)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL != lines || 0U == new_count);
+
+    for (size_t i = 0U; i < new_count; ++i)
+    {
+        size_t invalid_offset;
+        if (0 !=
+                utf8_validate(lines[i].data, lines[i].length, &invalid_offset))
+            return 1;
+    }
+
+    command_line_t* old_lines = NULL;
+    if (count > 0U)
+    {
+        old_lines = (command_line_t*)malloc(count * sizeof(command_line_t));
+        if (NULL == old_lines)
+            return 1;
+    }
+
+    /* the command copies the old lines, so it can put them back. */
+    command_t* cmd = NULL;
+    int retval = buffer_replace_old_lines(buffer, line, count, old_lines);
+    if (0 == retval)
+    {
+        retval =
+            command_create(
+                &cmd, buffer->allocator, line, old_lines, count, lines,
+                new_count);
+    }
+
+    free(old_lines);
+    if (0 != retval)
+        return 1;
+
+    /* the change is made first, as a pushed command may be merged into the
+     * one below it, and so could not simply be popped again. */
+    if (0 != buffer_apply(buffer, cmd, false))
+    {
+        retval = 1;
+    }
+    else if (
+        NULL != buffer->undo_commands &&
+        0 != command_stack_push(buffer->undo_commands, cmd))
+    {
+        /* a change which can't be undone is taken back. */
+        buffer_apply(buffer, cmd, true);
+
+        retval = 1;
+    }
+    else if (
+        NULL != buffer->history &&
+        buffer_replace_checkpoint_due(buffer->history, buffer->undo_commands))
+    {
+        /* a checkpoint which can't be taken is tried after the next change. */
+        buffer_checkpoint(buffer);
+    }
+
+    allocator_release_tagged(buffer->allocator, cmd, ALLOCATOR_TAG_COMMAND);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return retval;
+}
+
+/**
+ * \brief Gather the lines which are about to be replaced, materializing any
+ * regions which hold them.
+ *
+ * \param buffer        The buffer.
+ * \param line          The index of the first line.
+ * \param count         The number of lines.
+ * \param old_lines     The lines are written here.
+ *
+ * \returns 0 on success, or non-zero if the lines are not all in the buffer.
+ */
+static int buffer_replace_old_lines(
+    buffer_t* buffer, size_t line, size_t count, command_line_t* old_lines)
+{
+    buffer_cursor_t cursor;
+    if (0 != buffer_find_line(buffer, line, &cursor))
+        return 1;
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (buffer_cursor_done(&cursor) ||
+            0 != buffer_cursor_materialize(buffer, &cursor))
+            return 1;
+
+        const string_t* str = (const string_t*)*buffer_cursor_slot(&cursor);
+        old_lines[i].data = string_data(str);
+        old_lines[i].length = str->length;
+
+        buffer_cursor_next(&cursor);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Check whether enough commands have been pushed since the last
+ * checkpoint to take another.
+ *
+ * \param history       The history.
+ * \param stack         The undo stack.
+ *
+ * \returns true if a checkpoint should be taken.
+ */
+static bool buffer_replace_checkpoint_due(
+    const buffer_history_t* history, const command_stack_t* stack)
+{
+    size_t depth = (NULL == history->last) ? 0U : history->last->depth;
+
+    return stack->count >= depth + history->interval;
+}
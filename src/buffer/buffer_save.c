@@ -0,0 +1,337 @@
+/**
+ * \brief Save a buffer to a file.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief A batch of iovecs waiting to be written.
+ */
+typedef struct buffer_save_batch
+{
+    int fd;
+    size_t count;
+    struct iovec iov[BUFFER_SAVE_BATCH];
+} buffer_save_batch_t;
+
+static const char buffer_save_newline[] = "\n";
+static const char buffer_save_crlf[] = "\r\n";
+
+/* forward decls */
+static int buffer_save_lines(const buffer_t* buffer, int fd);
+static int buffer_save_append(
+    buffer_save_batch_t* batch, const char* data, size_t size);
+static int buffer_save_flush(buffer_save_batch_t* batch);
+static int buffer_save_atomic(const buffer_t* buffer, const char* path);
+static int buffer_save_sync_dir(const char* path);
+
+/**
+ * Save the lines of a buffer to the file at the given path, each followed by
+ * the buffer's line ending: CRLF if the file it was opened from used CRLF, and
+ * a newline otherwise.
+ *
+ * The lines are gathered into batches of iovecs which point at their own
+ * storage, and each batch is written with a single writev(), so nothing is
+ * copied.  A run of lines which still view the buffer's source, along with
+ * the line endings between them, is written as one iovec, so saving an
+ * unchanged region costs no more than writing it, and an unchanged file is
+ * written back byte for byte.
+ *
+ * With \ref BUFFER_SAVE_ATOMIC, the lines are written to a temporary file in
+ * the same directory, which is fsync()ed and renamed over the destination,
+ * and the directory is then fsync()ed.  The destination keeps its permissions.
+ * A buffer with a source is always saved atomically, as truncating its own
+ * file would pull the mapping out from under its lines.  The regions of a
+ * lazily loaded buffer are written from the mapping byte for byte.
+ *
+ * \param buffer            The buffer to save.
+ * \param path              The path of the file to write.
+ * \param flags             Zero, or \ref BUFFER_SAVE_ATOMIC.
+ *
+ * \returns 0 if the buffer was saved, or non-zero on failure, in which case
+ *          an atomic save leaves the destination untouched.
+ */
+int buffer_save(const buffer_t* buffer, const char* path, unsigned int flags)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL != path);
+
+    if ((flags & BUFFER_SAVE_ATOMIC) || NULL != buffer->source)
+        return buffer_save_atomic(buffer, path);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return 1;
+
+    int retval = buffer_save_lines(buffer, fd);
+
+    if (0 != close(fd))
+        retval = 1;
+
+    return retval;
+}
+
+/**
+ * \brief Write every line of the buffer to the given file.
+ *
+ * \param buffer    The buffer to write.
+ * \param fd        The file to write to.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_save_lines(const buffer_t* buffer, int fd)
+{
+    const reader_t* source = buffer->source;
+    buffer_save_batch_t* batch =
+        (buffer_save_batch_t*)malloc(sizeof(buffer_save_batch_t));
+    if (NULL == batch)
+        return 1;
+
+    batch->fd = fd;
+    batch->count = 0U;
+
+    const char* ending = buffer->crlf ? buffer_save_crlf : buffer_save_newline;
+    size_t ending_size = buffer->crlf ? 2U : 1U;
+
+    int retval = 0;
+    buffer_cursor_t cursor;
+    for (buffer_cursor_first(buffer, &cursor);
+         0 == retval && !buffer_cursor_done(&cursor);
+         buffer_cursor_next(&cursor))
+    {
+        const disposable_t* value = *buffer_cursor_slot(&cursor);
+
+        /* an unparsed region is written as it is, and then ended. */
+        if (buffer_is_region(value))
+        {
+            const buffer_region_t* region = (const buffer_region_t*)value;
+            const char* data = source->data + region->offset;
+
+            retval = buffer_save_append(batch, data, region->size);
+            if (0 == retval && '\n' != data[region->size - 1U])
+                retval = buffer_save_append(batch, ending, ending_size);
+
+            continue;
+        }
+
+        const string_t* str = (const string_t*)value;
+        const char* data = string_data(str);
+        size_t length = str->length;
+
+        /* a view followed by the line ending in the source is written as
+         * is; other views, such as those of a history, are not in the
+         * source. */
+        if (string_is_view(str) && NULL != source &&
+            data >= source->data && data < source->data + source->size &&
+            ending_size <= (size_t)(source->data + source->size - data) &&
+            length <=
+                (size_t)(source->data + source->size - data) - ending_size &&
+            0 == memcmp(data + length, ending, ending_size))
+        {
+            retval = buffer_save_append(batch, data, length + ending_size);
+        }
+        else
+        {
+            retval = buffer_save_append(batch, data, length);
+            if (0 == retval)
+                retval = buffer_save_append(batch, ending, ending_size);
+        }
+    }
+
+    if (0 == retval)
+        retval = buffer_save_flush(batch);
+
+    free(batch);
+
+    return retval;
+}
+
+/**
+ * \brief Add bytes to the batch, extending the last iovec if they follow it
+ * in memory, and flushing the batch if it is full.
+ *
+ * \param batch     The batch.
+ * \param data      The bytes to write.
+ * \param size      The number of bytes.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_save_append(
+    buffer_save_batch_t* batch, const char* data, size_t size)
+{
+    if (0U == size)
+        return 0;
+
+    if (batch->count > 0U)
+    {
+        struct iovec* last = &batch->iov[batch->count - 1U];
+        if ((const char*)last->iov_base + last->iov_len == data)
+        {
+            last->iov_len += size;
+            return 0;
+        }
+    }
+
+    if (BUFFER_SAVE_BATCH == batch->count && 0 != buffer_save_flush(batch))
+        return 1;
+
+    batch->iov[batch->count].iov_base = (void*)data;
+    batch->iov[batch->count].iov_len = size;
+    ++batch->count;
+
+    return 0;
+}
+
+/**
+ * \brief Write the batch, resuming after short writes, and empty it.
+ *
+ * \param batch     The batch.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_save_flush(buffer_save_batch_t* batch)
+{
+    struct iovec* iov = batch->iov;
+    size_t count = batch->count;
+
+    while (count > 0U)
+    {
+        ssize_t written = writev(batch->fd, iov, (int)count);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            return 1;
+        }
+
+        /* skip the iovecs which were written in full. */
+        size_t remaining = (size_t)written;
+        while (count > 0U && remaining >= iov->iov_len)
+        {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+
+        /* resume partway through an iovec. */
+        if (count > 0U)
+        {
+            iov->iov_base = (char*)iov->iov_base + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+
+    batch->count = 0U;
+
+    return 0;
+}
+
+/**
+ * \brief Save the buffer to a temporary file, and rename it over the
+ * destination once it is durable.
+ *
+ * \param buffer    The buffer to save.
+ * \param path      The destination.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_save_atomic(const buffer_t* buffer, const char* path)
+{
+    static const char suffix[] = ".XXXXXX";
+    size_t length = strlen(path);
+
+    char* temp = (char*)malloc(length + sizeof(suffix));
+    if (NULL == temp)
+        return 1;
+
+    memcpy(temp, path, length);
+    memcpy(temp + length, suffix, sizeof(suffix));
+
+    int fd = mkstemp(temp);
+    if (fd < 0)
+    {
+        free(temp);
+        return 1;
+    }
+
+    /* keep the destination's permissions, or use the usual ones. */
+    struct stat st;
+    mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+    if (0 == stat(path, &st))
+        mode = st.st_mode & 07777;
+
+    int retval = 0;
+    if (0 != fchmod(fd, mode) || 0 != buffer_save_lines(buffer, fd) ||
+        0 != fsync(fd))
+    {
+        retval = 1;
+    }
+
+    if (0 != close(fd))
+        retval = 1;
+
+    if (0 == retval && 0 != rename(temp, path))
+        retval = 1;
+
+    if (0 != retval)
+        unlink(temp);
+    else
+        retval = buffer_save_sync_dir(path);
+
+    free(temp);
+
+    return retval;
+}
+
+/**
+ * \brief Flush the directory containing the given path, so that a rename into
+ * it is durable.
+ *
+ * \param path      The path whose directory is flushed.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_save_sync_dir(const char* path)
+{
+    const char* slash = strrchr(path, '/');
+    char* dir;
+
+    if (NULL == slash)
+    {
+        dir = strdup(".");
+    }
+    else
+    {
+        size_t length = (slash == path) ? 1U : (size_t)(slash - path);
+        dir = strndup(path, length);
+    }
+
+    if (NULL == dir)
+        return 1;
+
+    int fd = open(dir, O_RDONLY);
+    free(dir);
+    if (fd < 0)
+        return 1;
+
+    int retval = (0 == fsync(fd)) ? 0 : 1;
+    close(fd);
+
+    return retval;
+}
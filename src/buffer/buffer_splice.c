@@ -0,0 +1,130 @@
+/**
+ * \brief Replace a range of lines in a buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Replace the remove lines starting at the given line with count new
+ * lines, which are valid UTF-8.  Either the lines are all replaced, or the
+ * buffer is unchanged.
+ *
+ * \param buffer        The buffer.
+ * \param line          The index of the first line to replace.
+ * \param remove        The number of lines to replace.
+ * \param lengths       The lengths of the new lines.
+ * \param text          The text of the new lines, one after another.
+ * \param count         The number of new lines.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int buffer_splice(
+    buffer_t* buffer, size_t line, size_t remove, const uint32_t* lengths,
+    const char* text, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    allocator_t* alloc = buffer_data_alloc(buffer);
+    buffer_cursor_t first;
+    if (0 != buffer_find_line(buffer, line, &first))
+        return 1;
+
+    /* every line to be removed must be there, and parsed. */
+    buffer_cursor_t end = first;
+    for (size_t i = 0U; i < remove; ++i)
+    {
+        if (buffer_cursor_done(&end) ||
+            0 != buffer_cursor_materialize(buffer, &end))
+            return 1;
+
+        buffer_cursor_next(&end);
+    }
+
+    /* build the new lines aside, so that a failure changes nothing. */
+    list_t lines;
+    ulist_t chunks;
+    list_init_allocator(&lines, alloc);
+    if (NULL != buffer->lines)
+        lines.node_alloc = buffer->lines->node_alloc;
+    ulist_init(&chunks);
+    for (size_t i = 0U; i < count; ++i)
+    {
+        string_t* str;
+        int retval = string_create_unchecked(&str, alloc, text, lengths[i]);
+        if (0 == retval)
+        {
+            retval =
+                (NULL == buffer->chunks)
+                    ? list_push_back(&lines, (disposable_t*)str)
+                    : ulist_push_back(&chunks, (disposable_t*)str);
+            if (0 != retval)
+            {
+                dispose((disposable_t*)str);
+                allocator_release_tagged(alloc, str, ALLOCATOR_TAG_LIST_DATA);
+            }
+        }
+
+        if (0 != retval)
+        {
+            dispose((disposable_t*)&lines);
+            buffer_chunks_release(&chunks, alloc, true);
+            return 1;
+        }
+
+        text += lengths[i];
+    }
+
+    if (NULL != buffer->chunks)
+    {
+        int retval =
+            buffer_splice_chunks(buffer, line, remove, first, &chunks);
+        buffer_chunks_release(&chunks, alloc, true);
+
+        return retval;
+    }
+
+    /* so are the tree's entries for them. */
+    ostree_t added;
+    ostree_init(&added);
+    if (NULL != buffer->tree && 0 != buffer_tree_add(&added, lines.head, NULL))
+    {
+        dispose((disposable_t*)&lines);
+        return 1;
+    }
+
+    /* the old lines are unlinked at once, and released with their list. */
+    list_t* list = buffer->lines;
+    list_t removed;
+    list_init_allocator(&removed, alloc);
+    removed.node_alloc = list->node_alloc;
+    if (0U < remove)
+    {
+        list_node_t* last = (NULL == end.node) ? list->tail : end.node->prev;
+        list_remove_range(list, first.node, last, remove, &removed);
+    }
+
+    list_insert_list(list, end.node, &lines);
+    dispose((disposable_t*)&lines);
+    dispose((disposable_t*)&removed);
+
+    if (NULL != buffer->tree)
+    {
+        ostree_t old, rest;
+        ostree_init(&old);
+        ostree_init(&rest);
+        ostree_remove_range(buffer->tree, line, remove, &old);
+        ostree_split(buffer->tree, line, &rest);
+        ostree_splice(buffer->tree, &added);
+        ostree_splice(buffer->tree, &rest);
+        dispose((disposable_t*)&old);
+    }
+
+    dispose((disposable_t*)&added);
+
+    return 0;
+}
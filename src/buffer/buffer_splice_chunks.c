@@ -0,0 +1,82 @@
+/**
+ * \brief Replace a range of lines in an unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * \brief Replace the remove lines of an unrolled list starting at the given
+ * line with the new lines, which are moved out of their own unrolled list.
+ * As many new lines as old ones are swapped into place; otherwise, the list
+ * is cut around the old lines and the new ones are spliced in, so that only
+ * the chunks at the cuts are touched.
+ *
+ * \param buffer        The buffer, which keeps an unrolled list.
+ * \param line          The index of the first line to replace.
+ * \param remove        The number of lines to replace.
+ * \param first         A cursor at the first line to replace.
+ * \param lines         The new lines, which are replaced by the old ones on
+ *                      success, to be released by the caller.
+ *
+ * \returns 0 on success, or non-zero on failure, in which case the buffer and
+ *          the new lines are unchanged.
+ */
+int buffer_splice_chunks(
+    buffer_t* buffer, size_t line, size_t remove, buffer_cursor_t first,
+    ulist_t* lines)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    ulist_t* chunks = buffer->chunks;
+    ulist_t old, rest;
+    ulist_pos_t pos;
+
+    if (remove == lines->size)
+    {
+        for (ulist_chunk_t* i = lines->head; NULL != i; i = i->next)
+        {
+            for (size_t j = 0U; j < i->count; ++j)
+            {
+                disposable_t** slot = buffer_cursor_slot(&first);
+                disposable_t* data = *slot;
+                *slot = i->data[j];
+                i->data[j] = data;
+                buffer_cursor_next(&first);
+            }
+        }
+
+        return 0;
+    }
+
+    ulist_init(&old);
+    ulist_init(&rest);
+
+    /* cut the list before the old lines, and then after them. */
+    if (line < chunks->size)
+    {
+        ulist_at(chunks, line, &pos);
+        if (0 != ulist_split(chunks, &pos, &old))
+            return 1;
+    }
+
+    if (remove < old.size)
+    {
+        ulist_at(&old, remove, &pos);
+        if (0 != ulist_split(&old, &pos, &rest))
+        {
+            ulist_splice(chunks, &old);
+            return 1;
+        }
+    }
+
+    ulist_splice(chunks, lines);
+    ulist_splice(chunks, &rest);
+    ulist_splice(lines, &old);
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * \brief Add entries for list nodes to a buffer's tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include <stdlib.h>
+#include "buffer_internal.h"
+
+/* forward decls */
+static void buffer_tree_entry_dispose(disposable_t* disp);
+
+/**
+ * \brief Append an entry for each node from first up to end to a tree of
+ * list nodes, which is left as it was if this fails.
+ *
+ * \param tree          The tree.
+ * \param first         The first node.
+ * \param end           The node after the last, or NULL.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int buffer_tree_add(ostree_t* tree, list_node_t* first, list_node_t* end)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+
+    /* the entries are built aside, and then appended at once. */
+    ostree_t added;
+    ostree_init(&added);
+    for (list_node_t* node = first; node != end; node = node->next)
+    {
+        buffer_tree_entry_t* entry =
+            (buffer_tree_entry_t*)malloc(sizeof(buffer_tree_entry_t));
+        if (NULL == entry)
+        {
+            dispose((disposable_t*)&added);
+            return 1;
+        }
+
+        entry->hdr.dispose = &buffer_tree_entry_dispose;
+        entry->node = node;
+
+        if (0 != ostree_push_back(&added, (disposable_t*)entry))
+        {
+            free(entry);
+            dispose((disposable_t*)&added);
+            return 1;
+        }
+    }
+
+    ostree_splice(tree, &added);
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a tree entry, which owns nothing.
+ *
+ * \param disp      The entry to dispose.
+ */
+static void buffer_tree_entry_dispose(disposable_t* disp)
+{
+    (void)disp;
+}
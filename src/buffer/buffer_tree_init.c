@@ -0,0 +1,56 @@
+/**
+ * \brief Index the lines of a buffer with an order statistic tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * Index the nodes of the buffer's line list with an order statistic tree, so
+ * that buffer_line_at(), buffer_replace(), and buffer_undo() find a line by
+ * its number in O(log n) rather than by walking the list.
+ *
+ * The tree is built in O(n log n), and then kept in step with every change
+ * made through the buffer's methods, at the cost of a tree node and an entry
+ * per line.  The lines must only be changed through those methods while the
+ * buffer keeps a tree.  Unrolling the buffer releases the tree.
+ *
+ * \param buffer            The buffer, which must not be lazily loaded or
+ *                          unrolled.
+ *
+ * \returns 0 on success, or non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_tree_init(buffer_t* buffer)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    if (NULL != buffer->tree)
+        return 0;
+
+    if (NULL != buffer->index || NULL != buffer->chunks)
+        return 1;
+
+    ostree_t* tree =
+        (ostree_t*)allocator_allocate(buffer->allocator, sizeof(ostree_t));
+    if (NULL == tree)
+        return 1;
+
+    ostree_init(tree);
+    if (0 != buffer_tree_add(tree, buffer->lines->head, NULL))
+    {
+        dispose((disposable_t*)tree);
+        allocator_release(buffer->allocator, tree);
+        return 1;
+    }
+
+    buffer->tree = tree;
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
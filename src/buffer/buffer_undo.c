@@ -0,0 +1,42 @@
+/**
+ * \brief Undo the most recent change to a buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * Undo the most recent change to the buffer, popping its command from the
+ * undo command stack.
+ *
+ * \param buffer            The buffer to change.
+ *
+ * \returns 0 on success, or non-zero if there is nothing to undo or the
+ *          change could not be undone, in which case the buffer and the stack
+ *          are unchanged.
+ */
+int buffer_undo(buffer_t* buffer)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    if (NULL == buffer->undo_commands)
+        return 1;
+
+    const command_t* cmd = command_stack_peek(buffer->undo_commands);
+    if (NULL == cmd)
+        return 1;
+
+    if (0 != buffer_apply(buffer, cmd, true))
+        return 1;
+
+    command_stack_pop(buffer->undo_commands);
+    buffer_history_drop(buffer, buffer->undo_commands->count);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * \brief Undo changes to a buffer until its undo stack is a given depth.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/* forward decls */
+static const buffer_checkpoint_t* buffer_undo_to_checkpoint(
+    const buffer_history_t* history, size_t depth);
+static int buffer_undo_to_restore(
+    buffer_t* buffer, const buffer_checkpoint_t* checkpoint, size_t depth);
+static int buffer_undo_to_lines(
+    buffer_t* buffer, const buffer_checkpoint_t* checkpoint);
+static disposable_t* buffer_undo_to_line(
+    buffer_t* buffer, const command_line_t* entry);
+
+/**
+ * Undo changes until the undo stack is depth commands deep.
+ *
+ * With a history, the nearest checkpoint at or below that depth is restored,
+ * and only the commands between it and depth are made again, unless undoing
+ * the changes one at a time is cheaper.  Either way, the commands above depth
+ * are discarded.
+ *
+ * \param buffer            The buffer to change.
+ * \param depth             The depth of the undo stack to return to.
+ *
+ * \returns 0 on success, or non-zero on failure, including if the stack is not
+ *          that deep, in which case the buffer is left at a depth between
+ *          depth and where it started, which matches its undo stack.
+ */
+int buffer_undo_to(buffer_t* buffer, size_t depth)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    command_stack_t* stack = buffer->undo_commands;
+    if (NULL == stack || depth > stack->count)
+        return 1;
+
+    const buffer_checkpoint_t* checkpoint =
+        buffer_undo_to_checkpoint(buffer->history, depth);
+
+    /* undoing is cheaper when the depth is nearer the top than a checkpoint. */
+    if (NULL == checkpoint || stack->count - depth <= depth - checkpoint->depth)
+    {
+        while (stack->count > depth)
+        {
+            if (0 != buffer_undo(buffer))
+                return 1;
+        }
+
+        return 0;
+    }
+
+    return buffer_undo_to_restore(buffer, checkpoint, depth);
+}
+
+/**
+ * \brief Find the newest checkpoint at or below the given depth.
+ *
+ * \param history       The history, or NULL.
+ * \param depth         The depth.
+ *
+ * \returns the checkpoint, or NULL if there is none.
+ */
+static const buffer_checkpoint_t* buffer_undo_to_checkpoint(
+    const buffer_history_t* history, size_t depth)
+{
+    if (NULL == history)
+        return NULL;
+
+    const buffer_checkpoint_t* checkpoint = history->last;
+    while (NULL != checkpoint && checkpoint->depth > depth)
+    {
+        checkpoint = checkpoint->prev;
+    }
+
+    return checkpoint;
+}
+
+/**
+ * \brief Restore a checkpoint, make the commands after it again up to the
+ * given depth, and discard the rest.
+ *
+ * \param buffer        The buffer.
+ * \param checkpoint    The checkpoint.
+ * \param depth         The depth.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_undo_to_restore(
+    buffer_t* buffer, const buffer_checkpoint_t* checkpoint, size_t depth)
+{
+    command_stack_t* stack = buffer->undo_commands;
+
+    if (0 != buffer_undo_to_lines(buffer, checkpoint))
+        return 1;
+
+    /* a command which can't be made again ends the replay where it is. */
+    int retval = 0;
+    uint64_t mark = checkpoint->mark;
+    size_t count = checkpoint->depth;
+    while (count < depth)
+    {
+        uint64_t next = mark;
+        const command_t* cmd = command_stack_next(stack, &next);
+        if (NULL == cmd || 0 != buffer_apply(buffer, cmd, false))
+        {
+            retval = 1;
+            break;
+        }
+
+        mark = next;
+        ++count;
+    }
+
+    buffer->history->replay_count += count - checkpoint->depth;
+
+    if (0 != command_stack_truncate(stack, mark, count))
+        retval = 1;
+
+    buffer_history_drop(buffer, count);
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return retval;
+}
+
+/**
+ * \brief Replace the lines of the buffer with those of a checkpoint.  The new
+ * lines are built aside, so that a failure changes nothing.
+ *
+ * \param buffer        The buffer.
+ * \param checkpoint    The checkpoint.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int buffer_undo_to_lines(
+    buffer_t* buffer, const buffer_checkpoint_t* checkpoint)
+{
+    allocator_t* alloc = buffer_data_alloc(buffer);
+    list_t lines;
+    ulist_t chunks;
+
+    list_init_allocator(&lines, alloc);
+    if (NULL != buffer->lines)
+        lines.node_alloc = buffer->lines->node_alloc;
+    ulist_init(&chunks);
+    for (size_t c = 0U; c < checkpoint->chunk_count; ++c)
+    {
+        const buffer_checkpoint_chunk_t* chunk = checkpoint->chunks[c];
+        for (size_t i = 0U; i < chunk->count; ++i)
+        {
+            disposable_t* data = buffer_undo_to_line(buffer, &chunk->lines[i]);
+            int retval = (NULL == data) ? 1 : 0;
+            if (0 == retval)
+            {
+                retval =
+                    (NULL == buffer->chunks)
+                        ? list_push_back(&lines, data)
+                        : ulist_push_back(&chunks, data);
+                if (0 != retval)
+                {
+                    dispose(data);
+                    allocator_release_tagged(
+                        alloc, data, ALLOCATOR_TAG_LIST_DATA);
+                }
+            }
+
+            if (0 != retval)
+            {
+                dispose((disposable_t*)&lines);
+                buffer_chunks_release(&chunks, alloc, true);
+                return 1;
+            }
+        }
+    }
+
+    /* the old lines make way for the checkpoint's. */
+    if (NULL != buffer->chunks)
+    {
+        ulist_t old;
+        ulist_init(&old);
+        ulist_splice(&old, buffer->chunks);
+        ulist_splice(buffer->chunks, &chunks);
+        buffer_chunks_release(&old, alloc, true);
+        dispose((disposable_t*)&lines);
+
+        return 0;
+    }
+
+    /* so does the tree, which is rebuilt for the new nodes. */
+    ostree_t tree;
+    ostree_init(&tree);
+    if (NULL != buffer->tree && 0 != buffer_tree_add(&tree, lines.head, NULL))
+    {
+        dispose((disposable_t*)&lines);
+        dispose((disposable_t*)&chunks);
+        return 1;
+    }
+
+    list_t* list = buffer->lines;
+    list_t old;
+    list_init_allocator(&old, alloc);
+    old.node_alloc = list->node_alloc;
+    if (NULL != list->head)
+        list_remove_range(list, list->head, list->tail, list->size, &old);
+
+    list_insert_list(list, NULL, &lines);
+    dispose((disposable_t*)&lines);
+    dispose((disposable_t*)&old);
+    dispose((disposable_t*)&chunks);
+
+    if (NULL != buffer->tree)
+    {
+        dispose((disposable_t*)buffer->tree);
+        ostree_splice(buffer->tree, &tree);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Create the line or the region for a checkpoint entry.
+ *
+ * \param buffer        The buffer.
+ * \param entry         The entry.
+ *
+ * \returns the line or the region, allocated with
+ *          \ref ALLOCATOR_TAG_LIST_DATA, or NULL on failure.
+ */
+static disposable_t* buffer_undo_to_line(
+    buffer_t* buffer, const command_line_t* entry)
+{
+    allocator_t* alloc = buffer_data_alloc(buffer);
+
+    if (NULL == entry->data)
+    {
+        const buffer_index_t* index = buffer->index;
+        buffer_region_t* region =
+            (buffer_region_t*)allocator_allocate_tagged(
+                alloc, sizeof(buffer_region_t), ALLOCATOR_TAG_LIST_DATA);
+        if (NULL == region)
+            return NULL;
+
+        region->hdr.dispose = &buffer_region_dispose;
+        region->number = entry->length;
+        region->offset = index->bounds[region->number];
+        region->size = index->bounds[region->number + 1U] - region->offset;
+
+        return (disposable_t*)region;
+    }
+
+    string_t* str =
+        (string_t*)allocator_allocate_tagged(
+            alloc, sizeof(string_t), ALLOCATOR_TAG_LIST_DATA);
+    if (NULL == str)
+        return NULL;
+
+    string_init_view(str, alloc, entry->data, entry->length);
+
+    return (disposable_t*)str;
+}
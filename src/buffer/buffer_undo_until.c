@@ -0,0 +1,88 @@
+/**
+ * \brief Undo the changes made to a buffer after a given time.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+
+/* forward decls */
+static size_t buffer_undo_until_depth(
+    command_stack_t* stack, const buffer_checkpoint_t* checkpoint,
+    uint64_t time);
+
+/**
+ * Undo every change made after the given time, as for an editor's
+ * :earlier command.  A run of merged changes is undone only if it began after
+ * the time.
+ *
+ * The depth to return to is found by reading the commands after the newest
+ * checkpoint taken by then, so it costs no more than the replay which follows.
+ * Without such a checkpoint, the changes are undone one at a time.
+ *
+ * \param buffer            The buffer to change.
+ * \param time              The time, in milliseconds since the epoch.
+ *
+ * \returns 0 on success and non-zero on failure, as for buffer_undo_to().
+ */
+int buffer_undo_until(buffer_t* buffer, uint64_t time)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    command_stack_t* stack = buffer->undo_commands;
+    if (NULL == stack)
+        return 1;
+
+    const buffer_checkpoint_t* checkpoint =
+        (NULL == buffer->history) ? NULL : buffer->history->last;
+    while (NULL != checkpoint && checkpoint->time > time)
+    {
+        checkpoint = checkpoint->prev;
+    }
+
+    if (NULL == checkpoint)
+    {
+        const command_t* cmd;
+        while (NULL != (cmd = command_stack_peek(stack)) && cmd->time > time)
+        {
+            if (0 != buffer_undo(buffer))
+                return 1;
+        }
+
+        return 0;
+    }
+
+    return
+        buffer_undo_to(
+            buffer, buffer_undo_until_depth(stack, checkpoint, time));
+}
+
+/**
+ * \brief Count the commands made by the given time, starting from a
+ * checkpoint taken by then.
+ *
+ * \param stack         The undo stack.
+ * \param checkpoint    The checkpoint.
+ * \param time          The time.
+ *
+ * \returns the depth of the stack at that time.
+ */
+static size_t buffer_undo_until_depth(
+    command_stack_t* stack, const buffer_checkpoint_t* checkpoint,
+    uint64_t time)
+{
+    uint64_t mark = checkpoint->mark;
+    size_t depth = checkpoint->depth;
+    const command_t* cmd;
+
+    while (depth < stack->count &&
+           NULL != (cmd = command_stack_next(stack, &mark)) &&
+           cmd->time <= time)
+    {
+        ++depth;
+    }
+
+    return depth;
+}
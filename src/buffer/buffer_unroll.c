@@ -0,0 +1,82 @@
+/**
+ * \brief Move the lines of a buffer into an unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/buffer.h>
+#include "buffer_internal.h"
+
+/**
+ * Move the lines of the buffer into an unrolled list, which holds the
+ * pointers to several lines in each chunk.
+ *
+ * Whole-buffer passes, such as buffer_save() and buffer_checkpoint(), then
+ * touch one chunk per \ref ULIST_CHUNK_CAPACITY lines rather than one node per
+ * line.  Lines are still replaced, undone, and restored from checkpoints as
+ * before, but the buffer has no list nodes, so buffer_line_at() fails, and
+ * the tree of a buffer indexed by buffer_tree_init() is released.  The lines
+ * are moved as they are, without being copied.
+ *
+ * \param buffer            The buffer, which must not be lazily loaded, and
+ *                          whose line list must release its lines to the
+ *                          buffer's allocator.
+ *
+ * \returns 0 on success, or non-zero on failure, in which case the buffer is
+ *          unchanged.
+ */
+int buffer_unroll(buffer_t* buffer)
+{
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    if (NULL != buffer->chunks)
+        return 0;
+
+    list_t* list = buffer->lines;
+    if (NULL != buffer->index || buffer->allocator != list->data_alloc)
+        return 1;
+
+    ulist_t* chunks =
+        (ulist_t*)allocator_allocate(buffer->allocator, sizeof(ulist_t));
+    if (NULL == chunks)
+        return 1;
+
+    /* the lines are shared until every one has a place in the chunks. */
+    ulist_init(chunks);
+    for (list_node_t* node = list->head; NULL != node; node = node->next)
+    {
+        if (0 != ulist_push_back(chunks, node->data))
+        {
+            buffer_chunks_release(chunks, buffer->allocator, false);
+            allocator_release(buffer->allocator, chunks);
+            return 1;
+        }
+    }
+
+    /* the list gives up its nodes, but not its lines. */
+    disposable_t* data;
+    while (NULL != list->head)
+    {
+        list_pop_front(list, &data);
+    }
+
+    dispose((disposable_t*)list);
+    allocator_release(buffer->allocator, list);
+
+    /* the tree indexes the nodes which are gone. */
+    if (NULL != buffer->tree)
+    {
+        dispose((disposable_t*)buffer->tree);
+        allocator_release(buffer->allocator, buffer->tree);
+        buffer->tree = NULL;
+    }
+
+    buffer->lines = NULL;
+    buffer->chunks = chunks;
+
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+
+    return 0;
+}
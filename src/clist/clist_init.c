@@ -0,0 +1,127 @@
+/**
+ * \brief Initialize a circular list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void clist_dispose(disposable_t* disp);
+
+/**
+ * \brief The clist_init method creates a new empty circular list.
+ *
+ * \param list          The list to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_init(clist_t* list)
+{
+    MODEL_ASSERT(NULL != list);
+
+    /* clear the list. */
+    memset(list, 0, sizeof(clist_t));
+
+    /* an empty ring is just the sentinel. */
+    list->sentinel.next = list->sentinel.prev = &list->sentinel;
+
+    /* set our dispose method. */
+    list->hdr.dispose = &clist_dispose;
+
+    /* nodes and data come from the system allocator by default. */
+    list->node_alloc = list->data_alloc = allocator_system();
+
+    /* the list is now valid. */
+    MODEL_ASSERT(PROP_VALID_CLIST(list) && PROP_VALID_CLIST_EMPTY(list));
+
+    return 0;
+}
+
+/**
+ * \brief The clist_init_pool method creates a new empty circular list whose
+ * nodes are allocated from the given node pool.
+ *
+ * The pool must have an object size of at least sizeof(list_node_t), and it
+ * must outlive this list.
+ *
+ * \param list          The list to initialize.
+ * \param pool          The pool from which nodes are allocated.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_init_pool(clist_t* list, pool_t* pool)
+{
+    MODEL_ASSERT(NULL != list);
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    /* the pool must be able to hold our nodes. */
+    if (pool->object_size < sizeof(list_node_t))
+        return 1;
+
+    /* initialize the list. */
+    if (0 != clist_init(list))
+        return 1;
+
+    /* draw nodes from this pool. */
+    list->node_alloc = &pool->alloc;
+
+    return 0;
+}
+
+/**
+ * \brief The clist_init_allocator method creates a new empty circular list
+ * whose nodes are allocated from, and whose data values are released to, the
+ * given allocator, which must outlive this list.
+ *
+ * \param list          The list to initialize.
+ * \param alloc         The allocator which owns the nodes and data.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_init_allocator(clist_t* list, allocator_t* alloc)
+{
+    MODEL_ASSERT(NULL != list);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+
+    /* initialize the list. */
+    if (0 != clist_init(list))
+        return 1;
+
+    /* nodes and data belong to this allocator. */
+    list->node_alloc = list->data_alloc = alloc;
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a circular list and clean up nodes.
+ *
+ * \param disp      The list to dispose.
+ */
+static void clist_dispose(disposable_t* disp)
+{
+    clist_t* list = (clist_t*)disp;
+
+    /* we are disposing a valid list. */
+    MODEL_ASSERT(PROP_VALID_CLIST(list));
+
+    list_node_t* i = list->sentinel.next;
+    while (i != &list->sentinel)
+    {
+        list_node_t* tmp = i->next;
+
+        /* clean up the node and data. */
+        dispose(i->data);
+        allocator_release_tagged(
+            list->data_alloc, i->data, ALLOCATOR_TAG_LIST_DATA);
+        clist_node_release(list, i);
+
+        i = tmp;
+    }
+}
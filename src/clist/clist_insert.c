@@ -0,0 +1,32 @@
+/**
+ * \brief Insert a value before a node in the circular list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+
+/**
+ * \brief The clist_insert method will insert the given data value BEFORE the
+ * given node in the list.  Inserting before clist_end() appends the value to
+ * the back of the list.  This method assumes that the provided node is part
+ * of the list; it is extremely important that the caller ensures that this is
+ * true.  The ownership of this data is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node before which this data is inserted.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_insert(clist_t* list, list_node_t* node, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_CLIST(list));
+    MODEL_ASSERT(NULL != node);
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    return clist_link_before(list, node, data);
+}
@@ -0,0 +1,90 @@
+/**
+ * \brief Internal helpers shared by the circular list implementation.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_CLIST_INTERNAL_HEADER_GUARD
+# define EJ_CLIST_INTERNAL_HEADER_GUARD
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include <stdlib.h>
+
+/**
+ * \brief Allocate a list node from the list's node allocator.
+ *
+ * \param list          The list for which the node is allocated.
+ *
+ * \returns the uninitialized node, or NULL on failure.
+ */
+static inline list_node_t* clist_node_alloc(clist_t* list)
+{
+    return (list_node_t*)allocator_allocate_tagged(
+        list->node_alloc, sizeof(list_node_t), ALLOCATOR_TAG_LIST_NODE);
+}
+
+/**
+ * \brief Release a list node allocated by clist_node_alloc().
+ *
+ * \param list          The list that owned the node.
+ * \param node          The node to release.
+ */
+static inline void clist_node_release(clist_t* list, list_node_t* node)
+{
+    allocator_release_tagged(list->node_alloc, node, ALLOCATOR_TAG_LIST_NODE);
+}
+
+/**
+ * \brief Allocate a node for the given data and link it BEFORE pos.  Since
+ * every node in the ring has a neighbor on both sides, this never branches on
+ * the position.
+ *
+ * \param list          The list to modify.
+ * \param pos           The node before which the new node is linked.
+ * \param data          The data for the new node.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static inline int clist_link_before(
+    clist_t* list, list_node_t* pos, disposable_t* data)
+{
+    list_node_t* node = clist_node_alloc(list);
+    if (NULL == node)
+        return 1;
+
+    node->data = data;
+    node->next = pos;
+    node->prev = pos->prev;
+    pos->prev->next = node;
+    pos->prev = node;
+
+    ++list->size;
+
+    return 0;
+}
+
+/**
+ * \brief Unlink the given node, release it, and return its data.
+ *
+ * \param list          The list to modify.
+ * \param node          The node to remove; it must not be the sentinel.
+ *
+ * \returns the data held by the node.
+ */
+static inline disposable_t* clist_unlink(clist_t* list, list_node_t* node)
+{
+    disposable_t* data = node->data;
+
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+
+    --list->size;
+
+    clist_node_release(list, node);
+
+    return data;
+}
+
+#endif /*EJ_CLIST_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,39 @@
+/**
+ * \brief Pop a value from the front of the circular list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+
+/**
+ * \brief The clist_pop_front method pops a data value off of the front of the
+ * list.  The ownership of this data is transferred to the caller who is
+ * responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_pop_front(clist_t* list, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_CLIST(list));
+    MODEL_ASSERT(NULL != data);
+
+    if (0U == list->size)
+    {
+        *data = NULL;
+        return 1;
+    }
+
+    *data = clist_unlink(list, list->sentinel.next);
+
+    return 0;
+}
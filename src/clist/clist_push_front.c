@@ -0,0 +1,29 @@
+/**
+ * \brief Push a value to the front of the circular list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+
+/**
+ * \brief The clist_push_front method pushes a data value onto the front of the
+ * list.  The ownership of this data is transferred to the list and may be
+ * dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_push_front(clist_t* list, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_CLIST(list));
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    /* the front of the list is just before the first node. */
+    return clist_link_before(list, list->sentinel.next, data);
+}
@@ -0,0 +1,34 @@
+/**
+ * \brief Remove a node from the circular list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+
+/**
+ * \brief The clist_remove method will remove the given node from the list,
+ * returning the data value to be dispose()d and free()d by the caller.  This
+ * method assumes that the provided node is part of the list and is not
+ * clist_end(); it is extremely important that the caller ensures that this is
+ * true.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node to be removed.
+ * \param data          Pointer to the data pointer returned to the caller.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int clist_remove(clist_t* list, list_node_t* node, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_CLIST_NOT_EMPTY(list));
+    MODEL_ASSERT(NULL != node && &list->sentinel != node);
+    MODEL_ASSERT(NULL != data);
+
+    *data = clist_unlink(list, node);
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+/**
+ * \brief Splice two circular lists together.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+
+/**
+ * \brief The clist_splice method will splice two lists into one.  After this
+ * method is called, the x list will contain all nodes, and the y list will be
+ * empty.  Both lists must share the same allocators.
+ *
+ * \param x             The x list to splice with the values from the y list.
+ * \param y             The y list to destructively splice.
+ */
+void clist_splice(clist_t* x, clist_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_CLIST(x));
+    MODEL_ASSERT(PROP_VALID_CLIST(y));
+    MODEL_ASSERT(x->node_alloc == y->node_alloc);
+    MODEL_ASSERT(x->data_alloc == y->data_alloc);
+
+    /* an empty y list has no ring to splice in. */
+    if (0U == y->size)
+        return;
+
+    list_node_t* first = y->sentinel.next;
+    list_node_t* last = y->sentinel.prev;
+
+    /* link the y ring in before the x sentinel. */
+    first->prev = x->sentinel.prev;
+    x->sentinel.prev->next = first;
+    last->next = &x->sentinel;
+    x->sentinel.prev = last;
+    x->size += y->size;
+
+    /* y is now empty. */
+    y->sentinel.next = y->sentinel.prev = &y->sentinel;
+    y->size = 0U;
+
+    MODEL_ASSERT(PROP_VALID_CLIST_NOT_EMPTY(x));
+    MODEL_ASSERT(PROP_VALID_CLIST_EMPTY(y));
+}
@@ -0,0 +1,76 @@
+/**
+ * \brief Split a circular list on a node.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/clist.h>
+#include "clist_internal.h"
+
+/**
+ * \brief The clist_split method will split the list on the given node.  The
+ * original list x will contain all entries BEFORE the node, and the new y list
+ * will contain this node and all entries AFTER this node.  It is expected that
+ * the y list is empty, node belongs to the original x list, and both lists
+ * share the same allocators.  Splitting on clist_end() leaves y empty.
+ *
+ * The size of the y list is found by walking inward from both ends of x at
+ * once, so this method touches at most half of the nodes in x.
+ *
+ * \param x             The x list to split.
+ * \param node          The node on which the list is split.
+ * \param y             The y list to receive node and every node after it.
+ */
+void clist_split(clist_t* x, list_node_t* node, clist_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_CLIST(x));
+    MODEL_ASSERT(PROP_VALID_CLIST_EMPTY(y));
+    MODEL_ASSERT(NULL != node);
+    MODEL_ASSERT(x->node_alloc == y->node_alloc);
+    MODEL_ASSERT(x->data_alloc == y->data_alloc);
+
+    if (&x->sentinel == node)
+        return;
+
+    /* count the nodes before node, walking from whichever end is closer. */
+    size_t index = 0U;
+    list_node_t* fwd = x->sentinel.next;
+    list_node_t* back = x->sentinel.prev;
+    size_t back_index = x->size - 1U;
+    for (;;)
+    {
+        if (fwd == node)
+            break;
+
+        if (back == node)
+        {
+            index = back_index;
+            break;
+        }
+
+        fwd = fwd->next;
+        ++index;
+        back = back->prev;
+        --back_index;
+    }
+
+    list_node_t* last = x->sentinel.prev;
+
+    /* close the x ring before node. */
+    node->prev->next = &x->sentinel;
+    x->sentinel.prev = node->prev;
+
+    /* close the y ring around node through last. */
+    y->sentinel.next = node;
+    node->prev = &y->sentinel;
+    y->sentinel.prev = last;
+    last->next = &y->sentinel;
+
+    y->size = x->size - index;
+    x->size = index;
+
+    MODEL_ASSERT(PROP_VALID_CLIST(x));
+    MODEL_ASSERT(PROP_VALID_CLIST_NOT_EMPTY(y));
+}
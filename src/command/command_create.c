@@ -0,0 +1,325 @@
+/**
+ * \brief Create a command.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <string.h>
+#include <time.h>
+
+/* forward decls */
+static char* command_copy_lines(
+    uint32_t* lengths, char* text, const command_line_t* lines, size_t count);
+static int command_sum_lines(
+    const command_line_t* lines, size_t count, size_t* total);
+static void command_delta_bounds(
+    const command_line_t* old_line, const command_line_t* new_line,
+    size_t* prefix, size_t* suffix);
+static size_t command_delta_bytes(
+    const command_line_t* old_lines, const command_line_t* new_lines,
+    size_t count, size_t* removed);
+static void command_fill_delta(
+    command_t* c, const command_line_t* old_lines,
+    const command_line_t* new_lines, size_t count);
+static command_t* command_alloc(
+    allocator_t* alloc, size_t size, size_t line, uint32_t type);
+
+/**
+ * \brief The command_create method creates a command which replaces the given
+ * old lines, starting at line, with the given new lines.
+ *
+ * When as many lines are replaced as replace them, and only the changed part
+ * of each line makes a smaller record, a \ref COMMAND_TYPE_DELTA command is
+ * created, and the bytes saved are recorded in the allocator's statistics.
+ * Otherwise, a \ref COMMAND_TYPE_REPLACE command holds a copy of every line.
+ *
+ * \param cmd           Set to the command, which must be released to the
+ *                      allocator with \ref ALLOCATOR_TAG_COMMAND.
+ * \param alloc         The allocator for the command.
+ * \param line          The zero-based index of the first line replaced.
+ * \param old_lines     The lines which are replaced.
+ * \param old_count     The number of lines which are replaced.
+ * \param new_lines     The lines which replace them.
+ * \param new_count     The number of lines which replace them.
+ *
+ * \returns 0 on success and non-zero on failure, including if a line is 4 GiB
+ *          or longer.
+ */
+int command_create(
+    command_t** cmd, allocator_t* alloc, size_t line,
+    const command_line_t* old_lines, size_t old_count,
+    const command_line_t* new_lines, size_t new_count)
+{
+    MODEL_ASSERT(NULL != cmd);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(NULL != old_lines || 0U == old_count);
+    MODEL_ASSERT(NULL != new_lines || 0U == new_count);
+
+    size_t old_bytes, new_bytes;
+    if (old_count > UINT32_MAX || new_count > UINT32_MAX ||
+        0 != command_sum_lines(old_lines, old_count, &old_bytes) ||
+        0 != command_sum_lines(new_lines, new_count, &new_bytes))
+        return 1;
+
+    /* the header, the lengths, and the text, padded to 8 bytes. */
+    size_t size =
+        sizeof(command_t) + (old_count + new_count) * sizeof(uint32_t) +
+        old_bytes + new_bytes;
+    size = (size + 7U) & ~(size_t)7U;
+
+    /* a line changed in place needs only its changed bytes, and an offset. */
+    if (old_count == new_count && old_count > 0U)
+    {
+        size_t removed;
+        size_t delta_size =
+            sizeof(command_t) + 3U * old_count * sizeof(uint32_t) +
+            command_delta_bytes(old_lines, new_lines, old_count, &removed);
+        delta_size = (delta_size + 7U) & ~(size_t)7U;
+
+        if (delta_size < size)
+        {
+            command_t* c =
+                command_alloc(alloc, delta_size, line, COMMAND_TYPE_DELTA);
+            if (NULL == c)
+                return 1;
+
+            c->old_bytes = removed;
+            c->old_count = c->new_count = (uint32_t)old_count;
+            command_fill_delta(c, old_lines, new_lines, old_count);
+            allocator_stats_saved(alloc, size - delta_size);
+
+            *cmd = c;
+
+            MODEL_ASSERT(PROP_VALID_COMMAND(*cmd));
+
+            return 0;
+        }
+    }
+
+    command_t* c = command_alloc(alloc, size, line, COMMAND_TYPE_REPLACE);
+    if (NULL == c)
+        return 1;
+
+    c->old_bytes = old_bytes;
+    c->old_count = (uint32_t)old_count;
+    c->new_count = (uint32_t)new_count;
+
+    uint32_t* lengths = (uint32_t*)(c + 1);
+    char* text = (char*)(lengths + old_count + new_count);
+    text = command_copy_lines(lengths, text, old_lines, old_count);
+    command_copy_lines(lengths + old_count, text, new_lines, new_count);
+
+    *cmd = c;
+
+    MODEL_ASSERT(PROP_VALID_COMMAND(*cmd));
+
+    return 0;
+}
+
+/**
+ * \brief Copy lines into a command, appending their lengths and their text.
+ *
+ * \param lengths       The lengths of the lines are written here.
+ * \param text          The text of the lines is written here.
+ * \param lines         The lines.
+ * \param count         The number of lines.
+ *
+ * \returns a pointer just past the text written.
+ */
+static char* command_copy_lines(
+    uint32_t* lengths, char* text, const command_line_t* lines, size_t count)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        lengths[i] = (uint32_t)lines[i].length;
+        if (lines[i].length > 0U)
+            memcpy(text, lines[i].data, lines[i].length);
+        text += lines[i].length;
+    }
+
+    return text;
+}
+
+/**
+ * \brief Sum the lengths of lines.
+ *
+ * \param lines         The lines.
+ * \param count         The number of lines.
+ * \param total         Set to the total length.
+ *
+ * \returns 0 on success, or non-zero if a line is too long for a command.
+ */
+static int command_sum_lines(
+    const command_line_t* lines, size_t count, size_t* total)
+{
+    *total = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (lines[i].length > UINT32_MAX)
+            return 1;
+
+        *total += lines[i].length;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Check whether an offset into a line starts a codepoint.
+ *
+ * \param line          The line.
+ * \param offset        The offset.
+ *
+ * \returns true if the offset is at a codepoint boundary or the end.
+ */
+static bool command_is_boundary(const command_line_t* line, size_t offset)
+{
+    return
+        offset >= line->length ||
+        0x80U != ((unsigned char)line->data[offset] & 0xC0U);
+}
+
+/**
+ * \brief Find the bytes that an old line and its new line share at each end.
+ * Both ends fall on codepoint boundaries, so that the changed bytes are whole
+ * codepoints.
+ *
+ * \param old_line      The old line.
+ * \param new_line      The new line.
+ * \param prefix        Set to the length of the shared prefix.
+ * \param suffix        Set to the length of the shared suffix, which does not
+ *                      overlap the prefix.
+ */
+static void command_delta_bounds(
+    const command_line_t* old_line, const command_line_t* new_line,
+    size_t* prefix, size_t* suffix)
+{
+    size_t shortest =
+        (old_line->length < new_line->length)
+            ? old_line->length : new_line->length;
+
+    size_t p = 0U;
+    while (p < shortest && old_line->data[p] == new_line->data[p])
+        ++p;
+    while (p > 0U &&
+           !(command_is_boundary(old_line, p) &&
+             command_is_boundary(new_line, p)))
+        --p;
+
+    size_t s = 0U;
+    while (s < shortest - p &&
+           old_line->data[old_line->length - 1U - s] ==
+               new_line->data[new_line->length - 1U - s])
+        ++s;
+    while (s > 0U &&
+           !(command_is_boundary(old_line, old_line->length - s) &&
+             command_is_boundary(new_line, new_line->length - s)))
+        --s;
+
+    *prefix = p;
+    *suffix = s;
+}
+
+/**
+ * \brief Count the bytes which a delta of the given lines holds.
+ *
+ * \param old_lines     The old lines.
+ * \param new_lines     The new lines.
+ * \param count         The number of lines of each.
+ * \param removed       Set to the number of bytes removed from the old lines.
+ *
+ * \returns the number of bytes removed and inserted.
+ */
+static size_t command_delta_bytes(
+    const command_line_t* old_lines, const command_line_t* new_lines,
+    size_t count, size_t* removed)
+{
+    size_t total = 0U;
+
+    *removed = 0U;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        size_t prefix, suffix;
+        command_delta_bounds(&old_lines[i], &new_lines[i], &prefix, &suffix);
+
+        size_t old_change = old_lines[i].length - prefix - suffix;
+        *removed += old_change;
+        total += old_change + new_lines[i].length - prefix - suffix;
+    }
+
+    return total;
+}
+
+/**
+ * \brief Write the changed bytes of each line into a delta command.
+ *
+ * \param c             The command, whose header is filled in.
+ * \param old_lines     The old lines.
+ * \param new_lines     The new lines.
+ * \param count         The number of lines of each.
+ */
+static void command_fill_delta(
+    command_t* c, const command_line_t* old_lines,
+    const command_line_t* new_lines, size_t count)
+{
+    uint32_t* removed = (uint32_t*)(c + 1);
+    uint32_t* inserted = removed + count;
+    uint32_t* offsets = inserted + count;
+    char* old_text = (char*)(offsets + count);
+    char* new_text = old_text + c->old_bytes;
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        size_t prefix, suffix;
+        command_delta_bounds(&old_lines[i], &new_lines[i], &prefix, &suffix);
+
+        offsets[i] = (uint32_t)prefix;
+        removed[i] = (uint32_t)(old_lines[i].length - prefix - suffix);
+        inserted[i] = (uint32_t)(new_lines[i].length - prefix - suffix);
+
+        if (removed[i] > 0U)
+            memcpy(old_text, old_lines[i].data + prefix, removed[i]);
+        if (inserted[i] > 0U)
+            memcpy(new_text, new_lines[i].data + prefix, inserted[i]);
+
+        old_text += removed[i];
+        new_text += inserted[i];
+    }
+}
+
+/**
+ * \brief Allocate a zeroed command, and fill in the common parts of its
+ * header.
+ *
+ * \param alloc         The allocator.
+ * \param size          The size of the command.
+ * \param line          The line of the command.
+ * \param type          The type of the command.
+ *
+ * \returns the command, or NULL on failure.
+ */
+static command_t* command_alloc(
+    allocator_t* alloc, size_t size, size_t line, uint32_t type)
+{
+    command_t* c =
+        (command_t*)allocator_allocate_tagged(
+            alloc, size, ALLOCATOR_TAG_COMMAND);
+    if (NULL == c)
+        return NULL;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    memset(c, 0, size);
+    c->size = size;
+    c->line = line;
+    c->time = (uint64_t)now.tv_sec * 1000U + (uint64_t)now.tv_nsec / 1000000U;
+    c->type = type;
+
+    return c;
+}
@@ -0,0 +1,438 @@
+/**
+ * \brief Initialize a command stack kept in an append-only file.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* forward decls */
+static int command_log_push(command_stack_t* stack, const command_t* cmd);
+static const command_t* command_log_peek(command_stack_t* stack);
+static int command_log_pop(command_stack_t* stack);
+static int command_log_replace(command_stack_t* stack, const command_t* cmd);
+static uint64_t command_log_mark(command_stack_t* stack);
+static const command_t* command_log_next(
+    command_stack_t* stack, uint64_t* mark);
+static int command_log_truncate(command_stack_t* stack, uint64_t mark);
+static void command_log_dispose(disposable_t* disp);
+static const command_t* command_log_top(command_log_t* log, uint64_t* offset);
+static const unsigned char* command_log_read(
+    command_log_t* log, uint64_t offset, size_t length);
+static const unsigned char* command_log_map(
+    command_log_t* log, uint64_t offset, size_t length);
+static int command_log_write(
+    command_log_t* log, const void* data, size_t size, uint64_t offset);
+static int command_log_flush(command_log_t* log);
+
+/**
+ * \brief The command_log_init method creates an empty command stack in the
+ * file at the given path, which is created or truncated.  The file is left
+ * in place when the log is dispose()d.
+ *
+ * \param log           The log to initialize.
+ * \param path          The path of the log file.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_log_init(command_log_t* log, const char* path)
+{
+    MODEL_ASSERT(NULL != log);
+    MODEL_ASSERT(NULL != path);
+
+    memset(log, 0, sizeof(command_log_t));
+    log->stack.hdr.dispose = &command_log_dispose;
+    log->stack.push = &command_log_push;
+    log->stack.peek = &command_log_peek;
+    log->stack.pop = &command_log_pop;
+    log->stack.replace = &command_log_replace;
+    log->stack.mark = &command_log_mark;
+    log->stack.next = &command_log_next;
+    log->stack.truncate = &command_log_truncate;
+
+    log->buffer = (unsigned char*)malloc(COMMAND_LOG_BUFFER_SIZE);
+    if (NULL == log->buffer)
+        return 1;
+
+    log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (log->fd < 0)
+    {
+        free(log->buffer);
+        return 1;
+    }
+
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(&log->stack));
+
+    return 0;
+}
+
+/**
+ * \brief Append a command and its size to the log.
+ *
+ * \param stack     The log.
+ * \param cmd       The command to append.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_log_push(command_stack_t* stack, const command_t* cmd)
+{
+    command_log_t* log = (command_log_t*)stack;
+    uint64_t size = cmd->size;
+    size_t record = (size_t)size + sizeof(size);
+
+    /* make room in the write buffer. */
+    if (log->end - log->flushed + record > COMMAND_LOG_BUFFER_SIZE &&
+        0 != command_log_flush(log))
+        return 1;
+
+    /* a command too big for the buffer is written on its own. */
+    if (record > COMMAND_LOG_BUFFER_SIZE)
+    {
+        if (0 != command_log_write(log, cmd, (size_t)size, log->end) ||
+            0 != command_log_write(log, &size, sizeof(size), log->end + size))
+            return 1;
+
+        log->end += record;
+        log->flushed = log->end;
+
+        return 0;
+    }
+
+    unsigned char* tail = log->buffer + (log->end - log->flushed);
+    memcpy(tail, cmd, (size_t)size);
+    memcpy(tail + size, &size, sizeof(size));
+    log->end += record;
+
+    return 0;
+}
+
+/**
+ * \brief Return the command at the end of the log.
+ *
+ * \param stack     The log.
+ *
+ * \returns the command, or NULL if it can't be read.
+ */
+static const command_t* command_log_peek(command_stack_t* stack)
+{
+    uint64_t offset;
+
+    return command_log_top((command_log_t*)stack, &offset);
+}
+
+/**
+ * \brief Move the end of the log back to the start of its last command.
+ *
+ * \param stack     The log.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_log_pop(command_stack_t* stack)
+{
+    command_log_t* log = (command_log_t*)stack;
+    uint64_t offset;
+
+    if (NULL == command_log_top(log, &offset))
+        return 1;
+
+    log->end = offset;
+    if (log->flushed > log->end)
+        log->flushed = log->end;
+
+    return 0;
+}
+
+/**
+ * \brief Write a command over the last command in the log.  The new command
+ * is always gathered in the write buffer, which is written out first if the
+ * last command is there and the new one would not fit behind it, so nothing
+ * in the file is overwritten until the buffer is next written out.
+ *
+ * \param stack     The log.
+ * \param cmd       The command to write.
+ *
+ * \returns 0 on success and non-zero on failure, including if the command is
+ *          too big for the write buffer, in which case the log is unchanged.
+ */
+static int command_log_replace(command_stack_t* stack, const command_t* cmd)
+{
+    command_log_t* log = (command_log_t*)stack;
+    uint64_t size = cmd->size;
+    size_t record = (size_t)size + sizeof(size);
+    uint64_t offset;
+
+    if (record > COMMAND_LOG_BUFFER_SIZE ||
+        NULL == command_log_top(log, &offset))
+        return 1;
+
+    if (offset >= log->flushed &&
+        offset - log->flushed + record > COMMAND_LOG_BUFFER_SIZE &&
+        0 != command_log_flush(log))
+        return 1;
+
+    /* the buffer restarts at the last command if that was written out. */
+    if (offset < log->flushed)
+        log->flushed = offset;
+
+    unsigned char* tail = log->buffer + (offset - log->flushed);
+    memcpy(tail, cmd, (size_t)size);
+    memcpy(tail + size, &size, sizeof(size));
+    log->end = offset + record;
+
+    return 0;
+}
+
+/**
+ * \brief Return a mark for the end of the log.
+ *
+ * \param stack     The log.
+ *
+ * \returns the offset of the end of the log.
+ */
+static uint64_t command_log_mark(command_stack_t* stack)
+{
+    command_log_t* log = (command_log_t*)stack;
+
+    return log->end;
+}
+
+/**
+ * \brief Return the command which starts at a mark, and move the mark past it
+ * and its size.
+ *
+ * \param stack     The log.
+ * \param mark      The mark.
+ *
+ * \returns the command, or NULL if the mark is the end of the log or the
+ *          command can't be read.
+ */
+static const command_t* command_log_next(
+    command_stack_t* stack, uint64_t* mark)
+{
+    command_log_t* log = (command_log_t*)stack;
+    uint64_t size;
+
+    if (*mark >= log->end)
+        return NULL;
+
+    const unsigned char* header =
+        command_log_read(log, *mark, sizeof(command_t));
+    if (NULL == header)
+        return NULL;
+
+    memcpy(&size, header, sizeof(size));
+    const command_t* cmd =
+        (const command_t*)command_log_read(log, *mark, (size_t)size);
+    if (NULL == cmd)
+        return NULL;
+
+    *mark += size + sizeof(size);
+
+    return cmd;
+}
+
+/**
+ * \brief Move the end of the log back to a mark.
+ *
+ * \param stack     The log.
+ * \param mark      The mark.
+ *
+ * \returns 0.
+ */
+static int command_log_truncate(command_stack_t* stack, uint64_t mark)
+{
+    command_log_t* log = (command_log_t*)stack;
+
+    log->end = mark;
+    if (log->flushed > log->end)
+        log->flushed = log->end;
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a command log, writing out its buffer and closing it.
+ *
+ * \param disp      The log to dispose.
+ */
+static void command_log_dispose(disposable_t* disp)
+{
+    command_log_t* log = (command_log_t*)disp;
+
+    command_log_flush(log);
+
+    if (NULL != log->map)
+        munmap(log->map, log->map_size);
+
+    close(log->fd);
+    free(log->buffer);
+
+    log->map = NULL;
+    log->buffer = NULL;
+    log->fd = -1;
+    log->stack.count = 0U;
+}
+
+/**
+ * \brief Find the last command in the log, in the write buffer if it is
+ * there, and otherwise in the file.
+ *
+ * \param log       The log.
+ * \param offset    Set to the offset of the command in the log.
+ *
+ * \returns the command, or NULL if it can't be read.
+ */
+static const command_t* command_log_top(command_log_t* log, uint64_t* offset)
+{
+    uint64_t size;
+
+    const unsigned char* trailer =
+        command_log_read(log, log->end - sizeof(size), sizeof(size));
+    if (NULL == trailer)
+        return NULL;
+
+    memcpy(&size, trailer, sizeof(size));
+    *offset = log->end - sizeof(size) - size;
+
+    return (const command_t*)command_log_read(log, *offset, (size_t)size);
+}
+
+/**
+ * \brief Read bytes of the log, from the write buffer if they are there, and
+ * otherwise from the file.  The buffer only ever holds whole commands, so no
+ * command is split between the two.
+ *
+ * \param log       The log.
+ * \param offset    The offset of the bytes.
+ * \param length    The number of bytes.
+ *
+ * \returns a pointer to the bytes, or NULL on failure.
+ */
+static const unsigned char* command_log_read(
+    command_log_t* log, uint64_t offset, size_t length)
+{
+    if (offset >= log->flushed)
+        return log->buffer + (offset - log->flushed);
+
+    return command_log_map(log, offset, length);
+}
+
+/**
+ * \brief Map the part of the log file holding the given bytes, unless it is
+ * mapped already.  The mapping also covers up to \ref COMMAND_LOG_MAP_SIZE
+ * bytes of the file on either side of them, which hold the commands that
+ * will be read next, whether the log is read down or up.
+ *
+ * \param log       The log.
+ * \param offset    The offset of the bytes.
+ * \param length    The number of bytes.
+ *
+ * \returns a pointer to the bytes, or NULL on failure.
+ */
+static const unsigned char* command_log_map(
+    command_log_t* log, uint64_t offset, size_t length)
+{
+    if (NULL != log->map && offset >= log->map_offset &&
+        offset + length <= log->map_offset + log->map_size)
+    {
+        return (const unsigned char*)log->map + (offset - log->map_offset);
+    }
+
+    if (NULL != log->map)
+    {
+        munmap(log->map, log->map_size);
+        log->map = NULL;
+    }
+
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t start =
+        (offset > COMMAND_LOG_MAP_SIZE) ? offset - COMMAND_LOG_MAP_SIZE : 0U;
+    start -= start % page;
+
+    /* only the part of the file which has been written is mapped. */
+    uint64_t end = offset + length + COMMAND_LOG_MAP_SIZE;
+    if (end > log->flushed)
+        end = log->flushed;
+
+    size_t size = (size_t)(end - start);
+    void* map =
+        mmap(NULL, size, PROT_READ, MAP_SHARED, log->fd, (off_t)start);
+    if (MAP_FAILED == map)
+        return NULL;
+
+    log->map = map;
+    log->map_offset = start;
+    log->map_size = size;
+    ++log->map_count;
+
+    return (const unsigned char*)map + (offset - start);
+}
+
+/**
+ * \brief Write bytes to the log file at the given offset.
+ *
+ * \param log       The log.
+ * \param data      The bytes.
+ * \param size      The number of bytes.
+ * \param offset    The offset at which they are written.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_log_write(
+    command_log_t* log, const void* data, size_t size, uint64_t offset)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    while (size > 0U)
+    {
+        ssize_t written = pwrite(log->fd, bytes, size, (off_t)offset);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            return 1;
+        }
+
+        bytes += written;
+        size -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+
+    ++log->write_count;
+
+    return 0;
+}
+
+/**
+ * \brief Write out the write buffer.
+ *
+ * \param log       The log.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_log_flush(command_log_t* log)
+{
+    if (log->end == log->flushed)
+        return 0;
+
+    if (0 !=
+            command_log_write(
+                log, log->buffer, (size_t)(log->end - log->flushed),
+                log->flushed))
+        return 1;
+
+    log->flushed = log->end;
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * \brief Compress bytes with a small LZ77 coder.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <string.h>
+
+/**
+ * \brief The number of bits of the hash of four bytes.
+ */
+#define COMMAND_LZ_HASH_BITS 12U
+
+/**
+ * \brief The shortest match which is worth coding.
+ */
+#define COMMAND_LZ_MIN_MATCH 4U
+
+/**
+ * \brief The furthest back a match can be.
+ */
+#define COMMAND_LZ_MAX_OFFSET 65535U
+
+/* forward decls */
+static uint32_t command_lz_read32(const unsigned char* p);
+static unsigned char* command_lz_length(unsigned char* out, size_t length);
+static unsigned char* command_lz_sequence(
+    unsigned char* out, const unsigned char* literals, size_t literal_count,
+    size_t offset, size_t match);
+
+/**
+ * \brief The command_lz_compress method compresses bytes with a small LZ77
+ * coder, which finds repeats through a hash of the next four bytes.  It is
+ * made for the text of commands, and favors speed over ratio.
+ *
+ * The output is a series of sequences, each a token whose high and low
+ * nibbles are the number of literals and the length of the match less four,
+ * the literals, and the match's 16-bit little-endian offset.  A nibble of 15
+ * is extended by bytes which are added to it, up to and including the first
+ * which is not 255.  The last sequence holds only literals.
+ *
+ * \param dst           The compressed bytes are written here.
+ * \param src           The bytes to compress.
+ * \param size          The number of bytes to compress.
+ *
+ * \returns the number of bytes written, which is at most
+ *          COMMAND_LZ_BOUND(size).
+ */
+size_t command_lz_compress(void* dst, const void* src, size_t size)
+{
+    MODEL_ASSERT(NULL != dst);
+    MODEL_ASSERT(NULL != src || 0U == size);
+
+    const unsigned char* in = (const unsigned char*)src;
+    unsigned char* out = (unsigned char*)dst;
+    size_t table[1U << COMMAND_LZ_HASH_BITS];
+    size_t anchor = 0U;
+    size_t i = 0U;
+
+    memset(table, 0xFF, sizeof(table));
+
+    while (i + COMMAND_LZ_MIN_MATCH <= size)
+    {
+        uint32_t next = command_lz_read32(in + i);
+        uint32_t hash =
+            (next * UINT32_C(2654435761)) >> (32U - COMMAND_LZ_HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = i;
+
+        if (candidate >= i || i - candidate > COMMAND_LZ_MAX_OFFSET ||
+            command_lz_read32(in + candidate) != next)
+        {
+            ++i;
+            continue;
+        }
+
+        size_t match = COMMAND_LZ_MIN_MATCH;
+        while (i + match < size && in[candidate + match] == in[i + match])
+            ++match;
+
+        out =
+            command_lz_sequence(
+                out, in + anchor, i - anchor, i - candidate, match);
+        i += match;
+        anchor = i;
+    }
+
+    /* the rest is literals, with no match. */
+    out = command_lz_sequence(out, in + anchor, size - anchor, 0U, 0U);
+
+    return (size_t)(out - (unsigned char*)dst);
+}
+
+/**
+ * \brief Read four bytes, in any alignment.
+ *
+ * \param p             The bytes.
+ *
+ * \returns the bytes as a 32-bit value.
+ */
+static uint32_t command_lz_read32(const unsigned char* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+
+    return value;
+}
+
+/**
+ * \brief Write the bytes which extend a nibble of 15.
+ *
+ * \param out           The output.
+ * \param length        The length less 15.
+ *
+ * \returns a pointer just past the bytes written.
+ */
+static unsigned char* command_lz_length(unsigned char* out, size_t length)
+{
+    while (length >= 255U)
+    {
+        *out++ = 255U;
+        length -= 255U;
+    }
+
+    *out++ = (unsigned char)length;
+
+    return out;
+}
+
+/**
+ * \brief Write a sequence of literals, followed by a match unless its length
+ * is 0.
+ *
+ * \param out           The output.
+ * \param literals      The literals.
+ * \param literal_count The number of literals.
+ * \param offset        How far back the match is.
+ * \param match         The length of the match, or 0 for none.
+ *
+ * \returns a pointer just past the sequence.
+ */
+static unsigned char* command_lz_sequence(
+    unsigned char* out, const unsigned char* literals, size_t literal_count,
+    size_t offset, size_t match)
+{
+    size_t match_code = (0U == match) ? 0U : match - COMMAND_LZ_MIN_MATCH;
+    unsigned char* token = out++;
+
+    *token = (unsigned char)
+        (((literal_count < 15U) ? literal_count : 15U) << 4U |
+         ((match_code < 15U) ? match_code : 15U));
+
+    if (literal_count >= 15U)
+        out = command_lz_length(out, literal_count - 15U);
+
+    if (literal_count > 0U)
+        memcpy(out, literals, literal_count);
+    out += literal_count;
+
+    if (0U == match)
+        return out;
+
+    *out++ = (unsigned char)(offset & 0xFFU);
+    *out++ = (unsigned char)(offset >> 8U);
+
+    if (match_code >= 15U)
+        out = command_lz_length(out, match_code - 15U);
+
+    return out;
+}
@@ -0,0 +1,108 @@
+/**
+ * \brief Decompress bytes written by command_lz_compress().
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <string.h>
+
+/* forward decls */
+static int command_lz_read_length(
+    const unsigned char** in, const unsigned char* end, size_t* length);
+
+/**
+ * \brief The command_lz_decompress method decompresses the bytes written by
+ * command_lz_compress().
+ *
+ * \param dst           The decompressed bytes are written here.
+ * \param size          The number of bytes which were compressed.
+ * \param src           The compressed bytes.
+ * \param packed        The number of compressed bytes.
+ *
+ * \returns 0 on success, or non-zero if the compressed bytes are damaged or
+ *          do not decompress to exactly size bytes.
+ */
+int command_lz_decompress(
+    void* dst, size_t size, const void* src, size_t packed)
+{
+    MODEL_ASSERT(NULL != dst || 0U == size);
+    MODEL_ASSERT(NULL != src);
+
+    const unsigned char* in = (const unsigned char*)src;
+    const unsigned char* end = in + packed;
+    unsigned char* out = (unsigned char*)dst;
+    size_t written = 0U;
+
+    while (in < end)
+    {
+        unsigned char token = *in++;
+
+        size_t literals = token >> 4U;
+        if (15U == literals && 0 != command_lz_read_length(&in, end, &literals))
+            return 1;
+
+        if (literals > (size_t)(end - in) || literals > size - written)
+            return 1;
+
+        if (literals > 0U)
+            memcpy(out + written, in, literals);
+        in += literals;
+        written += literals;
+
+        /* the last sequence has no match. */
+        if (in == end)
+            break;
+
+        if (2U > (size_t)(end - in))
+            return 1;
+
+        size_t offset = (size_t)in[0] | (size_t)in[1] << 8U;
+        in += 2;
+
+        size_t match = token & 0x0FU;
+        if (15U == match && 0 != command_lz_read_length(&in, end, &match))
+            return 1;
+        match += 4U;
+
+        if (0U == offset || offset > written || match > size - written)
+            return 1;
+
+        /* a match may overlap the bytes it writes, so it goes a byte at a
+         * time. */
+        const unsigned char* from = out + written - offset;
+        for (size_t i = 0U; i < match; ++i)
+            out[written + i] = from[i];
+        written += match;
+    }
+
+    return (written == size) ? 0 : 1;
+}
+
+/**
+ * \brief Read the bytes which extend a nibble of 15, and add them to it.
+ *
+ * \param in            The input, which is moved past the bytes.
+ * \param end           The end of the input.
+ * \param length        The length to add to.
+ *
+ * \returns 0 on success, or non-zero if the input ends first.
+ */
+static int command_lz_read_length(
+    const unsigned char** in, const unsigned char* end, size_t* length)
+{
+    unsigned char byte;
+
+    do
+    {
+        if (*in >= end)
+            return 1;
+
+        byte = *(*in)++;
+        *length += byte;
+    } while (255U == byte);
+
+    return 0;
+}
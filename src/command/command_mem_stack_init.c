@@ -0,0 +1,232 @@
+/**
+ * \brief Initialize a command stack kept in memory.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <stddef.h>
+#include <string.h>
+
+/* forward decls */
+static int command_mem_stack_push(command_stack_t* stack, const command_t* cmd);
+static const command_t* command_mem_stack_peek(command_stack_t* stack);
+static int command_mem_stack_pop(command_stack_t* stack);
+static int command_mem_stack_replace(
+    command_stack_t* stack, const command_t* cmd);
+static uint64_t command_mem_stack_mark(command_stack_t* stack);
+static const command_t* command_mem_stack_next(
+    command_stack_t* stack, uint64_t* mark);
+static int command_mem_stack_truncate(command_stack_t* stack, uint64_t mark);
+static void command_mem_stack_dispose(disposable_t* disp);
+
+/**
+ * \brief The command_mem_stack_init method creates an empty command stack
+ * whose commands are copied into memory from the given allocator.
+ *
+ * \param stack         The stack to initialize.
+ * \param alloc         The allocator for the commands.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_mem_stack_init(command_mem_stack_t* stack, allocator_t* alloc)
+{
+    MODEL_ASSERT(NULL != stack);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+
+    memset(stack, 0, sizeof(command_mem_stack_t));
+    stack->stack.hdr.dispose = &command_mem_stack_dispose;
+    stack->stack.push = &command_mem_stack_push;
+    stack->stack.peek = &command_mem_stack_peek;
+    stack->stack.pop = &command_mem_stack_pop;
+    stack->stack.replace = &command_mem_stack_replace;
+    stack->stack.mark = &command_mem_stack_mark;
+    stack->stack.next = &command_mem_stack_next;
+    stack->stack.truncate = &command_mem_stack_truncate;
+    stack->alloc = alloc;
+
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(&stack->stack));
+
+    return 0;
+}
+
+/**
+ * \brief Copy a command onto the top of the chain.
+ *
+ * \param stack     The stack.
+ * \param cmd       The command to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_mem_stack_push(command_stack_t* stack, const command_t* cmd)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+
+    command_mem_entry_t* entry =
+        (command_mem_entry_t*)allocator_allocate_tagged(
+            mem->alloc, offsetof(command_mem_entry_t, u) + cmd->size,
+            ALLOCATOR_TAG_COMMAND);
+    if (NULL == entry)
+        return 1;
+
+    memcpy(&entry->u.cmd, cmd, cmd->size);
+    entry->prev = mem->top;
+    entry->next = NULL;
+    if (NULL == mem->top)
+        mem->bottom = entry;
+    else
+        mem->top->next = entry;
+    mem->top = entry;
+
+    return 0;
+}
+
+/**
+ * \brief Return the command on top of the chain.
+ *
+ * \param stack     The stack.
+ *
+ * \returns the command.
+ */
+static const command_t* command_mem_stack_peek(command_stack_t* stack)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+
+    return &mem->top->u.cmd;
+}
+
+/**
+ * \brief Release the command on top of the chain.
+ *
+ * \param stack     The stack.
+ *
+ * \returns 0.
+ */
+static int command_mem_stack_pop(command_stack_t* stack)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+    command_mem_entry_t* entry = mem->top;
+
+    mem->top = entry->prev;
+    if (NULL == mem->top)
+        mem->bottom = NULL;
+    else
+        mem->top->next = NULL;
+    allocator_release_tagged(mem->alloc, entry, ALLOCATOR_TAG_COMMAND);
+
+    return 0;
+}
+
+/**
+ * \brief Copy a command into a new entry, which takes the place of the entry
+ * on top of the chain.
+ *
+ * \param stack     The stack.
+ * \param cmd       The command to copy.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the chain is
+ *          unchanged.
+ */
+static int command_mem_stack_replace(
+    command_stack_t* stack, const command_t* cmd)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+    command_mem_entry_t* old = mem->top;
+
+    command_mem_entry_t* entry =
+        (command_mem_entry_t*)allocator_allocate_tagged(
+            mem->alloc, offsetof(command_mem_entry_t, u) + cmd->size,
+            ALLOCATOR_TAG_COMMAND);
+    if (NULL == entry)
+        return 1;
+
+    memcpy(&entry->u.cmd, cmd, cmd->size);
+    entry->prev = old->prev;
+    entry->next = NULL;
+    if (NULL == entry->prev)
+        mem->bottom = entry;
+    else
+        entry->prev->next = entry;
+    mem->top = entry;
+    allocator_release_tagged(mem->alloc, old, ALLOCATOR_TAG_COMMAND);
+
+    return 0;
+}
+
+/**
+ * \brief Return a mark for the entry on top of the chain.
+ *
+ * \param stack     The stack.
+ *
+ * \returns the address of the entry on top, or 0 if the stack is empty.
+ */
+static uint64_t command_mem_stack_mark(command_stack_t* stack)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+
+    return (uint64_t)(uintptr_t)mem->top;
+}
+
+/**
+ * \brief Return the command of the entry above a mark, and move the mark to
+ * that entry.
+ *
+ * \param stack     The stack.
+ * \param mark      The mark.
+ *
+ * \returns the command, or NULL if the mark is the top of the chain.
+ */
+static const command_t* command_mem_stack_next(
+    command_stack_t* stack, uint64_t* mark)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+    command_mem_entry_t* entry = (command_mem_entry_t*)(uintptr_t)*mark;
+
+    entry = (NULL == entry) ? mem->bottom : entry->next;
+    if (NULL == entry)
+        return NULL;
+
+    *mark = (uint64_t)(uintptr_t)entry;
+
+    return &entry->u.cmd;
+}
+
+/**
+ * \brief Release every entry above a mark.
+ *
+ * \param stack     The stack.
+ * \param mark      The mark.
+ *
+ * \returns 0.
+ */
+static int command_mem_stack_truncate(command_stack_t* stack, uint64_t mark)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)stack;
+    command_mem_entry_t* entry = (command_mem_entry_t*)(uintptr_t)mark;
+
+    while (entry != mem->top)
+    {
+        command_mem_stack_pop(stack);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a memory command stack, releasing every command.
+ *
+ * \param disp      The stack to dispose.
+ */
+static void command_mem_stack_dispose(disposable_t* disp)
+{
+    command_mem_stack_t* mem = (command_mem_stack_t*)disp;
+
+    while (NULL != mem->top)
+    {
+        command_mem_stack_pop(&mem->stack);
+    }
+
+    mem->stack.count = 0U;
+}
@@ -0,0 +1,407 @@
+/**
+ * \brief Merge two commands into one.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static int command_merge_lines(
+    command_line_t* old_lines, size_t* old_count, command_line_t* new_lines,
+    size_t* new_count, char* scratch, const command_t* first,
+    const command_t* second);
+static int command_merge_deltas(
+    command_t** merged, allocator_t* alloc, const command_t* first,
+    const command_t* second, size_t max_bytes);
+static void command_replace_lines(
+    const command_t* cmd, bool new_side, command_line_t* lines);
+static bool command_same_lines(
+    const command_line_t* x, const command_line_t* y, size_t count);
+static char* command_patch_lines(
+    command_line_t* lines, char* scratch, const command_t* delta,
+    bool forward);
+
+/**
+ * \brief The command_merge method creates a command which has the effect of
+ * the first command followed by the second, if they are compatible.
+ *
+ * The second command is compatible if it replaces exactly the lines which the
+ * first one left, such as a line edited twice, if it changes some of them in
+ * place, or if it inserts lines just after them, such as lines appended one
+ * after another.  Two deltas to the same line are compatible if the changes
+ * touch or overlap, as keystrokes do.  The merged command replaces the first
+ * command's old lines, and has the first command's time.
+ *
+ * \param merged        Set to the merged command, which must be released to
+ *                      the allocator with \ref ALLOCATOR_TAG_COMMAND.
+ * \param alloc         The allocator for the merged command.
+ * \param first         The earlier command.
+ * \param second        The later command.
+ * \param max_bytes     The largest size of the merged command.
+ *
+ * \returns 0 if the commands were merged, or non-zero if they are not
+ *          compatible, the merged command would be larger than max_bytes, or
+ *          it could not be allocated.
+ */
+int command_merge(
+    command_t** merged, allocator_t* alloc, const command_t* first,
+    const command_t* second, size_t max_bytes)
+{
+    MODEL_ASSERT(NULL != merged);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(PROP_VALID_COMMAND(first));
+    MODEL_ASSERT(PROP_VALID_COMMAND(second));
+
+    if (COMMAND_TYPE_DELTA == first->type &&
+        COMMAND_TYPE_DELTA == second->type)
+    {
+        return command_merge_deltas(merged, alloc, first, second, max_bytes);
+    }
+
+    /* the lines of the merged command, and room for any patched ones. */
+    command_line_t* old_lines =
+        (command_line_t*)malloc(
+            (first->old_count + 1U) * sizeof(command_line_t));
+    command_line_t* new_lines =
+        (command_line_t*)malloc(
+            (first->new_count + second->old_count + second->new_count + 1U) *
+            sizeof(command_line_t));
+    char* scratch = (char*)malloc(first->size + second->size);
+
+    size_t old_count, new_count;
+    int retval = 1;
+    if (NULL != old_lines && NULL != new_lines && NULL != scratch &&
+        0 ==
+            command_merge_lines(
+                old_lines, &old_count, new_lines, &new_count, scratch, first,
+                second) &&
+        0 ==
+            command_create(
+                merged, alloc, first->line, old_lines, old_count, new_lines,
+                new_count))
+    {
+        retval = 0;
+        if ((*merged)->size > max_bytes)
+        {
+            allocator_release_tagged(alloc, *merged, ALLOCATOR_TAG_COMMAND);
+            retval = 1;
+        }
+        else
+        {
+            (*merged)->time = first->time;
+        }
+    }
+
+    free(old_lines);
+    free(new_lines);
+    free(scratch);
+
+    return retval;
+}
+
+/**
+ * \brief Work out the old and new lines of two commands merged, where at
+ * least one of them holds whole lines.
+ *
+ * \param old_lines     Set to the old lines.
+ * \param old_count     Set to the number of old lines.
+ * \param new_lines     Set to the new lines.
+ * \param new_count     Set to the number of new lines.
+ * \param scratch       Room for the text of any lines which are patched.
+ * \param first         The earlier command.
+ * \param second        The later command.
+ *
+ * \returns 0 on success, or non-zero if the commands are not compatible.
+ */
+static int command_merge_lines(
+    command_line_t* old_lines, size_t* old_count, command_line_t* new_lines,
+    size_t* new_count, char* scratch, const command_t* first,
+    const command_t* second)
+{
+    /* a delta can only be undone over the very lines the second replaced. */
+    if (COMMAND_TYPE_DELTA == first->type)
+    {
+        if (second->line != first->line ||
+            second->old_count != first->new_count)
+            return 1;
+
+        command_replace_lines(second, false, old_lines);
+        if (NULL == command_patch_lines(old_lines, scratch, first, false))
+            return 1;
+
+        *old_count = first->old_count;
+        command_replace_lines(second, true, new_lines);
+        *new_count = second->new_count;
+
+        return 0;
+    }
+
+    command_replace_lines(first, false, old_lines);
+    *old_count = first->old_count;
+    command_replace_lines(first, true, new_lines);
+    *new_count = first->new_count;
+
+    /* a delta to some of the lines the first command left. */
+    if (COMMAND_TYPE_DELTA == second->type)
+    {
+        if (second->line < first->line ||
+            second->line + second->old_count > first->line + first->new_count)
+            return 1;
+
+        command_line_t* patched = new_lines + (second->line - first->line);
+
+        return
+            (NULL == command_patch_lines(patched, scratch, second, true))
+                ? 1 : 0;
+    }
+
+    /* the lines the first command left, replaced again. */
+    command_line_t* replaced = new_lines + first->new_count;
+    command_replace_lines(second, false, replaced);
+    if (second->line == first->line &&
+        second->old_count == first->new_count &&
+        command_same_lines(new_lines, replaced, first->new_count))
+    {
+        command_replace_lines(second, true, new_lines);
+        *new_count = second->new_count;
+
+        return 0;
+    }
+
+    /* lines inserted just after the lines the first command left. */
+    if (0U == second->old_count &&
+        second->line == first->line + first->new_count)
+    {
+        command_replace_lines(second, true, new_lines + first->new_count);
+        *new_count = first->new_count + second->new_count;
+
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * \brief Merge two deltas to the same line whose changes touch or overlap.
+ *
+ * The bytes between the two changes are known from the first command's
+ * inserted bytes and the second command's removed bytes, so the merged change
+ * covers both, without the rest of the line.
+ *
+ * \param merged        Set to the merged command.
+ * \param alloc         The allocator for the merged command.
+ * \param first         The earlier command.
+ * \param second        The later command.
+ * \param max_bytes     The largest size of the merged command.
+ *
+ * \returns 0 if the commands were merged, and non-zero if they were not.
+ */
+static int command_merge_deltas(
+    command_t** merged, allocator_t* alloc, const command_t* first,
+    const command_t* second, size_t max_bytes)
+{
+    if (1U != first->old_count || 1U != second->old_count ||
+        first->line != second->line)
+        return 1;
+
+    size_t o1 = command_offsets(first)[0];
+    size_t r1 = command_lengths(first)[0];
+    size_t i1 = command_lengths(first)[1];
+    const char* removed1 = command_text(first);
+    const char* inserted1 = removed1 + r1;
+
+    size_t o2 = command_offsets(second)[0];
+    size_t r2 = command_lengths(second)[0];
+    size_t i2 = command_lengths(second)[1];
+    const char* removed2 = command_text(second);
+    const char* inserted2 = removed2 + r2;
+
+    if (o2 > o1 + i1 || o1 > o2 + r2)
+        return 1;
+
+    /* the span of the line between the commands covering both changes. */
+    size_t lo = (o1 < o2) ? o1 : o2;
+    size_t hi = (o1 + i1 > o2 + r2) ? o1 + i1 : o2 + r2;
+    size_t span = hi - lo;
+    size_t old_length = span - i1 + r1;
+    size_t new_length = span - r2 + i2;
+
+    size_t size =
+        sizeof(command_t) + 3U * sizeof(uint32_t) + old_length + new_length;
+    size = (size + 7U) & ~(size_t)7U;
+    if (size > max_bytes)
+        return 1;
+
+    char* between = (char*)malloc(span + 1U);
+    if (NULL == between)
+        return 1;
+
+    /* where both commands know a byte, they must agree on it. */
+    for (size_t pos = lo; pos < hi; ++pos)
+    {
+        bool in_first = pos >= o1 && pos < o1 + i1;
+        bool in_second = pos >= o2 && pos < o2 + r2;
+
+        between[pos - lo] =
+            in_first ? inserted1[pos - o1] : removed2[pos - o2];
+        if (in_first && in_second && inserted1[pos - o1] != removed2[pos - o2])
+        {
+            free(between);
+            return 1;
+        }
+    }
+
+    command_t* c =
+        (command_t*)allocator_allocate_tagged(
+            alloc, size, ALLOCATOR_TAG_COMMAND);
+    if (NULL == c)
+    {
+        free(between);
+        return 1;
+    }
+
+    memset(c, 0, size);
+    c->size = size;
+    c->line = first->line;
+    c->time = first->time;
+    c->old_bytes = old_length;
+    c->type = COMMAND_TYPE_DELTA;
+    c->old_count = c->new_count = 1U;
+
+    uint32_t* lengths = (uint32_t*)(c + 1);
+    lengths[0] = (uint32_t)old_length;
+    lengths[1] = (uint32_t)new_length;
+    lengths[2] = (uint32_t)lo;
+
+    /* the span with each change taken back, and then made. */
+    char* text = (char*)(lengths + 3);
+    memcpy(text, between, o1 - lo);
+    memcpy(text + (o1 - lo), removed1, r1);
+    memcpy(text + (o1 - lo) + r1, between + (o1 + i1 - lo), hi - o1 - i1);
+    text += old_length;
+    memcpy(text, between, o2 - lo);
+    memcpy(text + (o2 - lo), inserted2, i2);
+    memcpy(text + (o2 - lo) + i2, between + (o2 + r2 - lo), hi - o2 - r2);
+
+    free(between);
+    *merged = c;
+
+    MODEL_ASSERT(PROP_VALID_COMMAND(*merged));
+
+    return 0;
+}
+
+/**
+ * \brief Get the old or new lines of a \ref COMMAND_TYPE_REPLACE command.
+ *
+ * \param cmd           The command.
+ * \param new_side      true for the new lines, and false for the old lines.
+ * \param lines         The lines are written here.
+ */
+static void command_replace_lines(
+    const command_t* cmd, bool new_side, command_line_t* lines)
+{
+    const uint32_t* lengths = command_lengths(cmd);
+    const char* text = command_text(cmd);
+    size_t count = cmd->old_count;
+
+    if (new_side)
+    {
+        lengths += cmd->old_count;
+        text += cmd->old_bytes;
+        count = cmd->new_count;
+    }
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        lines[i].data = text;
+        lines[i].length = lengths[i];
+        text += lengths[i];
+    }
+}
+
+/**
+ * \brief Check whether two runs of lines are the same.
+ *
+ * \param x             The first run.
+ * \param y             The second run.
+ * \param count         The number of lines in each.
+ *
+ * \returns true if they are.
+ */
+static bool command_same_lines(
+    const command_line_t* x, const command_line_t* y, size_t count)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (x[i].length != y[i].length ||
+            0 != memcmp(x[i].data, y[i].data, x[i].length))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Apply a delta to lines, or take it back, writing the patched lines
+ * to scratch space.
+ *
+ * \param lines         The lines to patch, which are changed to refer to the
+ *                      patched lines.
+ * \param scratch       Room for the patched lines.
+ * \param delta         The \ref COMMAND_TYPE_DELTA command.
+ * \param forward       true to apply the delta, and false to take it back.
+ *
+ * \returns a pointer just past the patched lines, or NULL if the lines do not
+ *          hold the bytes the delta replaces.
+ */
+static char* command_patch_lines(
+    command_line_t* lines, char* scratch, const command_t* delta,
+    bool forward)
+{
+    const uint32_t* removed = command_lengths(delta);
+    const uint32_t* inserted = removed + delta->old_count;
+    const uint32_t* offsets = command_offsets(delta);
+    const char* cut = command_text(delta);
+    const char* put = cut + delta->old_bytes;
+
+    for (size_t i = 0U; i < delta->old_count; ++i)
+    {
+        size_t cut_length = removed[i], put_length = inserted[i];
+        const char* cut_text = cut;
+        const char* put_text = put;
+        cut += removed[i];
+        put += inserted[i];
+
+        if (!forward)
+        {
+            cut_length = inserted[i];
+            put_length = removed[i];
+            cut_text = put - inserted[i];
+            put_text = cut - removed[i];
+        }
+
+        size_t offset = offsets[i];
+        if (lines[i].length < offset + cut_length ||
+            0 != memcmp(lines[i].data + offset, cut_text, cut_length))
+            return NULL;
+
+        size_t tail = lines[i].length - offset - cut_length;
+        memcpy(scratch, lines[i].data, offset);
+        memcpy(scratch + offset, put_text, put_length);
+        memcpy(
+            scratch + offset + put_length,
+            lines[i].data + offset + cut_length, tail);
+
+        lines[i].data = scratch;
+        lines[i].length = offset + put_length + tail;
+        scratch += lines[i].length;
+    }
+
+    return scratch;
+}
@@ -0,0 +1,31 @@
+/**
+ * \brief Set the window within which a command stack merges commands.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_coalesce method sets the window within which a
+ * pushed command is merged into the command on top of the stack.
+ *
+ * Commands are merged while the later one is made no more than window_ms
+ * milliseconds after the first command of the run, and the merged command is
+ * no larger than max_bytes.  A max_bytes of 0, the default, turns coalescing
+ * off.
+ *
+ * \param stack         The stack.
+ * \param window_ms     The time window, in milliseconds.
+ * \param max_bytes     The size window, in bytes.
+ */
+void command_stack_coalesce(
+    command_stack_t* stack, uint64_t window_ms, size_t max_bytes)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+
+    stack->coalesce_ms = window_ms;
+    stack->coalesce_bytes = max_bytes;
+}
@@ -0,0 +1,25 @@
+/**
+ * \brief Mark the depth of a command stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_mark method returns a mark for the current depth
+ * of the stack, which stays valid while the commands below it are on the
+ * stack.
+ *
+ * \param stack         The stack.
+ *
+ * \returns the mark.
+ */
+uint64_t command_stack_mark(command_stack_t* stack)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+
+    return stack->mark(stack);
+}
@@ -0,0 +1,29 @@
+/**
+ * \brief Read the command above a mark of a command stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_next method returns the command just above a mark,
+ * and moves the mark past it, so that the commands above a mark can be read
+ * oldest first.  The command remains valid until the stack is next changed or
+ * read.
+ *
+ * \param stack         The stack.
+ * \param mark          The mark, which is moved past the command.
+ *
+ * \returns the command, or NULL if the mark is the top of the stack or the
+ *          command can't be read.
+ */
+const command_t* command_stack_next(command_stack_t* stack, uint64_t* mark)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+    MODEL_ASSERT(NULL != mark);
+
+    return stack->next(stack, mark);
+}
@@ -0,0 +1,27 @@
+/**
+ * \brief Get the command on top of a command stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_peek method returns the command on top of the
+ * stack, which remains valid until the stack is next changed or peeked at.
+ *
+ * \param stack         The stack.
+ *
+ * \returns the command, or NULL if the stack is empty or it can't be read.
+ */
+const command_t* command_stack_peek(command_stack_t* stack)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+
+    if (0U == stack->count)
+        return NULL;
+
+    return stack->peek(stack);
+}
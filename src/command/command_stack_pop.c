@@ -0,0 +1,31 @@
+/**
+ * \brief Pop the command on top of a command stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_pop method removes the command on top of the
+ * stack, and seals the stack, so that a command pushed after an undo is never
+ * merged into an earlier one.
+ *
+ * \param stack         The stack.
+ *
+ * \returns 0 on success and non-zero if the stack is empty.
+ */
+int command_stack_pop(command_stack_t* stack)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+
+    if (0U == stack->count || 0 != stack->pop(stack))
+        return 1;
+
+    --stack->count;
+    stack->sealed = true;
+
+    return 0;
+}
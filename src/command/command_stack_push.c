@@ -0,0 +1,81 @@
+/**
+ * \brief Push a command onto a command stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/* forward decls */
+static int command_stack_push_merged(
+    command_stack_t* stack, const command_t* cmd);
+
+/**
+ * \brief The command_stack_push method pushes a copy of the command onto the
+ * stack.
+ *
+ * If the stack coalesces commands and is not sealed, a command made within
+ * the time window of the command on top, and compatible with it, is merged
+ * into it instead, as by command_merge(), so the count is unchanged.
+ *
+ * \param stack         The stack.
+ * \param cmd           The command to copy.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the stack is
+ *          unchanged.
+ */
+int command_stack_push(command_stack_t* stack, const command_t* cmd)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+    MODEL_ASSERT(PROP_VALID_COMMAND(cmd));
+
+    if (0U != stack->coalesce_bytes && !stack->sealed && stack->count > 0U &&
+        0 == command_stack_push_merged(stack, cmd))
+    {
+        ++stack->merge_count;
+        return 0;
+    }
+
+    if (0 != stack->push(stack, cmd))
+        return 1;
+
+    ++stack->count;
+    stack->sealed = false;
+
+    return 0;
+}
+
+/**
+ * \brief Replace the command on top of the stack with its merger with the
+ * given command.
+ *
+ * The merged command is built aside, and then takes the place of the top by
+ * the stack's replace method, which leaves the top as it was if it fails, so
+ * the stack is unchanged if anything fails.
+ *
+ * \param stack         The stack.
+ * \param cmd           The command to merge.
+ *
+ * \returns 0 if the command was merged, and non-zero if it was not.
+ */
+static int command_stack_push_merged(
+    command_stack_t* stack, const command_t* cmd)
+{
+    allocator_t* alloc = allocator_system();
+
+    const command_t* top = stack->peek(stack);
+    if (NULL == top || cmd->time < top->time ||
+        cmd->time - top->time > stack->coalesce_ms)
+        return 1;
+
+    command_t* merged;
+    if (0 != command_merge(&merged, alloc, top, cmd, stack->coalesce_bytes))
+        return 1;
+
+    int retval = stack->replace(stack, merged);
+    allocator_release_tagged(alloc, merged, ALLOCATOR_TAG_COMMAND);
+
+    return retval;
+}
@@ -0,0 +1,23 @@
+/**
+ * \brief Seal a command stack.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_seal method ends the run of commands being merged,
+ * so that the next command pushed is kept on its own.  An editor seals the
+ * stack when the cursor moves, or when it leaves insert mode.
+ *
+ * \param stack         The stack.
+ */
+void command_stack_seal(command_stack_t* stack)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+
+    stack->sealed = true;
+}
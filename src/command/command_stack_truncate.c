@@ -0,0 +1,34 @@
+/**
+ * \brief Cut a command stack back to a mark.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+
+/**
+ * \brief The command_stack_truncate method removes every command above a
+ * mark, and seals the stack.
+ *
+ * \param stack         The stack.
+ * \param mark          The mark.
+ * \param count         The number of commands below the mark.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_stack_truncate(
+    command_stack_t* stack, uint64_t mark, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(stack));
+    MODEL_ASSERT(count <= stack->count);
+
+    if (0 != stack->truncate(stack, mark))
+        return 1;
+
+    stack->count = count;
+    stack->sealed = true;
+
+    return 0;
+}
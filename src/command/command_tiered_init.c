@@ -0,0 +1,733 @@
+/**
+ * \brief Initialize a command stack which spills old commands to a file.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/command.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* forward decls */
+static int command_tiered_push(command_stack_t* stack, const command_t* cmd);
+static const command_t* command_tiered_peek(command_stack_t* stack);
+static int command_tiered_pop(command_stack_t* stack);
+static int command_tiered_replace(
+    command_stack_t* stack, const command_t* cmd);
+static uint64_t command_tiered_mark(command_stack_t* stack);
+static const command_t* command_tiered_next(
+    command_stack_t* stack, uint64_t* mark);
+static int command_tiered_truncate(command_stack_t* stack, uint64_t mark);
+static void command_tiered_dispose(disposable_t* disp);
+static int command_tiered_spill(command_tiered_t* tiered);
+static int command_tiered_reload(command_tiered_t* tiered);
+static int command_tiered_read(
+    command_tiered_t* tiered, size_t block, unsigned char* raw);
+static const command_t* command_tiered_cold(
+    command_tiered_t* tiered, size_t depth);
+static void command_tiered_drop(command_tiered_t* tiered);
+static size_t command_tiered_entry_size(const command_mem_entry_t* entry);
+static uint64_t command_tiered_now(void);
+static void command_tiered_time(
+    uint64_t start, uint64_t* total, uint64_t* max);
+
+/**
+ * \brief The command_tiered_init method creates an empty command stack which
+ * keeps up to hot_limit bytes of its most recent commands in memory from the
+ * given allocator, and spills the rest to the file at the given path.  The
+ * file is created or truncated, and then unlinked at once, so that it never
+ * outlives the stack.
+ *
+ * \param tiered        The stack to initialize.
+ * \param alloc         The allocator for the commands kept in memory.
+ * \param path          The path of the spill file.
+ * \param hot_limit     The most bytes of commands to keep in memory, or 0 for
+ *                      \ref COMMAND_TIERED_HOT_SIZE.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int command_tiered_init(
+    command_tiered_t* tiered, allocator_t* alloc, const char* path,
+    size_t hot_limit)
+{
+    MODEL_ASSERT(NULL != tiered);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(NULL != path);
+
+    memset(tiered, 0, sizeof(command_tiered_t));
+    tiered->stack.hdr.dispose = &command_tiered_dispose;
+    tiered->stack.push = &command_tiered_push;
+    tiered->stack.peek = &command_tiered_peek;
+    tiered->stack.pop = &command_tiered_pop;
+    tiered->stack.replace = &command_tiered_replace;
+    tiered->stack.mark = &command_tiered_mark;
+    tiered->stack.next = &command_tiered_next;
+    tiered->stack.truncate = &command_tiered_truncate;
+    tiered->alloc = alloc;
+    tiered->hot_limit =
+        (0U == hot_limit) ? COMMAND_TIERED_HOT_SIZE : hot_limit;
+    tiered->cache_block = SIZE_MAX;
+
+    tiered->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (tiered->fd < 0)
+        return 1;
+
+    unlink(path);
+
+    MODEL_ASSERT(PROP_VALID_COMMAND_STACK(&tiered->stack));
+
+    return 0;
+}
+
+/**
+ * \brief Copy a command onto the top of the hot chain, and spill the oldest
+ * commands while the chain is over its limit.
+ *
+ * \param stack     The stack.
+ * \param cmd       The command to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_tiered_push(command_stack_t* stack, const command_t* cmd)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+
+    command_mem_entry_t* entry =
+        (command_mem_entry_t*)allocator_allocate_tagged(
+            tiered->alloc, offsetof(command_mem_entry_t, u) + cmd->size,
+            ALLOCATOR_TAG_COMMAND);
+    if (NULL == entry)
+        return 1;
+
+    memcpy(&entry->u.cmd, cmd, cmd->size);
+    entry->prev = tiered->top;
+    entry->next = NULL;
+    if (NULL == tiered->top)
+        tiered->bottom = entry;
+    else
+        tiered->top->next = entry;
+    tiered->top = entry;
+    tiered->hot_bytes += command_tiered_entry_size(entry);
+    ++tiered->hot_count;
+
+    /* the command is pushed even if the file can't take the old ones; they
+     * are tried again with the next push. */
+    while (tiered->hot_bytes > tiered->hot_limit && tiered->hot_count > 1U)
+    {
+        if (0 != command_tiered_spill(tiered))
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Return the command on top of the stack, reloading the last block if
+ * every command is cold.
+ *
+ * \param stack     The stack.
+ *
+ * \returns the command, or NULL if it can't be reloaded.
+ */
+static const command_t* command_tiered_peek(command_stack_t* stack)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+
+    if (NULL == tiered->top && 0 != command_tiered_reload(tiered))
+        return NULL;
+
+    return &tiered->top->u.cmd;
+}
+
+/**
+ * \brief Release the command on top of the stack, reloading the last block if
+ * every command is cold.
+ *
+ * \param stack     The stack.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_tiered_pop(command_stack_t* stack)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+
+    if (NULL == tiered->top && 0 != command_tiered_reload(tiered))
+        return 1;
+
+    command_mem_entry_t* entry = tiered->top;
+    tiered->top = entry->prev;
+    if (NULL == tiered->top)
+        tiered->bottom = NULL;
+    else
+        tiered->top->next = NULL;
+    tiered->hot_bytes -= command_tiered_entry_size(entry);
+    --tiered->hot_count;
+    tiered->cursor = NULL;
+
+    allocator_release_tagged(tiered->alloc, entry, ALLOCATOR_TAG_COMMAND);
+
+    return 0;
+}
+
+/**
+ * \brief Copy a command into a new entry, which takes the place of the command
+ * on top of the stack, reloading the last block if every command is cold.
+ * The oldest commands are spilled as for a push.
+ *
+ * \param stack     The stack.
+ * \param cmd       The command to copy.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the command on
+ *          top is unchanged.
+ */
+static int command_tiered_replace(
+    command_stack_t* stack, const command_t* cmd)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+
+    if (NULL == tiered->top && 0 != command_tiered_reload(tiered))
+        return 1;
+
+    command_mem_entry_t* entry =
+        (command_mem_entry_t*)allocator_allocate_tagged(
+            tiered->alloc, offsetof(command_mem_entry_t, u) + cmd->size,
+            ALLOCATOR_TAG_COMMAND);
+    if (NULL == entry)
+        return 1;
+
+    command_mem_entry_t* old = tiered->top;
+    memcpy(&entry->u.cmd, cmd, cmd->size);
+    entry->prev = old->prev;
+    entry->next = NULL;
+    if (NULL == entry->prev)
+        tiered->bottom = entry;
+    else
+        entry->prev->next = entry;
+    tiered->top = entry;
+    tiered->hot_bytes -= command_tiered_entry_size(old);
+    tiered->hot_bytes += command_tiered_entry_size(entry);
+    tiered->cursor = NULL;
+
+    allocator_release_tagged(tiered->alloc, old, ALLOCATOR_TAG_COMMAND);
+
+    while (tiered->hot_bytes > tiered->hot_limit && tiered->hot_count > 1U)
+    {
+        if (0 != command_tiered_spill(tiered))
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Return a mark for the depth of the stack.
+ *
+ * \param stack     The stack.
+ *
+ * \returns the number of commands on the stack.
+ */
+static uint64_t command_tiered_mark(command_stack_t* stack)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+
+    return tiered->cold_count + tiered->hot_count;
+}
+
+/**
+ * \brief Return the command at the depth of a mark, and move the mark past
+ * it.  A hot command is found from the last one read, if that is below it,
+ * and a cold one from the cache of its block.
+ *
+ * \param stack     The stack.
+ * \param mark      The mark.
+ *
+ * \returns the command, or NULL if the mark is the top of the stack or the
+ *          command can't be read.
+ */
+static const command_t* command_tiered_next(
+    command_stack_t* stack, uint64_t* mark)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+    size_t depth = (size_t)*mark;
+
+    if (depth >= tiered->cold_count + tiered->hot_count)
+        return NULL;
+
+    const command_t* cmd;
+    if (depth < tiered->cold_count)
+    {
+        cmd = command_tiered_cold(tiered, depth);
+        if (NULL == cmd)
+            return NULL;
+    }
+    else
+    {
+        if (NULL == tiered->cursor || tiered->cursor_depth > depth)
+        {
+            tiered->cursor = tiered->bottom;
+            tiered->cursor_depth = tiered->cold_count;
+        }
+
+        while (tiered->cursor_depth < depth)
+        {
+            tiered->cursor = tiered->cursor->next;
+            ++tiered->cursor_depth;
+        }
+
+        cmd = &tiered->cursor->u.cmd;
+    }
+
+    *mark = depth + 1U;
+
+    return cmd;
+}
+
+/**
+ * \brief Remove the commands above a mark.  Hot commands are released, cold
+ * blocks wholly above it are cut from the file, and the block which holds the
+ * mark is reloaded to be cut back in memory.
+ *
+ * \param stack     The stack.
+ * \param mark      The mark.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_tiered_truncate(command_stack_t* stack, uint64_t mark)
+{
+    command_tiered_t* tiered = (command_tiered_t*)stack;
+    size_t depth = (size_t)mark;
+
+    while (tiered->hot_count > 0U &&
+           tiered->cold_count + tiered->hot_count > depth)
+    {
+        command_tiered_pop(stack);
+    }
+
+    while (tiered->block_count > 0U &&
+           tiered->blocks[tiered->block_count - 1U].depth >= depth)
+    {
+        command_tiered_drop(tiered);
+    }
+
+    if (tiered->cold_count > depth)
+    {
+        if (0 != command_tiered_reload(tiered))
+            return 1;
+
+        while (tiered->cold_count + tiered->hot_count > depth)
+        {
+            command_tiered_pop(stack);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a tiered command stack, releasing every hot command and
+ * closing the spill file.
+ *
+ * \param disp      The stack to dispose.
+ */
+static void command_tiered_dispose(disposable_t* disp)
+{
+    command_tiered_t* tiered = (command_tiered_t*)disp;
+
+    while (NULL != tiered->top)
+    {
+        command_mem_entry_t* entry = tiered->top;
+        tiered->top = entry->prev;
+        allocator_release_tagged(tiered->alloc, entry, ALLOCATOR_TAG_COMMAND);
+    }
+
+    close(tiered->fd);
+    free(tiered->blocks);
+    free(tiered->cache);
+
+    tiered->bottom = NULL;
+    tiered->blocks = NULL;
+    tiered->cache = NULL;
+    tiered->fd = -1;
+    tiered->hot_count = tiered->cold_count = tiered->block_count = 0U;
+    tiered->stack.count = 0U;
+}
+
+/**
+ * \brief Spill a block of the oldest hot commands to the end of the file.
+ * The command on top always stays hot.
+ *
+ * \param tiered    The stack.
+ *
+ * \returns 0 on success and non-zero on failure, in which case every command
+ *          stays hot.
+ */
+static int command_tiered_spill(command_tiered_t* tiered)
+{
+    uint64_t start = command_tiered_now();
+
+    size_t target = COMMAND_TIERED_BLOCK_SIZE;
+    if (tiered->hot_limit / 2U < target)
+        target = tiered->hot_limit / 2U;
+
+    /* gather the oldest commands, and at least one. */
+    size_t size = 0U;
+    size_t count = 0U;
+    command_mem_entry_t* last = tiered->bottom;
+    for (command_mem_entry_t* i = tiered->bottom; i != tiered->top;
+         i = i->next)
+    {
+        if (count > 0U && size + i->u.cmd.size > target)
+            break;
+
+        size += i->u.cmd.size;
+        ++count;
+        last = i;
+    }
+
+    if (tiered->block_count == tiered->block_capacity)
+    {
+        size_t capacity =
+            (0U == tiered->block_capacity) ? 16U : 2U * tiered->block_capacity;
+        command_tiered_block_t* blocks =
+            (command_tiered_block_t*)realloc(
+                tiered->blocks, capacity * sizeof(command_tiered_block_t));
+        if (NULL == blocks)
+            return 1;
+
+        tiered->blocks = blocks;
+        tiered->block_capacity = capacity;
+    }
+
+    unsigned char* raw = (unsigned char*)malloc(size + COMMAND_LZ_BOUND(size));
+    if (NULL == raw)
+        return 1;
+
+    unsigned char* packed = raw + size;
+    unsigned char* p = raw;
+    for (command_mem_entry_t* i = tiered->bottom; ; i = i->next)
+    {
+        memcpy(p, &i->u.cmd, i->u.cmd.size);
+        p += i->u.cmd.size;
+        if (i == last)
+            break;
+    }
+
+    size_t packed_size = command_lz_compress(packed, raw, size);
+
+    /* write the block past the last one. */
+    const unsigned char* out = packed;
+    size_t remaining = packed_size;
+    uint64_t offset = tiered->end;
+    while (remaining > 0U)
+    {
+        ssize_t written = pwrite(tiered->fd, out, remaining, (off_t)offset);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            free(raw);
+            return 1;
+        }
+
+        out += written;
+        remaining -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+
+    free(raw);
+
+    command_tiered_block_t* block = &tiered->blocks[tiered->block_count++];
+    block->offset = tiered->end;
+    block->depth = tiered->cold_count;
+    block->count = count;
+    block->size = size;
+    block->packed = packed_size;
+    tiered->end += packed_size;
+    tiered->cold_count += count;
+
+    /* the spilled commands leave the bottom of the chain. */
+    for (size_t i = 0U; i < count; ++i)
+    {
+        command_mem_entry_t* entry = tiered->bottom;
+        tiered->bottom = entry->next;
+        tiered->bottom->prev = NULL;
+        tiered->hot_bytes -= command_tiered_entry_size(entry);
+        --tiered->hot_count;
+        allocator_release_tagged(tiered->alloc, entry, ALLOCATOR_TAG_COMMAND);
+    }
+
+    tiered->cursor = NULL;
+    tiered->spill_bytes += size;
+    tiered->spill_packed_bytes += packed_size;
+    ++tiered->spill_count;
+    command_tiered_time(start, &tiered->spill_ns, &tiered->spill_max_ns);
+
+    return 0;
+}
+
+/**
+ * \brief Read the last block back into memory under the hot commands, and cut
+ * it from the file.
+ *
+ * \param tiered    The stack.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the block
+ *          stays cold.
+ */
+static int command_tiered_reload(command_tiered_t* tiered)
+{
+    if (0U == tiered->block_count)
+        return 1;
+
+    uint64_t start = command_tiered_now();
+    size_t index = tiered->block_count - 1U;
+    const command_tiered_block_t* block = &tiered->blocks[index];
+
+    unsigned char* raw = (unsigned char*)malloc(block->size);
+    if (NULL == raw || 0 != command_tiered_read(tiered, index, raw))
+    {
+        free(raw);
+        return 1;
+    }
+
+    /* build the chain of the block's commands aside, oldest first. */
+    command_mem_entry_t* first = NULL;
+    command_mem_entry_t* last = NULL;
+    size_t bytes = 0U;
+    size_t offset = 0U;
+    for (size_t i = 0U; i < block->count; ++i)
+    {
+        const command_t* cmd = (const command_t*)(raw + offset);
+        command_mem_entry_t* entry =
+            (command_mem_entry_t*)allocator_allocate_tagged(
+                tiered->alloc, offsetof(command_mem_entry_t, u) + cmd->size,
+                ALLOCATOR_TAG_COMMAND);
+        if (NULL == entry)
+        {
+            while (NULL != first)
+            {
+                command_mem_entry_t* next = first->next;
+                allocator_release_tagged(
+                    tiered->alloc, first, ALLOCATOR_TAG_COMMAND);
+                first = next;
+            }
+
+            free(raw);
+            return 1;
+        }
+
+        memcpy(&entry->u.cmd, cmd, cmd->size);
+        entry->prev = last;
+        entry->next = NULL;
+        if (NULL == last)
+            first = entry;
+        else
+            last->next = entry;
+        last = entry;
+
+        bytes += command_tiered_entry_size(entry);
+        offset += cmd->size;
+    }
+
+    free(raw);
+
+    /* the chain goes under the hot commands. */
+    last->next = tiered->bottom;
+    if (NULL == tiered->bottom)
+        tiered->top = last;
+    else
+        tiered->bottom->prev = last;
+    tiered->bottom = first;
+    tiered->hot_bytes += bytes;
+    tiered->hot_count += block->count;
+    tiered->cursor = NULL;
+
+    command_tiered_drop(tiered);
+
+    ++tiered->reload_count;
+    command_tiered_time(start, &tiered->reload_ns, &tiered->reload_max_ns);
+
+    return 0;
+}
+
+/**
+ * \brief Read a block from the file and decompress it.
+ *
+ * \param tiered    The stack.
+ * \param index     The index of the block.
+ * \param raw       The block's commands are written here.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int command_tiered_read(
+    command_tiered_t* tiered, size_t index, unsigned char* raw)
+{
+    const command_tiered_block_t* block = &tiered->blocks[index];
+
+    unsigned char* packed = (unsigned char*)malloc(block->packed);
+    if (NULL == packed)
+        return 1;
+
+    size_t done = 0U;
+    while (done < block->packed)
+    {
+        ssize_t got =
+            pread(
+                tiered->fd, packed + done, block->packed - done,
+                (off_t)(block->offset + done));
+        if (got < 0 && EINTR == errno)
+            continue;
+
+        if (got <= 0)
+        {
+            free(packed);
+            return 1;
+        }
+
+        done += (size_t)got;
+    }
+
+    int retval =
+        command_lz_decompress(raw, block->size, packed, block->packed);
+    free(packed);
+
+    return retval;
+}
+
+/**
+ * \brief Find a cold command, decompressing the block which holds it into the
+ * cache unless it is there already.  The block stays in the file.
+ *
+ * \param tiered    The stack.
+ * \param depth     The depth of the command, which is cold.
+ *
+ * \returns the command, or NULL if its block can't be read.
+ */
+static const command_t* command_tiered_cold(
+    command_tiered_t* tiered, size_t depth)
+{
+    /* find the last block which starts at or below the depth. */
+    size_t low = 0U;
+    size_t high = tiered->block_count;
+    while (high - low > 1U)
+    {
+        size_t middle = low + (high - low) / 2U;
+        if (tiered->blocks[middle].depth <= depth)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    const command_tiered_block_t* block = &tiered->blocks[low];
+    if (low != tiered->cache_block)
+    {
+        uint64_t start = command_tiered_now();
+
+        if (block->size > tiered->cache_capacity)
+        {
+            unsigned char* cache =
+                (unsigned char*)realloc(tiered->cache, block->size);
+            if (NULL == cache)
+                return NULL;
+
+            tiered->cache = cache;
+            tiered->cache_capacity = block->size;
+        }
+
+        tiered->cache_block = SIZE_MAX;
+        if (0 != command_tiered_read(tiered, low, tiered->cache))
+            return NULL;
+
+        tiered->cache_block = low;
+        tiered->cache_offset = 0U;
+        tiered->cache_depth = block->depth;
+
+        ++tiered->reload_count;
+        command_tiered_time(start, &tiered->reload_ns, &tiered->reload_max_ns);
+    }
+
+    /* walk from the last command read, if it is below this one. */
+    if (tiered->cache_depth > depth)
+    {
+        tiered->cache_offset = 0U;
+        tiered->cache_depth = block->depth;
+    }
+
+    while (tiered->cache_depth < depth)
+    {
+        const command_t* cmd =
+            (const command_t*)(tiered->cache + tiered->cache_offset);
+        tiered->cache_offset += cmd->size;
+        ++tiered->cache_depth;
+    }
+
+    return (const command_t*)(tiered->cache + tiered->cache_offset);
+}
+
+/**
+ * \brief Cut the last block from the file.
+ *
+ * \param tiered    The stack.
+ */
+static void command_tiered_drop(command_tiered_t* tiered)
+{
+    size_t index = --tiered->block_count;
+
+    tiered->end = tiered->blocks[index].offset;
+    tiered->cold_count -= tiered->blocks[index].count;
+    if (tiered->cache_block == index)
+        tiered->cache_block = SIZE_MAX;
+}
+
+/**
+ * \brief Get the number of bytes a hot command takes.
+ *
+ * \param entry     The entry of the command.
+ *
+ * \returns the size of the entry.
+ */
+static size_t command_tiered_entry_size(const command_mem_entry_t* entry)
+{
+    return offsetof(command_mem_entry_t, u) + entry->u.cmd.size;
+}
+
+/**
+ * \brief Get the time on the monotonic clock.
+ *
+ * \returns the time, in nanoseconds.
+ */
+static uint64_t command_tiered_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * \brief Add the time since start to a total, and to the greatest time if it
+ * is greater.
+ *
+ * \param start     The time the work started.
+ * \param total     The total time.
+ * \param max       The greatest time.
+ */
+static void command_tiered_time(
+    uint64_t start, uint64_t* total, uint64_t* max)
+{
+    uint64_t elapsed = command_tiered_now() - start;
+
+    *total += elapsed;
+    if (elapsed > *max)
+        *max = elapsed;
+}
@@ -0,0 +1,124 @@
+/**
+ * \brief Initialize a heap.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/heap.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void heap_dispose(disposable_t* disp);
+static void* heap_alloc_allocate(allocator_t* alloc, size_t size);
+static void heap_alloc_release(allocator_t* alloc, void* ptr);
+
+/**
+ * \brief The heap_init method creates a new empty heap.
+ *
+ * \param heap              The heap to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int heap_init(heap_t* heap)
+{
+    MODEL_ASSERT(NULL != heap);
+
+    /* clear the heap. */
+    memset(heap, 0, sizeof(heap_t));
+
+    /* set our dispose and allocator methods. */
+    heap->alloc.hdr.dispose = &heap_dispose;
+    heap->alloc.allocate = &heap_alloc_allocate;
+    heap->alloc.release = &heap_alloc_release;
+    heap->alloc.stats_enabled = true;
+
+    /* the heap is now valid. */
+    MODEL_ASSERT(PROP_VALID_HEAP(heap));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a heap, releasing every outstanding allocation.
+ *
+ * \param disp      The heap to dispose.
+ */
+static void heap_dispose(disposable_t* disp)
+{
+    heap_t* heap = (heap_t*)disp;
+
+    /* we are disposing a valid heap. */
+    MODEL_ASSERT(PROP_VALID_HEAP(heap));
+
+    heap_block_t* i = heap->blocks;
+    while (i != NULL)
+    {
+        heap_block_t* tmp = i->link.next;
+
+        free(i);
+
+        i = tmp;
+    }
+
+    heap->blocks = NULL;
+    allocator_stats_cleared(&heap->alloc);
+}
+
+/**
+ * \brief Allocate a block via malloc() and link it into the heap.
+ *
+ * \param alloc     The heap.
+ * \param size      The number of bytes to allocate.
+ *
+ * \returns the memory, or NULL on failure.
+ */
+static void* heap_alloc_allocate(allocator_t* alloc, size_t size)
+{
+    heap_t* heap = (heap_t*)alloc;
+
+    if (size > SIZE_MAX - sizeof(heap_block_t))
+        return NULL;
+
+    heap_block_t* block = (heap_block_t*)malloc(sizeof(heap_block_t) + size);
+    if (NULL == block)
+        return NULL;
+
+    block->link.size = size;
+    block->link.prev = NULL;
+    block->link.next = heap->blocks;
+    if (NULL != heap->blocks)
+        heap->blocks->link.prev = block;
+    heap->blocks = block;
+
+    allocator_stats_allocated(alloc, size);
+
+    return block + 1;
+}
+
+/**
+ * \brief Unlink a block from the heap and free() it.
+ *
+ * \param alloc     The heap.
+ * \param ptr       The memory to release.
+ */
+static void heap_alloc_release(allocator_t* alloc, void* ptr)
+{
+    heap_t* heap = (heap_t*)alloc;
+    heap_block_t* block = ((heap_block_t*)ptr) - 1;
+
+    if (NULL != block->link.prev)
+        block->link.prev->link.next = block->link.next;
+    else
+        heap->blocks = block->link.next;
+
+    if (NULL != block->link.next)
+        block->link.next->link.prev = block->link.prev;
+
+    allocator_stats_released(alloc, block->link.size);
+
+    free(block);
+}
@@ -0,0 +1,43 @@
+/**
+ * \brief Append a node into the intrusive list after the given node.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ilist_append method will append the given node AFTER the
+ * position node in the list.  This method assumes that the position node is
+ * part of the list; it is extremely important that the caller ensures that
+ * this is true.  The ownership of the data structure containing the new node
+ * is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param pos           The list node after which the node is appended.
+ * \param node          The embedded node to append.
+ */
+void ilist_append(ilist_t* list, ilist_node_t* pos, ilist_node_t* node)
+{
+    MODEL_ASSERT(PROP_VALID_ILIST_NOT_EMPTY(list));
+    MODEL_ASSERT(NULL != pos);
+    MODEL_ASSERT(NULL != node);
+
+    /* fix up the tail appending past the tail. */
+    if (list->tail == pos)
+        list->tail = node;
+
+    /* weave in the node. */
+    node->prev = pos;
+    node->next = pos->next;
+    if (pos->next)
+        pos->next->prev = node;
+    pos->next = node;
+    ++list->size;
+
+    MODEL_ASSERT(PROP_VALID_ILIST(list));
+}
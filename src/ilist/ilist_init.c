@@ -0,0 +1,69 @@
+/**
+ * \brief Initialize an intrusive linked list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void ilist_dispose(disposable_t* disp);
+
+/**
+ * \brief The ilist_init method creates a new empty intrusive linked list.
+ *
+ * Each data structure placed in this list must be disposable, and it must
+ * embed an \ref ilist_node_t at the given offset, as returned by offsetof().
+ *
+ * \param list          The list to initialize.
+ * \param offset        The offset of the \ref ilist_node_t within each data
+ *                      structure.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ilist_init(ilist_t* list, size_t offset)
+{
+    MODEL_ASSERT(NULL != list);
+
+    /* clear the list. */
+    memset(list, 0, sizeof(ilist_t));
+
+    /* set our dispose method and node offset. */
+    list->hdr.dispose = &ilist_dispose;
+    list->offset = offset;
+
+    /* the list is now valid. */
+    MODEL_ASSERT(PROP_VALID_ILIST(list) && PROP_VALID_ILIST_EMPTY(list));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of an intrusive list and the data structures it contains.
+ *
+ * \param disp      The list to dispose.
+ */
+static void ilist_dispose(disposable_t* disp)
+{
+    ilist_t* list = (ilist_t*)disp;
+
+    /* we are disposing a valid list. */
+    MODEL_ASSERT(PROP_VALID_ILIST(list));
+
+    ilist_node_t* i = list->head;
+    while (i != NULL)
+    {
+        ilist_node_t* tmp = i->next;
+
+        /* the node lives inside the data, so clean up the data. */
+        disposable_t* data = (disposable_t*)((char*)i - list->offset);
+        dispose(data);
+        free(data);
+
+        i = tmp;
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * \brief Insert a node into the intrusive list before the given node.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ilist_insert method will insert the given node BEFORE the
+ * position node in the list.  This method assumes that the position node is
+ * part of the list; it is extremely important that the caller ensures that
+ * this is true.  The ownership of the data structure containing the new node
+ * is transferred to the list.
+ *
+ * \param list          The list to modify.
+ * \param pos           The list node before which the node is inserted.
+ * \param node          The embedded node to insert.
+ */
+void ilist_insert(ilist_t* list, ilist_node_t* pos, ilist_node_t* node)
+{
+    MODEL_ASSERT(PROP_VALID_ILIST_NOT_EMPTY(list));
+    MODEL_ASSERT(NULL != pos);
+    MODEL_ASSERT(NULL != node);
+
+    /* fix up the head if inserting before head. */
+    if (list->head == pos)
+        list->head = node;
+
+    /* weave in the node. */
+    node->next = pos;
+    node->prev = pos->prev;
+    if (pos->prev)
+        pos->prev->next = node;
+    pos->prev = node;
+    ++list->size;
+
+    MODEL_ASSERT(PROP_VALID_ILIST(list));
+}
@@ -0,0 +1,66 @@
+/**
+ * \brief Pop a node off of the back of an intrusive list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ilist_pop_back method pops a node off of the back of the linked
+ * list.  The ownership of the data structure containing this node is
+ * transferred to the caller who is responsible for dispose()ing and free()ing
+ * it.
+ *
+ * If the list is empty, a non-zero value is returned.
+ *
+ * \param list          The list to modify.
+ * \param node          A pointer to the node pointer set to the popped node.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ilist_pop_back(ilist_t* list, ilist_node_t** node)
+{
+    MODEL_ASSERT(PROP_VALID_ILIST(list));
+    MODEL_ASSERT(NULL != node);
+
+    if (list->tail)
+    {
+        /* list is NOT empty. */
+        MODEL_ASSERT(PROP_VALID_ILIST_NOT_EMPTY(list));
+
+        /* capture the node. */
+        *node = list->tail;
+
+        /* fix up tail's prev or head. */
+        if (list->tail->prev)
+            list->tail->prev->next = NULL;
+        else
+            list->head = NULL;
+
+        /* fix up the tail and size. */
+        list->tail = list->tail->prev;
+        --list->size;
+
+        /* the popped node is no longer linked. */
+        (*node)->next = (*node)->prev = NULL;
+
+        /* list invariant is maintained. */
+        MODEL_ASSERT(PROP_VALID_ILIST(list));
+
+        return 0;
+    }
+    else
+    {
+        /* list IS empty. */
+        MODEL_ASSERT(PROP_VALID_ILIST_EMPTY(list));
+
+        *node = NULL;
+
+        return 1;
+    }
+}
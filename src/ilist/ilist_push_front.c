@@ -0,0 +1,41 @@
+/**
+ * \brief Push a node to the front of the intrusive list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ilist_push_front method pushes a node onto the front of the
+ * linked list.  The ownership of the data structure containing this node is
+ * transferred to the list and may be dispose()d and free()d if the list is
+ * dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param node          The embedded node to push onto the list.
+ */
+void ilist_push_front(ilist_t* list, ilist_node_t* node)
+{
+    MODEL_ASSERT(PROP_VALID_ILIST(list));
+    MODEL_ASSERT(NULL != node);
+
+    /* push the node to the front of the list. */
+    node->prev = NULL;
+    node->next = list->head;
+    if (list->head)
+        list->head->prev = node;
+    else
+        list->tail = node;
+    list->head = node;
+
+    /* there is now an extra element in the list. */
+    ++list->size;
+
+    /* the list is valid and not empty. */
+    MODEL_ASSERT(PROP_VALID_ILIST(list) && PROP_VALID_ILIST_NOT_EMPTY(list));
+}
@@ -0,0 +1,46 @@
+/**
+ * \brief Remove a node from the intrusive list, returning ownership of its data
+ * structure to the caller.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ilist_remove method will remove the given node from the list.
+ * This method assumes that the provided node is part of the list; it is
+ * extremely important that the caller ensures that this is true.  The
+ * ownership of the data structure containing this node is transferred to the
+ * caller who is responsible for dispose()ing and free()ing it.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node to be removed.
+ */
+void ilist_remove(ilist_t* list, ilist_node_t* node)
+{
+    MODEL_ASSERT(PROP_VALID_ILIST_NOT_EMPTY(list));
+    MODEL_ASSERT(NULL != node);
+
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        list->head = node->next;    /* fixup for head. */
+
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        list->tail = node->prev;    /* fixup for tail. */
+
+    /* the list is one smaller. */
+    --list->size;
+
+    /* the removed node is no longer linked. */
+    node->next = node->prev = NULL;
+
+    MODEL_ASSERT(PROP_VALID_ILIST(list));
+}
@@ -0,0 +1,57 @@
+/**
+ * \brief Split an intrusive list at a given node, creating two lists.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ilist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ilist_split method will split the list on the given node.  The
+ * original list x will contain all entries BEFORE the node, and the new y list
+ * will contain this node and all entries AFTER this node.  It is expected that
+ * the y list is empty, node belongs to the original x list, and both lists
+ * have the same node offset.
+ *
+ * \param x             The x list to split, which will contain all values
+ *                      BEFORE node after this operation is complete.
+ * \param node          The node on which the list is split.
+ * \param y             The y list to receive half of the list, starting with
+ *                      node, and all nodes AFTER node after this operation is
+ *                      complete.
+ */
+void ilist_split(ilist_t* x, ilist_node_t* node, ilist_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_ILIST_NOT_EMPTY(x));
+    MODEL_ASSERT(PROP_VALID_ILIST_EMPTY(y));
+    MODEL_ASSERT(NULL != node);
+    MODEL_ASSERT(x->offset == y->offset);
+
+    /* y takes node through the tail. */
+    y->head = node;
+    y->tail = x->tail;
+    y->size = 0U;
+
+    /* x keeps everything before node. */
+    x->tail = node->prev;
+    if (x->tail)
+        x->tail->next = NULL;
+    else
+        x->head = NULL;
+    node->prev = NULL;
+
+    /* count the nodes moved to y. */
+    while (node)
+    {
+        ++y->size;
+        node = node->next;
+    }
+    x->size -= y->size;
+
+    MODEL_ASSERT(PROP_VALID_ILIST(x));
+    MODEL_ASSERT(PROP_VALID_ILIST_NOT_EMPTY(y));
+}
@@ -7,6 +7,7 @@
 
 #include <model_check/assert.h>
 #include <ej/list.h>
+#include "list_internal.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -30,12 +31,79 @@ int list_init(list_t* list)
     /* set our dispose method. */
     list->hdr.dispose = &list_dispose;
 
+    /* nodes and data come from the system allocator by default. */
+    list->node_alloc = list->data_alloc = allocator_system();
+
     /* the list is now valid. */
     MODEL_ASSERT(PROP_VALID_LIST(list) && PROP_VALID_LIST_EMPTY(list));
 
     return 0;
 }
 
+/**
+ * \brief The list_init_pool method creates a new empty linked list whose nodes
+ * are allocated from the given node pool.  Data values are released to the
+ * system allocator.
+ *
+ * The pool may be shared between several lists; nodes can only be moved
+ * between lists that share the same allocators.  The pool must have an object
+ * size of at least sizeof(list_node_t), and it must outlive this list.
+ *
+ * \param list          The list to initialize.
+ * \param pool          The pool from which nodes are allocated.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int list_init_pool(list_t* list, pool_t* pool)
+{
+    MODEL_ASSERT(NULL != list);
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    /* the pool must be able to hold our nodes. */
+    if (pool->object_size < sizeof(list_node_t))
+        return 1;
+
+    /* initialize the list. */
+    if (0 != list_init(list))
+        return 1;
+
+    /* draw nodes from this pool. */
+    list->node_alloc = &pool->alloc;
+
+    return 0;
+}
+
+/**
+ * \brief The list_init_allocator method creates a new empty linked list whose
+ * nodes are allocated from, and whose data values are released to, the given
+ * allocator.
+ *
+ * Data values pushed onto this list must be allocated from this allocator.
+ * If the allocator releases everything in bulk when it is dispose()d, as an
+ * \ref arena_t does, then the list and all of its values can be discarded
+ * together by dispose()ing the allocator.  The allocator must outlive this
+ * list.
+ *
+ * \param list          The list to initialize.
+ * \param alloc         The allocator which owns the nodes and data.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int list_init_allocator(list_t* list, allocator_t* alloc)
+{
+    MODEL_ASSERT(NULL != list);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+
+    /* initialize the list. */
+    if (0 != list_init(list))
+        return 1;
+
+    /* nodes and data belong to this allocator. */
+    list->node_alloc = list->data_alloc = alloc;
+
+    return 0;
+}
+
 /**
  * \brief Dispose of a list and clean up nodes.
  *
@@ -58,9 +126,8 @@ static void list_dispose(disposable_t* disp)
             list_node_t* tmp = i->next;
 
             /* clean up the node and data. */
-            dispose(i->data);
-            free(i->data);
-            free(i);
+            list_data_release(list, i->data);
+            list_node_release(list, i);
 
             i = tmp;
         }
@@ -7,6 +7,7 @@
 
 #include <model_check/assert.h>
 #include <ej/list.h>
+#include "list_internal.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -30,7 +31,7 @@ int list_insert(list_t* list, list_node_t* node, disposable_t* data)
     MODEL_ASSERT(NULL != data);
 
     /* create a new node to hold the data. */
-    list_node_t* newnode = (list_node_t*)malloc(sizeof(list_node_t));
+    list_node_t* newnode = list_node_alloc(list);
     if (NULL == newnode)
         return 1;
 
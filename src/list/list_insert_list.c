@@ -0,0 +1,50 @@
+/**
+ * \brief Insert every node of another list into the list in constant time.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/list.h>
+#include "list_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The list_insert_list method will insert every node of the other list
+ * BEFORE the given node in the list, in constant time.  If node is NULL, then
+ * the nodes are appended to the end of the list.  This method assumes that the
+ * provided node is part of the list; it is extremely important that the
+ * caller ensures that this is true.  Both lists must share the same node
+ * pool.  After this method is called, the other list will be empty.
+ *
+ * \param list          The list to modify.
+ * \param node          The list node before which the nodes are inserted, or
+ *                      NULL to append them.
+ * \param other         The list whose nodes are destructively inserted.
+ */
+void list_insert_list(list_t* list, list_node_t* node, list_t* other)
+{
+    MODEL_ASSERT(PROP_VALID_LIST(list));
+    MODEL_ASSERT(PROP_VALID_LIST(other));
+    MODEL_ASSERT(list->node_alloc == other->node_alloc);
+    MODEL_ASSERT(list->data_alloc == other->data_alloc);
+
+    /* there is nothing to insert from an empty list. */
+    if (NULL == other->head)
+        return;
+
+    /* weave the other list in before node, or after the tail. */
+    list_link_range(
+        list, (NULL != node) ? node->prev : list->tail, other->head,
+        other->tail);
+    list->size += other->size;
+
+    /* the other list is now empty. */
+    other->head = other->tail = NULL;
+    other->size = 0U;
+
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(list));
+    MODEL_ASSERT(PROP_VALID_LIST_EMPTY(other));
+}
@@ -0,0 +1,106 @@
+/**
+ * \brief Internal helpers shared by the list implementation.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_LIST_INTERNAL_HEADER_GUARD
+# define EJ_LIST_INTERNAL_HEADER_GUARD
+
+#include <model_check/assert.h>
+#include <ej/list.h>
+#include <stdlib.h>
+
+/**
+ * \brief Allocate a list node from the list's node allocator.
+ *
+ * \param list          The list for which the node is allocated.
+ *
+ * \returns the uninitialized node, or NULL on failure.
+ */
+static inline list_node_t* list_node_alloc(list_t* list)
+{
+    return (list_node_t*)allocator_allocate_tagged(
+        list->node_alloc, sizeof(list_node_t), ALLOCATOR_TAG_LIST_NODE);
+}
+
+/**
+ * \brief Release a list node allocated by list_node_alloc().
+ *
+ * \param list          The list that owned the node.
+ * \param node          The node to release.
+ */
+static inline void list_node_release(list_t* list, list_node_t* node)
+{
+    allocator_release_tagged(list->node_alloc, node, ALLOCATOR_TAG_LIST_NODE);
+}
+
+/**
+ * \brief Dispose of a data value owned by the list and release it to the
+ * list's data allocator.  Values are attributed to the list data tag, so
+ * callers should allocate them with \ref ALLOCATOR_TAG_LIST_DATA.
+ *
+ * \param list          The list that owned the value.
+ * \param data          The value to release.
+ */
+static inline void list_data_release(list_t* list, disposable_t* data)
+{
+    dispose(data);
+    allocator_release_tagged(list->data_alloc, data, ALLOCATOR_TAG_LIST_DATA);
+}
+
+/**
+ * \brief Unlink the run of nodes from first through last from the list,
+ * fixing up the head and tail.  The list size is not changed.
+ *
+ * \param list          The list to modify.
+ * \param first         The first node of the run.
+ * \param last          The last node of the run.
+ */
+static inline void list_unlink_range(
+    list_t* list, list_node_t* first, list_node_t* last)
+{
+    if (first->prev)
+        first->prev->next = last->next;
+    else
+        list->head = last->next;
+
+    if (last->next)
+        last->next->prev = first->prev;
+    else
+        list->tail = first->prev;
+
+    first->prev = NULL;
+    last->next = NULL;
+}
+
+/**
+ * \brief Link an unlinked run of nodes from first through last into the list
+ * after the given node, or at the front of the list if the node is NULL.  The
+ * list size is not changed.
+ *
+ * \param list          The list to modify.
+ * \param node          The node after which the run is linked, or NULL.
+ * \param first         The first node of the run.
+ * \param last          The last node of the run.
+ */
+static inline void list_link_range(
+    list_t* list, list_node_t* node, list_node_t* first, list_node_t* last)
+{
+    list_node_t* next = (NULL != node) ? node->next : list->head;
+
+    first->prev = node;
+    if (node)
+        node->next = first;
+    else
+        list->head = first;
+
+    last->next = next;
+    if (next)
+        next->prev = last;
+    else
+        list->tail = last;
+}
+
+#endif /*EJ_LIST_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,45 @@
+/**
+ * \brief Move a run of nodes within the list in constant time.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/list.h>
+#include "list_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The list_move_range method will move the contiguous run of nodes
+ * from first through last so that it follows the dest node, in constant time.
+ * If dest is NULL, then the run is moved to the front of the list.  This
+ * method assumes that first, last, and dest are part of the list, that first
+ * does not come after last, and that dest is not part of the run; it is
+ * extremely important that the caller ensures that this is true.
+ *
+ * \param list          The list to modify.
+ * \param first         The first node of the run to be moved.
+ * \param last          The last node of the run to be moved.
+ * \param dest          The node after which the run is placed, or NULL to
+ *                      place the run at the front of the list.
+ */
+void list_move_range(
+    list_t* list, list_node_t* first, list_node_t* last, list_node_t* dest)
+{
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(list));
+    MODEL_ASSERT(NULL != first);
+    MODEL_ASSERT(NULL != last);
+    MODEL_ASSERT(dest != first && dest != last);
+
+    /* moving the run to where it already is does nothing. */
+    if (dest == first->prev)
+        return;
+
+    /* cut the run out and weave it back in after dest. */
+    list_unlink_range(list, first, last);
+    list_link_range(list, dest, first, last);
+
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(list));
+}
@@ -7,6 +7,7 @@
 
 #include <model_check/assert.h>
 #include <ej/list.h>
+#include "list_internal.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -48,7 +49,7 @@ int list_pop_back(list_t* list, disposable_t** data)
         --list->size;
 
         /* clean up the node. */
-        free(node);
+        list_node_release(list, node);
 
         /* list invariant is maintained. */
         MODEL_ASSERT(PROP_VALID_LIST(list));
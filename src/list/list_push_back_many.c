@@ -0,0 +1,138 @@
+/**
+ * \brief Push an array of values to the back of the linked list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/list.h>
+#include "list_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void list_push_back_many_run(
+    list_t* list, disposable_t** data, size_t count, unsigned char* run,
+    size_t stride);
+
+/**
+ * \brief The list_push_back_many method pushes count data values onto the
+ * back of the linked list, in order.  The ownership of this data is
+ * transferred to the list and may be dispose()d and free()d if deleted or if
+ * the list is dispose()d.
+ *
+ * The new nodes are allocated and linked together before they are spliced
+ * onto the list, so either every value is pushed or, on failure, none are and
+ * the list is unchanged.  A node allocator which supports runs, such as a
+ * pool, carves every node from one contiguous block at once.  Otherwise the
+ * nodes are reserved up front, so an arena still places them side by side.
+ *
+ * \param list          The list to modify.
+ * \param data          The array of count data items to push onto the list.
+ * \param count         The number of data items.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int list_push_back_many(list_t* list, disposable_t** data, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_LIST(list));
+    MODEL_ASSERT(NULL != data || 0U == count);
+
+    if (0U == count)
+        return 0;
+
+    /* carve the whole batch at once where the allocator can. */
+    size_t stride;
+    unsigned char* run =
+        (unsigned char*)allocator_allocate_run_tagged(
+            list->node_alloc, sizeof(list_node_t), count, &stride,
+            ALLOCATOR_TAG_LIST_NODE);
+    if (NULL != run)
+    {
+        list_push_back_many_run(list, data, count, run, stride);
+        return 0;
+    }
+
+    /* otherwise, reserve every node up front, so an arena can carve them
+     * from one contiguous block. */
+    if (0 != allocator_reserve(list->node_alloc, sizeof(list_node_t), count))
+        return 1;
+
+    /* build the run of nodes off to the side. */
+    list_node_t* first = NULL;
+    list_node_t* last = NULL;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        MODEL_ASSERT(PROP_VALID_DISPOSABLE(data[i]));
+
+        list_node_t* node = list_node_alloc(list);
+        if (NULL == node)
+        {
+            /* release the partial run; the data is still owned by the
+             * caller. */
+            while (NULL != first)
+            {
+                list_node_t* next = first->next;
+                list_node_release(list, first);
+                first = next;
+            }
+
+            return 1;
+        }
+
+        node->data = data[i];
+        node->prev = last;
+        node->next = NULL;
+        if (last)
+            last->next = node;
+        else
+            first = node;
+        last = node;
+    }
+
+    /* link the whole run onto the back of the list at once. */
+    list_link_range(list, list->tail, first, last);
+    list->size += count;
+
+    /* the list is valid and not empty. */
+    MODEL_ASSERT(PROP_VALID_LIST(list) && PROP_VALID_LIST_NOT_EMPTY(list));
+
+    return 0;
+}
+
+/**
+ * \brief Link a contiguous run of nodes holding the given data onto the back
+ * of the list.
+ *
+ * \param list          The list to modify.
+ * \param data          The array of count data items.
+ * \param count         The number of data items.
+ * \param run           The first node of the run.
+ * \param stride        The distance between nodes in the run.
+ */
+static void list_push_back_many_run(
+    list_t* list, disposable_t** data, size_t count, unsigned char* run,
+    size_t stride)
+{
+    list_node_t* first = (list_node_t*)run;
+    list_node_t* last = NULL;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        MODEL_ASSERT(PROP_VALID_DISPOSABLE(data[i]));
+
+        list_node_t* node = (list_node_t*)(run + i * stride);
+        node->data = data[i];
+        node->prev = last;
+        node->next = NULL;
+        if (last)
+            last->next = node;
+        last = node;
+    }
+
+    list_link_range(list, list->tail, first, last);
+    list->size += count;
+
+    /* the list is valid and not empty. */
+    MODEL_ASSERT(PROP_VALID_LIST(list) && PROP_VALID_LIST_NOT_EMPTY(list));
+}
@@ -7,6 +7,7 @@
 
 #include <model_check/assert.h>
 #include <ej/list.h>
+#include "list_internal.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -26,7 +27,7 @@ int list_push_front(list_t* list, disposable_t* data)
     MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
 
     /* attempt to allocate a list node. */
-    list_node_t* node = (list_node_t*)malloc(sizeof(list_node_t));
+    list_node_t* node = list_node_alloc(list);
     if (NULL == node)
         return 1;
 
@@ -8,6 +8,7 @@
 
 #include <model_check/assert.h>
 #include <ej/list.h>
+#include "list_internal.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -64,7 +65,7 @@ int list_remove(list_t* list, list_node_t* node, disposable_t** data)
     *data = node->data;
 
     /* cleanup. */
-    free(node);
+    list_node_release(list, node);
 
     return 0;
 }
@@ -0,0 +1,52 @@
+/**
+ * \brief Remove a run of nodes from the list in constant time.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/list.h>
+#include "list_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The list_remove_range method will remove the contiguous run of nodes
+ * from first through last from the list, moving them into the empty removed
+ * list in constant time.  This method assumes that first and last are part of
+ * the list, that first does not come after last, and that count is the number
+ * of nodes in the run; it is extremely important that the caller ensures that
+ * this is true.  Both lists must share the same node pool.  The ownership of
+ * the run is transferred to the removed list.
+ *
+ * \param list          The list to modify.
+ * \param first         The first node of the run to be removed.
+ * \param last          The last node of the run to be removed.
+ * \param count         The number of nodes from first through last.
+ * \param removed       The empty list which receives the run.
+ */
+void list_remove_range(
+    list_t* list, list_node_t* first, list_node_t* last, size_t count,
+    list_t* removed)
+{
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(list));
+    MODEL_ASSERT(PROP_VALID_LIST_EMPTY(removed));
+    MODEL_ASSERT(NULL != first);
+    MODEL_ASSERT(NULL != last);
+    MODEL_ASSERT(count > 0U && count <= list->size);
+    MODEL_ASSERT(list->node_alloc == removed->node_alloc);
+    MODEL_ASSERT(list->data_alloc == removed->data_alloc);
+
+    /* cut the run out of the list. */
+    list_unlink_range(list, first, last);
+    list->size -= count;
+
+    /* the removed list now holds the run. */
+    removed->head = first;
+    removed->tail = last;
+    removed->size = count;
+
+    MODEL_ASSERT(PROP_VALID_LIST(list));
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(removed));
+}
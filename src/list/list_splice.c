@@ -13,7 +13,7 @@
 /**
  * \brief The list_splice method will splice two lists into one.  After this
  * method is called, the x list will contain all nodes, and the y list will be
- * empty.
+ * empty.  Both lists must share the same node pool.
  *
  * \param x             The x list to splice with the values from the y list.
  * \param y             The y list to destructively splice.
@@ -22,6 +22,8 @@ void list_splice(list_t* x, list_t* y)
 {
     MODEL_ASSERT(PROP_VALID_LIST(x));
     MODEL_ASSERT(PROP_VALID_LIST(y));
+    MODEL_ASSERT(x->node_alloc == y->node_alloc);
+    MODEL_ASSERT(x->data_alloc == y->data_alloc);
 
     /* if there are no elements in x, then take y's head and tail. */
     if (NULL == x->head)
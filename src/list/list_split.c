@@ -14,7 +14,13 @@
  * \brief The list_split method will split the list on the given node.  The
  * original list x will contain all entries BEFORE the node, and the new y list
  * will contain this node and all entries AFTER this node.  It is expected that
- * the y list is empty, and node belongs to the original x list.
+ * the y list is empty, node belongs to the original x list, and both lists
+ * share the same node pool.
+ *
+ * The position of node is found by counting from node toward both ends of the
+ * list at once, so this method runs in time proportional to the distance from
+ * node to the nearer end of the list.  Callers that already know the position
+ * of node should use list_split_at() instead.
  *
  * \param x             The x list to split, which will contain all values
  *                      BEFORE node after this operation is complete.
@@ -28,45 +34,39 @@ void list_split(list_t* x, list_node_t* node, list_t* y)
     MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(x));
     MODEL_ASSERT(PROP_VALID_LIST_EMPTY(y));
     MODEL_ASSERT(NULL != node);
+    MODEL_ASSERT(x->node_alloc == y->node_alloc);
+    MODEL_ASSERT(x->data_alloc == y->data_alloc);
+
+    size_t index;
 
     if (node == x->head)
     {
-        y->head = node;
-        y->tail = x->tail;
-        y->size = x->size;
-        x->head = NULL;
-        x->tail = NULL;
-        x->size = 0U;
-        MODEL_ASSERT(PROP_VALID_LIST_EMPTY(x));
-        MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(y));
+        index = 0U;
     }
     else if (node == x->tail)
     {
-        x->tail = node->prev;
-        x->tail->next = NULL;
-        node->prev = NULL;
-        node->next = NULL;
-        y->head = node;
-        y->tail = node;
-        --x->size;
-        y->size = 1;
-        MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(x));
-        MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(y));
+        index = x->size - 1U;
     }
     else
     {
-        y->tail = x->tail;
-        x->tail = node->prev;
-        y->head = node;
-        x->tail->next = NULL;
-        node->prev = NULL;
-        while (node)
+        /* count from node toward both ends at once; whichever end is reached
+         * first determines the position of node. */
+        list_node_t* forward = node;
+        list_node_t* backward = node->prev;
+        size_t after = 0U, before = 0U;
+        while (NULL != forward && NULL != backward)
         {
-            ++y->size;
-            --x->size;
-            node = node->next;
+            ++after;
+            forward = forward->next;
+            ++before;
+            backward = backward->prev;
         }
-        MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(x));
-        MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(y));
+
+        if (NULL == forward)
+            index = x->size - after;
+        else
+            index = before;
     }
+
+    list_split_at(x, node, index, y);
 }
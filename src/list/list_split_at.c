@@ -0,0 +1,62 @@
+/**
+ * \brief Split a list at a given node whose position is known.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/list.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The list_split_at method will split the list on the given node, whose
+ * zero-based position in x is supplied by the caller.  The original list x
+ * will contain all entries BEFORE the node, and the new y list will contain
+ * this node and all entries AFTER this node.  It is expected that the y list
+ * is empty, node belongs to the original x list at the given index, and both
+ * lists share the same allocators.
+ *
+ * Because the caller supplies the index, the sizes of both lists are updated
+ * without walking either list, so this method runs in constant time.  The
+ * index is trusted rather than checked: if node is not at that position, the
+ * nodes are still divided correctly, but the sizes of x and y are wrong, and
+ * both lists are invalid from then on.  It is extremely important that the
+ * caller ensures that the index is correct.
+ *
+ * \param x             The x list to split, which will contain all values
+ *                      BEFORE node after this operation is complete.
+ * \param node          The node on which the list is split.
+ * \param index         The zero-based position of node in x, which must be
+ *                      less than the size of x.
+ * \param y             The y list to receive half of the list, starting with
+ *                      node, and all nodes AFTER node after this operation is
+ *                      complete.
+ */
+void list_split_at(list_t* x, list_node_t* node, size_t index, list_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(x));
+    MODEL_ASSERT(PROP_VALID_LIST_EMPTY(y));
+    MODEL_ASSERT(NULL != node);
+    MODEL_ASSERT(index < x->size);
+    MODEL_ASSERT(x->node_alloc == y->node_alloc);
+    MODEL_ASSERT(x->data_alloc == y->data_alloc);
+
+    /* y takes node through the tail. */
+    y->head = node;
+    y->tail = x->tail;
+    y->size = x->size - index;
+
+    /* x keeps everything before node. */
+    x->tail = node->prev;
+    if (x->tail)
+        x->tail->next = NULL;
+    else
+        x->head = NULL;
+    x->size = index;
+    node->prev = NULL;
+
+    MODEL_ASSERT(PROP_VALID_LIST(x));
+    MODEL_ASSERT(PROP_VALID_LIST_NOT_EMPTY(y));
+}
@@ -0,0 +1,56 @@
+/**
+ * \brief Find a value in an order statistic tree by position.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_at method finds the value at the given zero-based
+ * position in O(log n) time.  The ownership of this data remains with the
+ * tree.
+ *
+ * \param tree          The tree to search.
+ * \param index         The position of the value to find.
+ * \param data          A pointer to the data pointer set to the value.
+ *
+ * \returns 0 on success and non-zero if the index is out of bounds.
+ */
+int ostree_at(const ostree_t* tree, size_t index, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(NULL != data);
+
+    if (index >= ostree_node_size(tree->root))
+    {
+        *data = NULL;
+        return 1;
+    }
+
+    /* descend, using subtree sizes to steer toward the index. */
+    const ostree_node_t* i = tree->root;
+    for (;;)
+    {
+        size_t left_size = ostree_node_size(i->left);
+        if (index < left_size)
+        {
+            i = i->left;
+        }
+        else if (index == left_size)
+        {
+            *data = i->data;
+            return 0;
+        }
+        else
+        {
+            index -= left_size + 1U;
+            i = i->right;
+        }
+    }
+}
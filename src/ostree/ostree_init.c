@@ -0,0 +1,80 @@
+/**
+ * \brief Initialize an order statistic tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void ostree_dispose(disposable_t* disp);
+
+/**
+ * \brief The ostree_init method creates a new empty order statistic tree.
+ *
+ * \param tree          The tree to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ostree_init(ostree_t* tree)
+{
+    MODEL_ASSERT(NULL != tree);
+
+    /* clear the tree. */
+    memset(tree, 0, sizeof(ostree_t));
+
+    /* set our dispose method and seed the priority generator. */
+    tree->hdr.dispose = &ostree_dispose;
+    tree->seed = 2463534242U;
+
+    /* the tree is now valid. */
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree) && PROP_VALID_OSTREE_EMPTY(tree));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a tree and clean up nodes.
+ *
+ * Nodes are released without recursion by rotating each left child up until
+ * the current node has no left child, so arbitrarily deep trees are safe.
+ *
+ * \param disp      The tree to dispose.
+ */
+static void ostree_dispose(disposable_t* disp)
+{
+    ostree_t* tree = (ostree_t*)disp;
+
+    /* we are disposing a valid tree. */
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+
+    ostree_node_t* i = tree->root;
+    while (i != NULL)
+    {
+        if (NULL != i->left)
+        {
+            /* rotate the left child up. */
+            ostree_node_t* left = i->left;
+            i->left = left->right;
+            left->right = i;
+            i = left;
+        }
+        else
+        {
+            ostree_node_t* tmp = i->right;
+
+            /* clean up the node and data. */
+            dispose(i->data);
+            free(i->data);
+            free(i);
+
+            i = tmp;
+        }
+    }
+
+    tree->root = NULL;
+}
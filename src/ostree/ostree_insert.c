@@ -0,0 +1,54 @@
+/**
+ * \brief Insert a value into an order statistic tree by position.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_insert method inserts the given data value so that it
+ * has the given zero-based position, shifting the value at that position and
+ * all values after it back by one, in O(log n) time.  An index equal to the
+ * size of the tree appends the value.  The ownership of this data is
+ * transferred to the tree and may be dispose()d and free()d if deleted or if
+ * the tree is dispose()d.
+ *
+ * \param tree          The tree to modify.
+ * \param index         The position at which to insert the value.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ostree_insert(ostree_t* tree, size_t index, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    if (index > ostree_node_size(tree->root))
+        return 1;
+
+    /* create a node to hold the data. */
+    ostree_node_t* node = (ostree_node_t*)malloc(sizeof(ostree_node_t));
+    if (NULL == node)
+        return 1;
+
+    node->left = node->right = NULL;
+    node->size = 1U;
+    node->priority = ostree_next_priority(tree);
+    node->data = data;
+
+    /* split at the index and merge the node in between. */
+    ostree_node_t *left, *right;
+    ostree_node_split(tree->root, index, &left, &right);
+    tree->root = ostree_node_merge(ostree_node_merge(left, node), right);
+
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+
+    return 0;
+}
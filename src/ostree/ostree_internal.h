@@ -0,0 +1,69 @@
+/**
+ * \brief Internal helpers shared by the order statistic tree implementation.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_OSTREE_INTERNAL_HEADER_GUARD
+# define EJ_OSTREE_INTERNAL_HEADER_GUARD
+
+#include <ej/ostree.h>
+
+/**
+ * \brief Get the number of values in the subtree rooted at the given node.
+ *
+ * \param node          The subtree root, which may be NULL.
+ *
+ * \returns the number of values in this subtree.
+ */
+static inline size_t ostree_node_size(const ostree_node_t* node)
+{
+    return (NULL != node) ? node->size : 0U;
+}
+
+/**
+ * \brief Recompute the size of the given node from its children.
+ *
+ * \param node          The node to update.
+ */
+static inline void ostree_node_update(ostree_node_t* node)
+{
+    node->size =
+        1U + ostree_node_size(node->left) + ostree_node_size(node->right);
+}
+
+/**
+ * \brief Generate the next node priority for the given tree.
+ *
+ * \param tree          The tree whose generator is advanced.
+ *
+ * \returns a pseudo-random priority.
+ */
+uint32_t ostree_next_priority(ostree_t* tree);
+
+/**
+ * \brief Split the subtree rooted at node so that the first index values are
+ * in the left subtree, and the remaining values are in the right subtree.
+ *
+ * \param node          The subtree to split, which may be NULL.
+ * \param index         The number of values to place in the left subtree.
+ * \param left          Set to the left subtree.
+ * \param right         Set to the right subtree.
+ */
+void ostree_node_split(
+    ostree_node_t* node, size_t index, ostree_node_t** left,
+    ostree_node_t** right);
+
+/**
+ * \brief Merge two subtrees such that every value in the left subtree comes
+ * before every value in the right subtree.
+ *
+ * \param left          The left subtree, which may be NULL.
+ * \param right         The right subtree, which may be NULL.
+ *
+ * \returns the merged subtree.
+ */
+ostree_node_t* ostree_node_merge(ostree_node_t* left, ostree_node_t* right);
+
+#endif /*EJ_OSTREE_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,109 @@
+/**
+ * \brief Node balancing for the order statistic tree.
+ *
+ * The tree is an implicit treap: values are ordered by position, and each
+ * node carries a random priority that is kept in max-heap order.  Splitting
+ * and merging by position both run in expected O(log n) time, and every other
+ * mutating operation is built from them.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief Generate the next node priority for the given tree.
+ *
+ * \param tree          The tree whose generator is advanced.
+ *
+ * \returns a pseudo-random priority.
+ */
+uint32_t ostree_next_priority(ostree_t* tree)
+{
+    MODEL_ASSERT(NULL != tree);
+
+    /* xorshift32. */
+    uint32_t x = tree->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    tree->seed = x;
+
+    return x;
+}
+
+/**
+ * \brief Split the subtree rooted at node so that the first index values are
+ * in the left subtree, and the remaining values are in the right subtree.
+ *
+ * \param node          The subtree to split, which may be NULL.
+ * \param index         The number of values to place in the left subtree.
+ * \param left          Set to the left subtree.
+ * \param right         Set to the right subtree.
+ */
+void ostree_node_split(
+    ostree_node_t* node, size_t index, ostree_node_t** left,
+    ostree_node_t** right)
+{
+    MODEL_ASSERT(NULL != left);
+    MODEL_ASSERT(NULL != right);
+
+    if (NULL == node)
+    {
+        *left = *right = NULL;
+        return;
+    }
+
+    size_t left_size = ostree_node_size(node->left);
+    if (index <= left_size)
+    {
+        /* the split point is in the left subtree. */
+        ostree_node_split(node->left, index, left, &node->left);
+        *right = node;
+    }
+    else
+    {
+        /* the split point is in the right subtree. */
+        ostree_node_split(
+            node->right, index - left_size - 1U, &node->right, right);
+        *left = node;
+    }
+
+    ostree_node_update(node);
+}
+
+/**
+ * \brief Merge two subtrees such that every value in the left subtree comes
+ * before every value in the right subtree.
+ *
+ * \param left          The left subtree, which may be NULL.
+ * \param right         The right subtree, which may be NULL.
+ *
+ * \returns the merged subtree.
+ */
+ostree_node_t* ostree_node_merge(ostree_node_t* left, ostree_node_t* right)
+{
+    if (NULL == left)
+        return right;
+    if (NULL == right)
+        return left;
+
+    /* the root with the higher priority stays on top. */
+    if (left->priority > right->priority)
+    {
+        left->right = ostree_node_merge(left->right, right);
+        ostree_node_update(left);
+        return left;
+    }
+    else
+    {
+        right->left = ostree_node_merge(left, right->left);
+        ostree_node_update(right);
+        return right;
+    }
+}
@@ -0,0 +1,29 @@
+/**
+ * \brief Append a value to an order statistic tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_push_back method appends the given data value to the end
+ * of the tree.  The ownership of this data is transferred to the tree.
+ *
+ * \param tree          The tree to modify.
+ * \param data          The data to append.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ostree_push_back(ostree_t* tree, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    return ostree_insert(tree, ostree_node_size(tree->root), data);
+}
@@ -0,0 +1,73 @@
+/**
+ * \brief Remove a value from an order statistic tree by position.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_remove method removes the value at the given zero-based
+ * position in O(log n) time, returning the data value to be dispose()d and
+ * free()d by the caller.
+ *
+ * \param tree          The tree to modify.
+ * \param index         The position of the value to remove.
+ * \param data          Pointer to the data pointer returned to the caller.
+ *
+ * \returns 0 on success and non-zero if the index is out of bounds.
+ */
+int ostree_remove(ostree_t* tree, size_t index, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(NULL != data);
+
+    if (index >= ostree_node_size(tree->root))
+    {
+        *data = NULL;
+        return 1;
+    }
+
+    /* find the link that points to the node at this index.  The index is in
+     * bounds, so every subtree along the way will shrink by one. */
+    ostree_node_t** link = &tree->root;
+    for (;;)
+    {
+        ostree_node_t* i = *link;
+        size_t left_size = ostree_node_size(i->left);
+
+        if (index == left_size)
+            break;
+
+        --i->size;
+
+        if (index < left_size)
+        {
+            link = &i->left;
+        }
+        else
+        {
+            index -= left_size + 1U;
+            link = &i->right;
+        }
+    }
+
+    /* replace the node with the merge of its children. */
+    ostree_node_t* node = *link;
+    *link = ostree_node_merge(node->left, node->right);
+
+    /* pass the data to the caller. */
+    *data = node->data;
+
+    /* cleanup. */
+    free(node);
+
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+
+    return 0;
+}
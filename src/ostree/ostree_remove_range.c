@@ -0,0 +1,47 @@
+/**
+ * \brief Remove a range of values from an order statistic tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_remove_range method moves the count values starting at
+ * the given zero-based position from the tree into the empty y tree in
+ * O(log n) time.  The ownership of these values is transferred to y.
+ *
+ * \param tree          The tree to modify.
+ * \param index         The position of the first value to remove.
+ * \param count         The number of values to remove.
+ * \param y             The empty tree which receives the removed values.
+ *
+ * \returns 0 on success and non-zero if the range is out of bounds.
+ */
+int ostree_remove_range(
+    ostree_t* tree, size_t index, size_t count, ostree_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(PROP_VALID_OSTREE_EMPTY(y));
+
+    size_t size = ostree_node_size(tree->root);
+    if (index > size || count > size - index)
+        return 1;
+
+    /* cut out the range and rejoin the values around it. */
+    ostree_node_t *left, *middle, *right;
+    ostree_node_split(tree->root, index, &left, &right);
+    ostree_node_split(right, count, &middle, &right);
+    tree->root = ostree_node_merge(left, right);
+    y->root = middle;
+
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(PROP_VALID_OSTREE(y));
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+/**
+ * \brief Get the size of an order statistic tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_size method returns the number of values in the tree.
+ *
+ * \param tree          The tree to query.
+ *
+ * \returns the number of values in the tree.
+ */
+size_t ostree_size(const ostree_t* tree)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+
+    return ostree_node_size(tree->root);
+}
@@ -0,0 +1,34 @@
+/**
+ * \brief Splice two order statistic trees together.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_splice method will splice two trees into one in
+ * O(log n) time.  After this method is called, the x tree will contain all
+ * values, with the values of y following the values of x, and the y tree will
+ * be empty.
+ *
+ * \param x             The x tree to splice with the values from the y tree.
+ * \param y             The y tree to destructively splice.
+ */
+void ostree_splice(ostree_t* x, ostree_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(x));
+    MODEL_ASSERT(PROP_VALID_OSTREE(y));
+
+    x->root = ostree_node_merge(x->root, y->root);
+    y->root = NULL;
+
+    /* x is valid, and y is now empty. */
+    MODEL_ASSERT(PROP_VALID_OSTREE(x));
+    MODEL_ASSERT(PROP_VALID_OSTREE_EMPTY(y));
+}
@@ -0,0 +1,34 @@
+/**
+ * \brief Split an order statistic tree at a given position, creating two trees.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ostree_split method will split the tree at the given zero-based
+ * position in O(log n) time.  The original tree x will contain all values
+ * BEFORE the position, and the new y tree will contain the value at this
+ * position and all values AFTER it.  It is expected that the y tree is empty.
+ * An index greater than or equal to the size of x leaves y empty.
+ *
+ * \param x             The x tree to split.
+ * \param index         The position at which the tree is split.
+ * \param y             The y tree to receive the values from index onward.
+ */
+void ostree_split(ostree_t* x, size_t index, ostree_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(x));
+    MODEL_ASSERT(PROP_VALID_OSTREE_EMPTY(y));
+
+    ostree_node_split(x->root, index, &x->root, &y->root);
+
+    MODEL_ASSERT(PROP_VALID_OSTREE(x));
+    MODEL_ASSERT(PROP_VALID_OSTREE(y));
+}
@@ -0,0 +1,89 @@
+/**
+ * \brief Visit a range of values in an order statistic tree in order.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ostree.h>
+#include "ostree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static int ostree_visit_node(
+    const ostree_node_t* node, size_t offset, size_t first, size_t last,
+    ostree_visitor_t visitor, void* context);
+
+/**
+ * An order statistic tree holds the root of the tree and the state of the
+ * generator used to assign node priorities.
+ */
+int ostree_visit(
+    const ostree_t* tree, size_t index, size_t count, ostree_visitor_t visitor,
+    void* context)
+{
+    MODEL_ASSERT(PROP_VALID_OSTREE(tree));
+    MODEL_ASSERT(NULL != visitor);
+
+    size_t size = ostree_node_size(tree->root);
+    if (index >= size || 0U == count)
+        return 0;
+
+    /* clamp the range to the end of the tree. */
+    size_t last = (count > size - index) ? size : index + count;
+
+    return
+        ostree_visit_node(tree->root, 0U, index, last, visitor, context);
+}
+
+/**
+ * \brief Visit the values of a subtree whose positions fall in [first, last).
+ *
+ * \param node          The subtree to visit.
+ * \param offset        The position of the first value in this subtree.
+ * \param first         The first position to visit.
+ * \param last          One past the last position to visit.
+ * \param visitor       The visitor to call for each value.
+ * \param context       The user context to pass to the visitor.
+ *
+ * \returns 0 to continue visiting, or the visitor's non-zero stop value.
+ */
+static int ostree_visit_node(
+    const ostree_node_t* node, size_t offset, size_t first, size_t last,
+    ostree_visitor_t visitor, void* context)
+{
+    int retval;
+
+    while (NULL != node && offset < last && offset + node->size > first)
+    {
+        size_t position = offset + ostree_node_size(node->left);
+
+        /* visit the left subtree if it overlaps the range. */
+        if (first < position)
+        {
+            retval =
+                ostree_visit_node(
+                    node->left, offset, first, last, visitor, context);
+            if (0 != retval)
+                return retval;
+        }
+
+        /* visit this node if it is in the range. */
+        if (position >= last)
+            return 0;
+        if (position >= first)
+        {
+            retval = visitor(context, position, node->data);
+            if (0 != retval)
+                return retval;
+        }
+
+        /* continue with the right subtree without recursing. */
+        offset = position + 1U;
+        node = node->right;
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * \brief Allocate an object from a fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/pool.h>
+#include "pool_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The pool_allocate method returns an object from the pool.
+ *
+ * Recycled objects are preferred.  Otherwise, the object is carved from the
+ * current slab, then from the spare slab, and a new slab is allocated if both
+ * are exhausted.  The object is owned by the pool and must be returned via
+ * pool_release() or reclaimed when the pool is dispose()d.
+ *
+ * \param pool              The pool from which the object is allocated.
+ *
+ * \returns the object, or NULL if a new slab could not be allocated.
+ */
+void* pool_allocate(pool_t* pool)
+{
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    void* object;
+
+    /* recycle a released object if one is available. */
+    if (NULL != pool->free_list)
+    {
+        object = pool->free_list;
+        pool->free_list = pool->free_list->next;
+        --pool->free_count;
+    }
+    else
+    {
+        /* move on to the spare, or to a new slab, once this one is done. */
+        if (pool->bump == pool->bump_end && pool->spare != pool->spare_end)
+        {
+            pool->bump = pool->spare;
+            pool->bump_end = pool->spare_end;
+            pool->spare = pool->spare_end = NULL;
+        }
+        else if (pool->bump == pool->bump_end)
+        {
+            unsigned char* objects =
+                pool_slab_alloc(pool, pool->objects_per_slab);
+            if (NULL == objects)
+                return NULL;
+
+            pool->bump = objects;
+            pool->bump_end =
+                objects + pool->object_size * pool->objects_per_slab;
+        }
+
+        /* carve the next object from the current slab. */
+        object = pool->bump;
+        pool->bump += pool->object_size;
+    }
+
+    ++pool->live_count;
+    allocator_stats_allocated(&pool->alloc, pool->object_size);
+
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    return object;
+}
@@ -0,0 +1,68 @@
+/**
+ * \brief Allocate a contiguous run of objects from a fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/pool.h>
+#include "pool_internal.h"
+
+/**
+ * \brief The pool_allocate_run method returns count objects which lie one after
+ * another in the same slab, each object_size bytes after the last.
+ *
+ * The run is carved from the current slab if it fits, then from the spare
+ * slab.  Otherwise a new slab of at least count objects is allocated, and its
+ * unused objects become the spare.  Each object is owned by the pool and is
+ * returned via pool_release() on its own.
+ *
+ * \param pool              The pool from which the objects are allocated.
+ * \param count             The number of objects, which must not be 0.
+ *
+ * \returns the first object, or NULL if a new slab could not be allocated.
+ */
+void* pool_allocate_run(pool_t* pool, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+    MODEL_ASSERT(0U < count);
+
+    unsigned char* run;
+
+    if (count <= pool_remaining(pool, pool->bump, pool->bump_end))
+    {
+        run = pool->bump;
+        pool->bump += pool->object_size * count;
+    }
+    else if (count <= pool_remaining(pool, pool->spare, pool->spare_end))
+    {
+        run = pool->spare;
+        pool->spare += pool->object_size * count;
+    }
+    else
+    {
+        size_t slab_objects =
+            (count > pool->objects_per_slab) ? count : pool->objects_per_slab;
+
+        run = pool_slab_alloc(pool, slab_objects);
+        if (NULL == run)
+            return NULL;
+
+        /* the rest of the slab is kept for the objects which follow. */
+        unsigned char* rest = run + pool->object_size * count;
+        unsigned char* end = run + pool->object_size * slab_objects;
+        if (rest != end)
+            pool_spare_replace(pool, rest, end);
+    }
+
+    pool->live_count += count;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        allocator_stats_allocated(&pool->alloc, pool->object_size);
+    }
+
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    return run;
+}
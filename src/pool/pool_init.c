@@ -0,0 +1,178 @@
+/**
+ * \brief Initialize a fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/pool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void pool_dispose(disposable_t* disp);
+static void* pool_alloc_allocate(allocator_t* alloc, size_t size);
+static void pool_alloc_release(allocator_t* alloc, void* ptr);
+static int pool_alloc_reserve(allocator_t* alloc, size_t size, size_t count);
+static void* pool_alloc_allocate_run(
+    allocator_t* alloc, size_t size, size_t count, size_t* stride);
+
+/**
+ * \brief The pool_init method creates a new empty object pool.
+ *
+ * The object size is rounded up so that every object handed out by this pool
+ * is pointer aligned.  No slab is allocated until the first object is
+ * requested.
+ *
+ * \param pool              The pool to initialize.
+ * \param object_size       The size of each object in this pool.
+ * \param objects_per_slab  The number of objects to carve from each slab.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int pool_init(pool_t* pool, size_t object_size, size_t objects_per_slab)
+{
+    MODEL_ASSERT(NULL != pool);
+
+    if (0U == object_size || 0U == objects_per_slab)
+        return 1;
+
+    /* every object must be able to hold a free list link. */
+    if (object_size < sizeof(pool_free_object_t))
+        object_size = sizeof(pool_free_object_t);
+
+    /* round the object size up so each object is pointer aligned. */
+    object_size =
+        (object_size + sizeof(void*) - 1U) & ~(sizeof(void*) - 1U);
+
+    /* a slab must fit in memory. */
+    if (objects_per_slab > (SIZE_MAX - sizeof(pool_slab_t)) / object_size)
+        return 1;
+
+    /* clear the pool. */
+    memset(pool, 0, sizeof(pool_t));
+
+    /* set our dispose and allocator methods. */
+    pool->alloc.hdr.dispose = &pool_dispose;
+    pool->alloc.allocate = &pool_alloc_allocate;
+    pool->alloc.release = &pool_alloc_release;
+    pool->alloc.reserve = &pool_alloc_reserve;
+    pool->alloc.allocate_run = &pool_alloc_allocate_run;
+    pool->alloc.stats_enabled = true;
+    pool->object_size = object_size;
+    pool->objects_per_slab = objects_per_slab;
+
+    /* the pool is now valid. */
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a pool, releasing every slab in bulk.
+ *
+ * \param disp      The pool to dispose.
+ */
+static void pool_dispose(disposable_t* disp)
+{
+    pool_t* pool = (pool_t*)disp;
+
+    /* we are disposing a valid pool. */
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    pool_slab_t* i = pool->slabs;
+    while (i != NULL)
+    {
+        pool_slab_t* tmp = i->next;
+
+        free(i);
+
+        i = tmp;
+    }
+
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->free_count = 0U;
+    pool->bump = pool->bump_end = NULL;
+    pool->spare = pool->spare_end = NULL;
+    pool->slab_count = 0U;
+    pool->live_count = 0U;
+    allocator_stats_cleared(&pool->alloc);
+}
+
+/**
+ * \brief Allocate an object from the pool on behalf of the allocator
+ * interface.
+ *
+ * \param alloc     The pool.
+ * \param size      The number of bytes requested.
+ *
+ * \returns an object, or NULL if size exceeds the object size or a new slab
+ *          could not be allocated.
+ */
+static void* pool_alloc_allocate(allocator_t* alloc, size_t size)
+{
+    pool_t* pool = (pool_t*)alloc;
+
+    if (size > pool->object_size)
+        return NULL;
+
+    return pool_allocate(pool);
+}
+
+/**
+ * \brief Release an object to the pool on behalf of the allocator interface.
+ *
+ * \param alloc     The pool.
+ * \param ptr       The object to release.
+ */
+static void pool_alloc_release(allocator_t* alloc, void* ptr)
+{
+    pool_release((pool_t*)alloc, ptr);
+}
+
+/**
+ * \brief Reserve objects in the pool on behalf of the allocator interface.
+ *
+ * \param alloc     The pool.
+ * \param size      The size of each allocation.
+ * \param count     The number of allocations.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int pool_alloc_reserve(allocator_t* alloc, size_t size, size_t count)
+{
+    pool_t* pool = (pool_t*)alloc;
+
+    if (size > pool->object_size)
+        return 1;
+
+    return pool_reserve(pool, count);
+}
+
+/**
+ * \brief Allocate a contiguous run of objects from the pool on behalf of the
+ * allocator interface.
+ *
+ * \param alloc     The pool.
+ * \param size      The size of each allocation.
+ * \param count     The number of allocations.
+ * \param stride    Set to the object size.
+ *
+ * \returns the first object, or NULL if size exceeds the object size or a new
+ *          slab could not be allocated.
+ */
+static void* pool_alloc_allocate_run(
+    allocator_t* alloc, size_t size, size_t count, size_t* stride)
+{
+    pool_t* pool = (pool_t*)alloc;
+
+    if (size > pool->object_size)
+        return NULL;
+
+    *stride = pool->object_size;
+
+    return pool_allocate_run(pool, count);
+}
@@ -0,0 +1,83 @@
+/**
+ * \brief Internal helpers shared by the pool implementation.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_POOL_INTERNAL_HEADER_GUARD
+# define EJ_POOL_INTERNAL_HEADER_GUARD
+
+#include <model_check/assert.h>
+#include <ej/pool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * \brief Allocate a slab of the given number of objects and chain it to the
+ * pool, so that it is released in bulk when the pool is dispose()d.
+ *
+ * \param pool          The pool.
+ * \param objects       The number of objects in the slab.
+ *
+ * \returns the first object in the slab, or NULL on failure.
+ */
+static inline unsigned char* pool_slab_alloc(pool_t* pool, size_t objects)
+{
+    /* a slab this large must fit in memory. */
+    if (objects > (SIZE_MAX - sizeof(pool_slab_t)) / pool->object_size)
+        return NULL;
+
+    pool_slab_t* slab =
+        (pool_slab_t*)malloc(sizeof(pool_slab_t) + pool->object_size * objects);
+    if (NULL == slab)
+        return NULL;
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    ++pool->slab_count;
+
+    /* objects are carved from the memory following the header. */
+    return (unsigned char*)(slab + 1);
+}
+
+/**
+ * \brief Thread the unused objects of the spare slab onto the free list, and
+ * make the given objects the spare.
+ *
+ * \param pool          The pool.
+ * \param spare         The first unused object of the new spare.
+ * \param spare_end     The end of the new spare.
+ */
+static inline void pool_spare_replace(
+    pool_t* pool, unsigned char* spare, unsigned char* spare_end)
+{
+    for (unsigned char* i = pool->spare; i != pool->spare_end;
+         i += pool->object_size)
+    {
+        pool_free_object_t* freed = (pool_free_object_t*)i;
+        freed->next = pool->free_list;
+        pool->free_list = freed;
+        ++pool->free_count;
+    }
+
+    pool->spare = spare;
+    pool->spare_end = spare_end;
+}
+
+/**
+ * \brief Get the number of objects left between two bounds of a slab.
+ *
+ * \param pool          The pool.
+ * \param begin         The first unused object.
+ * \param end           The end of the slab.
+ *
+ * \returns the number of objects.
+ */
+static inline size_t pool_remaining(
+    const pool_t* pool, const unsigned char* begin, const unsigned char* end)
+{
+    return (size_t)(end - begin) / pool->object_size;
+}
+
+#endif /*EJ_POOL_INTERNAL_HEADER_GUARD*/
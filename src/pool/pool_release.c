@@ -0,0 +1,36 @@
+/**
+ * \brief Release an object back to a fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/pool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The pool_release method returns an object to the pool's free list.
+ *
+ * This method assumes that the object was allocated from this pool; it is
+ * extremely important that the caller ensures that this is true.
+ *
+ * \param pool              The pool to which the object is returned.
+ * \param object            The object to return.
+ */
+void pool_release(pool_t* pool, void* object)
+{
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+    MODEL_ASSERT(NULL != object);
+    MODEL_ASSERT(pool->live_count > 0U);
+
+    /* thread the object onto the free list. */
+    pool_free_object_t* freed = (pool_free_object_t*)object;
+    freed->next = pool->free_list;
+    pool->free_list = freed;
+    ++pool->free_count;
+
+    --pool->live_count;
+    allocator_stats_released(&pool->alloc, pool->object_size);
+}
@@ -0,0 +1,57 @@
+/**
+ * \brief Reserve room for several objects in a fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/pool.h>
+#include "pool_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The pool_reserve method ensures that the next count calls to
+ * pool_allocate() will succeed without allocating another slab.
+ *
+ * Recycled objects and the unused objects of the current and spare slabs all
+ * count towards the reservation.  If they fall short, a single new slab large
+ * enough for the rest becomes the spare, so that a large batch is carved from
+ * one contiguous block rather than from one slab at a time, and the unused
+ * objects of the old spare are moved to the free list.  The current slab is
+ * left as it is, so objects already carved from it stay next to the ones which
+ * follow.
+ *
+ * \param pool              The pool in which room is reserved.
+ * \param count             The number of objects to reserve.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int pool_reserve(pool_t* pool, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    size_t remaining =
+        pool->free_count + pool_remaining(pool, pool->bump, pool->bump_end);
+    size_t spare = pool_remaining(pool, pool->spare, pool->spare_end);
+    if (count <= remaining + spare)
+        return 0;
+
+    /* the new spare takes over from the old one. */
+    size_t slab_objects = count - remaining;
+    if (slab_objects < pool->objects_per_slab)
+        slab_objects = pool->objects_per_slab;
+
+    unsigned char* objects = pool_slab_alloc(pool, slab_objects);
+    if (NULL == objects)
+        return 1;
+
+    pool_spare_replace(
+        pool, objects, objects + pool->object_size * slab_objects);
+
+    MODEL_ASSERT(PROP_VALID_POOL(pool));
+
+    return 0;
+}
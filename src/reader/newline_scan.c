@@ -0,0 +1,33 @@
+/**
+ * \brief Find newlines using the best supported SIMD level.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+
+/**
+ * \brief The newline_scan method finds the offsets of up to max_ends newline
+ * characters in data, starting at offset start, using the best supported SIMD
+ * level.
+ *
+ * \param data          The bytes to scan.
+ * \param size          The number of bytes.
+ * \param start         The offset at which to start scanning.
+ * \param ends          The array which receives the newline offsets.
+ * \param max_ends      The capacity of the ends array.
+ * \param crlf_count    Incremented for each newline found which is preceded
+ *                      by a carriage return.
+ *
+ * \returns the number of newlines found.
+ */
+size_t newline_scan(
+    const char* data, size_t size, size_t start, size_t* ends,
+    size_t max_ends, size_t* crlf_count)
+{
+    return
+        newline_scan_level(
+            simd_level(), data, size, start, ends, max_ends, crlf_count);
+}
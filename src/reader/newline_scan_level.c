@@ -0,0 +1,204 @@
+/**
+ * \brief Find newlines using a given SIMD level.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <stdint.h>
+
+#ifdef SIMD_X86
+# include <immintrin.h>
+#endif /*SIMD_X86*/
+
+/**
+ * \brief The state of a scan, shared by each implementation.
+ */
+typedef struct newline_scan_state
+{
+    const char* data;
+    size_t* ends;
+    size_t max_ends;
+    size_t count;
+    size_t crlf_count;
+} newline_scan_state_t;
+
+/**
+ * \brief Record a newline at the given offset.
+ *
+ * \param state         The scan state.
+ * \param offset        The offset of the newline.
+ *
+ * \returns true if the ends array is now full.
+ */
+static inline bool newline_scan_found(
+    newline_scan_state_t* state, size_t offset)
+{
+    state->ends[state->count++] = offset;
+    state->crlf_count += (offset > 0U && '\r' == state->data[offset - 1U]);
+
+    return state->count == state->max_ends;
+}
+
+/**
+ * \brief Record every newline in a vector's match mask.
+ *
+ * \param state         The scan state.
+ * \param base          The offset of the vector.
+ * \param mask          One bit per byte of the vector, set for newlines.
+ *
+ * \returns true if the ends array is now full.
+ */
+static inline bool newline_scan_mask(
+    newline_scan_state_t* state, size_t base, uint32_t mask)
+{
+    while (0U != mask)
+    {
+        if (newline_scan_found(state, base + __builtin_ctz(mask)))
+            return true;
+
+        mask &= mask - 1U;
+    }
+
+    return false;
+}
+
+/**
+ * \brief Scan a byte at a time.
+ *
+ * \param state         The scan state.
+ * \param offset        The offset at which to start.
+ * \param size          The offset at which to stop.
+ *
+ * \returns the offset at which the scan stopped.
+ */
+static size_t newline_scan_scalar(
+    newline_scan_state_t* state, size_t offset, size_t size)
+{
+    for (; offset < size; ++offset)
+    {
+        if ('\n' == state->data[offset] && newline_scan_found(state, offset))
+            return offset + 1U;
+    }
+
+    return offset;
+}
+
+#ifdef SIMD_X86
+/**
+ * \brief Scan 16 bytes at a time with SSE2.
+ *
+ * \param state         The scan state.
+ * \param offset        The offset at which to start.
+ * \param size          The offset at which to stop.
+ *
+ * \returns the offset at which the scan stopped, which is within 16 bytes of
+ *          size unless the ends array filled up.
+ */
+__attribute__((target("sse2")))
+static size_t newline_scan_sse2(
+    newline_scan_state_t* state, size_t offset, size_t size)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    for (; size - offset >= 16U; offset += 16U)
+    {
+        __m128i block =
+            _mm_loadu_si128((const __m128i*)(state->data + offset));
+        uint32_t mask =
+            (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+
+        if (newline_scan_mask(state, offset, mask))
+            return state->ends[state->count - 1U] + 1U;
+    }
+
+    return offset;
+}
+
+/**
+ * \brief Scan 32 bytes at a time with AVX2.
+ *
+ * \param state         The scan state.
+ * \param offset        The offset at which to start.
+ * \param size          The offset at which to stop.
+ *
+ * \returns the offset at which the scan stopped, which is within 32 bytes of
+ *          size unless the ends array filled up.
+ */
+__attribute__((target("avx2")))
+static size_t newline_scan_avx2(
+    newline_scan_state_t* state, size_t offset, size_t size)
+{
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    for (; size - offset >= 32U; offset += 32U)
+    {
+        __m256i block =
+            _mm256_loadu_si256((const __m256i*)(state->data + offset));
+        uint32_t mask =
+            (uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(block, newline));
+
+        if (newline_scan_mask(state, offset, mask))
+            return state->ends[state->count - 1U] + 1U;
+    }
+
+    return offset;
+}
+#endif /*SIMD_X86*/
+
+/**
+ * \brief The newline_scan_level method finds the offsets of up to max_ends
+ * newline characters in data, starting at offset start, using the best
+ * implementation at or below the given SIMD level which is also supported by
+ * the running processor.
+ *
+ * Each vector implementation stops when fewer than a vector's worth of bytes
+ * remain, and the tail is finished a byte at a time.
+ *
+ * \param level         The maximum SIMD level to use.
+ * \param data          The bytes to scan.
+ * \param size          The number of bytes.
+ * \param start         The offset at which to start scanning.
+ * \param ends          The array which receives the newline offsets.
+ * \param max_ends      The capacity of the ends array.
+ * \param crlf_count    Incremented for each newline found which is preceded
+ *                      by a carriage return.
+ *
+ * \returns the number of newlines found.
+ */
+size_t newline_scan_level(
+    simd_level_t level, const char* data, size_t size, size_t start,
+    size_t* ends, size_t max_ends, size_t* crlf_count)
+{
+    MODEL_ASSERT(NULL != data || 0U == size);
+    MODEL_ASSERT(start <= size);
+    MODEL_ASSERT(NULL != ends);
+    MODEL_ASSERT(NULL != crlf_count);
+
+    if (0U == max_ends)
+        return 0U;
+
+    newline_scan_state_t state = { data, ends, max_ends, 0U, 0U };
+    size_t offset = start;
+
+    simd_level_t supported = simd_level();
+    if (level > supported)
+        level = supported;
+
+#ifdef SIMD_X86
+    if (SIMD_LEVEL_AVX2 == level)
+        offset = newline_scan_avx2(&state, offset, size);
+    else if (level >= SIMD_LEVEL_SSE2)
+        offset = newline_scan_sse2(&state, offset, size);
+#endif /*SIMD_X86*/
+
+    if (state.count < max_ends)
+        newline_scan_scalar(&state, offset, size);
+
+    *crlf_count += state.crlf_count;
+
+    return state.count;
+}
@@ -0,0 +1,92 @@
+/**
+ * \brief Initialize a reader from a file.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* forward decls */
+static int reader_read_fd(int fd, char* data, size_t size);
+
+/**
+ * \brief The reader_init method reads the whole file at the given path into
+ * a new reader.
+ *
+ * \param reader        The reader to initialize.
+ * \param path          The path of the file to read.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init(reader_t* reader, const char* path)
+{
+    MODEL_ASSERT(NULL != reader);
+    MODEL_ASSERT(NULL != path);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 1;
+
+    /* size the contents from the file. */
+    struct stat st;
+    if (0 != fstat(fd, &st) || st.st_size < 0 ||
+        (uintmax_t)st.st_size >= (uintmax_t)SIZE_MAX)
+    {
+        close(fd);
+        return 1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    char* data = (char*)malloc(size + 1U);
+    if (NULL == data)
+    {
+        close(fd);
+        return 1;
+    }
+
+    int retval = reader_read_fd(fd, data, size);
+    close(fd);
+
+    if (0 != retval)
+    {
+        free(data);
+        return retval;
+    }
+
+    reader_init_memory(reader, data, size);
+    reader->owned = true;
+
+    return 0;
+}
+
+/**
+ * \brief Read exactly size bytes from a file.
+ *
+ * \param fd        The file descriptor.
+ * \param data      The bytes to fill.
+ * \param size      The number of bytes to read.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int reader_read_fd(int fd, char* data, size_t size)
+{
+    size_t offset = 0U;
+
+    while (offset < size)
+    {
+        ssize_t amount = read(fd, data + offset, size - offset);
+        if (amount <= 0)
+            return 1;
+
+        offset += (size_t)amount;
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * \brief Initialize a reader over bytes in memory.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <ej/string.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* forward decls */
+static void reader_dispose(disposable_t* disp);
+
+/**
+ * \brief The reader_init_memory method initializes a reader over the given
+ * bytes, which are not copied and must outlive the reader.
+ *
+ * \param reader        The reader to initialize.
+ * \param data          The bytes to read.
+ * \param size          The number of bytes.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_memory(reader_t* reader, const char* data, size_t size)
+{
+    MODEL_ASSERT(NULL != reader);
+    MODEL_ASSERT(NULL != data || 0U == size);
+
+    /* clear the reader. */
+    memset(reader, 0, sizeof(reader_t));
+
+    /* set the dispose method and the contents. */
+    reader->hdr.dispose = &reader_dispose;
+    reader->data = data;
+    reader->size = size;
+    reader->level = simd_level();
+    reader->validated = true;
+    reader->invalid_offset = size;
+    reader->valid_utf8 =
+        0 == utf8_validate_level(
+                reader->level, data, size, &reader->invalid_offset);
+
+    /* the reader is now valid. */
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a reader, freeing or unmapping its contents if it owns
+ * them.
+ *
+ * \param disp      The reader to dispose.
+ */
+static void reader_dispose(disposable_t* disp)
+{
+    reader_t* reader = (reader_t*)disp;
+
+    /* we are disposing a valid reader. */
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+
+    if (reader->mapped)
+        munmap((void*)reader->data, reader->size);
+    else if (reader->owned)
+        free((void*)reader->data);
+
+    reader->data = NULL;
+    reader->size = reader->offset = 0U;
+    reader->owned = reader->mapped = false;
+}
@@ -0,0 +1,52 @@
+/**
+ * \brief Initialize a reader from a memory mapped file.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <ej/string.h>
+#include <sys/mman.h>
+
+/**
+ * \brief The reader_init_mmap method maps the whole file at the given path
+ * into a new reader, rather than reading it.
+ *
+ * Pages of the file are only read as they are touched, and they are clean, so
+ * the kernel can drop them again under memory pressure.  Changes to the file
+ * while it is mapped are visible through the reader, so the file should not
+ * be changed while it is in use.
+ *
+ * \param reader        The reader to initialize.
+ * \param path          The path of the file to map.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_mmap(reader_t* reader, const char* path)
+{
+    MODEL_ASSERT(NULL != reader);
+    MODEL_ASSERT(NULL != path);
+
+    if (0 != reader_init_mmap_unchecked(reader, path))
+        return 1;
+
+    /* an empty file isn't mapped, and has already been checked. */
+    if (!reader->mapped)
+        return 0;
+
+    /* the first pass over the mapping reads it front to back. */
+    posix_madvise((void*)reader->data, reader->size, POSIX_MADV_SEQUENTIAL);
+
+    reader->validated = true;
+    reader->invalid_offset = reader->size;
+    reader->valid_utf8 =
+        0 == utf8_validate_level(
+                reader->level, reader->data, reader->size,
+                &reader->invalid_offset);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * \brief Initialize a reader from a memory mapped file without validating it.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * \brief The reader_init_mmap_unchecked method maps the whole file at the
+ * given path into a new reader, without validating it.
+ *
+ * Nothing in the file is read until it is used, so this costs the same for
+ * any size of file.  The reader's validated and valid_utf8 are false and its
+ * invalid_offset is 0, so it is never mistaken for a validated reader; callers
+ * validate the parts that they use, for instance with reader_init_memory() or
+ * reader_init_range().
+ *
+ * \param reader        The reader to initialize.
+ * \param path          The path of the file to map.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_mmap_unchecked(reader_t* reader, const char* path)
+{
+    MODEL_ASSERT(NULL != reader);
+    MODEL_ASSERT(NULL != path);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 1;
+
+    struct stat st;
+    if (0 != fstat(fd, &st) || st.st_size < 0 ||
+        (uintmax_t)st.st_size > (uintmax_t)SIZE_MAX)
+    {
+        close(fd);
+        return 1;
+    }
+
+    /* an empty file can't be mapped, but it has no lines either. */
+    size_t size = (size_t)st.st_size;
+    if (0U == size)
+    {
+        close(fd);
+        return reader_init_memory(reader, NULL, 0U);
+    }
+
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data)
+        return 1;
+
+    /* an empty reader is trivially valid, so this doesn't scan anything. */
+    reader_init_memory(reader, NULL, 0U);
+
+    reader->data = (const char*)data;
+    reader->size = size;
+    reader->mapped = true;
+    reader->validated = false;
+    reader->valid_utf8 = false;
+    reader->invalid_offset = 0U;
+
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+
+    return 0;
+}
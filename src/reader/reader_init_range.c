@@ -0,0 +1,68 @@
+/**
+ * \brief Initialize a reader over part of another reader's contents.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <ej/string.h>
+
+/**
+ * \brief The reader_init_range method initializes a reader over size bytes of
+ * the parent reader's contents, starting at offset.  The range must begin at
+ * the start of a line and end at the end of a line.  The contents are not
+ * copied, and are only validated again if the parent's first invalid sequence
+ * comes before the range, or if the parent was not validated, so that the
+ * ranges of an unchecked reader can be validated by several threads at once.
+ * The parent must outlive this reader.
+ *
+ * \param reader        The reader to initialize.
+ * \param parent        The reader whose contents are shared.
+ * \param offset        The offset of the range in the parent's contents.
+ * \param size          The number of bytes in the range.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reader_init_range(
+    reader_t* reader, const reader_t* parent, size_t offset, size_t size)
+{
+    MODEL_ASSERT(NULL != reader);
+    MODEL_ASSERT(PROP_VALID_READER(parent));
+
+    if (offset > parent->size || size > parent->size - offset)
+        return 1;
+
+    /* an empty reader is trivially valid, so this doesn't scan anything. */
+    reader_init_memory(reader, NULL, 0U);
+
+    reader->data = parent->data + offset;
+    reader->size = size;
+    reader->level = parent->level;
+
+    /* lines are whole codepoints, so the range inherits the parent's check,
+     * unless the parent's first error comes before the range. */
+    if (parent->validated &&
+        (parent->valid_utf8 || parent->invalid_offset >= offset + size))
+    {
+        reader->invalid_offset = size;
+    }
+    else if (parent->validated && parent->invalid_offset >= offset)
+    {
+        reader->valid_utf8 = false;
+        reader->invalid_offset = parent->invalid_offset - offset;
+    }
+    else
+    {
+        reader->invalid_offset = size;
+        reader->valid_utf8 =
+            0 == utf8_validate_level(
+                    reader->level, reader->data, size,
+                    &reader->invalid_offset);
+    }
+
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+
+    return 0;
+}
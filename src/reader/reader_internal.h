@@ -0,0 +1,116 @@
+/**
+ * \brief Internal helpers shared by the reader methods.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_READER_INTERNAL_HEADER_GUARD
+# define EJ_READER_INTERNAL_HEADER_GUARD
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include <ej/string.h>
+
+/**
+ * \brief Create a string for a line, allocated from the list's data
+ * allocator.
+ *
+ * \param list          The list which will own the string.
+ * \param line          The line, which is valid UTF-8.
+ * \param view          True to view the line rather than copy it.
+ *
+ * \returns the string, or NULL on failure.
+ */
+static inline disposable_t* reader_line_string(
+    list_t* list, const reader_line_t* line, bool view)
+{
+    string_t* str;
+
+    if (!view)
+    {
+        if (0 !=
+                string_create_unchecked(
+                    &str, list->data_alloc, line->data, line->length))
+            return NULL;
+
+        return (disposable_t*)str;
+    }
+
+    str =
+        (string_t*)allocator_allocate_tagged(
+            list->data_alloc, sizeof(string_t), ALLOCATOR_TAG_LIST_DATA);
+    if (NULL == str)
+        return NULL;
+
+    string_init_view(str, list->data_alloc, line->data, line->length);
+
+    return (disposable_t*)str;
+}
+
+/**
+ * \brief Release strings which could not be added to the list.
+ *
+ * \param list          The list whose data allocator owns the strings.
+ * \param strings       The strings to release.
+ * \param count         The number of strings.
+ */
+static inline void reader_release_strings(
+    list_t* list, disposable_t** strings, size_t count)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        dispose(strings[i]);
+        allocator_release_tagged(
+            list->data_alloc, strings[i], ALLOCATOR_TAG_LIST_DATA);
+    }
+}
+
+/**
+ * \brief Read every remaining line into a string, and push the strings onto
+ * the back of the list a batch at a time.
+ *
+ * \param reader        The reader.
+ * \param list          The list which receives the lines.
+ * \param view          True to view each line rather than copy it.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static inline int reader_read_strings(
+    reader_t* reader, list_t* list, bool view)
+{
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+    MODEL_ASSERT(PROP_VALID_LIST(list));
+
+    /* the contents were validated once, so each line needn't be. */
+    if (!reader->valid_utf8)
+        return 1;
+
+    reader_batch_t batch;
+    disposable_t* strings[READER_BATCH_LINES];
+
+    for (reader_next_batch(reader, &batch); batch.count > 0U;
+         reader_next_batch(reader, &batch))
+    {
+        for (size_t i = 0U; i < batch.count; ++i)
+        {
+            strings[i] = reader_line_string(list, &batch.lines[i], view);
+            if (NULL == strings[i])
+            {
+                reader_release_strings(list, strings, i);
+                return 1;
+            }
+        }
+
+        /* the whole batch is linked in at once. */
+        if (0 != list_push_back_many(list, strings, batch.count))
+        {
+            reader_release_strings(list, strings, batch.count);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#endif /*EJ_READER_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,60 @@
+/**
+ * \brief Read the next batch of lines.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+
+/**
+ * \brief The reader_next_batch method reads the next batch of lines.
+ *
+ * Every newline ends a line.  A final line which does not end with a newline
+ * is returned if it is not empty.  The lines refer to the reader's contents,
+ * and remain valid until the reader is dispose()d.
+ *
+ * \param reader        The reader.
+ * \param batch         The batch to fill, which is empty once every line has
+ *                      been read.
+ */
+void reader_next_batch(reader_t* reader, reader_batch_t* batch)
+{
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+    MODEL_ASSERT(NULL != batch);
+
+    size_t ends[READER_BATCH_LINES];
+    size_t crlf_count = 0U;
+    size_t count =
+        newline_scan_level(
+            reader->level, reader->data, reader->size, reader->offset, ends,
+            READER_BATCH_LINES, &crlf_count);
+
+    /* each newline ends a line; drop the carriage return of a CRLF. */
+    for (size_t i = 0U; i < count; ++i)
+    {
+        size_t length = ends[i] - reader->offset;
+        if (length > 0U && '\r' == reader->data[ends[i] - 1U])
+            --length;
+
+        batch->lines[i].data = reader->data + reader->offset;
+        batch->lines[i].length = length;
+        reader->offset = ends[i] + 1U;
+    }
+
+    /* the last line may not end with a newline. */
+    if (count < READER_BATCH_LINES && reader->offset < reader->size)
+    {
+        batch->lines[count].data = reader->data + reader->offset;
+        batch->lines[count].length = reader->size - reader->offset;
+        reader->offset = reader->size;
+        ++count;
+    }
+
+    batch->count = count;
+    reader->line_count += count;
+    reader->crlf_count += crlf_count;
+
+    MODEL_ASSERT(PROP_VALID_READER(reader));
+}
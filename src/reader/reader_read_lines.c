@@ -0,0 +1,27 @@
+/**
+ * \brief Read every remaining line into a list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include "reader_internal.h"
+
+/**
+ * \brief The reader_read_lines method reads every remaining line into a
+ * \ref string_t, and pushes the strings onto the back of the given list a
+ * batch at a time.  The strings are allocated from the list's data allocator.
+ *
+ * \param reader        The reader.
+ * \param list          The list which receives the lines.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the list holds
+ *          the lines read before the failing batch.  This fails without
+ *          reading any lines if the contents are not valid UTF-8.
+ */
+int reader_read_lines(reader_t* reader, list_t* list)
+{
+    return reader_read_strings(reader, list, false);
+}
@@ -0,0 +1,28 @@
+/**
+ * \brief Read every remaining line into a list as views.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reader.h>
+#include "reader_internal.h"
+
+/**
+ * \brief The reader_read_views method is reader_read_lines(), except that each
+ * \ref string_t is a view of the line in the reader's contents rather than a
+ * copy.  The reader must outlive the list, or every string must be changed
+ * first, since changing a view copies it.
+ *
+ * \param reader        The reader.
+ * \param list          The list which receives the lines.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the list holds
+ *          the lines read before the failing batch.  This fails without
+ *          reading any lines if the contents are not valid UTF-8.
+ */
+int reader_read_views(reader_t* reader, list_t* list)
+{
+    return reader_read_strings(reader, list, true);
+}
@@ -0,0 +1,45 @@
+/**
+ * \brief Queue a data structure to be reclaimed in the background.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reclaimer.h>
+
+/**
+ * \brief The reclaimer_defer method queues the given data structure to be
+ * dispose()d and free()d on the worker thread.  On success, the ownership of
+ * this data is transferred to the reclaimer.  On failure, the caller retains
+ * ownership of it.
+ *
+ * The data structure must have been allocated via malloc(), and its dispose
+ * method must be safe to call from another thread.
+ *
+ * \param reclaimer     The reclaimer to which the data is handed.
+ * \param data          The data structure to reclaim.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_defer(reclaimer_t* reclaimer, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_RECLAIMER(reclaimer));
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    int retval;
+
+    pthread_mutex_lock(&reclaimer->lock);
+
+    /* queue the data and wake the worker. */
+    retval = list_push_back(&reclaimer->queue, data);
+    if (0 == retval)
+    {
+        ++reclaimer->pending;
+        pthread_cond_signal(&reclaimer->work);
+    }
+
+    pthread_mutex_unlock(&reclaimer->lock);
+
+    return retval;
+}
@@ -0,0 +1,93 @@
+/**
+ * \brief Hand a buffer to a reclaimer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reclaimer.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief A buffer moved to the reclaimer, with the allocator it came from.
+ */
+typedef struct reclaimer_buffer
+{
+    disposable_t hdr;
+    buffer_t buffer;
+    allocator_t* owner;
+} reclaimer_buffer_t;
+
+/* forward decls */
+static void reclaimer_buffer_dispose(disposable_t* disp);
+
+/**
+ * \brief The reclaimer_defer_buffer method moves the given buffer, and the
+ * allocator which owns its memory, to the worker thread in O(1), where the
+ * buffer is dispose()d and the allocator is dispose()d and free()d.  After
+ * this method succeeds, the buffer has been handed over and must not be used
+ * or dispose()d.  On failure, the caller retains ownership of both.
+ *
+ * The buffer's allocator must be one that no other thread uses while it is
+ * reclaimed: the arena of a buffer in arena mode, the given owner, or the
+ * system allocator.  Buffers using any other allocator are rejected.
+ *
+ * \param reclaimer     The reclaimer to which the buffer is handed.
+ * \param buffer        The buffer to reclaim.
+ * \param owner         The allocator from which the buffer allocates, which
+ *                      must have been allocated via malloc(), or NULL if the
+ *                      buffer owns its arena or uses the system allocator.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_defer_buffer(
+    reclaimer_t* reclaimer, buffer_t* buffer, allocator_t* owner)
+{
+    MODEL_ASSERT(PROP_VALID_RECLAIMER(reclaimer));
+    MODEL_ASSERT(PROP_VALID_BUFFER(buffer));
+    MODEL_ASSERT(NULL == owner || PROP_VALID_ALLOCATOR(owner));
+    MODEL_ASSERT(NULL == owner || NULL == buffer->arena);
+
+    /* the worker may only touch memory that nothing else is using. */
+    if (owner != buffer->allocator && NULL == buffer->arena &&
+        allocator_system() != buffer->allocator)
+        return 1;
+
+    reclaimer_buffer_t* moved =
+        (reclaimer_buffer_t*)malloc(sizeof(reclaimer_buffer_t));
+    if (NULL == moved)
+        return 1;
+
+    /* the buffer refers to nothing inside itself, so it can be moved. */
+    moved->hdr.dispose = &reclaimer_buffer_dispose;
+    memcpy(&moved->buffer, buffer, sizeof(buffer_t));
+    moved->owner = owner;
+
+    if (0 != reclaimer_defer(reclaimer, &moved->hdr))
+    {
+        free(moved);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of a moved buffer, and then of the allocator it came from.
+ *
+ * \param disp      The moved buffer.
+ */
+static void reclaimer_buffer_dispose(disposable_t* disp)
+{
+    reclaimer_buffer_t* moved = (reclaimer_buffer_t*)disp;
+
+    dispose((disposable_t*)&moved->buffer);
+
+    if (NULL != moved->owner)
+    {
+        dispose((disposable_t*)moved->owner);
+        free(moved->owner);
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * \brief Hand the contents of a list to a reclaimer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reclaimer.h>
+#include <stdlib.h>
+
+/**
+ * \brief The reclaimer_defer_list method detaches every node of the given list
+ * in O(1) and queues them to be dispose()d and free()d on the worker thread.
+ * After this method succeeds, the list is empty and may be reused or
+ * dispose()d as usual.  On failure, the list is unchanged.
+ *
+ * Lists which use any allocator other than the system allocator are rejected,
+ * as other allocators may not be touched from more than one thread.
+ *
+ * \param reclaimer     The reclaimer to which the nodes are handed.
+ * \param list          The list to empty.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_defer_list(reclaimer_t* reclaimer, list_t* list)
+{
+    MODEL_ASSERT(PROP_VALID_RECLAIMER(reclaimer));
+    MODEL_ASSERT(PROP_VALID_LIST(list));
+
+    /* only the system allocator may be used from another thread. */
+    if (allocator_system() != list->node_alloc ||
+        allocator_system() != list->data_alloc)
+        return 1;
+
+    /* there is nothing to reclaim in an empty list. */
+    if (0U == list->size)
+        return 0;
+
+    /* move the nodes into a heap list that the reclaimer can free. */
+    list_t* detached = (list_t*)malloc(sizeof(list_t));
+    if (NULL == detached)
+        return 1;
+
+    if (0 != list_init(detached))
+    {
+        free(detached);
+        return 1;
+    }
+
+    list_splice(detached, list);
+
+    /* if it can't be queued, give the nodes back. */
+    if (0 != reclaimer_defer(reclaimer, (disposable_t*)detached))
+    {
+        list_splice(list, detached);
+        free(detached);
+        return 1;
+    }
+
+    MODEL_ASSERT(PROP_VALID_LIST_EMPTY(list));
+
+    return 0;
+}
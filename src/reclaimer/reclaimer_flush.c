@@ -0,0 +1,27 @@
+/**
+ * \brief Wait for a reclaimer to drain its queue.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reclaimer.h>
+
+/**
+ * \brief The reclaimer_flush method blocks until every structure queued so far
+ * has been reclaimed.
+ *
+ * \param reclaimer     The reclaimer to flush.
+ */
+void reclaimer_flush(reclaimer_t* reclaimer)
+{
+    MODEL_ASSERT(PROP_VALID_RECLAIMER(reclaimer));
+
+    pthread_mutex_lock(&reclaimer->lock);
+
+    while (0U != reclaimer->pending)
+        pthread_cond_wait(&reclaimer->idle, &reclaimer->lock);
+
+    pthread_mutex_unlock(&reclaimer->lock);
+}
@@ -0,0 +1,145 @@
+/**
+ * \brief Initialize a reclaimer and its worker thread.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/reclaimer.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void reclaimer_dispose(disposable_t* disp);
+static void* reclaimer_worker(void* context);
+
+/**
+ * \brief The reclaimer_init method creates a new reclaimer and starts its
+ * worker thread.
+ *
+ * When the reclaimer is dispose()d, every structure still queued is reclaimed
+ * before the worker thread is joined.
+ *
+ * \param reclaimer     The reclaimer to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int reclaimer_init(reclaimer_t* reclaimer)
+{
+    MODEL_ASSERT(NULL != reclaimer);
+
+    /* clear the reclaimer. */
+    memset(reclaimer, 0, sizeof(reclaimer_t));
+
+    if (0 != list_init(&reclaimer->queue))
+        return 1;
+
+    if (0 != pthread_mutex_init(&reclaimer->lock, NULL))
+    {
+        dispose((disposable_t*)&reclaimer->queue);
+        return 1;
+    }
+
+    if (0 != pthread_cond_init(&reclaimer->work, NULL))
+    {
+        pthread_mutex_destroy(&reclaimer->lock);
+        dispose((disposable_t*)&reclaimer->queue);
+        return 1;
+    }
+
+    if (0 != pthread_cond_init(&reclaimer->idle, NULL))
+    {
+        pthread_cond_destroy(&reclaimer->work);
+        pthread_mutex_destroy(&reclaimer->lock);
+        dispose((disposable_t*)&reclaimer->queue);
+        return 1;
+    }
+
+    /* start the worker thread. */
+    if (0 !=
+            pthread_create(
+                &reclaimer->thread, NULL, &reclaimer_worker, reclaimer))
+    {
+        pthread_cond_destroy(&reclaimer->idle);
+        pthread_cond_destroy(&reclaimer->work);
+        pthread_mutex_destroy(&reclaimer->lock);
+        dispose((disposable_t*)&reclaimer->queue);
+        return 1;
+    }
+
+    /* set our dispose method. */
+    reclaimer->hdr.dispose = &reclaimer_dispose;
+
+    MODEL_ASSERT(PROP_VALID_RECLAIMER(reclaimer));
+
+    return 0;
+}
+
+/**
+ * \brief Stop the worker thread once the queue has drained, and release the
+ * reclaimer's resources.
+ *
+ * \param disp      The reclaimer to dispose.
+ */
+static void reclaimer_dispose(disposable_t* disp)
+{
+    reclaimer_t* reclaimer = (reclaimer_t*)disp;
+
+    MODEL_ASSERT(PROP_VALID_RECLAIMER(reclaimer));
+
+    /* ask the worker to stop. */
+    pthread_mutex_lock(&reclaimer->lock);
+    reclaimer->stopping = true;
+    pthread_cond_signal(&reclaimer->work);
+    pthread_mutex_unlock(&reclaimer->lock);
+
+    /* the worker drains the queue before it exits. */
+    pthread_join(reclaimer->thread, NULL);
+
+    pthread_cond_destroy(&reclaimer->idle);
+    pthread_cond_destroy(&reclaimer->work);
+    pthread_mutex_destroy(&reclaimer->lock);
+    dispose((disposable_t*)&reclaimer->queue);
+}
+
+/**
+ * \brief The worker thread reclaims queued structures until it is asked to
+ * stop and the queue is empty.
+ *
+ * \param context   The reclaimer.
+ *
+ * \returns NULL.
+ */
+static void* reclaimer_worker(void* context)
+{
+    reclaimer_t* reclaimer = (reclaimer_t*)context;
+    disposable_t* data;
+
+    pthread_mutex_lock(&reclaimer->lock);
+
+    for (;;)
+    {
+        /* wait for work, or for a request to stop. */
+        while (0U == reclaimer->queue.size && !reclaimer->stopping)
+            pthread_cond_wait(&reclaimer->work, &reclaimer->lock);
+
+        /* only stop once everything has been reclaimed. */
+        if (0 != list_pop_front(&reclaimer->queue, &data))
+            break;
+
+        /* reclaim the structure without holding the lock. */
+        pthread_mutex_unlock(&reclaimer->lock);
+        dispose(data);
+        free(data);
+        pthread_mutex_lock(&reclaimer->lock);
+
+        /* wake anyone waiting for the queue to drain. */
+        if (0U == --reclaimer->pending)
+            pthread_cond_broadcast(&reclaimer->idle);
+    }
+
+    pthread_mutex_unlock(&reclaimer->lock);
+
+    return NULL;
+}
@@ -0,0 +1,30 @@
+/**
+ * \brief Detect the supported SIMD level.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/simd.h>
+
+/**
+ * \brief The simd_level method returns the best SIMD level supported by both
+ * this build and the running processor.
+ *
+ * \returns the best supported SIMD level.
+ */
+simd_level_t simd_level(void)
+{
+#ifdef SIMD_X86
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_LEVEL_AVX2;
+
+    if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3"))
+        return SIMD_LEVEL_SSE4;
+
+    if (__builtin_cpu_supports("sse2"))
+        return SIMD_LEVEL_SSE2;
+#endif /*SIMD_X86*/
+
+    return SIMD_LEVEL_SCALAR;
+}
@@ -0,0 +1,27 @@
+/**
+ * \brief Append bytes to a string.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+
+/**
+ * \brief The string_append method appends a copy of the given bytes to the
+ * end of the string.
+ *
+ * \param str           The string to modify.
+ * \param data          The UTF-8 bytes to append.
+ * \param length        The number of bytes to append.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the string is
+ *          unchanged.
+ */
+int string_append(string_t* str, const char* data, size_t length)
+{
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    return string_insert(str, str->length, data, length);
+}
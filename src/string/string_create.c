@@ -0,0 +1,48 @@
+/**
+ * \brief Allocate and initialize a string.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+
+/**
+ * \brief The string_create method allocates a string from the given allocator
+ * and initializes it with a copy of the given bytes.
+ *
+ * The string is allocated with \ref ALLOCATOR_TAG_LIST_DATA, so that it can be
+ * pushed onto a list whose data allocator is the same allocator; the list
+ * dispose()s and releases it.  Otherwise, the caller must dispose() the string
+ * and then release it with that tag.
+ *
+ * \param str           Pointer to the string pointer set on success.
+ * \param alloc         The allocator for the string and its storage.
+ * \param data          The UTF-8 bytes to copy.
+ * \param length        The number of bytes to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int string_create(
+    string_t** str, allocator_t* alloc, const char* data, size_t length)
+{
+    MODEL_ASSERT(NULL != str);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+
+    string_t* tmp =
+        (string_t*)allocator_allocate_tagged(
+            alloc, sizeof(string_t), ALLOCATOR_TAG_LIST_DATA);
+    if (NULL == tmp)
+        return 1;
+
+    if (0 != string_init(tmp, alloc, data, length))
+    {
+        allocator_release_tagged(alloc, tmp, ALLOCATOR_TAG_LIST_DATA);
+        return 1;
+    }
+
+    *str = tmp;
+
+    return 0;
+}
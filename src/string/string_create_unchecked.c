@@ -0,0 +1,47 @@
+/**
+ * \brief Allocate and initialize a string from validated bytes.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include "string_internal.h"
+
+/**
+ * \brief The string_create_unchecked method is string_create(), for bytes
+ * which the caller has already checked with utf8_validate().
+ *
+ * \param str           Pointer to the string pointer set on success.
+ * \param alloc         The allocator for the string and its storage.
+ * \param data          The valid UTF-8 bytes to copy.
+ * \param length        The number of bytes to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int string_create_unchecked(
+    string_t** str, allocator_t* alloc, const char* data, size_t length)
+{
+    MODEL_ASSERT(NULL != str);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(NULL != data || 0U == length);
+
+    string_t* tmp =
+        (string_t*)allocator_allocate_tagged(
+            alloc, sizeof(string_t), ALLOCATOR_TAG_LIST_DATA);
+    if (NULL == tmp)
+        return 1;
+
+    /* an empty string is always valid, so only the bytes can fail. */
+    string_init(tmp, alloc, NULL, 0U);
+    if (0 != string_insert_unchecked(tmp, 0U, data, length))
+    {
+        allocator_release_tagged(alloc, tmp, ALLOCATOR_TAG_LIST_DATA);
+        return 1;
+    }
+
+    *str = tmp;
+
+    return 0;
+}
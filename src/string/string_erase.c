@@ -0,0 +1,52 @@
+/**
+ * \brief Erase bytes from a string.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include <string.h>
+#include "string_internal.h"
+
+/**
+ * \brief The string_erase method removes count bytes starting at the given
+ * byte offset.  Both ends of the range must be on codepoint boundaries.
+ *
+ * \param str           The string to modify.
+ * \param offset        The byte offset of the first byte to remove.
+ * \param count         The number of bytes to remove.
+ *
+ * \returns 0 on success and non-zero if the range is out of bounds, or if a
+ *          view could not be copied.
+ */
+int string_erase(string_t* str, size_t offset, size_t count)
+{
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    if (offset > str->length || count > str->length - offset)
+        return 1;
+
+    MODEL_ASSERT(string_is_boundary(str, offset));
+    MODEL_ASSERT(string_is_boundary(str, offset + count));
+
+    if (0U == count)
+        return 0;
+
+    /* a view is copied before it is changed. */
+    if (0 != string_reserve(str, str->length))
+        return 1;
+
+    char* buf = string_buffer(str);
+    str->codepoints -= string_count_codepoints(buf + offset, count);
+
+    /* close the gap, including the NUL terminator. */
+    memmove(
+        buf + offset, buf + offset + count, str->length - offset - count + 1U);
+    str->length -= count;
+
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * \brief Initialize a string.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include <string.h>
+#include "string_internal.h"
+
+/* forward decls */
+static void string_dispose(disposable_t* disp);
+
+/**
+ * \brief The string_init method initializes a string with a copy of the given
+ * bytes.
+ *
+ * \param str           The string to initialize.
+ * \param alloc         The allocator for out of line storage.
+ * \param data          The UTF-8 bytes to copy, which need not be NUL
+ *                      terminated.
+ * \param length        The number of bytes to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int string_init(
+    string_t* str, allocator_t* alloc, const char* data, size_t length)
+{
+    MODEL_ASSERT(NULL != str);
+    MODEL_ASSERT(PROP_VALID_ALLOCATOR(alloc));
+    MODEL_ASSERT(NULL != data || 0U == length);
+
+    /* start with an empty inline string. */
+    memset(str, 0, sizeof(string_t));
+    str->hdr.dispose = &string_dispose;
+    str->alloc = alloc;
+    str->capacity = STRING_INLINE_CAPACITY;
+
+    /* the string is now valid. */
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    return string_append(str, data, length);
+}
+
+/**
+ * \brief Dispose of a string, releasing any out of line storage.
+ *
+ * \param disp      The string to dispose.
+ */
+static void string_dispose(disposable_t* disp)
+{
+    string_t* str = (string_t*)disp;
+
+    /* we are disposing a valid string. */
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    if (string_is_allocated(str))
+    {
+        allocator_release_tagged(
+            str->alloc, str->data.ptr, ALLOCATOR_TAG_STRING);
+    }
+
+    str->length = str->codepoints = 0U;
+    str->capacity = STRING_INLINE_CAPACITY;
+    str->data.buf[0] = 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * \brief Initialize a string as a view of bytes it does not own.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include "string_internal.h"
+
+/**
+ * \brief The string_init_view method initializes a string as a view of the
+ * given bytes, which the caller has already checked with utf8_validate().  The
+ * bytes are not copied, and must outlive the view or the first change to it.
+ *
+ * \param str           The string to initialize.
+ * \param alloc         The allocator for storage, if the view is changed.
+ * \param data          The valid UTF-8 bytes to view.
+ * \param length        The number of bytes.
+ */
+void string_init_view(
+    string_t* str, allocator_t* alloc, const char* data, size_t length)
+{
+    MODEL_ASSERT(NULL != data || 0U == length);
+
+    /* an empty string is always valid, so this can't fail. */
+    string_init(str, alloc, NULL, 0U);
+
+    str->data.view = data;
+    str->capacity = 0U;
+    str->length = length;
+    str->codepoints = string_count_codepoints(data, length);
+
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+}
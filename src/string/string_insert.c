@@ -0,0 +1,35 @@
+/**
+ * \brief Insert bytes into a string.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include "string_internal.h"
+
+/**
+ * \brief The string_insert method inserts a copy of the given bytes at the
+ * given byte offset, which must be on a codepoint boundary.
+ *
+ * \param str           The string to modify.
+ * \param offset        The byte offset at which the bytes are inserted.
+ * \param data          The UTF-8 bytes to insert.
+ * \param length        The number of bytes to insert.
+ *
+ * \returns 0 on success and non-zero on failure, including if the bytes are
+ *          not valid UTF-8, in which case the string is unchanged.
+ */
+int string_insert(
+    string_t* str, size_t offset, const char* data, size_t length)
+{
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+    MODEL_ASSERT(NULL != data || 0U == length);
+
+    size_t invalid_offset;
+    if (0 != utf8_validate(data, length, &invalid_offset))
+        return 1;
+
+    return string_insert_unchecked(str, offset, data, length);
+}
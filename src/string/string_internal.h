@@ -0,0 +1,113 @@
+/**
+ * \brief Internal helpers shared by the string methods.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_STRING_INTERNAL_HEADER_GUARD
+# define EJ_STRING_INTERNAL_HEADER_GUARD
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * \brief Get the mutable bytes of the string, which must not be a view.
+ *
+ * \param str           The string.
+ */
+static inline char* string_buffer(string_t* str)
+{
+    MODEL_ASSERT(!string_is_view(str));
+
+    return string_is_inline(str) ? str->data.buf : str->data.ptr;
+}
+
+/**
+ * \brief Return true if the string's bytes are in storage from its allocator.
+ *
+ * \param str           The string.
+ */
+static inline bool string_is_allocated(const string_t* str)
+{
+    return str->capacity > STRING_INLINE_CAPACITY;
+}
+
+/**
+ * \brief Count the codepoints in the given UTF-8 bytes, which is the number of
+ * bytes that are not continuation bytes.
+ *
+ * \param data          The bytes to count.
+ * \param length        The number of bytes.
+ *
+ * \returns the number of codepoints.
+ */
+static inline size_t string_count_codepoints(const char* data, size_t length)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t count = 0U;
+
+    for (size_t i = 0U; i < length; ++i)
+    {
+        count += (0x80U != (bytes[i] & 0xC0U));
+    }
+
+    return count;
+}
+
+/**
+ * \brief Return true if the given byte offset begins a codepoint or ends the
+ * string.
+ *
+ * \param str           The string.
+ * \param offset        The byte offset, which must not exceed the length.
+ */
+static inline bool string_is_boundary(const string_t* str, size_t offset)
+{
+    return
+        offset == str->length ||
+        0x80U != (((const unsigned char*)string_data(str))[offset] & 0xC0U);
+}
+
+/**
+ * \brief Insert a copy of the given bytes, which must be valid UTF-8, at the
+ * given byte offset, which must be on a codepoint boundary.
+ *
+ * \param str           The string to modify.
+ * \param offset        The byte offset at which the bytes are inserted.
+ * \param data          The valid UTF-8 bytes to insert.
+ * \param length        The number of bytes to insert.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the string is
+ *          unchanged.
+ */
+static inline int string_insert_unchecked(
+    string_t* str, size_t offset, const char* data, size_t length)
+{
+    if (offset > str->length || length > SIZE_MAX - str->length)
+        return 1;
+
+    MODEL_ASSERT(string_is_boundary(str, offset));
+
+    if (0U == length)
+        return 0;
+
+    if (0 != string_reserve(str, str->length + length))
+        return 1;
+
+    /* open a gap, including the NUL terminator, and copy the bytes in. */
+    char* buf = string_buffer(str);
+    memmove(buf + offset + length, buf + offset, str->length - offset + 1U);
+    memcpy(buf + offset, data, length);
+
+    str->length += length;
+    str->codepoints += string_count_codepoints(data, length);
+
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    return 0;
+}
+
+#endif /*EJ_STRING_INTERNAL_HEADER_GUARD*/
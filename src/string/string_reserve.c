@@ -0,0 +1,77 @@
+/**
+ * \brief Reserve storage in a string.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include <stdint.h>
+#include <string.h>
+#include "string_internal.h"
+
+/**
+ * \brief The string_reserve method ensures that the string can hold at least
+ * capacity bytes without allocating.  A view is always copied into storage of
+ * its own.
+ *
+ * Out of line storage at least doubles each time it grows, so that repeated
+ * appends take amortized constant time per byte.
+ *
+ * \param str           The string to modify.
+ * \param capacity      The number of bytes to reserve.
+ *
+ * \returns 0 on success and non-zero on failure, in which case the string is
+ *          unchanged.
+ */
+int string_reserve(string_t* str, size_t capacity)
+{
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    bool view = string_is_view(str);
+    if (!view && capacity <= str->capacity)
+        return 0;
+
+    if (capacity >= SIZE_MAX / 2U)
+        return 1;
+
+    /* a view which fits is copied inline. */
+    if (capacity < str->length)
+        capacity = str->length;
+    if (view && capacity <= STRING_INLINE_CAPACITY)
+    {
+        memcpy(str->data.buf, str->data.view, str->length);
+        str->data.buf[str->length] = 0;
+        str->capacity = STRING_INLINE_CAPACITY;
+
+        return 0;
+    }
+
+    size_t grown = 2U * str->capacity + 1U;
+    if (capacity < grown)
+        capacity = grown;
+
+    char* ptr =
+        (char*)allocator_allocate_tagged(
+            str->alloc, capacity + 1U, ALLOCATOR_TAG_STRING);
+    if (NULL == ptr)
+        return 1;
+
+    /* copy the current bytes, which aren't NUL terminated in a view. */
+    memcpy(ptr, string_data(str), str->length);
+    ptr[str->length] = 0;
+
+    if (string_is_allocated(str))
+    {
+        allocator_release_tagged(
+            str->alloc, str->data.ptr, ALLOCATOR_TAG_STRING);
+    }
+
+    str->data.ptr = ptr;
+    str->capacity = capacity;
+
+    MODEL_ASSERT(PROP_VALID_STRING(str));
+
+    return 0;
+}
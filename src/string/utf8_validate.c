@@ -0,0 +1,25 @@
+/**
+ * \brief Validate UTF-8 using the best supported SIMD level.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+
+/**
+ * \brief The utf8_validate method checks that the given bytes are valid
+ * UTF-8, using the best supported SIMD level.
+ *
+ * \param data              The bytes to validate.
+ * \param size              The number of bytes.
+ * \param invalid_offset    Set to the offset of the first invalid sequence
+ *                          if the bytes are not valid UTF-8.
+ *
+ * \returns 0 if the bytes are valid UTF-8, and non-zero otherwise.
+ */
+int utf8_validate(const char* data, size_t size, size_t* invalid_offset)
+{
+    return utf8_validate_level(simd_level(), data, size, invalid_offset);
+}
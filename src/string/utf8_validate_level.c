@@ -0,0 +1,435 @@
+/**
+ * \brief Validate UTF-8 using a given SIMD level.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/string.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef SIMD_X86
+# include <immintrin.h>
+#endif /*SIMD_X86*/
+
+/* forward decls */
+static size_t utf8_restart(const unsigned char* s, size_t offset);
+static int utf8_validate_scalar(
+    const unsigned char* s, size_t offset, size_t size,
+    size_t* invalid_offset);
+
+#ifdef SIMD_X86
+/*
+ * The vector implementations classify each byte by its high nibble and the
+ * nibbles of the byte before it, using three 16 entry lookup tables.  Each
+ * table entry is a set of the errors that are possible given that nibble; an
+ * error is present when all three lookups agree.  Whether the third and fourth
+ * bytes of a sequence are continuation bytes is checked separately.  This is
+ * the lookup algorithm of Keiser and Lemire, "Validating UTF-8 In Less Than
+ * One Instruction Per Byte".
+ */
+#define UTF8_TOO_SHORT      0x01
+#define UTF8_TOO_LONG       0x02
+#define UTF8_OVERLONG_3     0x04
+#define UTF8_TOO_LARGE      0x08
+#define UTF8_SURROGATE      0x10
+#define UTF8_OVERLONG_2     0x20
+#define UTF8_TOO_LARGE_1000 0x40
+#define UTF8_OVERLONG_4     0x40
+#define UTF8_TWO_CONTS      0x80
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+/* errors possible given the high nibble of the previous byte. */
+#define UTF8_BYTE_1_HIGH \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2, \
+    UTF8_TOO_SHORT, \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE, \
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+/* errors possible given the low nibble of the previous byte. */
+#define UTF8_BYTE_1_LOW \
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, \
+    UTF8_CARRY | UTF8_OVERLONG_2, \
+    UTF8_CARRY, \
+    UTF8_CARRY, \
+    UTF8_CARRY | UTF8_TOO_LARGE, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+
+/* errors possible given the high nibble of the current byte. */
+#define UTF8_BYTE_2_HIGH \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | \
+        UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | \
+        UTF8_TOO_LARGE, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | \
+        UTF8_TOO_LARGE, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | \
+        UTF8_TOO_LARGE, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+/* a lead byte in the last three bytes of a vector is still incomplete. */
+#define UTF8_MAX_INCOMPLETE_TAIL 0xEF, 0xDF, 0xBF
+
+/**
+ * \brief Find the errors in a 16 byte vector, given the vector before it.
+ *
+ * \param input         The vector to check.
+ * \param prev_input    The previous vector.
+ *
+ * \returns a vector which is non-zero if there is an error.
+ */
+__attribute__((target("ssse3,sse4.1")))
+static inline __m128i utf8_check_sse4(__m128i input, __m128i prev_input)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i byte_1_high_table = _mm_setr_epi8(UTF8_BYTE_1_HIGH);
+    const __m128i byte_1_low_table = _mm_setr_epi8(UTF8_BYTE_1_LOW);
+    const __m128i byte_2_high_table = _mm_setr_epi8(UTF8_BYTE_2_HIGH);
+
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+    __m128i byte_1_high =
+        _mm_shuffle_epi8(
+            byte_1_high_table,
+            _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    __m128i byte_1_low =
+        _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble));
+    __m128i byte_2_high =
+        _mm_shuffle_epi8(
+            byte_2_high_table,
+            _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    __m128i special =
+        _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    /* the third and fourth bytes of a sequence must be continuations. */
+    __m128i is_third = _mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80));
+    __m128i is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80));
+    __m128i must_continue =
+        _mm_and_si128(
+            _mm_or_si128(is_third, is_fourth), _mm_set1_epi8((char)0x80));
+
+    return _mm_xor_si128(must_continue, special);
+}
+
+/**
+ * \brief Validate 16 bytes at a time with SSSE3 and SSE4.1.
+ *
+ * \param s             The bytes to validate.
+ * \param size          The number of bytes.
+ *
+ * \returns the offset of the first vector with an error, or the offset at
+ *          which fewer than 16 bytes remain.
+ */
+__attribute__((target("ssse3,sse4.1")))
+static size_t utf8_validate_sse4(const unsigned char* s, size_t size)
+{
+    const __m128i max_incomplete =
+        _mm_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            UTF8_MAX_INCOMPLETE_TAIL);
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    size_t offset = 0U;
+
+    for (; size - offset >= 16U; offset += 16U)
+    {
+        __m128i input = _mm_loadu_si128((const __m128i*)(s + offset));
+        __m128i error;
+
+        /* an ASCII vector is valid if the previous one was complete. */
+        if (0 == _mm_movemask_epi8(input))
+        {
+            error = prev_incomplete;
+            prev_incomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            error = utf8_check_sse4(input, prev_input);
+            prev_incomplete = _mm_subs_epu8(input, max_incomplete);
+        }
+
+        if (!_mm_testz_si128(error, error))
+            return offset;
+
+        prev_input = input;
+    }
+
+    return offset;
+}
+
+/**
+ * \brief Find the errors in a 32 byte vector, given the vector before it.
+ *
+ * \param input         The vector to check.
+ * \param prev_input    The previous vector.
+ *
+ * \returns a vector which is non-zero if there is an error.
+ */
+__attribute__((target("avx2")))
+static inline __m256i utf8_check_avx2(__m256i input, __m256i prev_input)
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i byte_1_high_table =
+        _mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH);
+    const __m256i byte_1_low_table =
+        _mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW);
+    const __m256i byte_2_high_table =
+        _mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH);
+
+    /* shifts cross the 128-bit lanes through the previous high lane. */
+    __m256i carry = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carry, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, carry, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, carry, 13);
+
+    __m256i byte_1_high =
+        _mm256_shuffle_epi8(
+            byte_1_high_table,
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i byte_1_low =
+        _mm256_shuffle_epi8(
+            byte_1_low_table, _mm256_and_si256(prev1, nibble));
+    __m256i byte_2_high =
+        _mm256_shuffle_epi8(
+            byte_2_high_table,
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    __m256i special =
+        _mm256_and_si256(
+            _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    /* the third and fourth bytes of a sequence must be continuations. */
+    __m256i is_third =
+        _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80));
+    __m256i is_fourth =
+        _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80));
+    __m256i must_continue =
+        _mm256_and_si256(
+            _mm256_or_si256(is_third, is_fourth),
+            _mm256_set1_epi8((char)0x80));
+
+    return _mm256_xor_si256(must_continue, special);
+}
+
+/**
+ * \brief Validate 32 bytes at a time with AVX2.
+ *
+ * \param s             The bytes to validate.
+ * \param size          The number of bytes.
+ *
+ * \returns the offset of the first vector with an error, or the offset at
+ *          which fewer than 32 bytes remain.
+ */
+__attribute__((target("avx2")))
+static size_t utf8_validate_avx2(const unsigned char* s, size_t size)
+{
+    const __m256i max_incomplete =
+        _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            UTF8_MAX_INCOMPLETE_TAIL);
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    size_t offset = 0U;
+
+    for (; size - offset >= 32U; offset += 32U)
+    {
+        __m256i input = _mm256_loadu_si256((const __m256i*)(s + offset));
+        __m256i error;
+
+        /* an ASCII vector is valid if the previous one was complete. */
+        if (0 == _mm256_movemask_epi8(input))
+        {
+            error = prev_incomplete;
+            prev_incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            error = utf8_check_avx2(input, prev_input);
+            prev_incomplete = _mm256_subs_epu8(input, max_incomplete);
+        }
+
+        if (!_mm256_testz_si256(error, error))
+            return offset;
+
+        prev_input = input;
+    }
+
+    return offset;
+}
+#endif /*SIMD_X86*/
+
+/**
+ * \brief The utf8_validate_level method is utf8_validate(), using the best
+ * implementation at or below the given SIMD level which is also supported by
+ * the running processor.
+ *
+ * The vector implementations only find the first vector with an error.  The
+ * exact offset, and any tail shorter than a vector, are found a byte at a time
+ * starting from the beginning of the sequence which straddles that vector.
+ *
+ * \param level             The maximum SIMD level to use.
+ * \param data              The bytes to validate.
+ * \param size              The number of bytes.
+ * \param invalid_offset    Set to the offset of the first invalid sequence
+ *                          if the bytes are not valid UTF-8.
+ *
+ * \returns 0 if the bytes are valid UTF-8, and non-zero otherwise.
+ */
+int utf8_validate_level(
+    simd_level_t level, const char* data, size_t size, size_t* invalid_offset)
+{
+    MODEL_ASSERT(NULL != data || 0U == size);
+    MODEL_ASSERT(NULL != invalid_offset);
+
+    const unsigned char* s = (const unsigned char*)data;
+    size_t offset = 0U;
+
+    simd_level_t supported = simd_level();
+    if (level > supported)
+        level = supported;
+
+#ifdef SIMD_X86
+    if (SIMD_LEVEL_AVX2 == level)
+        offset = utf8_validate_avx2(s, size);
+    else if (SIMD_LEVEL_SSE4 == level)
+        offset = utf8_validate_sse4(s, size);
+#endif /*SIMD_X86*/
+
+    return
+        utf8_validate_scalar(
+            s, utf8_restart(s, offset), size, invalid_offset);
+}
+
+/**
+ * \brief Back up from an offset to the start of the sequence which contains
+ * the byte before it, so that a sequence straddling the offset is rechecked.
+ *
+ * \param s             The bytes.
+ * \param offset        The offset, before which all sequences are valid.
+ *
+ * \returns the offset at which to restart validation.
+ */
+static size_t utf8_restart(const unsigned char* s, size_t offset)
+{
+    size_t restart = offset;
+
+    while (restart > 0U && offset - restart < 3U &&
+           0x80U == (s[restart - 1U] & 0xC0U))
+    {
+        --restart;
+    }
+
+    if (restart > 0U && s[restart - 1U] >= 0xC0U)
+        --restart;
+
+    return restart;
+}
+
+/**
+ * \brief Validate a byte at a time, skipping ASCII a word at a time.
+ *
+ * \param s                 The bytes to validate.
+ * \param offset            The offset at which to start, which must begin a
+ *                          sequence.
+ * \param size              The number of bytes.
+ * \param invalid_offset    Set to the offset of the first invalid sequence.
+ *
+ * \returns 0 if the bytes are valid UTF-8, and non-zero otherwise.
+ */
+static int utf8_validate_scalar(
+    const unsigned char* s, size_t offset, size_t size,
+    size_t* invalid_offset)
+{
+    while (offset < size)
+    {
+        uint64_t word;
+        if (size - offset >= 8U)
+        {
+            memcpy(&word, s + offset, sizeof(word));
+            if (0U == (word & UINT64_C(0x8080808080808080)))
+            {
+                offset += 8U;
+                continue;
+            }
+        }
+
+        unsigned char lead = s[offset];
+        if (lead < 0x80U)
+        {
+            ++offset;
+            continue;
+        }
+
+        /* the lead byte limits the range of the first continuation byte. */
+        size_t need;
+        unsigned char low = 0x80U, high = 0xBFU;
+        if (lead < 0xC2U)
+        {
+            break;
+        }
+        else if (lead < 0xE0U)
+        {
+            need = 1U;
+        }
+        else if (lead < 0xF0U)
+        {
+            need = 2U;
+            low = (0xE0U == lead) ? 0xA0U : low;
+            high = (0xEDU == lead) ? 0x9FU : high;
+        }
+        else if (lead < 0xF5U)
+        {
+            need = 3U;
+            low = (0xF0U == lead) ? 0x90U : low;
+            high = (0xF4U == lead) ? 0x8FU : high;
+        }
+        else
+        {
+            break;
+        }
+
+        if (size - offset <= need ||
+            s[offset + 1U] < low || s[offset + 1U] > high)
+        {
+            break;
+        }
+
+        size_t i = 2U;
+        while (i <= need && 0x80U == (s[offset + i] & 0xC0U))
+        {
+            ++i;
+        }
+
+        if (i <= need)
+            break;
+
+        offset += need + 1U;
+    }
+
+    if (offset < size)
+    {
+        *invalid_offset = offset;
+        return 1;
+    }
+
+    return 0;
+}
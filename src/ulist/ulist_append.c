@@ -0,0 +1,44 @@
+/**
+ * \brief Append a data value into the unrolled list after the given
+ * position.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_append method will append the given data value AFTER the
+ * given position in the list.  This method assumes that the provided position
+ * is valid for this list; it is extremely important that the caller ensures
+ * that this is true.  The ownership of this data is transferred to the list
+ * who is responsible for dispose()ing and free()ing it.
+ *
+ * On success, pos is updated to refer to the newly appended data value.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position after which this data is appended.
+ * \param data          The data to append.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_append(ulist_t* list, ulist_pos_t* pos, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(list));
+    MODEL_ASSERT(PROP_VALID_ULIST_POS(pos));
+    MODEL_ASSERT(NULL != data);
+
+    /* appending after the value takes the following index. */
+    ulist_pos_t after = { pos->chunk, pos->index + 1U };
+    if (0 != ulist_chunk_insert(list, &after, data))
+        return 1;
+
+    *pos = after;
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * \brief Find the position of a value in an unrolled list by index.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_at method finds the position of the data value at the
+ * given zero-based index, walking chunks from whichever end of the list is
+ * closer.
+ *
+ * \param list          The list to search.
+ * \param index         The index of the data value to find.
+ * \param pos           The position to set.
+ *
+ * \returns 0 on success and non-zero if the index is out of bounds.
+ */
+int ulist_at(ulist_t* list, size_t index, ulist_pos_t* pos)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+    MODEL_ASSERT(NULL != pos);
+
+    if (index >= list->size)
+        return 1;
+
+    if (index < list->size / 2U)
+    {
+        /* walk forward from the head. */
+        ulist_chunk_t* i = list->head;
+        while (index >= i->count)
+        {
+            index -= i->count;
+            i = i->next;
+        }
+
+        pos->chunk = i;
+        pos->index = index;
+    }
+    else
+    {
+        /* walk backward from the tail, counting from the end. */
+        size_t remaining = list->size - index;
+        ulist_chunk_t* i = list->tail;
+        while (remaining > i->count)
+        {
+            remaining -= i->count;
+            i = i->prev;
+        }
+
+        pos->chunk = i;
+        pos->index = i->count - remaining;
+    }
+
+    MODEL_ASSERT(PROP_VALID_ULIST_POS(pos));
+
+    return 0;
+}
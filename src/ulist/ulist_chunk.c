@@ -0,0 +1,143 @@
+/**
+ * \brief Chunk management for the unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief Create an empty chunk and link it into the list after the given
+ * chunk, or at the head of the list if the given chunk is NULL.
+ *
+ * The new chunk is empty, so the caller must populate it before the list is
+ * used again.
+ *
+ * \param list          The list to modify.
+ * \param after         The chunk after which the new chunk is linked.
+ *
+ * \returns the new chunk, or NULL on failure.
+ */
+ulist_chunk_t* ulist_chunk_create(ulist_t* list, ulist_chunk_t* after)
+{
+    MODEL_ASSERT(NULL != list);
+
+    ulist_chunk_t* chunk = (ulist_chunk_t*)malloc(sizeof(ulist_chunk_t));
+    if (NULL == chunk)
+        return NULL;
+
+    chunk->count = 0U;
+    chunk->prev = after;
+
+    if (NULL == after)
+    {
+        /* link the chunk at the head. */
+        chunk->next = list->head;
+        list->head = chunk;
+    }
+    else
+    {
+        /* link the chunk after the given chunk. */
+        chunk->next = after->next;
+        after->next = chunk;
+    }
+
+    /* fix up the next chunk or the tail. */
+    if (chunk->next)
+        chunk->next->prev = chunk;
+    else
+        list->tail = chunk;
+
+    return chunk;
+}
+
+/**
+ * \brief Unlink the given chunk from the list and free it.
+ *
+ * \param list          The list to modify.
+ * \param chunk         The chunk to release.
+ */
+void ulist_chunk_release(ulist_t* list, ulist_chunk_t* chunk)
+{
+    MODEL_ASSERT(NULL != list);
+    MODEL_ASSERT(NULL != chunk);
+
+    if (chunk->prev)
+        chunk->prev->next = chunk->next;
+    else
+        list->head = chunk->next;
+
+    if (chunk->next)
+        chunk->next->prev = chunk->prev;
+    else
+        list->tail = chunk->prev;
+
+    free(chunk);
+}
+
+/**
+ * \brief Insert a data value at the given chunk index, which may be equal to
+ * the chunk's count to insert after its last value.  A full chunk is split in
+ * half to make room.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position at which to insert, which is updated to
+ *                      the inserted value's final position.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_chunk_insert(ulist_t* list, ulist_pos_t* pos, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(list));
+    MODEL_ASSERT(NULL != pos && NULL != pos->chunk);
+    MODEL_ASSERT(pos->index <= pos->chunk->count);
+    MODEL_ASSERT(NULL != data);
+
+    ulist_chunk_t* chunk = pos->chunk;
+    size_t index = pos->index;
+
+    /* split a full chunk in half to make room. */
+    if (ULIST_CHUNK_CAPACITY == chunk->count)
+    {
+        ulist_chunk_t* upper = ulist_chunk_create(list, chunk);
+        if (NULL == upper)
+            return 1;
+
+        const size_t half = ULIST_CHUNK_CAPACITY / 2U;
+        upper->count = chunk->count - half;
+        memcpy(
+            upper->data, chunk->data + half,
+            upper->count * sizeof(disposable_t*));
+        chunk->count = half;
+
+        /* the insertion point may now be in the upper half. */
+        if (index > half)
+        {
+            chunk = upper;
+            index -= half;
+        }
+    }
+
+    /* make room for and insert the data value. */
+    memmove(
+        chunk->data + index + 1, chunk->data + index,
+        (chunk->count - index) * sizeof(disposable_t*));
+    chunk->data[index] = data;
+    ++chunk->count;
+    ++list->size;
+
+    /* report the final position of the inserted value. */
+    pos->chunk = chunk;
+    pos->index = index;
+
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(list));
+    MODEL_ASSERT(PROP_VALID_ULIST_POS(pos));
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * \brief Initialize an unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* forward decls */
+static void ulist_dispose(disposable_t* disp);
+
+/**
+ * \brief The ulist_init method creates a new empty unrolled list.
+ *
+ * \param list          The list to initialize.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_init(ulist_t* list)
+{
+    MODEL_ASSERT(NULL != list);
+
+    /* clear the list. */
+    memset(list, 0, sizeof(ulist_t));
+
+    /* set our dispose method. */
+    list->hdr.dispose = &ulist_dispose;
+
+    /* the list is now valid. */
+    MODEL_ASSERT(PROP_VALID_ULIST(list) && PROP_VALID_ULIST_EMPTY(list));
+
+    return 0;
+}
+
+/**
+ * \brief Dispose of an unrolled list and clean up its chunks.
+ *
+ * \param disp      The list to dispose.
+ */
+static void ulist_dispose(disposable_t* disp)
+{
+    ulist_t* list = (ulist_t*)disp;
+
+    /* we are disposing a valid list. */
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+
+    ulist_chunk_t* i = list->head;
+    while (i != NULL)
+    {
+        ulist_chunk_t* tmp = i->next;
+
+        /* clean up the data held in this chunk. */
+        for (size_t j = 0; j < i->count; ++j)
+        {
+            dispose(i->data[j]);
+            free(i->data[j]);
+        }
+
+        /* clean up the chunk. */
+        free(i);
+
+        i = tmp;
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ * \brief Insert a data value into the unrolled list before the given
+ * position.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_insert method will insert the given data value BEFORE the
+ * given position in the list.  This method assumes that the provided position
+ * is valid for this list; it is extremely important that the caller ensures
+ * that this is true.  The ownership of this data is transferred to the list
+ * who is responsible for dispose()ing and free()ing it.
+ *
+ * On success, pos is updated to refer to the newly inserted data value.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position before which this data is inserted.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_insert(ulist_t* list, ulist_pos_t* pos, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(list));
+    MODEL_ASSERT(PROP_VALID_ULIST_POS(pos));
+    MODEL_ASSERT(NULL != data);
+
+    /* inserting before the value takes its index. */
+    return ulist_chunk_insert(list, pos, data);
+}
@@ -0,0 +1,49 @@
+/**
+ * \brief Internal helpers shared by the unrolled list implementation.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#ifndef  EJ_ULIST_INTERNAL_HEADER_GUARD
+# define EJ_ULIST_INTERNAL_HEADER_GUARD
+
+#include <ej/ulist.h>
+
+/**
+ * \brief Create an empty chunk and link it into the list after the given
+ * chunk, or at the head of the list if the given chunk is NULL.
+ *
+ * The new chunk is empty, so the caller must populate it before the list is
+ * used again.
+ *
+ * \param list          The list to modify.
+ * \param after         The chunk after which the new chunk is linked.
+ *
+ * \returns the new chunk, or NULL on failure.
+ */
+ulist_chunk_t* ulist_chunk_create(ulist_t* list, ulist_chunk_t* after);
+
+/**
+ * \brief Unlink the given chunk from the list and free it.
+ *
+ * \param list          The list to modify.
+ * \param chunk         The chunk to release.
+ */
+void ulist_chunk_release(ulist_t* list, ulist_chunk_t* chunk);
+
+/**
+ * \brief Insert a data value at the given chunk index, which may be equal to
+ * the chunk's count to insert after its last value.  A full chunk is split in
+ * half to make room.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position at which to insert, which is updated to
+ *                      the inserted value's final position.
+ * \param data          The data to insert.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_chunk_insert(ulist_t* list, ulist_pos_t* pos, disposable_t* data);
+
+#endif /*EJ_ULIST_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,55 @@
+/**
+ * \brief Pop a value off of the back of an unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_pop_back method pops a data value off of the back of the
+ * unrolled list.  The ownership of this data is transferred to the caller who
+ * is responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_pop_back(ulist_t* list, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+    MODEL_ASSERT(NULL != data);
+
+    if (NULL == list->tail)
+    {
+        /* list IS empty. */
+        MODEL_ASSERT(PROP_VALID_ULIST_EMPTY(list));
+
+        *data = NULL;
+
+        return 1;
+    }
+
+    /* popping the last value of the tail chunk never shifts or merges. */
+    ulist_chunk_t* tail = list->tail;
+    *data = tail->data[--tail->count];
+    --list->size;
+
+    /* release the tail chunk once it is empty. */
+    if (0U == tail->count)
+        ulist_chunk_release(list, tail);
+
+    /* list invariant is maintained. */
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+
+    return 0;
+}
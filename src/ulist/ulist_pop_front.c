@@ -0,0 +1,44 @@
+/**
+ * \brief Pop a value off of the front of an unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_pop_front method pops a data value off of the front of the
+ * unrolled list.  The ownership of this data is transferred to the caller who
+ * is responsible for dispose()ing and free()ing it.
+ *
+ * If the list is empty, a non-zero value is returned, and the data pointer
+ * will be set to NULL.
+ *
+ * \param list          The list to modify.
+ * \param data          A pointer to the data pointer set to the popped value.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_pop_front(ulist_t* list, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+    MODEL_ASSERT(NULL != data);
+
+    if (NULL == list->head)
+    {
+        /* list IS empty. */
+        MODEL_ASSERT(PROP_VALID_ULIST_EMPTY(list));
+
+        *data = NULL;
+
+        return 1;
+    }
+
+    ulist_pos_t pos = { list->head, 0U };
+
+    return ulist_remove(list, &pos, data);
+}
@@ -0,0 +1,44 @@
+/**
+ * \brief Push a value to the back of the unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_push_back method pushes a data value onto the back of the
+ * unrolled list.  The ownership of this data is transferred to the list and
+ * may be dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_push_back(ulist_t* list, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    /* start a new tail chunk if the tail chunk is missing or full. */
+    if (NULL == list->tail || ULIST_CHUNK_CAPACITY == list->tail->count)
+    {
+        if (NULL == ulist_chunk_create(list, list->tail))
+            return 1;
+    }
+
+    /* append the value to the tail chunk. */
+    list->tail->data[list->tail->count++] = data;
+    ++list->size;
+
+    /* the list is valid and not empty. */
+    MODEL_ASSERT(PROP_VALID_ULIST(list) && PROP_VALID_ULIST_NOT_EMPTY(list));
+
+    return 0;
+}
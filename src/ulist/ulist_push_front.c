@@ -0,0 +1,51 @@
+/**
+ * \brief Push a value to the front of the unrolled list.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_push_front method pushes a data value onto the front of the
+ * unrolled list.  The ownership of this data is transferred to the list and
+ * may be dispose()d and free()d if deleted or if the list is dispose()d.
+ *
+ * \param list          The list to modify.
+ * \param data          The data item to push onto the list.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_push_front(ulist_t* list, disposable_t* data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+    MODEL_ASSERT(PROP_VALID_DISPOSABLE(data));
+
+    /* start a new head chunk if the head chunk is missing or full. */
+    if (NULL == list->head || ULIST_CHUNK_CAPACITY == list->head->count)
+    {
+        ulist_chunk_t* chunk = ulist_chunk_create(list, NULL);
+        if (NULL == chunk)
+            return 1;
+
+        chunk->data[0] = data;
+        chunk->count = 1U;
+        ++list->size;
+    }
+    else
+    {
+        ulist_pos_t pos = { list->head, 0U };
+        if (0 != ulist_chunk_insert(list, &pos, data))
+            return 1;
+    }
+
+    /* the list is valid and not empty. */
+    MODEL_ASSERT(PROP_VALID_ULIST(list) && PROP_VALID_ULIST_NOT_EMPTY(list));
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * \brief Remove a data value from the unrolled list, returning ownership of
+ * it to the caller.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_remove method will remove the data value at the given
+ * position from the list, returning it to be dispose()d and free()d by the
+ * caller.  This method assumes that the provided position is valid for this
+ * list; it is extremely important that the caller ensures that this is true.
+ *
+ * Sparse neighboring chunks are merged, and empty chunks are released.
+ *
+ * \param list          The list to modify.
+ * \param pos           The position of the data value to be removed.
+ * \param data          Pointer to the data pointer returned to the caller.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_remove(ulist_t* list, const ulist_pos_t* pos, disposable_t** data)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(list));
+    MODEL_ASSERT(PROP_VALID_ULIST_POS(pos));
+    MODEL_ASSERT(NULL != data);
+
+    ulist_chunk_t* chunk = pos->chunk;
+
+    /* pass the data to the caller. */
+    *data = chunk->data[pos->index];
+
+    /* close the gap. */
+    --chunk->count;
+    memmove(
+        chunk->data + pos->index, chunk->data + pos->index + 1,
+        (chunk->count - pos->index) * sizeof(disposable_t*));
+
+    /* the list is one smaller. */
+    --list->size;
+
+    if (0U == chunk->count)
+    {
+        /* release an empty chunk. */
+        ulist_chunk_release(list, chunk);
+    }
+    else if (
+        NULL != chunk->next
+     && chunk->count + chunk->next->count <= ULIST_CHUNK_CAPACITY / 2U)
+    {
+        /* absorb a sparse next chunk into this chunk. */
+        ulist_chunk_t* next = chunk->next;
+        memcpy(
+            chunk->data + chunk->count, next->data,
+            next->count * sizeof(disposable_t*));
+        chunk->count += next->count;
+        ulist_chunk_release(list, next);
+    }
+    else if (
+        NULL != chunk->prev
+     && chunk->prev->count + chunk->count <= ULIST_CHUNK_CAPACITY / 2U)
+    {
+        /* absorb this sparse chunk into the previous chunk. */
+        ulist_chunk_t* prev = chunk->prev;
+        memcpy(
+            prev->data + prev->count, chunk->data,
+            chunk->count * sizeof(disposable_t*));
+        prev->count += chunk->count;
+        ulist_chunk_release(list, chunk);
+    }
+
+    MODEL_ASSERT(PROP_VALID_ULIST(list));
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * \brief Splice two unrolled lists together.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_splice method will splice two lists into one.  After this
+ * method is called, the x list will contain all chunks, and the y list will be
+ * empty.
+ *
+ * \param x             The x list to splice with the values from the y list.
+ * \param y             The y list to destructively splice.
+ */
+void ulist_splice(ulist_t* x, ulist_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST(x));
+    MODEL_ASSERT(PROP_VALID_ULIST(y));
+
+    /* if there are no elements in x, then take y's head and tail. */
+    if (NULL == x->head)
+    {
+        x->head = y->head;
+        x->tail = y->tail;
+        x->size = y->size;
+    }
+    /* if there are elements in x and y, then splice the chunks. */
+    else if (NULL != y->head)
+    {
+        x->tail->next = y->head;
+        y->head->prev = x->tail;
+        x->tail = y->tail;
+        x->size += y->size;
+    }
+
+    /* In each case, we can clean up y. */
+    y->head = y->tail = NULL;
+    y->size = 0U;
+
+    /* x is valid, and y is now empty. */
+    MODEL_ASSERT(PROP_VALID_ULIST(x));
+    MODEL_ASSERT(PROP_VALID_ULIST_EMPTY(y));
+}
@@ -0,0 +1,81 @@
+/**
+ * \brief Split an unrolled list at a given position, creating two lists.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <model_check/assert.h>
+#include <ej/ulist.h>
+#include "ulist_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief The ulist_split method will split the list at the given position.
+ * The original list x will contain all entries BEFORE the position, and the
+ * new y list will contain the entry at this position and all entries AFTER
+ * it.  It is expected that the y list is empty, and the position is valid for
+ * the original x list.
+ *
+ * Splitting in the middle of a chunk requires a new chunk, which may fail.
+ * The sizes of the two lists are recomputed from the chunk counts, so this
+ * method touches one chunk per \ref ULIST_CHUNK_CAPACITY entries rather than
+ * every entry.
+ *
+ * \param x             The x list to split, which will contain all values
+ *                      BEFORE pos after this operation is complete.
+ * \param pos           The position at which the list is split.
+ * \param y             The y list to receive half of the list, starting with
+ *                      the value at pos.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ulist_split(ulist_t* x, const ulist_pos_t* pos, ulist_t* y)
+{
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(x));
+    MODEL_ASSERT(PROP_VALID_ULIST_POS(pos));
+    MODEL_ASSERT(PROP_VALID_ULIST_EMPTY(y));
+
+    ulist_chunk_t* first = pos->chunk;
+
+    /* splitting mid-chunk moves the upper part of the chunk to a new chunk. */
+    if (pos->index > 0U)
+    {
+        ulist_chunk_t* upper = ulist_chunk_create(x, first);
+        if (NULL == upper)
+            return 1;
+
+        upper->count = first->count - pos->index;
+        memcpy(
+            upper->data, first->data + pos->index,
+            upper->count * sizeof(disposable_t*));
+        first->count = pos->index;
+
+        first = upper;
+    }
+
+    /* y takes first through the tail. */
+    y->head = first;
+    y->tail = x->tail;
+
+    /* x keeps everything before first. */
+    x->tail = first->prev;
+    if (x->tail)
+        x->tail->next = NULL;
+    else
+        x->head = NULL;
+    first->prev = NULL;
+
+    /* count the values moved to y, one chunk at a time. */
+    for (ulist_chunk_t* i = first; i != NULL; i = i->next)
+    {
+        y->size += i->count;
+    }
+    x->size -= y->size;
+
+    MODEL_ASSERT(PROP_VALID_ULIST(x));
+    MODEL_ASSERT(PROP_VALID_ULIST_NOT_EMPTY(y));
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * \brief Unit tests for the allocator interface.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/allocator.h>
+#include <gtest/gtest.h>
+
+/**
+ * The system allocator is a valid singleton.
+ */
+TEST(allocator, system_singleton)
+{
+    allocator_t* alloc = allocator_system();
+
+    EXPECT_TRUE(PROP_VALID_ALLOCATOR(alloc));
+    EXPECT_EQ(alloc, allocator_system());
+
+    /* the system allocator doesn't support reservation, so it succeeds. */
+    EXPECT_EQ(nullptr, alloc->reserve);
+    EXPECT_EQ(0, allocator_reserve(alloc, 16, 1000));
+
+    /* disposing the singleton does nothing. */
+    dispose((disposable_t*)alloc);
+    EXPECT_TRUE(PROP_VALID_ALLOCATOR(allocator_system()));
+}
+
+/**
+ * The system allocator allocates and releases memory.
+ */
+TEST(allocator, system_allocate_release)
+{
+    allocator_t* alloc = allocator_system();
+
+    char* mem = (char*)allocator_allocate(alloc, 64);
+    ASSERT_NE(nullptr, mem);
+    memset(mem, 0x5A, 64);
+
+    allocator_release(alloc, mem);
+
+    /* releasing NULL is ignored. */
+    allocator_release(alloc, nullptr);
+}
+
+/**
+ * The system allocator measures each allocation without a header of its own,
+ * and attributes it to its tag.
+ */
+TEST(allocator, system_stats)
+{
+    allocator_t* alloc = allocator_system();
+    const allocator_stats_t* stats = allocator_stats(alloc);
+    allocator_stats_t before = *stats;
+
+    void* mem = allocator_allocate_tagged(alloc, 100, ALLOCATOR_TAG_STRING);
+    ASSERT_NE(nullptr, mem);
+
+    size_t bytes = alloc->measure(alloc, mem);
+    EXPECT_GE(bytes, 100U);
+    EXPECT_EQ(before.live_bytes + bytes, stats->live_bytes);
+    EXPECT_EQ(before.live_count + 1U, stats->live_count);
+    EXPECT_EQ(before.total_count + 1U, stats->total_count);
+    EXPECT_GE(stats->high_water_bytes, stats->live_bytes);
+    EXPECT_EQ(
+        before.tag_live_bytes[ALLOCATOR_TAG_STRING] + bytes,
+        stats->tag_live_bytes[ALLOCATOR_TAG_STRING]);
+    EXPECT_EQ(
+        before.tag_live_count[ALLOCATOR_TAG_STRING] + 1U,
+        stats->tag_live_count[ALLOCATOR_TAG_STRING]);
+
+    allocator_release_tagged(alloc, mem, ALLOCATOR_TAG_STRING);
+    EXPECT_EQ(before.live_bytes, stats->live_bytes);
+    EXPECT_EQ(before.live_count, stats->live_count);
+    EXPECT_EQ(
+        before.tag_live_bytes[ALLOCATOR_TAG_STRING],
+        stats->tag_live_bytes[ALLOCATOR_TAG_STRING]);
+    EXPECT_EQ(
+        before.tag_live_count[ALLOCATOR_TAG_STRING],
+        stats->tag_live_count[ALLOCATOR_TAG_STRING]);
+}
@@ -0,0 +1,263 @@
+/**
+ * \brief Unit tests for the arena allocator.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/arena.h>
+#include <ej/list.h>
+#include <gtest/gtest.h>
+
+struct foo
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static void foo_disposer_mock(disposable_t* disp);
+static int foo_disposer_mock_count;
+
+/**
+ * An arena can be initialized as an empty arena.
+ */
+TEST(arena, init)
+{
+    arena_t arena;
+
+    memset(&arena, 0xFE, sizeof(arena));
+
+    /* initialize the arena. */
+    ASSERT_EQ(0, arena_init(&arena, 1024));
+
+    /* the arena is valid, and it has no chunks yet. */
+    EXPECT_TRUE(PROP_VALID_ARENA(&arena));
+    EXPECT_EQ(nullptr, arena.chunks);
+    EXPECT_EQ(0U, arena.chunk_count);
+
+    /* a zero chunk size is rejected. */
+    arena_t bad;
+    EXPECT_NE(0, arena_init(&bad, 0));
+
+    dispose((disposable_t*)&arena);
+}
+
+/**
+ * Allocations are bumped sequentially from a chunk and maximally aligned.
+ */
+TEST(arena, allocate)
+{
+    arena_t arena;
+    allocator_t* alloc = &arena.alloc;
+    const size_t align = alignof(max_align_t);
+
+    /* initialize the arena. */
+    ASSERT_EQ(0, arena_init(&arena, 1024));
+
+    unsigned char* a = (unsigned char*)allocator_allocate(alloc, 3);
+    unsigned char* b = (unsigned char*)allocator_allocate(alloc, 40);
+    unsigned char* c = (unsigned char*)allocator_allocate(alloc, 1);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    ASSERT_NE(nullptr, c);
+
+    /* every allocation is aligned. */
+    EXPECT_EQ(0U, ((uintptr_t)a) % align);
+    EXPECT_EQ(0U, ((uintptr_t)b) % align);
+    EXPECT_EQ(0U, ((uintptr_t)c) % align);
+
+    /* allocations are sequential. */
+    EXPECT_EQ(a + align, b);
+    EXPECT_EQ(b + ((40 + align - 1) / align) * align, c);
+    EXPECT_EQ(1U, arena.chunk_count);
+
+    /* releasing is a no-op. */
+    allocator_release(alloc, b);
+    EXPECT_EQ(c + align, (unsigned char*)allocator_allocate(alloc, 1));
+
+    dispose((disposable_t*)&arena);
+    EXPECT_EQ(0U, arena.chunk_count);
+}
+
+/**
+ * New chunks are started on demand, and oversized requests get their own.
+ */
+TEST(arena, chunks)
+{
+    arena_t arena;
+    allocator_t* alloc = &arena.alloc;
+
+    /* initialize the arena. */
+    ASSERT_EQ(0, arena_init(&arena, 256));
+
+    unsigned char* a = (unsigned char*)allocator_allocate(alloc, 200);
+    ASSERT_NE(nullptr, a);
+    EXPECT_EQ(1U, arena.chunk_count);
+
+    /* this doesn't fit in the rest of the chunk. */
+    ASSERT_NE(nullptr, allocator_allocate(alloc, 200));
+    EXPECT_EQ(2U, arena.chunk_count);
+
+    /* an oversized request gets a chunk of its own... */
+    unsigned char* big = (unsigned char*)allocator_allocate(alloc, 4096);
+    ASSERT_NE(nullptr, big);
+    memset(big, 0xA5, 4096);
+    EXPECT_EQ(3U, arena.chunk_count);
+
+    /* ...and doesn't disturb the current chunk. */
+    unsigned char* before = arena.bump;
+    ASSERT_EQ(before, (unsigned char*)allocator_allocate(alloc, 8));
+
+    dispose((disposable_t*)&arena);
+}
+
+/**
+ * A reservation makes a batch contiguous.
+ */
+TEST(arena, reserve)
+{
+    arena_t arena;
+    allocator_t* alloc = &arena.alloc;
+    const size_t align = alignof(max_align_t);
+
+    /* initialize the arena. */
+    ASSERT_EQ(0, arena_init(&arena, 256));
+    ASSERT_NE(nullptr, allocator_allocate(alloc, 200));
+
+    /* reserve more than a chunk's worth. */
+    ASSERT_EQ(0, allocator_reserve(alloc, align, 100));
+    EXPECT_EQ(2U, arena.chunk_count);
+
+    unsigned char* first = (unsigned char*)allocator_allocate(alloc, align);
+    for (size_t i = 1; i < 100; ++i)
+        EXPECT_EQ(first + i * align, allocator_allocate(alloc, align));
+    EXPECT_EQ(2U, arena.chunk_count);
+
+    dispose((disposable_t*)&arena);
+}
+
+/**
+ * A list whose nodes and values come from an arena is released in bulk.
+ */
+TEST(arena, list)
+{
+    arena_t arena;
+    list_t list;
+
+    /* initialize the arena and a list that uses it. */
+    ASSERT_EQ(0, arena_init(&arena, 4096));
+    ASSERT_EQ(0, list_init_allocator(&list, &arena.alloc));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        foo* f = (foo*)allocator_allocate(&arena.alloc, sizeof(foo));
+        ASSERT_NE(nullptr, f);
+        f->hdr.dispose = &foo_disposer_mock;
+        f->val = i;
+        ASSERT_EQ(0, list_push_back(&list, (disposable_t*)f));
+    }
+
+    /* bulk push reserves contiguous nodes from the arena. */
+    foo* items[10];
+    for (int i = 0; i < 10; ++i)
+    {
+        items[i] = (foo*)allocator_allocate(&arena.alloc, sizeof(foo));
+        ASSERT_NE(nullptr, items[i]);
+        items[i]->hdr.dispose = &foo_disposer_mock;
+        items[i]->val = 1000 + i;
+    }
+    ASSERT_EQ(0, list_push_back_many(&list, (disposable_t**)items, 10));
+    EXPECT_EQ(1010U, list.size);
+    EXPECT_EQ(1009, ((foo*)list.tail->data)->val);
+
+    /* disposing the list still disposes each value... */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(1010, foo_disposer_mock_count);
+
+    /* ...and the arena releases all of the memory at once. */
+    EXPECT_GT(arena.chunk_count, 1U);
+    dispose((disposable_t*)&arena);
+    EXPECT_EQ(nullptr, arena.chunks);
+}
+
+/**
+ * An arena can take the chunks and statistics of another arena.
+ */
+TEST(arena, adopt)
+{
+    arena_t arena, other;
+    const allocator_stats_t* stats = allocator_stats(&arena.alloc);
+
+    ASSERT_EQ(0, arena_init(&arena, 1024));
+    ASSERT_EQ(0, arena_init(&other, 1024));
+
+    /* adopting an empty arena changes nothing. */
+    arena_adopt(&arena, &other);
+    EXPECT_EQ(nullptr, arena.chunks);
+    EXPECT_EQ(0U, arena.chunk_count);
+
+    /* an empty arena takes the other arena's chunks as its own. */
+    ASSERT_NE(nullptr, allocator_allocate(&other.alloc, 800));
+    ASSERT_NE(nullptr, allocator_allocate(&other.alloc, 800));
+    arena_adopt(&arena, &other);
+    EXPECT_EQ(2U, arena.chunk_count);
+    EXPECT_EQ(2U, stats->live_count);
+    EXPECT_EQ(nullptr, other.chunks);
+    EXPECT_EQ(0U, other.chunk_count);
+    EXPECT_EQ(0U, allocator_stats(&other.alloc)->live_count);
+
+    /* adopted chunks don't disturb the current chunk. */
+    unsigned char* bump = arena.bump;
+    ASSERT_NE(nullptr, allocator_allocate(&other.alloc, 800));
+    arena_adopt(&arena, &other);
+    EXPECT_EQ(3U, arena.chunk_count);
+    EXPECT_EQ(3U, stats->live_count);
+    EXPECT_EQ(bump, arena.bump);
+
+    /* the other arena can be reused, and everything is released once. */
+    ASSERT_NE(nullptr, allocator_allocate(&other.alloc, 16));
+    dispose((disposable_t*)&other);
+    dispose((disposable_t*)&arena);
+    EXPECT_EQ(nullptr, arena.chunks);
+}
+
+/**
+ * An arena knows which memory was carved from its chunks.
+ */
+TEST(arena, owns)
+{
+    arena_t arena, other;
+
+    ASSERT_EQ(0, arena_init(&arena, 1024));
+    ASSERT_EQ(0, arena_init(&other, 1024));
+
+    char* small = (char*)allocator_allocate(&arena.alloc, 16);
+    char* large = (char*)allocator_allocate(&arena.alloc, 4096);
+    char* elsewhere = (char*)allocator_allocate(&other.alloc, 16);
+    ASSERT_NE(nullptr, small);
+    ASSERT_NE(nullptr, large);
+    ASSERT_NE(nullptr, elsewhere);
+
+    EXPECT_TRUE(arena_owns(&arena, small));
+    EXPECT_TRUE(arena_owns(&arena, small + 15));
+    EXPECT_TRUE(arena_owns(&arena, large));
+    EXPECT_TRUE(arena_owns(&arena, large + 4095));
+    EXPECT_FALSE(arena_owns(&arena, elsewhere));
+    EXPECT_FALSE(arena_owns(&arena, &arena));
+
+    /* adopted chunks are owned by their new arena. */
+    arena_adopt(&arena, &other);
+    EXPECT_TRUE(arena_owns(&arena, elsewhere));
+    EXPECT_FALSE(arena_owns(&other, elsewhere));
+
+    dispose((disposable_t*)&other);
+    dispose((disposable_t*)&arena);
+    EXPECT_FALSE(arena_owns(&arena, small));
+}
+
+static void foo_disposer_mock(disposable_t*)
+{
+    ++foo_disposer_mock_count;
+}
@@ -0,0 +1,1438 @@
+/**
+ * \brief Unit tests for the buffer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/arena.h>
+#include <ej/buffer.h>
+#include <ej/heap.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+struct line
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static void line_disposer_mock(disposable_t* disp);
+static int line_disposer_mock_count;
+
+/**
+ * A buffer creates its own empty line list from its allocator.
+ */
+TEST(buffer, init_empty)
+{
+    buffer_t buffer;
+    arena_t arena;
+
+    ASSERT_EQ(0, arena_init(&arena, 4096));
+
+    /* initialize the buffer. */
+    ASSERT_EQ(0, buffer_init(&buffer, &arena.alloc, NULL, NULL, NULL));
+    EXPECT_TRUE(PROP_VALID_BUFFER(&buffer));
+    EXPECT_EQ(&arena.alloc, buffer.allocator);
+    EXPECT_EQ(nullptr, buffer.undo_commands);
+    EXPECT_EQ(nullptr, buffer.redo_commands);
+
+    /* the line list and its lines belong to the arena. */
+    ASSERT_NE(nullptr, buffer.lines);
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(buffer.lines));
+    EXPECT_EQ(&arena.alloc, buffer.lines->node_alloc);
+    EXPECT_EQ(&arena.alloc, buffer.lines->data_alloc);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        line* l = (line*)allocator_allocate(&arena.alloc, sizeof(line));
+        ASSERT_NE(nullptr, l);
+        l->hdr.dispose = &line_disposer_mock;
+        l->val = i;
+        ASSERT_EQ(0, list_push_back(buffer.lines, (disposable_t*)l));
+    }
+
+    /* disposing the buffer disposes every line. */
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(100, line_disposer_mock_count);
+
+    /* the arena releases the memory. */
+    dispose((disposable_t*)&arena);
+}
+
+/**
+ * A buffer takes ownership of a given line list.
+ */
+TEST(buffer, init_lines)
+{
+    buffer_t buffer;
+
+    /* the system allocator frees the list when the buffer is disposed. */
+    list_t* lines = (list_t*)malloc(sizeof(list_t));
+    ASSERT_NE(nullptr, lines);
+    ASSERT_EQ(0, list_init(lines));
+
+    line* l = (line*)malloc(sizeof(line));
+    l->hdr.dispose = &line_disposer_mock;
+    l->val = 7;
+    ASSERT_EQ(0, list_push_back(lines, (disposable_t*)l));
+
+    ASSERT_EQ(
+        0, buffer_init(&buffer, allocator_system(), lines, NULL, NULL));
+    EXPECT_EQ(lines, buffer.lines);
+
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(1, line_disposer_mock_count);
+}
+
+/**
+ * A buffer in arena mode releases its lines in bulk.
+ */
+TEST(buffer, init_arena)
+{
+    buffer_t buffer;
+
+    arena_t* arena = (arena_t*)malloc(sizeof(arena_t));
+    ASSERT_NE(nullptr, arena);
+    ASSERT_EQ(0, arena_init(arena, 65536));
+
+    /* initialize the buffer. */
+    ASSERT_EQ(0, buffer_init_arena(&buffer, arena, NULL, NULL, NULL));
+    EXPECT_TRUE(PROP_VALID_BUFFER(&buffer));
+    EXPECT_EQ(arena, buffer.arena);
+    EXPECT_EQ(&arena->alloc, buffer.allocator);
+    EXPECT_EQ(&arena->alloc, buffer.lines->node_alloc);
+    EXPECT_EQ(&arena->alloc, buffer.lines->data_alloc);
+
+    /* the lines and nodes come from the arena. */
+    for (int i = 0; i < 10000; ++i)
+    {
+        line* l = (line*)allocator_allocate(buffer.allocator, sizeof(line));
+        ASSERT_NE(nullptr, l);
+        l->hdr.dispose = &line_disposer_mock;
+        l->val = i;
+        ASSERT_EQ(0, list_push_back(buffer.lines, (disposable_t*)l));
+    }
+
+    /* the whole buffer fits in a handful of chunks. */
+    EXPECT_LT(arena->chunk_count, 10U);
+
+    /* disposing the buffer doesn't walk the lines. */
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0, line_disposer_mock_count);
+}
+
+/**
+ * A buffer not in arena mode has no arena.
+ */
+TEST(buffer, no_arena)
+{
+    buffer_t buffer;
+
+    ASSERT_EQ(0, buffer_init(&buffer, allocator_system(), NULL, NULL, NULL));
+    EXPECT_EQ(nullptr, buffer.arena);
+    EXPECT_EQ(allocator_system(), buffer.allocator);
+    EXPECT_EQ(allocator_system(), buffer.lines->node_alloc);
+
+    dispose((disposable_t*)&buffer);
+}
+
+/**
+ * A buffer opened from a file views the mapped lines until they change.
+ */
+TEST(buffer, init_file)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+
+    std::string text;
+    for (int i = 0; i < 2000; ++i)
+        text += "a line of text which is long enough to spill " +
+                std::to_string(i) + "\n";
+    ASSERT_EQ((ssize_t)text.size(), write(fd, text.data(), text.size()));
+    close(fd);
+
+    heap_t heap;
+    buffer_t buffer;
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file(&buffer, &heap.alloc, path));
+    ASSERT_NE(nullptr, buffer.source);
+    EXPECT_TRUE(buffer.source->mapped);
+    EXPECT_EQ(2000U, buffer.lines->size);
+
+    /* every line is a view, so no line storage has been allocated. */
+    string_t* first = (string_t*)buffer.lines->head->data;
+    EXPECT_TRUE(string_is_view(first));
+    EXPECT_EQ(buffer.source->data, string_data(first));
+    EXPECT_EQ(0U, stats->tag_live_bytes[ALLOCATOR_TAG_STRING]);
+
+    /* changing a line copies only that line. */
+    ASSERT_EQ(0, string_append(first, "!", 1));
+    EXPECT_FALSE(string_is_view(first));
+    EXPECT_STREQ(
+        "a line of text which is long enough to spill 0!", string_data(first));
+    EXPECT_EQ(1U, stats->tag_live_count[ALLOCATOR_TAG_STRING]);
+    EXPECT_TRUE(string_is_view((string_t*)buffer.lines->tail->data));
+
+    /* disposing the buffer releases the lines, then the mapping. */
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, stats->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * A missing file can't be opened.
+ */
+TEST(buffer, init_file_missing)
+{
+    buffer_t buffer;
+
+    EXPECT_NE(
+        0,
+        buffer_init_file(
+            &buffer, allocator_system(), "/nonexistent/ej_buffer_file"));
+}
+
+/**
+ * \brief Write text to a new temporary file, whose path is returned in path.
+ */
+static bool write_temp_file(char* path, const std::string& text)
+{
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return false;
+
+    bool written =
+        (ssize_t)text.size() == write(fd, text.data(), text.size());
+    close(fd);
+
+    return written;
+}
+
+/**
+ * \brief Check that two buffers hold the same lines.
+ */
+static void expect_same_lines(const buffer_t* expected, const buffer_t* actual)
+{
+    ASSERT_EQ(expected->lines->size, actual->lines->size);
+
+    for (list_node_t *e = expected->lines->head, *a = actual->lines->head;
+         NULL != e; e = e->next, a = a->next)
+    {
+        const string_t* es = (const string_t*)e->data;
+        const string_t* as = (const string_t*)a->data;
+        ASSERT_EQ(
+            std::string(string_data(es), es->length),
+            std::string(string_data(as), as->length));
+    }
+}
+
+/**
+ * A file loaded in parallel has the same lines as one loaded serially.
+ */
+TEST(buffer, init_file_parallel)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 40000; ++i)
+        text += "line " + std::to_string(i) + (i % 7 ? "\n" : "\r\n");
+    text += "no trailing newline";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    buffer_t serial;
+    ASSERT_EQ(0, buffer_init_file(&serial, allocator_system(), path));
+    EXPECT_EQ(40001U, serial.lines->size);
+
+    for (size_t workers : {0U, 1U, 2U, 3U, 8U})
+    {
+        buffer_t buffer;
+        ASSERT_EQ(0, buffer_init_file_parallel(&buffer, path, workers));
+        ASSERT_NE(nullptr, buffer.arena);
+        ASSERT_NE(nullptr, buffer.source);
+        expect_same_lines(&serial, &buffer);
+
+        /* the worker arenas now belong to the buffer's arena. */
+        const allocator_stats_t* stats = allocator_stats(&buffer.arena->alloc);
+        EXPECT_EQ(40001U, stats->tag_live_count[ALLOCATOR_TAG_LIST_NODE]);
+        EXPECT_EQ(40001U, stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+
+        /* a changed line is copied into the buffer's arena. */
+        string_t* last = (string_t*)buffer.lines->tail->data;
+        EXPECT_TRUE(string_is_view(last));
+        const std::string tail(40, '!');
+        ASSERT_EQ(0, string_append(last, tail.data(), tail.size()));
+        EXPECT_EQ("no trailing newline" + tail, string_data(last));
+        EXPECT_EQ(1U, stats->tag_live_count[ALLOCATOR_TAG_STRING]);
+
+        dispose((disposable_t*)&buffer);
+    }
+
+    dispose((disposable_t*)&serial);
+    unlink(path);
+}
+
+/**
+ * Empty and invalid files are handled by a parallel load.
+ */
+TEST(buffer, init_file_parallel_edges)
+{
+    char empty[] = "/tmp/ej_buffer_XXXXXX";
+    char invalid[] = "/tmp/ej_buffer_XXXXXX";
+    buffer_t buffer;
+
+    ASSERT_TRUE(write_temp_file(empty, ""));
+    ASSERT_EQ(0, buffer_init_file_parallel(&buffer, empty, 4));
+    EXPECT_EQ(0U, buffer.lines->size);
+    dispose((disposable_t*)&buffer);
+
+    ASSERT_TRUE(write_temp_file(invalid, "valid\n\xff\n"));
+    EXPECT_NE(0, buffer_init_file_parallel(&buffer, invalid, 4));
+
+    /* each worker validates its own range, including the last. */
+    char large[] = "/tmp/ej_buffer_XXXXXX";
+    char large_invalid[] = "/tmp/ej_buffer_XXXXXX";
+    std::string text;
+    while (text.size() < 4U * BUFFER_PARALLEL_MIN_CHUNK)
+        text += "a valid line\n";
+    ASSERT_TRUE(write_temp_file(large, text + "\xc3\xa9\n"));
+    ASSERT_EQ(0, buffer_init_file_parallel(&buffer, large, 4));
+    dispose((disposable_t*)&buffer);
+    ASSERT_TRUE(write_temp_file(large_invalid, text + "\xff\n"));
+    EXPECT_NE(0, buffer_init_file_parallel(&buffer, large_invalid, 4));
+    unlink(large);
+    unlink(large_invalid);
+
+    EXPECT_NE(
+        0,
+        buffer_init_file_parallel(
+            &buffer, "/nonexistent/ej_buffer_file", 4));
+
+    unlink(empty);
+    unlink(invalid);
+}
+
+/**
+ * \brief Read the whole of a file.
+ */
+static std::string read_file(const char* path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream contents;
+    contents << in.rdbuf();
+
+    return contents.str();
+}
+
+/**
+ * A buffer is saved with a newline after each line.
+ */
+TEST(buffer, save)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    ASSERT_TRUE(write_temp_file(path, "old contents\n"));
+
+    buffer_t buffer;
+    ASSERT_EQ(0, buffer_init(&buffer, allocator_system(), NULL, NULL, NULL));
+
+    /* enough lines to need several batches, some of them long or empty. */
+    std::string expected;
+    for (size_t i = 0; i < 3 * BUFFER_SAVE_BATCH; ++i)
+    {
+        std::string text =
+            (i % 5) ? std::string(i % 97, 'a' + i % 26) : std::string();
+        string_t* str;
+        ASSERT_EQ(
+            0,
+            string_create(
+                &str, allocator_system(), text.data(), text.size()));
+        ASSERT_EQ(0, list_push_back(buffer.lines, (disposable_t*)str));
+        expected += text + "\n";
+    }
+
+    ASSERT_EQ(0, buffer_save(&buffer, path, 0U));
+    EXPECT_EQ(expected, read_file(path));
+
+    /* an atomic save keeps the file's permissions. */
+    ASSERT_EQ(0, chmod(path, 0640));
+    ASSERT_EQ(0, buffer_save(&buffer, path, BUFFER_SAVE_ATOMIC));
+    EXPECT_EQ(expected, read_file(path));
+
+    struct stat st;
+    ASSERT_EQ(0, stat(path, &st));
+    EXPECT_EQ(0640U, st.st_mode & 07777);
+
+    /* a missing directory fails either way. */
+    const char* missing = "/nonexistent/ej_buffer_file";
+    EXPECT_NE(0, buffer_save(&buffer, missing, 0U));
+    EXPECT_NE(0, buffer_save(&buffer, missing, BUFFER_SAVE_ATOMIC));
+
+    dispose((disposable_t*)&buffer);
+    unlink(path);
+}
+
+/**
+ * A buffer opened from a file can be saved over that file.
+ */
+TEST(buffer, save_file)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+        text += "line " + std::to_string(i) + (i % 3 ? "\n" : "\r\n");
+    text += "no trailing newline";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    buffer_t buffer;
+    ASSERT_EQ(0, buffer_init_file_parallel(&buffer, path, 2));
+
+    /* change a line in the middle. */
+    list_node_t* node = buffer.lines->head;
+    for (int i = 0; i < 2501; ++i)
+        node = node->next;
+    ASSERT_EQ(0, string_append((string_t*)node->data, " changed", 8));
+
+    /* the CRLF line endings are normalized, and the last line ended. */
+    std::string expected;
+    for (int i = 0; i < 5000; ++i)
+        expected +=
+            "line " + std::to_string(i) + (2501 == i ? " changed\n" : "\n");
+    expected += "no trailing newline\n";
+
+    ASSERT_EQ(0, buffer_save(&buffer, path, 0U));
+    EXPECT_EQ(expected, read_file(path));
+
+    /* the views of the replaced file are still readable. */
+    string_t* last = (string_t*)buffer.lines->tail->data;
+    EXPECT_EQ(
+        std::string("no trailing newline"),
+        std::string(string_data(last), last->length));
+
+    dispose((disposable_t*)&buffer);
+    unlink(path);
+}
+
+/**
+ * An unchanged CRLF file is saved byte for byte, however it was loaded, and
+ * changed lines are saved with CRLF too.
+ */
+TEST(buffer, save_crlf)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    char copy[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+        text += "line " + std::to_string(i) + "\r\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+    ASSERT_TRUE(write_temp_file(copy, ""));
+
+    buffer_t buffer;
+    list_node_t* node;
+
+    ASSERT_EQ(0, buffer_init_file(&buffer, allocator_system(), path));
+    EXPECT_TRUE(buffer.crlf);
+    ASSERT_EQ(0, buffer_save(&buffer, copy, 0U));
+    EXPECT_EQ(text, read_file(copy));
+
+    /* a changed line is ended the same way. */
+    ASSERT_EQ(0, buffer_line_at(&buffer, 2, &node));
+    ASSERT_EQ(0, string_append((string_t*)node->data, "!", 1));
+    ASSERT_EQ(0, buffer_save(&buffer, copy, 0U));
+    std::string expected = text;
+    expected.insert(expected.find("line 2\r\n") + 6, "!");
+    EXPECT_EQ(expected, read_file(copy));
+    dispose((disposable_t*)&buffer);
+
+    ASSERT_EQ(0, buffer_init_file_parallel(&buffer, path, 2));
+    EXPECT_TRUE(buffer.crlf);
+    ASSERT_EQ(0, buffer_save(&buffer, copy, 0U));
+    EXPECT_EQ(text, read_file(copy));
+    dispose((disposable_t*)&buffer);
+
+    /* a lazy load saves its regions and its parsed lines alike. */
+    ASSERT_EQ(
+        0, buffer_init_file_lazy(&buffer, allocator_system(), path, 4096));
+    EXPECT_TRUE(buffer.crlf);
+    ASSERT_EQ(0, buffer_save(&buffer, copy, 0U));
+    EXPECT_EQ(text, read_file(copy));
+    ASSERT_EQ(0, buffer_line_at(&buffer, 2000, &node));
+    ASSERT_EQ(0, buffer_save(&buffer, copy, 0U));
+    EXPECT_EQ(text, read_file(copy));
+    dispose((disposable_t*)&buffer);
+
+    unlink(path);
+    unlink(copy);
+}
+
+/**
+ * \brief Get the text of the line at the given node.
+ */
+static std::string line_text(const list_node_t* node)
+{
+    const string_t* str = (const string_t*)node->data;
+
+    return std::string(string_data(str), str->length);
+}
+
+/**
+ * A lazily loaded file only parses the regions that are used.
+ */
+TEST(buffer, init_file_lazy)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 50000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    text += "no trailing newline";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    heap_t heap;
+    buffer_t buffer;
+    list_node_t* node;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file_lazy(&buffer, &heap.alloc, path, 16384));
+    ASSERT_NE(nullptr, buffer.index);
+
+    /* the file is only split into regions. */
+    size_t regions = buffer.lines->size;
+    EXPECT_GE(regions, text.size() / 16384);
+    EXPECT_LE(regions, text.size() / 16384 + 1U);
+    for (node = buffer.lines->head; NULL != node; node = node->next)
+        ASSERT_TRUE(buffer_is_region(node->data));
+
+    /* jumping to the last line parses only the last region. */
+    ASSERT_EQ(0, buffer_line_at(&buffer, 50000, &node));
+    EXPECT_EQ("no trailing newline", line_text(node));
+    EXPECT_EQ(buffer.lines->tail, node);
+    EXPECT_LT(buffer.lines->size, regions + 2000U);
+    EXPECT_TRUE(buffer_is_region(buffer.lines->head->data));
+    EXPECT_NE(0, buffer_line_at(&buffer, 50001, &node));
+
+    /* any line can be reached, and changed. */
+    for (size_t i : {0U, 1U, 12345U, 25000U, 49999U})
+    {
+        ASSERT_EQ(0, buffer_line_at(&buffer, i, &node));
+        EXPECT_EQ("line " + std::to_string(i), line_text(node));
+    }
+
+    ASSERT_EQ(0, buffer_line_at(&buffer, 25000, &node));
+    ASSERT_EQ(0, string_append((string_t*)node->data, " changed", 8));
+
+    /* regions are saved as they are, and lines as they have become. */
+    size_t changed = text.find("line 25000\n") + 10;
+    std::string expected =
+        text.substr(0, changed) + " changed" + text.substr(changed) + "\n";
+    ASSERT_EQ(0, buffer_save(&buffer, path, 0U));
+    EXPECT_EQ(expected, read_file(path));
+    EXPECT_LT(buffer.lines->size, 50001U);
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * A lazily loaded region is only validated when it is parsed.
+ */
+TEST(buffer, init_file_lazy_invalid)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text(1000, 'a');
+    text += "\n\xff" + std::string(999, 'c') + "\n";
+    text += std::string(1000, 'b') + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    buffer_t buffer;
+    list_node_t* node;
+
+    ASSERT_EQ(
+        0, buffer_init_file_lazy(&buffer, allocator_system(), path, 1000));
+    EXPECT_EQ(3U, buffer.lines->size);
+
+    /* the regions around the invalid one can be used. */
+    ASSERT_EQ(0, buffer_line_at(&buffer, 0, &node));
+    EXPECT_EQ(std::string(1000, 'a'), line_text(node));
+    ASSERT_EQ(0, buffer_line_at(&buffer, 2, &node));
+    EXPECT_EQ(std::string(1000, 'b'), line_text(node));
+
+    /* the invalid region stays a region. */
+    EXPECT_NE(0, buffer_line_at(&buffer, 1, &node));
+    EXPECT_TRUE(buffer_is_region(buffer.lines->head->next->data));
+
+    dispose((disposable_t*)&buffer);
+    unlink(path);
+}
+
+/**
+ * \brief Get the text of every line of a buffer, each followed by a newline.
+ */
+static std::string buffer_text(const buffer_t* buffer)
+{
+    std::string text;
+    if (NULL != buffer->chunks)
+    {
+        for (const ulist_chunk_t* chunk = buffer->chunks->head;
+             NULL != chunk; chunk = chunk->next)
+        {
+            for (size_t i = 0U; i < chunk->count; ++i)
+            {
+                const string_t* str = (const string_t*)chunk->data[i];
+                text += std::string(string_data(str), str->length) + "\n";
+            }
+        }
+
+        return text;
+    }
+
+    for (const list_node_t* node = buffer->lines->head; NULL != node;
+         node = node->next)
+    {
+        text += line_text(node) + "\n";
+    }
+
+    return text;
+}
+
+/**
+ * \brief Replace lines of a buffer with the given text.
+ */
+static int replace_lines(
+    buffer_t* buffer, size_t line, size_t count,
+    const std::vector<std::string>& text)
+{
+    std::vector<command_line_t> lines;
+    for (const std::string& s : text)
+        lines.push_back(command_line_t{s.data(), s.size()});
+
+    return buffer_replace(buffer, line, count, lines.data(), lines.size());
+}
+
+/**
+ * Replacing lines records commands which undo the changes in turn.
+ */
+TEST(buffer, replace_undo)
+{
+    heap_t heap;
+    buffer_t buffer;
+
+    /* the buffer owns its command stack. */
+    ASSERT_EQ(0, heap_init(&heap));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    ASSERT_EQ(0, buffer_init(&buffer, &heap.alloc, NULL, &stack->stack, NULL));
+
+    /* insert, append, replace, and delete. */
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 0, {"a", "b", "c"}));
+    EXPECT_EQ("a\nb\nc\n", buffer_text(&buffer));
+    ASSERT_EQ(0, replace_lines(&buffer, 3, 0, {"d"}));
+    EXPECT_EQ("a\nb\nc\nd\n", buffer_text(&buffer));
+    ASSERT_EQ(0, replace_lines(&buffer, 1, 2, {"x", "y", "z"}));
+    EXPECT_EQ("a\nx\ny\nz\nd\n", buffer_text(&buffer));
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 2, {}));
+    EXPECT_EQ("y\nz\nd\n", buffer_text(&buffer));
+    EXPECT_EQ(4U, stack->stack.count);
+
+    /* a change which can't be made changes nothing. */
+    EXPECT_NE(0, replace_lines(&buffer, 4, 0, {"e"}));
+    EXPECT_NE(0, replace_lines(&buffer, 2, 2, {"e"}));
+    EXPECT_NE(0, replace_lines(&buffer, 0, 0, {"\xff"}));
+    EXPECT_EQ("y\nz\nd\n", buffer_text(&buffer));
+    EXPECT_EQ(4U, stack->stack.count);
+
+    /* undo each change in turn. */
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ("a\nx\ny\nz\nd\n", buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ("a\nb\nc\nd\n", buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ("a\nb\nc\n", buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ("", buffer_text(&buffer));
+    EXPECT_NE(0, buffer_undo(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * Typing into a buffer is undone a run of keystrokes at a time.
+ */
+TEST(buffer, replace_undo_coalesce)
+{
+    heap_t heap;
+    buffer_t buffer;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    command_stack_coalesce(&stack->stack, 60000, 4096);
+    ASSERT_EQ(0, buffer_init(&buffer, &heap.alloc, NULL, &stack->stack, NULL));
+
+    /* type two lines, and then edit the first. */
+    std::string line;
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 0, {""}));
+    for (char c : std::string("first"))
+    {
+        ASSERT_EQ(0, replace_lines(&buffer, 0, 1, {line + c}));
+        line += c;
+    }
+    ASSERT_EQ(0, replace_lines(&buffer, 1, 0, {"second"}));
+    EXPECT_EQ(1U, stack->stack.count);
+
+    command_stack_seal(&stack->stack);
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 1, {"1st"}));
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 1, {"1st!"}));
+    EXPECT_EQ("1st!\nsecond\n", buffer_text(&buffer));
+    EXPECT_EQ(2U, stack->stack.count);
+
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ("first\nsecond\n", buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ("", buffer_text(&buffer));
+    EXPECT_NE(0, buffer_undo(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A buffer given the system allocator records its lines, nodes, and commands,
+ * and the bytes its deltas save, in the statistics of the system allocator.
+ */
+TEST(buffer, default_stats)
+{
+    buffer_t buffer;
+    const allocator_stats_t* stats = allocator_stats(allocator_system());
+
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)malloc(sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, allocator_system()));
+    ASSERT_EQ(
+        0,
+        buffer_init(&buffer, allocator_system(), NULL, &stack->stack, NULL));
+    allocator_stats_t before = *stats;
+
+    std::vector<std::string> lines, changed;
+    for (int i = 0; i < 10; ++i)
+    {
+        lines.push_back(std::to_string(i) + std::string(200, 'a'));
+        changed.push_back(lines.back());
+        changed.back()[100] = 'b';
+    }
+
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 0, lines));
+    EXPECT_EQ(
+        before.tag_live_count[ALLOCATOR_TAG_LIST_NODE] + 10U,
+        stats->tag_live_count[ALLOCATOR_TAG_LIST_NODE]);
+    EXPECT_EQ(
+        before.tag_live_count[ALLOCATOR_TAG_LIST_DATA] + 10U,
+        stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+    EXPECT_GE(
+        stats->tag_live_bytes[ALLOCATOR_TAG_STRING],
+        before.tag_live_bytes[ALLOCATOR_TAG_STRING] + 10U * 200U);
+    EXPECT_GT(
+        stats->tag_live_count[ALLOCATOR_TAG_COMMAND],
+        before.tag_live_count[ALLOCATOR_TAG_COMMAND]);
+
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 10, changed));
+    EXPECT_GT(stats->saved_bytes, before.saved_bytes + 10U * 100U);
+
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ(
+        before.tag_live_count[ALLOCATOR_TAG_LIST_DATA],
+        stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+
+    dispose((disposable_t*)&buffer);
+}
+
+/**
+ * A substitution over many long lines is recorded as a delta per line.
+ */
+TEST(buffer, replace_undo_delta)
+{
+    heap_t heap;
+    buffer_t buffer;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    ASSERT_EQ(0, buffer_init(&buffer, &heap.alloc, NULL, &stack->stack, NULL));
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+
+    std::vector<std::string> lines, changed;
+    for (int i = 0; i < 1000; ++i)
+    {
+        lines.push_back(std::to_string(i) + std::string(2000, 'a'));
+        changed.push_back(lines.back());
+        changed.back()[changed.back().size() - 1000] = 'b';
+    }
+
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 0, lines));
+    std::string text = buffer_text(&buffer);
+    size_t saved = stats->saved_bytes;
+
+    /* s/a/b/ on every line costs a few bytes of undo per line. */
+    size_t command_bytes = stats->tag_live_bytes[ALLOCATOR_TAG_COMMAND];
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 1000, changed));
+    const command_t* cmd = command_stack_peek(&stack->stack);
+    ASSERT_NE(nullptr, cmd);
+    EXPECT_EQ(COMMAND_TYPE_DELTA, cmd->type);
+    EXPECT_LT(
+        stats->tag_live_bytes[ALLOCATOR_TAG_COMMAND] - command_bytes,
+        20U * 1000U);
+    EXPECT_GT(stats->saved_bytes - saved, 4000U * 1000U - 20U * 1000U);
+
+    std::string expected;
+    for (const std::string& line : changed)
+        expected += line + "\n";
+    EXPECT_EQ(expected, buffer_text(&buffer));
+
+    /* undo puts back the original bytes. */
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ(text, buffer_text(&buffer));
+
+    /* a delta only applies to the lines it was made for. */
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 1, {changed[0]}));
+    cmd = command_stack_peek(&stack->stack);
+    ASSERT_NE(nullptr, cmd);
+    ASSERT_EQ(COMMAND_TYPE_DELTA, cmd->type);
+    EXPECT_NE(0, buffer_apply(&buffer, cmd, false));
+    ASSERT_EQ(0, buffer_apply(&buffer, cmd, true));
+    EXPECT_EQ(text, buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_apply(&buffer, cmd, false));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ(text, buffer_text(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, stats->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * The changes to a lazily loaded buffer can be logged to a file and undone.
+ */
+TEST(buffer, replace_undo_log)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    char log_path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 20000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+    ASSERT_TRUE(write_temp_file(log_path, ""));
+
+    heap_t heap;
+    buffer_t buffer;
+    list_node_t* node;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file_lazy(&buffer, &heap.alloc, path, 4096));
+    command_log_t* log =
+        (command_log_t*)allocator_allocate(&heap.alloc, sizeof(command_log_t));
+    ASSERT_NE(nullptr, log);
+    ASSERT_EQ(0, command_log_init(log, log_path));
+    buffer.undo_commands = &log->stack;
+
+    /* change every tenth line, parsing only the regions that hold them. */
+    for (size_t i = 0U; i < 20000U; i += 10U)
+    {
+        ASSERT_EQ(
+            0, replace_lines(&buffer, i, 1, {"changed " + std::to_string(i)}));
+    }
+
+    /* delete lines across the boundaries of regions. */
+    ASSERT_EQ(0, replace_lines(&buffer, 100, 5000, {}));
+    ASSERT_EQ(0, buffer_line_at(&buffer, 100, &node));
+    EXPECT_EQ("changed 5100", line_text(node));
+    EXPECT_GT(log->write_count, 0U);
+
+    /* undoing every change restores the file. */
+    while (0U != log->stack.count)
+        ASSERT_EQ(0, buffer_undo(&buffer));
+    ASSERT_EQ(0, buffer_save(&buffer, path, 0U));
+    EXPECT_EQ(text, read_file(path));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+    unlink(log_path);
+}
+
+/**
+ * \brief Make the k-th of a series of edits within the first lines lines of
+ * a buffer, which change, insert, and delete lines in turn.
+ */
+static int edit_lines(buffer_t* buffer, size_t k, size_t lines)
+{
+    size_t line = (k * 7919U) % lines;
+    std::string text = "edit " + std::to_string(k);
+
+    switch (k % 3U)
+    {
+        case 0U:
+            return replace_lines(buffer, line, 1, {text});
+        case 1U:
+            return replace_lines(buffer, line, 0, {text, text + "!"});
+        default:
+            return replace_lines(buffer, line, 1, {});
+    }
+}
+
+/**
+ * Jumping through history restores the nearest checkpoint, and replays only
+ * the commands after it.
+ */
+TEST(buffer, history_undo_to)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    heap_t heap;
+    buffer_t buffer;
+    std::vector<std::string> snapshots;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file(&buffer, &heap.alloc, path));
+    EXPECT_NE(0, buffer_history_init(&buffer, 50));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    buffer.undo_commands = &stack->stack;
+    ASSERT_EQ(0, buffer_history_init(&buffer, 50));
+    EXPECT_NE(0, buffer_history_init(&buffer, 50));
+    buffer_history_t* history = buffer.history;
+    EXPECT_EQ(1U, history->checkpoint_count);
+    EXPECT_EQ(0U, history->copied_bytes);
+
+    /* edit the start of the file, keeping its text after each edit. */
+    snapshots.push_back(buffer_text(&buffer));
+    for (size_t k = 0U; k < 1000U; ++k)
+    {
+        ASSERT_EQ(0, edit_lines(&buffer, k, 200));
+        snapshots.push_back(buffer_text(&buffer));
+    }
+
+    EXPECT_EQ(21U, history->checkpoint_count);
+    EXPECT_GT(history->copied_bytes, 0U);
+
+    /* the unchanged rest of the file is shared between checkpoints. */
+    EXPECT_GT(history->shared_count, history->chunk_count);
+
+    /* a jump restores the checkpoint at 750, and replays 27 commands. */
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 777));
+    EXPECT_EQ(snapshots[777], buffer_text(&buffer));
+    EXPECT_EQ(777U, stack->stack.count);
+    EXPECT_EQ(27U, history->replay_count);
+    EXPECT_EQ(16U, history->checkpoint_count);
+
+    /* a short step is undone a command at a time. */
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 770));
+    EXPECT_EQ(snapshots[770], buffer_text(&buffer));
+    EXPECT_EQ(27U, history->replay_count);
+
+    /* editing carries on from there. */
+    ASSERT_EQ(0, edit_lines(&buffer, 770, 200));
+    EXPECT_EQ(snapshots[771], buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ(snapshots[770], buffer_text(&buffer));
+
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 123));
+    EXPECT_EQ(snapshots[123], buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 0));
+    EXPECT_EQ(text, buffer_text(&buffer));
+    EXPECT_EQ(1U, history->checkpoint_count);
+    EXPECT_NE(0, buffer_undo_to(&buffer, 1));
+
+    /* the file saved from the restored views is the original. */
+    ASSERT_EQ(0, buffer_save(&buffer, path, 0U));
+    EXPECT_EQ(text, read_file(path));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * \brief Get the text of a long line written by the k-th edit.
+ */
+static std::string long_line(size_t k)
+{
+    return std::string(8192U, (char)('a' + k % 26U)) + std::to_string(k);
+}
+
+/**
+ * \brief Get the text of a buffer of 200 lines after the first depth edits,
+ * the k-th of which replaced line k with long_line(k).
+ */
+static std::string long_lines_text(size_t depth)
+{
+    std::string text;
+    for (size_t i = 0U; i < 200U; ++i)
+    {
+        text += (i < depth) ? long_line(i) : "line " + std::to_string(i);
+        text += "\n";
+    }
+
+    return text;
+}
+
+/**
+ * Once dropped checkpoints hold most of the history's arena, the rest are
+ * compacted into a new one, and the lines which viewed the old arena view
+ * their copies in the new one.
+ */
+TEST(buffer, history_compact)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    ASSERT_TRUE(write_temp_file(path, long_lines_text(0)));
+
+    heap_t heap;
+    buffer_t buffer;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file(&buffer, &heap.alloc, path));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    buffer.undo_commands = &stack->stack;
+    ASSERT_EQ(0, buffer_history_init(&buffer, 10));
+    buffer_history_t* history = buffer.history;
+
+    for (size_t k = 0U; k < 200U; ++k)
+        ASSERT_EQ(0, replace_lines(&buffer, k, 1, {long_line(k)}));
+    EXPECT_EQ(21U, history->checkpoint_count);
+    const allocator_stats_t* stats = allocator_stats(&history->arena.alloc);
+    size_t grown = stats->live_bytes;
+
+    /* undoing a change at a time drops checkpoints whose copies the lines
+     * still view, until the history is compacted and those are copied too. */
+    for (size_t depth = 199U; depth >= 50U; --depth)
+    {
+        ASSERT_EQ(0, buffer_undo(&buffer));
+        ASSERT_TRUE(long_lines_text(depth) == buffer_text(&buffer));
+    }
+
+    EXPECT_EQ(1U, history->compact_count);
+    EXPECT_EQ(6U, history->checkpoint_count);
+    EXPECT_LT(history->dropped_bytes, BUFFER_HISTORY_ARENA_CHUNK);
+    EXPECT_LT(stats->live_bytes, grown);
+
+    /* the compacted checkpoints still restore the buffer. */
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 22));
+    EXPECT_TRUE(long_lines_text(22) == buffer_text(&buffer));
+    for (size_t k = 22U; k < 40U; ++k)
+        ASSERT_EQ(0, replace_lines(&buffer, k, 1, {long_line(k)}));
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 5));
+    EXPECT_TRUE(long_lines_text(5) == buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 0));
+    EXPECT_TRUE(long_lines_text(0) == buffer_text(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * \brief Check that every line of a buffer is found at its own node.
+ */
+static bool lines_found(buffer_t* buffer)
+{
+    size_t index = 0U;
+    list_node_t* found;
+
+    for (list_node_t* node = buffer->lines->head; NULL != node;
+         node = node->next, ++index)
+    {
+        if (0 != buffer_line_at(buffer, index, &found) || node != found)
+            return false;
+    }
+
+    return 0 != buffer_line_at(buffer, index, &found);
+}
+
+/**
+ * A buffer indexed by a tree finds its lines through edits, undo, and jumps
+ * through history.
+ */
+TEST(buffer, tree)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 2000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    heap_t heap;
+    buffer_t buffer;
+    std::vector<std::string> snapshots;
+
+    /* a lazily loaded buffer can't be indexed. */
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file_lazy(&buffer, &heap.alloc, path, 1000));
+    EXPECT_NE(0, buffer_tree_init(&buffer));
+    dispose((disposable_t*)&buffer);
+
+    ASSERT_EQ(0, buffer_init_file(&buffer, &heap.alloc, path));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    buffer.undo_commands = &stack->stack;
+    ASSERT_EQ(0, buffer_tree_init(&buffer));
+    ASSERT_EQ(0, buffer_tree_init(&buffer));
+    ASSERT_NE(nullptr, buffer.tree);
+    EXPECT_EQ(2000U, ostree_size(buffer.tree));
+    EXPECT_TRUE(lines_found(&buffer));
+
+    /* the tree follows each change. */
+    ASSERT_EQ(0, buffer_history_init(&buffer, 20));
+    snapshots.push_back(buffer_text(&buffer));
+    for (size_t k = 0U; k < 150U; ++k)
+    {
+        ASSERT_EQ(0, edit_lines(&buffer, k, 1990));
+        snapshots.push_back(buffer_text(&buffer));
+    }
+    ASSERT_EQ(0, replace_lines(&buffer, 5, 100, {"a", "b"}));
+    EXPECT_EQ(buffer.lines->size, ostree_size(buffer.tree));
+    EXPECT_TRUE(lines_found(&buffer));
+
+    /* and each change taken back, or restored from a checkpoint. */
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ(snapshots[150], buffer_text(&buffer));
+    EXPECT_TRUE(lines_found(&buffer));
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 42));
+    EXPECT_EQ(snapshots[42], buffer_text(&buffer));
+    EXPECT_GT(buffer.history->replay_count, 0U);
+    EXPECT_EQ(buffer.lines->size, ostree_size(buffer.tree));
+    EXPECT_TRUE(lines_found(&buffer));
+
+    /* unrolling the buffer releases the tree. */
+    ASSERT_EQ(0, buffer_unroll(&buffer));
+    EXPECT_EQ(nullptr, buffer.tree);
+    EXPECT_NE(0, buffer_tree_init(&buffer));
+    EXPECT_EQ(snapshots[42], buffer_text(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * A buffer whose lines are moved into an unrolled list is still edited,
+ * checkpointed, and saved as before.
+ */
+TEST(buffer, unroll)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 1000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+
+    heap_t heap;
+    buffer_t buffer;
+    list_node_t* node;
+    std::vector<std::string> snapshots;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file(&buffer, &heap.alloc, path));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    buffer.undo_commands = &stack->stack;
+
+    /* the lines are moved, and there are no nodes to find. */
+    ASSERT_EQ(0, buffer_unroll(&buffer));
+    ASSERT_EQ(0, buffer_unroll(&buffer));
+    EXPECT_EQ(nullptr, buffer.lines);
+    ASSERT_NE(nullptr, buffer.chunks);
+    EXPECT_EQ(1000U, buffer.chunks->size);
+    EXPECT_EQ(text, buffer_text(&buffer));
+    EXPECT_NE(0, buffer_line_at(&buffer, 0, &node));
+
+    /* replace, insert, and delete lines around the chunks. */
+    ASSERT_EQ(0, buffer_history_init(&buffer, 10));
+    snapshots.push_back(buffer_text(&buffer));
+    for (size_t k = 0U; k < 100U; ++k)
+    {
+        ASSERT_EQ(0, edit_lines(&buffer, 7U * k, 990));
+        snapshots.push_back(buffer_text(&buffer));
+    }
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 0, {"first"}));
+    snapshots.push_back(buffer_text(&buffer));
+    EXPECT_EQ("first\n", snapshots.back().substr(0, 6));
+    EXPECT_NE(0, replace_lines(&buffer, 2000, 0, {"x"}));
+    EXPECT_EQ(snapshots.back(), buffer_text(&buffer));
+
+    /* undo, and jump through the checkpoints. */
+    ASSERT_EQ(0, buffer_undo(&buffer));
+    EXPECT_EQ(snapshots[100], buffer_text(&buffer));
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 55));
+    EXPECT_EQ(snapshots[55], buffer_text(&buffer));
+    EXPECT_GT(buffer.history->replay_count, 0U);
+
+    /* the saved file holds the unrolled lines. */
+    ASSERT_EQ(0, buffer_save(&buffer, path, 0U));
+    EXPECT_EQ(snapshots[55], read_file(path));
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 0));
+    EXPECT_EQ(text, buffer_text(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * The checkpoints of a lazily loaded file keep the regions which have not
+ * been parsed, and a command log can be replayed from a checkpoint.
+ */
+TEST(buffer, history_lazy_log)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    char log_path[] = "/tmp/ej_buffer_XXXXXX";
+    char save_path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 20000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+    ASSERT_TRUE(write_temp_file(log_path, ""));
+    ASSERT_TRUE(write_temp_file(save_path, ""));
+
+    heap_t heap;
+    buffer_t buffer;
+    std::string middle;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file_lazy(&buffer, &heap.alloc, path, 4096));
+    command_log_t* log =
+        (command_log_t*)allocator_allocate(&heap.alloc, sizeof(command_log_t));
+    ASSERT_NE(nullptr, log);
+    ASSERT_EQ(0, command_log_init(log, log_path));
+    buffer.undo_commands = &log->stack;
+    ASSERT_EQ(0, buffer_history_init(&buffer, 32));
+
+    /* edit lines all over the file, parsing the regions that hold them. */
+    for (size_t k = 0U; k < 1500U; ++k)
+    {
+        ASSERT_EQ(0, edit_lines(&buffer, k, 19000));
+        if (750U == k)
+        {
+            ASSERT_EQ(0, buffer_save(&buffer, save_path, 0U));
+            middle = read_file(save_path);
+        }
+    }
+
+    EXPECT_GT(log->write_count, 0U);
+
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 751));
+    EXPECT_GT(buffer.history->replay_count, 0U);
+    ASSERT_EQ(0, buffer_save(&buffer, save_path, 0U));
+    EXPECT_EQ(middle, read_file(save_path));
+
+    /* the first checkpoint puts back the regions. */
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 0));
+    ASSERT_EQ(0, buffer_save(&buffer, save_path, 0U));
+    EXPECT_EQ(text, read_file(save_path));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+    unlink(log_path);
+    unlink(save_path);
+}
+
+/**
+ * \brief Get the time now, in milliseconds since the epoch.
+ */
+static uint64_t now_ms()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (uint64_t)now.tv_sec * 1000U + (uint64_t)now.tv_nsec / 1000000U;
+}
+
+/**
+ * Undoing the changes made after a time returns the buffer to how it was
+ * then.
+ */
+TEST(buffer, history_undo_until)
+{
+    heap_t heap;
+    buffer_t buffer;
+    std::vector<std::string> snapshots;
+    std::vector<uint64_t> times;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    command_mem_stack_t* stack =
+        (command_mem_stack_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_mem_stack_t));
+    ASSERT_NE(nullptr, stack);
+    ASSERT_EQ(0, command_mem_stack_init(stack, &heap.alloc));
+    ASSERT_EQ(0, buffer_init(&buffer, &heap.alloc, NULL, &stack->stack, NULL));
+    ASSERT_EQ(0, replace_lines(&buffer, 0, 0, {"a", "b", "c", "d"}));
+    ASSERT_EQ(0, buffer_history_init(&buffer, 4));
+
+    /* each edit is made a few milliseconds after the time before it. */
+    snapshots.push_back(buffer_text(&buffer));
+    times.push_back(now_ms());
+    for (size_t k = 0U; k < 30U; ++k)
+    {
+        usleep(3000);
+        ASSERT_EQ(0, edit_lines(&buffer, k, 4));
+        snapshots.push_back(buffer_text(&buffer));
+        times.push_back(now_ms());
+    }
+
+    ASSERT_EQ(0, buffer_undo_until(&buffer, times[23]));
+    EXPECT_EQ(24U, stack->stack.count);
+    EXPECT_EQ(snapshots[23], buffer_text(&buffer));
+
+    ASSERT_EQ(0, buffer_undo_until(&buffer, times[6]));
+    EXPECT_EQ(7U, stack->stack.count);
+    EXPECT_EQ(snapshots[6], buffer_text(&buffer));
+    EXPECT_GT(buffer.history->replay_count, 0U);
+
+    /* before the first checkpoint, the changes are undone one at a time. */
+    ASSERT_EQ(0, buffer_undo_until(&buffer, 0U));
+    EXPECT_EQ(0U, stack->stack.count);
+    EXPECT_EQ("", buffer_text(&buffer));
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A buffer's undo history can spill to disk, and still be undone and jumped
+ * through.
+ */
+TEST(buffer, replace_undo_tiered)
+{
+    char path[] = "/tmp/ej_buffer_XXXXXX";
+    char spill_path[] = "/tmp/ej_buffer_XXXXXX";
+
+    std::string text;
+    for (int i = 0; i < 2000; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_TRUE(write_temp_file(path, text));
+    ASSERT_TRUE(write_temp_file(spill_path, ""));
+
+    heap_t heap;
+    buffer_t buffer;
+    std::vector<std::string> snapshots;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init_file(&buffer, &heap.alloc, path));
+    command_tiered_t* tiered =
+        (command_tiered_t*)allocator_allocate(
+            &heap.alloc, sizeof(command_tiered_t));
+    ASSERT_NE(nullptr, tiered);
+    ASSERT_EQ(
+        0, command_tiered_init(tiered, &heap.alloc, spill_path, 16 * 1024));
+    buffer.undo_commands = &tiered->stack;
+    ASSERT_EQ(0, buffer_history_init(&buffer, 100));
+
+    snapshots.push_back(buffer_text(&buffer));
+    for (size_t k = 0U; k < 1000U; ++k)
+    {
+        ASSERT_EQ(0, edit_lines(&buffer, k, 1500));
+        snapshots.push_back(buffer_text(&buffer));
+        EXPECT_LE(tiered->hot_bytes, 16U * 1024U);
+    }
+
+    EXPECT_GT(tiered->spill_count, 0U);
+    EXPECT_GT(tiered->block_count, 0U);
+
+    /* a jump replays cold commands from their blocks. */
+    ASSERT_EQ(0, buffer_undo_to(&buffer, 345));
+    EXPECT_EQ(snapshots[345], buffer_text(&buffer));
+    EXPECT_GT(tiered->reload_count, 0U);
+
+    /* undoing reloads the blocks in turn. */
+    while (0U != tiered->stack.count)
+    {
+        ASSERT_EQ(0, buffer_undo(&buffer));
+        EXPECT_EQ(snapshots[tiered->stack.count], buffer_text(&buffer));
+    }
+    EXPECT_EQ(text, buffer_text(&buffer));
+    EXPECT_EQ(0U, tiered->block_count);
+
+    dispose((disposable_t*)&buffer);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+static void line_disposer_mock(disposable_t*)
+{
+    ++line_disposer_mock_count;
+}
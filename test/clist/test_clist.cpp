@@ -0,0 +1,295 @@
+/**
+ * \brief Unit tests for the circular list container.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/clist.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+struct foo
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static foo* foo_create(int val);
+static void foo_disposer_mock(disposable_t* disp);
+static int foo_disposer_mock_count;
+static std::vector<int> clist_values(clist_t* list);
+
+/**
+ * A circular list can be initialized as an empty ring.
+ */
+TEST(clist, init)
+{
+    clist_t list;
+
+    memset(&list, 0xFE, sizeof(list));
+
+    /* initialize the list. */
+    ASSERT_EQ(0, clist_init(&list));
+
+    /* the sentinel points to itself. */
+    EXPECT_TRUE(PROP_VALID_CLIST_EMPTY(&list));
+    EXPECT_EQ(clist_end(&list), clist_begin(&list));
+    EXPECT_EQ(nullptr, list.sentinel.data);
+    EXPECT_EQ(allocator_system(), list.node_alloc);
+    EXPECT_EQ(allocator_system(), list.data_alloc);
+
+    /* the list can be disposed. */
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * Values can be pushed and popped from either end.
+ */
+TEST(clist, push_pop)
+{
+    clist_t list;
+    disposable_t* data;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, clist_init(&list));
+
+    /* popping an empty list fails. */
+    EXPECT_NE(0, clist_pop_front(&list, &data));
+    EXPECT_EQ(nullptr, data);
+    EXPECT_NE(0, clist_pop_back(&list, &data));
+    EXPECT_EQ(nullptr, data);
+
+    ASSERT_EQ(0, clist_push_back(&list, (disposable_t*)foo_create(2)));
+    ASSERT_EQ(0, clist_push_front(&list, (disposable_t*)foo_create(1)));
+    ASSERT_EQ(0, clist_push_back(&list, (disposable_t*)foo_create(3)));
+
+    EXPECT_TRUE(PROP_VALID_CLIST_NOT_EMPTY(&list));
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), clist_values(&list));
+
+    ASSERT_EQ(0, clist_pop_front(&list, &data));
+    EXPECT_EQ(1, ((foo*)data)->val);
+    free(data);
+
+    ASSERT_EQ(0, clist_pop_back(&list, &data));
+    EXPECT_EQ(3, ((foo*)data)->val);
+    free(data);
+
+    ASSERT_EQ(0, clist_pop_back(&list, &data));
+    EXPECT_EQ(2, ((foo*)data)->val);
+    free(data);
+
+    /* the list is an empty ring again. */
+    EXPECT_TRUE(PROP_VALID_CLIST_EMPTY(&list));
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * insert and append work anywhere in the ring, including at the sentinel.
+ */
+TEST(clist, insert_append)
+{
+    clist_t list;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, clist_init(&list));
+
+    /* inserting before the end appends to the back. */
+    ASSERT_EQ(
+        0, clist_insert(&list, clist_end(&list), (disposable_t*)foo_create(3)));
+
+    /* appending after the end pushes to the front. */
+    ASSERT_EQ(
+        0, clist_append(&list, clist_end(&list), (disposable_t*)foo_create(0)));
+    EXPECT_EQ(std::vector<int>({0, 3}), clist_values(&list));
+
+    /* insert and append in the middle. */
+    list_node_t* three = clist_begin(&list)->next;
+    ASSERT_EQ(0, clist_insert(&list, three, (disposable_t*)foo_create(2)));
+    ASSERT_EQ(
+        0,
+        clist_append(
+            &list, clist_begin(&list), (disposable_t*)foo_create(1)));
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), clist_values(&list));
+
+    /* every value is disposed with the list. */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(4, foo_disposer_mock_count);
+}
+
+/**
+ * Nodes can be removed from the front, middle, and back.
+ */
+TEST(clist, remove)
+{
+    clist_t list;
+    disposable_t* data;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, clist_init(&list));
+
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ(0, clist_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* remove the middle. */
+    ASSERT_EQ(0, clist_remove(&list, clist_begin(&list)->next->next, &data));
+    EXPECT_EQ(2, ((foo*)data)->val);
+    free(data);
+
+    /* remove the front. */
+    ASSERT_EQ(0, clist_remove(&list, clist_begin(&list), &data));
+    EXPECT_EQ(0, ((foo*)data)->val);
+    free(data);
+
+    /* remove the back. */
+    ASSERT_EQ(0, clist_remove(&list, clist_end(&list)->prev, &data));
+    EXPECT_EQ(4, ((foo*)data)->val);
+    free(data);
+
+    EXPECT_EQ(std::vector<int>({1, 3}), clist_values(&list));
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * Splicing moves the whole y ring into x.
+ */
+TEST(clist, splice)
+{
+    clist_t x, y;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, clist_init(&x));
+    ASSERT_EQ(0, clist_init(&y));
+
+    /* splicing empty lists is a no-op. */
+    clist_splice(&x, &y);
+    EXPECT_TRUE(PROP_VALID_CLIST_EMPTY(&x));
+
+    for (int i = 0; i < 3; ++i)
+        ASSERT_EQ(0, clist_push_back(&y, (disposable_t*)foo_create(i)));
+
+    /* splice into an empty list. */
+    clist_splice(&x, &y);
+    EXPECT_EQ(std::vector<int>({0, 1, 2}), clist_values(&x));
+    EXPECT_TRUE(PROP_VALID_CLIST_EMPTY(&y));
+
+    for (int i = 3; i < 5; ++i)
+        ASSERT_EQ(0, clist_push_back(&y, (disposable_t*)foo_create(i)));
+
+    /* splice into a non-empty list. */
+    clist_splice(&x, &y);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), clist_values(&x));
+    EXPECT_TRUE(PROP_VALID_CLIST_EMPTY(&y));
+
+    dispose((disposable_t*)&x);
+    dispose((disposable_t*)&y);
+}
+
+/**
+ * Splitting counts from the nearer end and closes both rings.
+ */
+TEST(clist, split)
+{
+    for (int at = 0; at <= 7; ++at)
+    {
+        clist_t x, y;
+
+        /* initialize the lists. */
+        ASSERT_EQ(0, clist_init(&x));
+        ASSERT_EQ(0, clist_init(&y));
+
+        for (int i = 0; i < 7; ++i)
+            ASSERT_EQ(0, clist_push_back(&x, (disposable_t*)foo_create(i)));
+
+        /* find the split point; 7 is the sentinel. */
+        list_node_t* node = clist_begin(&x);
+        for (int i = 0; i < at; ++i)
+            node = node->next;
+
+        clist_split(&x, node, &y);
+
+        std::vector<int> before, after;
+        for (int i = 0; i < 7; ++i)
+            (i < at ? before : after).push_back(i);
+
+        EXPECT_EQ(before, clist_values(&x));
+        EXPECT_EQ(after, clist_values(&y));
+
+        /* the two halves go back together. */
+        clist_splice(&x, &y);
+        EXPECT_EQ(
+            std::vector<int>({0, 1, 2, 3, 4, 5, 6}), clist_values(&x));
+
+        dispose((disposable_t*)&x);
+        dispose((disposable_t*)&y);
+    }
+}
+
+/**
+ * A pooled circular list recycles its nodes through the pool.
+ */
+TEST(clist, pool)
+{
+    pool_t pool;
+    clist_t list;
+    disposable_t* data;
+
+    /* a pool that is too small for nodes is rejected. */
+    ASSERT_EQ(0, pool_init(&pool, sizeof(void*), 16));
+    EXPECT_NE(0, clist_init_pool(&list, &pool));
+    dispose((disposable_t*)&pool);
+
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 16));
+    ASSERT_EQ(0, clist_init_pool(&list, &pool));
+
+    ASSERT_EQ(0, clist_push_back(&list, (disposable_t*)foo_create(1)));
+    list_node_t* first = clist_begin(&list);
+    ASSERT_EQ(0, clist_pop_front(&list, &data));
+    free(data);
+
+    /* the released node is reused. */
+    ASSERT_EQ(0, clist_push_back(&list, (disposable_t*)foo_create(2)));
+    EXPECT_EQ(first, clist_begin(&list));
+    EXPECT_EQ(1U, pool.live_count);
+
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(0U, pool.live_count);
+    dispose((disposable_t*)&pool);
+}
+
+static foo* foo_create(int val)
+{
+    foo* ret = (foo*)malloc(sizeof(foo));
+
+    ret->hdr.dispose = &foo_disposer_mock;
+    ret->val = val;
+
+    return ret;
+}
+
+static void foo_disposer_mock(disposable_t*)
+{
+    ++foo_disposer_mock_count;
+}
+
+static std::vector<int> clist_values(clist_t* list)
+{
+    std::vector<int> values;
+
+    /* walk the ring, checking the back links along the way. */
+    list_node_t* prev = clist_end(list);
+    for (list_node_t* i = clist_begin(list); i != clist_end(list); i = i->next)
+    {
+        EXPECT_EQ(prev, i->prev);
+        values.push_back(((foo*)i->data)->val);
+        prev = i;
+    }
+    EXPECT_EQ(prev, clist_end(list)->prev);
+    EXPECT_EQ(values.size(), list->size);
+
+    return values;
+}
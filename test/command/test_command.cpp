@@ -0,0 +1,985 @@
+/**
+ * \brief Unit tests for commands and command stacks.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/command.h>
+#include <ej/heap.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * \brief Create a command replacing the old lines with the new ones.
+ */
+static command_t* make_command(
+    allocator_t* alloc, size_t line, const std::vector<std::string>& old_text,
+    const std::vector<std::string>& new_text)
+{
+    std::vector<command_line_t> old_lines, new_lines;
+    for (const std::string& s : old_text)
+        old_lines.push_back(command_line_t{s.data(), s.size()});
+    for (const std::string& s : new_text)
+        new_lines.push_back(command_line_t{s.data(), s.size()});
+
+    command_t* cmd = nullptr;
+    if (0 !=
+            command_create(
+                &cmd, alloc, line, old_lines.data(), old_lines.size(),
+                new_lines.data(), new_lines.size()))
+        return nullptr;
+
+    return cmd;
+}
+
+/**
+ * \brief Get the text of a command's old lines, followed by its new lines, or
+ * for a delta, the bytes removed from each line and then the bytes inserted.
+ */
+static std::vector<std::string> command_lines(const command_t* cmd)
+{
+    std::vector<std::string> lines;
+    const uint32_t* lengths = command_lengths(cmd);
+    const char* text = command_text(cmd);
+
+    for (uint32_t i = 0U; i < cmd->old_count + cmd->new_count; ++i)
+    {
+        lines.push_back(std::string(text, lengths[i]));
+        text += lengths[i];
+    }
+
+    return lines;
+}
+
+/**
+ * A command holds copies of its old and new lines.
+ */
+TEST(command, create)
+{
+    heap_t heap;
+    ASSERT_EQ(0, heap_init(&heap));
+
+    command_t* cmd = make_command(&heap.alloc, 7, {"ab", ""}, {"xyz"});
+    ASSERT_NE(nullptr, cmd);
+
+    EXPECT_EQ(COMMAND_TYPE_REPLACE, cmd->type);
+    EXPECT_EQ(7U, cmd->line);
+    EXPECT_EQ(2U, cmd->old_count);
+    EXPECT_EQ(1U, cmd->new_count);
+    EXPECT_EQ(2U, cmd->old_bytes);
+    EXPECT_EQ(0U, cmd->size % 8U);
+    EXPECT_GE(cmd->size, sizeof(command_t) + 3U * sizeof(uint32_t) + 5U);
+    EXPECT_NE(0U, cmd->time);
+    EXPECT_EQ(
+        (std::vector<std::string>{"ab", "", "xyz"}), command_lines(cmd));
+
+    /* commands are tagged, so that their memory can be told apart. */
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+    EXPECT_EQ(1U, stats->tag_live_count[ALLOCATOR_TAG_COMMAND]);
+    EXPECT_EQ(cmd->size, stats->tag_live_bytes[ALLOCATOR_TAG_COMMAND]);
+
+    allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    EXPECT_EQ(0U, stats->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A line changed in place keeps only the changed bytes, if that is smaller.
+ */
+TEST(command, create_delta)
+{
+    heap_t heap;
+    ASSERT_EQ(0, heap_init(&heap));
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+
+    std::string before(2000, 'a'), after(2000, 'a');
+    after[1000] = 'b';
+    command_t* cmd = make_command(&heap.alloc, 5, {before}, {after});
+    ASSERT_NE(nullptr, cmd);
+
+    EXPECT_EQ(COMMAND_TYPE_DELTA, cmd->type);
+    EXPECT_EQ(5U, cmd->line);
+    EXPECT_EQ(1U, cmd->old_count);
+    EXPECT_EQ(1U, cmd->new_count);
+    EXPECT_EQ(1U, cmd->old_bytes);
+    EXPECT_EQ(1U, command_lengths(cmd)[0]);
+    EXPECT_EQ(1U, command_lengths(cmd)[1]);
+    EXPECT_EQ(1000U, command_offsets(cmd)[0]);
+    EXPECT_EQ("ab", std::string(command_text(cmd), 2));
+    EXPECT_LE(cmd->size, 64U);
+
+    /* the bytes saved are counted, along with the command. */
+    EXPECT_EQ(cmd->size, stats->tag_live_bytes[ALLOCATOR_TAG_COMMAND]);
+    EXPECT_GE(stats->saved_bytes, 4000U - cmd->size);
+    allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+
+    /* a change is widened to whole codepoints. */
+    cmd =
+        make_command(
+            &heap.alloc, 0, {"xyz caf\xc3\xa9"}, {"xyz caf\xc3\xa8"});
+    ASSERT_NE(nullptr, cmd);
+    ASSERT_EQ(COMMAND_TYPE_DELTA, cmd->type);
+    EXPECT_EQ(7U, command_offsets(cmd)[0]);
+    EXPECT_EQ(
+        "\xc3\xa9\xc3\xa8",
+        std::string(command_text(cmd), cmd->old_bytes + 2U));
+    allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+
+    /* lines which change throughout are kept whole. */
+    size_t saved = stats->saved_bytes;
+    cmd = make_command(&heap.alloc, 0, {"abcdefgh"}, {"12345678"});
+    ASSERT_NE(nullptr, cmd);
+    EXPECT_EQ(COMMAND_TYPE_REPLACE, cmd->type);
+    EXPECT_EQ(saved, stats->saved_bytes);
+    allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+
+    /* as are lines which are inserted or deleted. */
+    cmd = make_command(&heap.alloc, 0, {before}, {after, after});
+    ASSERT_NE(nullptr, cmd);
+    EXPECT_EQ(COMMAND_TYPE_REPLACE, cmd->type);
+    allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+
+    EXPECT_EQ(0U, stats->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * \brief Push commands numbered first to last onto the stack, then check and
+ * pop them all in reverse.
+ */
+static void push_and_pop(
+    command_stack_t* stack, allocator_t* alloc, size_t count, size_t length)
+{
+    for (size_t i = 0U; i < count; ++i)
+    {
+        command_t* cmd =
+            make_command(
+                alloc, i, {std::string(length, 'a' + i % 26)},
+                {std::to_string(i)});
+        ASSERT_NE(nullptr, cmd);
+        ASSERT_EQ(0, command_stack_push(stack, cmd));
+        allocator_release_tagged(alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    }
+
+    EXPECT_EQ(count, stack->count);
+
+    for (size_t i = count; i-- > 0U;)
+    {
+        const command_t* cmd = command_stack_peek(stack);
+        ASSERT_NE(nullptr, cmd);
+        EXPECT_EQ(i, cmd->line);
+        EXPECT_EQ(
+            (std::vector<std::string>{
+                std::string(length, 'a' + i % 26), std::to_string(i)}),
+            command_lines(cmd));
+        ASSERT_EQ(0, command_stack_pop(stack));
+    }
+
+    EXPECT_EQ(0U, stack->count);
+    EXPECT_EQ(nullptr, command_stack_peek(stack));
+    EXPECT_NE(0, command_stack_pop(stack));
+}
+
+/**
+ * A memory command stack holds copies of its commands.
+ */
+TEST(command, mem_stack)
+{
+    heap_t heap;
+    command_mem_stack_t stack;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_mem_stack_init(&stack, &heap.alloc));
+
+    push_and_pop(&stack.stack, &heap.alloc, 100, 10);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    /* the commands left are released when the stack is disposed. */
+    command_t* cmd = make_command(&heap.alloc, 0, {"a"}, {"b"});
+    ASSERT_NE(nullptr, cmd);
+    ASSERT_EQ(0, command_stack_push(&stack.stack, cmd));
+    ASSERT_EQ(0, command_stack_push(&stack.stack, cmd));
+    allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    EXPECT_EQ(
+        2U,
+        allocator_stats(&heap.alloc)->tag_live_count[ALLOCATOR_TAG_COMMAND]);
+
+    dispose((disposable_t*)&stack);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A command log holds its commands in a file, writing them in batches.
+ */
+TEST(command, log)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_log_t log;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_log_init(&log, path));
+
+    /* a few small commands stay in the write buffer. */
+    push_and_pop(&log.stack, &heap.alloc, 10, 10);
+    EXPECT_EQ(0U, log.write_count);
+    EXPECT_EQ(0U, log.map_count);
+
+    /* many commands are written in a few batches, and read back through a
+     * few mappings. */
+    push_and_pop(&log.stack, &heap.alloc, 20000, 100);
+    EXPECT_GT(log.write_count, 0U);
+    EXPECT_LT(log.write_count, 100U);
+    EXPECT_GT(log.map_count, 0U);
+    EXPECT_LT(log.map_count, 100U);
+
+    /* commands bigger than the write buffer are written on their own. */
+    push_and_pop(&log.stack, &heap.alloc, 5, 3 * COMMAND_LOG_BUFFER_SIZE);
+
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&log);
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * Commands pushed after others are popped replace them.
+ */
+TEST(command, log_interleaved)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_log_t log;
+    std::vector<size_t> expected;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_log_init(&log, path));
+
+    /* push three and pop two, over and over, across buffer flushes. */
+    for (size_t i = 0U; i < 30000U; ++i)
+    {
+        if (i % 3U == 2U)
+        {
+            for (int j = 0; j < 2 && !expected.empty(); ++j)
+            {
+                const command_t* cmd = command_stack_peek(&log.stack);
+                ASSERT_NE(nullptr, cmd);
+                EXPECT_EQ(expected.back(), cmd->line);
+                ASSERT_EQ(0, command_stack_pop(&log.stack));
+                expected.pop_back();
+            }
+        }
+
+        command_t* cmd =
+            make_command(&heap.alloc, i, {std::string(i % 200, 'x')}, {});
+        ASSERT_NE(nullptr, cmd);
+        ASSERT_EQ(0, command_stack_push(&log.stack, cmd));
+        allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+        expected.push_back(i);
+    }
+
+    ASSERT_EQ(expected.size(), log.stack.count);
+    while (!expected.empty())
+    {
+        const command_t* cmd = command_stack_peek(&log.stack);
+        ASSERT_NE(nullptr, cmd);
+        EXPECT_EQ(expected.back(), cmd->line);
+        EXPECT_EQ(expected.back() % 200U, cmd->old_bytes);
+        ASSERT_EQ(0, command_stack_pop(&log.stack));
+        expected.pop_back();
+    }
+
+    dispose((disposable_t*)&log);
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * Commands merge when the second rewrites or extends what the first left.
+ */
+TEST(command, merge)
+{
+    heap_t heap;
+    command_t* merged;
+    ASSERT_EQ(0, heap_init(&heap));
+
+    command_t* first = make_command(&heap.alloc, 3, {"ab"}, {"abc"});
+    command_t* rewrite = make_command(&heap.alloc, 3, {"abc"}, {"abcd"});
+    command_t* append = make_command(&heap.alloc, 4, {}, {"x", "y"});
+    command_t* other = make_command(&heap.alloc, 3, {"abX"}, {"abcd"});
+    command_t* below = make_command(&heap.alloc, 5, {}, {"z"});
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, rewrite);
+    ASSERT_NE(nullptr, append);
+    ASSERT_NE(nullptr, other);
+    ASSERT_NE(nullptr, below);
+
+    /* the same line edited twice. */
+    ASSERT_EQ(0, command_merge(&merged, &heap.alloc, first, rewrite, 4096));
+    EXPECT_EQ(3U, merged->line);
+    EXPECT_EQ(first->time, merged->time);
+    EXPECT_EQ(1U, merged->old_count);
+    EXPECT_EQ(1U, merged->new_count);
+    EXPECT_EQ((std::vector<std::string>{"ab", "abcd"}), command_lines(merged));
+    allocator_release_tagged(&heap.alloc, merged, ALLOCATOR_TAG_COMMAND);
+
+    /* lines inserted just after the line edited. */
+    ASSERT_EQ(0, command_merge(&merged, &heap.alloc, first, append, 4096));
+    EXPECT_EQ(1U, merged->old_count);
+    EXPECT_EQ(3U, merged->new_count);
+    EXPECT_EQ(
+        (std::vector<std::string>{"ab", "abc", "x", "y"}),
+        command_lines(merged));
+    allocator_release_tagged(&heap.alloc, merged, ALLOCATOR_TAG_COMMAND);
+
+    /* commands which don't meet, or disagree, stay apart. */
+    EXPECT_NE(0, command_merge(&merged, &heap.alloc, first, other, 4096));
+    EXPECT_NE(0, command_merge(&merged, &heap.alloc, first, below, 4096));
+    EXPECT_NE(0, command_merge(&merged, &heap.alloc, rewrite, first, 4096));
+
+    /* as do commands which would merge into too large a command. */
+    EXPECT_NE(
+        0,
+        command_merge(
+            &merged, &heap.alloc, first, append, sizeof(command_t) + 8U));
+
+    for (command_t* cmd : {first, rewrite, append, other, below})
+        allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * Deltas merge with each other when they touch, and with whole lines.
+ */
+TEST(command, merge_delta)
+{
+    heap_t heap;
+    command_t* merged;
+    ASSERT_EQ(0, heap_init(&heap));
+
+    /* typing "xy" and then deleting the "x" in the middle of a long line. */
+    std::string line(500, 'a');
+    std::string typed = line.substr(0, 250) + "x" + line.substr(250);
+    std::string more = line.substr(0, 250) + "xy" + line.substr(250);
+    std::string less = line.substr(0, 250) + "y" + line.substr(250);
+    command_t* first = make_command(&heap.alloc, 9, {line}, {typed});
+    command_t* second = make_command(&heap.alloc, 9, {typed}, {more});
+    command_t* third = make_command(&heap.alloc, 9, {more}, {less});
+    command_t* apart = make_command(&heap.alloc, 9, {typed}, {"b" + typed});
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    ASSERT_NE(nullptr, third);
+    ASSERT_NE(nullptr, apart);
+    ASSERT_EQ(COMMAND_TYPE_DELTA, first->type);
+    ASSERT_EQ(COMMAND_TYPE_DELTA, second->type);
+    ASSERT_EQ(COMMAND_TYPE_DELTA, third->type);
+
+    ASSERT_EQ(0, command_merge(&merged, &heap.alloc, first, second, 4096));
+    EXPECT_EQ(COMMAND_TYPE_DELTA, merged->type);
+    EXPECT_EQ(9U, merged->line);
+    EXPECT_EQ(250U, command_offsets(merged)[0]);
+    EXPECT_EQ(0U, command_lengths(merged)[0]);
+    EXPECT_EQ("xy", std::string(command_text(merged), 2));
+
+    command_t* both;
+    ASSERT_EQ(0, command_merge(&both, &heap.alloc, merged, third, 4096));
+    EXPECT_EQ(COMMAND_TYPE_DELTA, both->type);
+    EXPECT_EQ(250U, command_offsets(both)[0]);
+    EXPECT_EQ("y", std::string(command_text(both), both->old_bytes + 1U));
+    allocator_release_tagged(&heap.alloc, both, ALLOCATOR_TAG_COMMAND);
+    allocator_release_tagged(&heap.alloc, merged, ALLOCATOR_TAG_COMMAND);
+
+    /* changes which don't touch stay apart. */
+    EXPECT_NE(0, command_merge(&merged, &heap.alloc, first, apart, 4096));
+
+    /* a delta to a line which was inserted whole. */
+    command_t* insert = make_command(&heap.alloc, 9, {}, {line});
+    ASSERT_NE(nullptr, insert);
+    ASSERT_EQ(0, command_merge(&merged, &heap.alloc, insert, first, 4096));
+    EXPECT_EQ(COMMAND_TYPE_REPLACE, merged->type);
+    EXPECT_EQ((std::vector<std::string>{typed}), command_lines(merged));
+    allocator_release_tagged(&heap.alloc, merged, ALLOCATOR_TAG_COMMAND);
+
+    /* whole lines which replace the lines a delta left. */
+    command_t* rewrite = make_command(&heap.alloc, 9, {typed}, {"short"});
+    ASSERT_NE(nullptr, rewrite);
+    ASSERT_EQ(COMMAND_TYPE_REPLACE, rewrite->type);
+    ASSERT_EQ(0, command_merge(&merged, &heap.alloc, first, rewrite, 4096));
+    EXPECT_EQ(COMMAND_TYPE_REPLACE, merged->type);
+    EXPECT_EQ((std::vector<std::string>{line, "short"}), command_lines(merged));
+    allocator_release_tagged(&heap.alloc, merged, ALLOCATOR_TAG_COMMAND);
+
+    for (command_t* cmd : {first, second, third, apart, insert, rewrite})
+        allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * \brief Push a command typing text onto the end of a line, made at the given
+ * time.
+ */
+static void push_typed(
+    command_stack_t* stack, allocator_t* alloc, const std::string& before,
+    const std::string& after, uint64_t time)
+{
+    command_t* cmd = make_command(alloc, 0, {before}, {after});
+    ASSERT_NE(nullptr, cmd);
+    cmd->time = time;
+    ASSERT_EQ(0, command_stack_push(stack, cmd));
+    allocator_release_tagged(alloc, cmd, ALLOCATOR_TAG_COMMAND);
+}
+
+/**
+ * \brief Coalesce keystrokes on a stack, checking the runs that are undone.
+ */
+static void coalesce_keystrokes(command_stack_t* stack, allocator_t* alloc)
+{
+    command_stack_coalesce(stack, 1000, 136);
+
+    /* keystrokes within the time window become one command. */
+    push_typed(stack, alloc, "", "h", 10000);
+    push_typed(stack, alloc, "h", "he", 10100);
+    push_typed(stack, alloc, "he", "hel", 10900);
+    EXPECT_EQ(1U, stack->count);
+    EXPECT_EQ(2U, stack->merge_count);
+
+    /* one past the window starts a new command. */
+    push_typed(stack, alloc, "hel", "hell", 11001);
+    push_typed(stack, alloc, "hell", "hello", 11002);
+    EXPECT_EQ(2U, stack->count);
+
+    /* so does one after the stack is sealed. */
+    command_stack_seal(stack);
+    push_typed(stack, alloc, "hello", "hello ", 11003);
+    push_typed(stack, alloc, "hello ", "hello w", 11004);
+    EXPECT_EQ(3U, stack->count);
+
+    /* and one which would make the command too large: six appended lines
+     * fit in the size window, and the seventh starts a new command. */
+    command_stack_seal(stack);
+    for (size_t i = 1U; i <= 12U; ++i)
+    {
+        command_t* cmd = make_command(alloc, i, {}, {"0123456789"});
+        ASSERT_NE(nullptr, cmd);
+        cmd->time = 11005;
+        ASSERT_EQ(0, command_stack_push(stack, cmd));
+        allocator_release_tagged(alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    }
+    EXPECT_EQ(5U, stack->count);
+
+    /* each run is undone in one step. */
+    for (size_t line : {7U, 1U})
+    {
+        const command_t* cmd = command_stack_peek(stack);
+        ASSERT_NE(nullptr, cmd);
+        EXPECT_EQ(line, cmd->line);
+        EXPECT_EQ(0U, cmd->old_count);
+        EXPECT_EQ(6U, cmd->new_count);
+        ASSERT_EQ(0, command_stack_pop(stack));
+    }
+
+    /* the third run appended to its line, so it is kept as a delta. */
+    const std::vector<std::vector<std::string>> runs = {
+        {"", " w"}, {"hel", "hello"}, {"", "hel"}};
+    for (const auto& run : runs)
+    {
+        const command_t* cmd = command_stack_peek(stack);
+        ASSERT_NE(nullptr, cmd);
+        EXPECT_EQ(run, command_lines(cmd));
+        ASSERT_EQ(0, command_stack_pop(stack));
+    }
+
+    /* a command pushed after an undo is never merged below it. */
+    push_typed(stack, alloc, "", "a", 20000);
+    push_typed(stack, alloc, "a", "ab", 20001);
+    EXPECT_EQ(1U, stack->count);
+    ASSERT_EQ(0, command_stack_pop(stack));
+    push_typed(stack, alloc, "", "x", 20002);
+    EXPECT_EQ(1U, stack->count);
+    ASSERT_EQ(0, command_stack_pop(stack));
+}
+
+/**
+ * A memory command stack coalesces commands within its window.
+ */
+TEST(command, mem_stack_coalesce)
+{
+    heap_t heap;
+    command_mem_stack_t stack;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_mem_stack_init(&stack, &heap.alloc));
+
+    coalesce_keystrokes(&stack.stack, &heap.alloc);
+
+    dispose((disposable_t*)&stack);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * \brief An allocator which draws from a heap until it is told to fail.
+ */
+struct failing_allocator
+{
+    allocator_t alloc;
+    allocator_t* backing;
+    bool fail;
+};
+
+static void* failing_allocate(allocator_t* alloc, size_t size)
+{
+    failing_allocator* failing = (failing_allocator*)alloc;
+
+    return failing->fail ? nullptr : allocator_allocate(failing->backing, size);
+}
+
+static void failing_release(allocator_t* alloc, void* ptr)
+{
+    allocator_release(((failing_allocator*)alloc)->backing, ptr);
+}
+
+static void failing_dispose(disposable_t*)
+{
+}
+
+static void failing_init(failing_allocator* failing, allocator_t* backing)
+{
+    memset(failing, 0, sizeof(failing_allocator));
+    failing->alloc.hdr.dispose = &failing_dispose;
+    failing->alloc.allocate = &failing_allocate;
+    failing->alloc.release = &failing_release;
+    failing->backing = backing;
+}
+
+/**
+ * \brief Merge into the command on top of a stack whose allocator fails,
+ * checking that the command on top survives.
+ */
+static void coalesce_failing(
+    command_stack_t* stack, failing_allocator* failing, allocator_t* alloc)
+{
+    command_stack_coalesce(stack, 1000, 4096);
+    push_typed(stack, alloc, "", "h", 10000);
+
+    command_t* cmd = make_command(alloc, 0, {"h"}, {"he"});
+    ASSERT_NE(nullptr, cmd);
+    cmd->time = 10100;
+    failing->fail = true;
+    EXPECT_NE(0, command_stack_push(stack, cmd));
+    failing->fail = false;
+    allocator_release_tagged(alloc, cmd, ALLOCATOR_TAG_COMMAND);
+
+    EXPECT_EQ(1U, stack->count);
+    EXPECT_EQ(0U, stack->merge_count);
+    const command_t* top = command_stack_peek(stack);
+    ASSERT_NE(nullptr, top);
+    EXPECT_EQ((std::vector<std::string>{"", "h"}), command_lines(top));
+
+    /* the next keystroke merges as usual. */
+    push_typed(stack, alloc, "h", "he", 10200);
+    EXPECT_EQ(1U, stack->count);
+    EXPECT_EQ(1U, stack->merge_count);
+    top = command_stack_peek(stack);
+    ASSERT_NE(nullptr, top);
+    EXPECT_EQ((std::vector<std::string>{"", "he"}), command_lines(top));
+}
+
+/**
+ * A memory command stack keeps the command on top if a merge into it fails.
+ */
+TEST(command, mem_stack_coalesce_fail)
+{
+    heap_t heap;
+    failing_allocator failing;
+    command_mem_stack_t stack;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    failing_init(&failing, &heap.alloc);
+    ASSERT_EQ(0, command_mem_stack_init(&stack, &failing.alloc));
+
+    coalesce_failing(&stack.stack, &failing, &heap.alloc);
+
+    dispose((disposable_t*)&stack);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A command log coalesces commands within its window.
+ */
+TEST(command, log_coalesce)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_log_t log;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_log_init(&log, path));
+
+    coalesce_keystrokes(&log.stack, &heap.alloc);
+
+    /* a merged command too big for the write buffer is not written over the
+     * one on top, so the command is pushed on its own. */
+    const std::string big(COMMAND_LOG_BUFFER_SIZE, 'x');
+    command_stack_coalesce(&log.stack, 1000, 4U * COMMAND_LOG_BUFFER_SIZE);
+    push_typed(&log.stack, &heap.alloc, "", big, 30000);
+    push_typed(&log.stack, &heap.alloc, big, big + "y", 30001);
+    EXPECT_EQ(2U, log.stack.count);
+    ASSERT_EQ(0, command_stack_pop(&log.stack));
+    const command_t* top = command_stack_peek(&log.stack);
+    ASSERT_NE(nullptr, top);
+    EXPECT_EQ((std::vector<std::string>{"", big}), command_lines(top));
+
+    dispose((disposable_t*)&log);
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * \brief Push commands numbered 0 to count - 1, marking the stack at depth,
+ * then read the commands above the mark, and cut the stack back to it.
+ */
+static void mark_and_truncate(
+    command_stack_t* stack, allocator_t* alloc, size_t count, size_t depth)
+{
+    uint64_t bottom = command_stack_mark(stack);
+    uint64_t mark = bottom;
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        if (i == depth)
+            mark = command_stack_mark(stack);
+
+        command_t* cmd =
+            make_command(alloc, i, {std::string(100, 'a')}, {"b"});
+        ASSERT_NE(nullptr, cmd);
+        ASSERT_EQ(0, command_stack_push(stack, cmd));
+        allocator_release_tagged(alloc, cmd, ALLOCATOR_TAG_COMMAND);
+    }
+
+    /* every command is read oldest first from the bottom. */
+    uint64_t next = bottom;
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const command_t* cmd = command_stack_next(stack, &next);
+        ASSERT_NE(nullptr, cmd);
+        EXPECT_EQ(i, cmd->line);
+    }
+    EXPECT_EQ(nullptr, command_stack_next(stack, &next));
+    EXPECT_EQ(command_stack_mark(stack), next);
+
+    /* and those above the mark from the mark. */
+    next = mark;
+    const command_t* cmd = command_stack_next(stack, &next);
+    ASSERT_NE(nullptr, cmd);
+    EXPECT_EQ(depth, cmd->line);
+
+    /* cutting the stack back leaves the commands below the mark. */
+    ASSERT_EQ(0, command_stack_truncate(stack, mark, depth));
+    EXPECT_EQ(depth, stack->count);
+    EXPECT_TRUE(stack->sealed);
+    EXPECT_EQ(mark, command_stack_mark(stack));
+    next = mark;
+    EXPECT_EQ(nullptr, command_stack_next(stack, &next));
+
+    /* a command pushed now follows them. */
+    cmd = make_command(alloc, count, {"c"}, {"d"});
+    ASSERT_NE(nullptr, cmd);
+    ASSERT_EQ(0, command_stack_push(stack, cmd));
+    allocator_release_tagged(alloc, (void*)cmd, ALLOCATOR_TAG_COMMAND);
+
+    next = mark;
+    cmd = command_stack_next(stack, &next);
+    ASSERT_NE(nullptr, cmd);
+    EXPECT_EQ(count, cmd->line);
+    ASSERT_EQ(0, command_stack_pop(stack));
+    cmd = command_stack_peek(stack);
+    ASSERT_NE(nullptr, cmd);
+    EXPECT_EQ(depth - 1U, cmd->line);
+
+    ASSERT_EQ(0, command_stack_truncate(stack, bottom, 0U));
+    EXPECT_EQ(0U, stack->count);
+}
+
+/**
+ * A memory command stack can be read from a mark, and cut back to it.
+ */
+TEST(command, mem_stack_mark)
+{
+    heap_t heap;
+    command_mem_stack_t stack;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_mem_stack_init(&stack, &heap.alloc));
+
+    mark_and_truncate(&stack.stack, &heap.alloc, 100, 40);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&stack);
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A command log can be read from a mark, and cut back to it, whether the
+ * commands are in its file or its write buffer.
+ */
+TEST(command, log_mark)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_log_t log;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_log_init(&log, path));
+
+    mark_and_truncate(&log.stack, &heap.alloc, 10, 4);
+    EXPECT_EQ(0U, log.write_count);
+
+    /* the mark is in the file, and the top is in the write buffer. */
+    mark_and_truncate(&log.stack, &heap.alloc, 20000, 7000);
+    EXPECT_GT(log.write_count, 0U);
+    EXPECT_LT(log.map_count, 100U);
+
+    dispose((disposable_t*)&log);
+    dispose((disposable_t*)&heap);
+    unlink(path);
+}
+
+/**
+ * \brief Compress and decompress bytes, checking that they survive.
+ */
+static size_t lz_round_trip(const std::string& text)
+{
+    std::vector<unsigned char> packed(COMMAND_LZ_BOUND(text.size()));
+    std::string unpacked(text.size(), '\0');
+
+    size_t size = command_lz_compress(packed.data(), text.data(), text.size());
+    EXPECT_LE(size, packed.size());
+    EXPECT_EQ(
+        0,
+        command_lz_decompress(
+            &unpacked[0], unpacked.size(), packed.data(), size));
+    EXPECT_EQ(text, unpacked);
+
+    return size;
+}
+
+/**
+ * The LZ coder shrinks repetitive text, and never grows other bytes beyond
+ * its bound.
+ */
+TEST(command, lz)
+{
+    lz_round_trip("");
+    lz_round_trip("a");
+    lz_round_trip("abcdabcd");
+    lz_round_trip(std::string(100000, 'x'));
+
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+        text += "    line = line_at(buffer, " + std::to_string(i) + ");\n";
+    EXPECT_LT(lz_round_trip(text), text.size() / 3U);
+
+    std::string noise;
+    unsigned int seed = 1U;
+    for (int i = 0; i < 100000; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        noise += (char)(seed >> 16);
+    }
+    lz_round_trip(noise);
+
+    /* damaged input is refused. */
+    std::vector<unsigned char> packed(COMMAND_LZ_BOUND(text.size()));
+    std::string unpacked(text.size(), '\0');
+    size_t size = command_lz_compress(packed.data(), text.data(), text.size());
+    EXPECT_NE(
+        0,
+        command_lz_decompress(
+            &unpacked[0], unpacked.size(), packed.data(), size / 2U));
+    EXPECT_NE(
+        0,
+        command_lz_decompress(
+            &unpacked[0], unpacked.size() - 1U, packed.data(), size));
+    std::vector<unsigned char> damaged(8U, 0xFFU);
+    EXPECT_NE(
+        0,
+        command_lz_decompress(
+            &unpacked[0], unpacked.size(), damaged.data(), damaged.size()));
+    const unsigned char far[] = {0x00U, 0x05U, 0x00U};
+    EXPECT_NE(
+        0,
+        command_lz_decompress(
+            &unpacked[0], unpacked.size(), far, sizeof(far)));
+}
+
+/**
+ * A tiered command stack keeps its newest commands in memory, and spills the
+ * rest to its file, reloading them as they are popped.
+ */
+TEST(command, tiered)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_tiered_t tiered;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_tiered_init(&tiered, &heap.alloc, path, 64 * 1024));
+
+    /* the file is gone, but the stack still has it open. */
+    EXPECT_NE(0, access(path, F_OK));
+
+    /* a few commands stay in memory. */
+    push_and_pop(&tiered.stack, &heap.alloc, 10, 10);
+    EXPECT_EQ(0U, tiered.spill_count);
+
+    /* many are spilled in compressed blocks, and reloaded. */
+    push_and_pop(&tiered.stack, &heap.alloc, 20000, 100);
+    EXPECT_GT(tiered.spill_count, 0U);
+    EXPECT_LT(tiered.spill_count, 1000U);
+    EXPECT_LT(tiered.spill_packed_bytes, tiered.spill_bytes / 2U);
+    EXPECT_GT(tiered.reload_count, 0U);
+    EXPECT_EQ(0U, tiered.block_count);
+    EXPECT_GE(tiered.spill_ns, tiered.spill_max_ns);
+    EXPECT_GE(tiered.reload_ns, tiered.reload_max_ns);
+
+    /* commands bigger than a block are spilled on their own. */
+    push_and_pop(&tiered.stack, &heap.alloc, 5, 3 * COMMAND_TIERED_BLOCK_SIZE);
+
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    /* memory stays within the limit while commands are pushed. */
+    for (size_t i = 0U; i < 5000U; ++i)
+    {
+        command_t* cmd =
+            make_command(&heap.alloc, i, {std::string(200, 'a')}, {"b"});
+        ASSERT_NE(nullptr, cmd);
+        ASSERT_EQ(0, command_stack_push(&tiered.stack, cmd));
+        allocator_release_tagged(&heap.alloc, cmd, ALLOCATOR_TAG_COMMAND);
+        EXPECT_LE(tiered.hot_bytes, 64U * 1024U);
+    }
+    EXPECT_LE(
+        allocator_stats(&heap.alloc)->tag_live_count[ALLOCATOR_TAG_COMMAND],
+        tiered.hot_count);
+
+    /* the cold commands are not released when the stack is disposed. */
+    dispose((disposable_t*)&tiered);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A tiered command stack can be read from a mark, and cut back to it, whether
+ * the commands are hot or cold.
+ */
+TEST(command, tiered_mark)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_tiered_t tiered;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_tiered_init(&tiered, &heap.alloc, path, 64 * 1024));
+
+    mark_and_truncate(&tiered.stack, &heap.alloc, 10, 4);
+    EXPECT_EQ(0U, tiered.spill_count);
+
+    /* the mark is in a cold block, below more cold blocks. */
+    mark_and_truncate(&tiered.stack, &heap.alloc, 20000, 7000);
+    EXPECT_GT(tiered.spill_count, 0U);
+    EXPECT_GT(tiered.reload_count, 0U);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&tiered);
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A tiered command stack coalesces commands within its window.
+ */
+TEST(command, tiered_coalesce)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    command_tiered_t tiered;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, command_tiered_init(&tiered, &heap.alloc, path, 0));
+
+    coalesce_keystrokes(&tiered.stack, &heap.alloc);
+
+    dispose((disposable_t*)&tiered);
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A tiered command stack keeps the command on top if a merge into it fails.
+ */
+TEST(command, tiered_coalesce_fail)
+{
+    char path[] = "/tmp/ej_command_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    heap_t heap;
+    failing_allocator failing;
+    command_tiered_t tiered;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    failing_init(&failing, &heap.alloc);
+    ASSERT_EQ(0, command_tiered_init(&tiered, &failing.alloc, path, 0));
+
+    coalesce_failing(&tiered.stack, &failing, &heap.alloc);
+
+    dispose((disposable_t*)&tiered);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
@@ -0,0 +1,132 @@
+/**
+ * \brief Unit tests for the heap allocator and allocator statistics.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/heap.h>
+#include <ej/list.h>
+#include <gtest/gtest.h>
+#include <string.h>
+
+struct foo
+{
+    disposable_t hdr;
+    int val;
+};
+
+static void foo_dispose(disposable_t*)
+{
+}
+
+/**
+ * A heap can be initialized and disposed.
+ */
+TEST(heap, init)
+{
+    heap_t heap;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    EXPECT_TRUE(PROP_VALID_HEAP(&heap));
+    EXPECT_TRUE(heap.alloc.stats_enabled);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A heap tracks live bytes, counts, the high-water mark and size classes.
+ */
+TEST(heap, stats)
+{
+    heap_t heap;
+    allocator_t* alloc = &heap.alloc;
+    const allocator_stats_t* stats = allocator_stats(alloc);
+
+    ASSERT_EQ(0, heap_init(&heap));
+
+    void* a = allocator_allocate(alloc, 10);
+    void* b = allocator_allocate(alloc, 100);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    memset(b, 0x5A, 100);
+
+    EXPECT_EQ(110U, stats->live_bytes);
+    EXPECT_EQ(2U, stats->live_count);
+    EXPECT_EQ(2U, stats->total_count);
+    EXPECT_EQ(110U, stats->high_water_bytes);
+    EXPECT_EQ(110U, stats->tag_live_bytes[ALLOCATOR_TAG_UNTAGGED]);
+
+    /* 10 bytes is in the first class; 100 bytes is in the (64, 128] class. */
+    EXPECT_EQ(1U, stats->size_class_count[0]);
+    EXPECT_EQ(1U, stats->size_class_count[3]);
+    EXPECT_EQ(0U, allocator_size_class(16));
+    EXPECT_EQ(1U, allocator_size_class(17));
+    EXPECT_EQ(ALLOCATOR_SIZE_CLASSES - 1U, allocator_size_class(SIZE_MAX));
+
+    /* releasing lowers the live bytes, but not the high-water mark. */
+    allocator_release(alloc, b);
+    EXPECT_EQ(10U, stats->live_bytes);
+    EXPECT_EQ(1U, stats->live_count);
+    EXPECT_EQ(110U, stats->high_water_bytes);
+
+    /* a failed allocation is counted. */
+    EXPECT_EQ(nullptr, allocator_allocate(alloc, SIZE_MAX));
+    EXPECT_EQ(1U, stats->failed_count);
+    EXPECT_EQ(10U, stats->live_bytes);
+
+    /* disposing the heap releases the rest. */
+    dispose((disposable_t*)&heap);
+    EXPECT_EQ(0U, stats->live_bytes);
+    EXPECT_EQ(0U, stats->live_count);
+    EXPECT_EQ(110U, stats->high_water_bytes);
+}
+
+/**
+ * List nodes and values are attributed to their own tags.
+ */
+TEST(heap, list_tags)
+{
+    heap_t heap;
+    list_t list;
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, list_init_allocator(&list, &heap.alloc));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        foo* f =
+            (foo*)allocator_allocate_tagged(
+                &heap.alloc, sizeof(foo), ALLOCATOR_TAG_LIST_DATA);
+        ASSERT_NE(nullptr, f);
+        f->hdr.dispose = &foo_dispose;
+        f->val = i;
+        ASSERT_EQ(0, list_push_back(&list, (disposable_t*)f));
+    }
+
+    EXPECT_EQ(
+        10U * sizeof(list_node_t),
+        stats->tag_live_bytes[ALLOCATOR_TAG_LIST_NODE]);
+    EXPECT_EQ(10U, stats->tag_live_count[ALLOCATOR_TAG_LIST_NODE]);
+    EXPECT_EQ(
+        10U * sizeof(foo), stats->tag_live_bytes[ALLOCATOR_TAG_LIST_DATA]);
+    EXPECT_EQ(10U, stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+    EXPECT_EQ(0U, stats->tag_live_bytes[ALLOCATOR_TAG_UNTAGGED]);
+
+    /* removing a value releases its node and its value. */
+    disposable_t* data;
+    ASSERT_EQ(0, list_pop_front(&list, &data));
+    EXPECT_EQ(9U, stats->tag_live_count[ALLOCATOR_TAG_LIST_NODE]);
+    allocator_release_tagged(&heap.alloc, data, ALLOCATOR_TAG_LIST_DATA);
+    EXPECT_EQ(9U, stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+
+    /* disposing the list releases everything it owns. */
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(0U, stats->live_bytes);
+    EXPECT_EQ(0U, stats->tag_live_count[ALLOCATOR_TAG_LIST_NODE]);
+    EXPECT_EQ(0U, stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+
+    dispose((disposable_t*)&heap);
+}
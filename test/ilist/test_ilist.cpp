@@ -0,0 +1,350 @@
+/**
+ * \brief Unit tests for the intrusive list container.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/ilist.h>
+#include <gtest/gtest.h>
+
+struct line
+{
+    disposable_t hdr;
+    ilist_node_t link;
+    int val;
+};
+
+/* forward decls */
+static line* line_create(int val);
+static int line_val(ilist_node_t* node);
+static void line_disposer_mock(disposable_t* disp);
+static int line_disposer_mock_count;
+
+/**
+ * An intrusive list can be initialized as an empty list.
+ */
+TEST(ilist, init)
+{
+    ilist_t list;
+
+    memset(&list, 0xFE, sizeof(list));
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ilist_init(&list, offsetof(line, link)));
+
+    /* the head and tail should be NULL. */
+    EXPECT_EQ(nullptr, list.head);
+    EXPECT_EQ(nullptr, list.tail);
+
+    /* the size should be 0, and the offset should be set. */
+    EXPECT_EQ(0U, list.size);
+    EXPECT_EQ(offsetof(line, link), list.offset);
+
+    /* the list can be disposed. */
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * push_front and push_back link the embedded nodes in order.
+ */
+TEST(ilist, push_front_back)
+{
+    ilist_t list;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ilist_init(&list, offsetof(line, link)));
+
+    line* l1 = line_create(1);
+    line* l2 = line_create(2);
+    line* l3 = line_create(3);
+
+    /* push the lines. */
+    ilist_push_back(&list, &l2->link);
+    ilist_push_front(&list, &l1->link);
+    ilist_push_back(&list, &l3->link);
+
+    /* our not empty list property is valid. */
+    EXPECT_TRUE(PROP_VALID_ILIST_NOT_EMPTY(&list));
+    EXPECT_EQ(3U, list.size);
+
+    /* the list holds the embedded nodes directly. */
+    EXPECT_EQ(&l1->link, list.head);
+    EXPECT_EQ(&l3->link, list.tail);
+
+    /* the order is l1, l2, l3 forwards. */
+    EXPECT_EQ(1, line_val(list.head));
+    EXPECT_EQ(2, line_val(list.head->next));
+    EXPECT_EQ(3, line_val(list.head->next->next));
+    EXPECT_EQ(nullptr, list.head->next->next->next);
+
+    /* the order is l3, l2, l1 backwards. */
+    EXPECT_EQ(3, line_val(list.tail));
+    EXPECT_EQ(2, line_val(list.tail->prev));
+    EXPECT_EQ(1, line_val(list.tail->prev->prev));
+    EXPECT_EQ(nullptr, list.tail->prev->prev->prev);
+
+    /* ILIST_ENTRY recovers the line. */
+    EXPECT_EQ(l2, ILIST_ENTRY(list.head->next, line, link));
+
+    /* disposing the list disposes each line. */
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(3, line_disposer_mock_count);
+}
+
+/**
+ * pop_front and pop_back unlink nodes and fail on an empty list.
+ */
+TEST(ilist, pop_front_back)
+{
+    ilist_t list;
+    ilist_node_t* node;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ilist_init(&list, offsetof(line, link)));
+
+    /* popping an empty list fails. */
+    EXPECT_NE(0, ilist_pop_front(&list, &node));
+    EXPECT_EQ(nullptr, node);
+    EXPECT_NE(0, ilist_pop_back(&list, &node));
+    EXPECT_EQ(nullptr, node);
+
+    line* l1 = line_create(1);
+    line* l2 = line_create(2);
+    line* l3 = line_create(3);
+    ilist_push_back(&list, &l1->link);
+    ilist_push_back(&list, &l2->link);
+    ilist_push_back(&list, &l3->link);
+
+    /* pop the front. */
+    ASSERT_EQ(0, ilist_pop_front(&list, &node));
+    EXPECT_EQ(&l1->link, node);
+    EXPECT_EQ(nullptr, node->next);
+    EXPECT_EQ(nullptr, node->prev);
+    EXPECT_EQ(2U, list.size);
+    EXPECT_EQ(nullptr, list.head->prev);
+
+    /* pop the back. */
+    ASSERT_EQ(0, ilist_pop_back(&list, &node));
+    EXPECT_EQ(&l3->link, node);
+    EXPECT_EQ(1U, list.size);
+    EXPECT_EQ(nullptr, list.tail->next);
+
+    /* pop the last element. */
+    ASSERT_EQ(0, ilist_pop_back(&list, &node));
+    EXPECT_EQ(&l2->link, node);
+    EXPECT_TRUE(PROP_VALID_ILIST_EMPTY(&list));
+
+    free(l1);
+    free(l2);
+    free(l3);
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * insert and append weave nodes around a position, fixing head and tail.
+ */
+TEST(ilist, insert_append)
+{
+    ilist_t list;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ilist_init(&list, offsetof(line, link)));
+
+    line* l1 = line_create(1);
+    line* l2 = line_create(2);
+    line* l3 = line_create(3);
+    line* l4 = line_create(4);
+    line* l5 = line_create(5);
+
+    ilist_push_back(&list, &l3->link);
+
+    /* insert before the head. */
+    ilist_insert(&list, &l3->link, &l1->link);
+    EXPECT_EQ(&l1->link, list.head);
+
+    /* append after the tail. */
+    ilist_append(&list, &l3->link, &l5->link);
+    EXPECT_EQ(&l5->link, list.tail);
+
+    /* insert and append in the middle. */
+    ilist_insert(&list, &l3->link, &l2->link);
+    ilist_append(&list, &l3->link, &l4->link);
+    EXPECT_EQ(5U, list.size);
+
+    /* the list is in order forwards and backwards. */
+    int expected = 1;
+    for (ilist_node_t* i = list.head; i != NULL; i = i->next)
+        EXPECT_EQ(expected++, line_val(i));
+    EXPECT_EQ(6, expected);
+    for (ilist_node_t* i = list.tail; i != NULL; i = i->prev)
+        EXPECT_EQ(--expected, line_val(i));
+    EXPECT_EQ(1, expected);
+
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(5, line_disposer_mock_count);
+}
+
+/**
+ * remove unlinks the head, tail, and middle nodes.
+ */
+TEST(ilist, remove)
+{
+    ilist_t list;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ilist_init(&list, offsetof(line, link)));
+
+    line* l1 = line_create(1);
+    line* l2 = line_create(2);
+    line* l3 = line_create(3);
+    line* l4 = line_create(4);
+    ilist_push_back(&list, &l1->link);
+    ilist_push_back(&list, &l2->link);
+    ilist_push_back(&list, &l3->link);
+    ilist_push_back(&list, &l4->link);
+
+    /* remove from the middle. */
+    ilist_remove(&list, &l2->link);
+    EXPECT_EQ(3U, list.size);
+    EXPECT_EQ(&l3->link, l1->link.next);
+    EXPECT_EQ(&l1->link, l3->link.prev);
+
+    /* remove the head. */
+    ilist_remove(&list, &l1->link);
+    EXPECT_EQ(&l3->link, list.head);
+    EXPECT_EQ(nullptr, list.head->prev);
+
+    /* remove the tail. */
+    ilist_remove(&list, &l4->link);
+    EXPECT_EQ(&l3->link, list.tail);
+    EXPECT_EQ(nullptr, list.tail->next);
+
+    /* remove the last node. */
+    ilist_remove(&list, &l3->link);
+    EXPECT_TRUE(PROP_VALID_ILIST_EMPTY(&list));
+
+    free(l1);
+    free(l2);
+    free(l3);
+    free(l4);
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * splice moves every node from y onto the end of x.
+ */
+TEST(ilist, splice)
+{
+    ilist_t x, y;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, ilist_init(&x, offsetof(line, link)));
+    ASSERT_EQ(0, ilist_init(&y, offsetof(line, link)));
+
+    /* splicing an empty y onto x is a no-op. */
+    ilist_splice(&x, &y);
+    EXPECT_TRUE(PROP_VALID_ILIST_EMPTY(&x));
+
+    line* l1 = line_create(1);
+    line* l2 = line_create(2);
+    line* l3 = line_create(3);
+    ilist_push_back(&y, &l1->link);
+
+    /* splicing onto an empty x takes y's nodes. */
+    ilist_splice(&x, &y);
+    EXPECT_EQ(1U, x.size);
+    EXPECT_TRUE(PROP_VALID_ILIST_EMPTY(&y));
+
+    /* splicing two non-empty lists joins them. */
+    ilist_push_back(&y, &l2->link);
+    ilist_push_back(&y, &l3->link);
+    ilist_splice(&x, &y);
+    EXPECT_EQ(3U, x.size);
+    EXPECT_TRUE(PROP_VALID_ILIST_EMPTY(&y));
+    EXPECT_EQ(1, line_val(x.head));
+    EXPECT_EQ(2, line_val(x.head->next));
+    EXPECT_EQ(3, line_val(x.tail));
+    EXPECT_EQ(&l1->link, x.tail->prev->prev);
+
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&x);
+    dispose((disposable_t*)&y);
+    EXPECT_EQ(3, line_disposer_mock_count);
+}
+
+/**
+ * split divides a list at the head, middle, and tail.
+ */
+TEST(ilist, split)
+{
+    ilist_t x, y;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, ilist_init(&x, offsetof(line, link)));
+    ASSERT_EQ(0, ilist_init(&y, offsetof(line, link)));
+
+    line* l1 = line_create(1);
+    line* l2 = line_create(2);
+    line* l3 = line_create(3);
+    line* l4 = line_create(4);
+    ilist_push_back(&x, &l1->link);
+    ilist_push_back(&x, &l2->link);
+    ilist_push_back(&x, &l3->link);
+    ilist_push_back(&x, &l4->link);
+
+    /* split in the middle. */
+    ilist_split(&x, &l3->link, &y);
+    EXPECT_EQ(2U, x.size);
+    EXPECT_EQ(2U, y.size);
+    EXPECT_EQ(&l2->link, x.tail);
+    EXPECT_EQ(nullptr, x.tail->next);
+    EXPECT_EQ(&l3->link, y.head);
+    EXPECT_EQ(nullptr, y.head->prev);
+    EXPECT_EQ(&l4->link, y.tail);
+    ilist_splice(&x, &y);
+
+    /* split at the tail. */
+    ilist_split(&x, &l4->link, &y);
+    EXPECT_EQ(3U, x.size);
+    EXPECT_EQ(1U, y.size);
+    EXPECT_EQ(y.head, y.tail);
+    ilist_splice(&x, &y);
+
+    /* split at the head. */
+    ilist_split(&x, &l1->link, &y);
+    EXPECT_TRUE(PROP_VALID_ILIST_EMPTY(&x));
+    EXPECT_EQ(4U, y.size);
+    EXPECT_EQ(&l1->link, y.head);
+    EXPECT_EQ(&l4->link, y.tail);
+
+    line_disposer_mock_count = 0;
+    dispose((disposable_t*)&x);
+    dispose((disposable_t*)&y);
+    EXPECT_EQ(4, line_disposer_mock_count);
+}
+
+static line* line_create(int val)
+{
+    line* ret = (line*)malloc(sizeof(line));
+    memset(ret, 0, sizeof(line));
+
+    ret->hdr.dispose = &line_disposer_mock;
+    ret->val = val;
+
+    return ret;
+}
+
+static int line_val(ilist_node_t* node)
+{
+    return ILIST_ENTRY(node, line, link)->val;
+}
+
+static void line_disposer_mock(disposable_t*)
+{
+    ++line_disposer_mock_count;
+}
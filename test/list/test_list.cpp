@@ -7,6 +7,7 @@
 
 #include <ej/list.h>
 #include <gtest/gtest.h>
+#include <vector>
 
 struct foo
 {
@@ -20,6 +21,9 @@ static void foo_disposer_mock(disposable_t* disp);
 static void foo_disposer_mock_clear();
 static bool foo_disposer_mock_called;
 static disposable_t* foo_disposer_mock_param_disp;
+static int foo_disposer_mock_count;
+static list_node_t* list_node_at(list_t* list, size_t index);
+static std::vector<int> list_values(list_t* list);
 
 /**
  * A list can be initialized as an empty list.
@@ -39,6 +43,10 @@ TEST(list, init)
 
     /* the size should be 0. */
     EXPECT_EQ(0U, list.size);
+
+    /* nodes and data use the system allocator. */
+    EXPECT_EQ(allocator_system(), list.node_alloc);
+    EXPECT_EQ(allocator_system(), list.data_alloc);
 }
 
 /**
@@ -1258,6 +1266,478 @@ TEST(list, split_multi_middle)
     dispose((disposable_t*)&list2);
 }
 
+/**
+ * Test that split computes sizes correctly near either end of a long list.
+ */
+TEST(list, split_counts_from_nearer_end)
+{
+    const size_t count = 50;
+
+    for (size_t at = 0; at < count; ++at)
+    {
+        list_t list1, list2;
+
+        /* initialize the lists. */
+        ASSERT_EQ(0, list_init(&list1));
+        ASSERT_EQ(0, list_init(&list2));
+
+        for (size_t i = 0; i < count; ++i)
+            ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)foo_create(i)));
+
+        /* find the node at the split position. */
+        list_node_t* node = list1.head;
+        for (size_t i = 0; i < at; ++i)
+            node = node->next;
+
+        /* split the list on this node. */
+        list_split(&list1, node, &list2);
+
+        /* the sizes reflect the split position. */
+        EXPECT_EQ(at, list1.size);
+        EXPECT_EQ(count - at, list2.size);
+        EXPECT_TRUE(PROP_VALID_LIST(&list1));
+        EXPECT_TRUE(PROP_VALID_LIST_NOT_EMPTY(&list2));
+        EXPECT_EQ(node, list2.head);
+        EXPECT_EQ(nullptr, list2.head->prev);
+        if (list1.tail)
+            EXPECT_EQ(nullptr, list1.tail->next);
+
+        /* the lists can be disposed. */
+        dispose((disposable_t*)&list1);
+        dispose((disposable_t*)&list2);
+    }
+}
+
+/**
+ * Test that split_at splits a list using a caller-supplied index.
+ */
+TEST(list, split_at)
+{
+    list_t list1, list2;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, list_init(&list1));
+    ASSERT_EQ(0, list_init(&list2));
+
+    /* create foo objects to place on the list. */
+    foo* f1 = foo_create(1);
+    foo* f2 = foo_create(2);
+    foo* f3 = foo_create(3);
+    foo* f4 = foo_create(4);
+
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f1));
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f2));
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f3));
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f4));
+
+    /* split on f3, which is at index 2. */
+    list_split_at(&list1, list1.tail->prev, 2, &list2);
+
+    /* list1 contains f1 and f2. */
+    EXPECT_TRUE(PROP_VALID_LIST_NOT_EMPTY(&list1));
+    EXPECT_EQ(2U, list1.size);
+    ASSERT_EQ((disposable_t*)f1, list1.head->data);
+    ASSERT_EQ((disposable_t*)f2, list1.tail->data);
+    ASSERT_EQ(nullptr, list1.tail->next);
+
+    /* list2 contains f3 and f4. */
+    EXPECT_TRUE(PROP_VALID_LIST_NOT_EMPTY(&list2));
+    EXPECT_EQ(2U, list2.size);
+    ASSERT_EQ((disposable_t*)f3, list2.head->data);
+    ASSERT_EQ(nullptr, list2.head->prev);
+    ASSERT_EQ((disposable_t*)f4, list2.tail->data);
+
+    /* splice them back and split at the head. */
+    list_splice(&list1, &list2);
+    list_split_at(&list1, list1.head, 0, &list2);
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list1));
+    EXPECT_EQ(4U, list2.size);
+
+    /* the lists can be disposed, which will dispose and free each pointer. */
+    dispose((disposable_t*)&list1);
+    dispose((disposable_t*)&list2);
+}
+
+/**
+ * Test that push_back_many appends an array of values in order.
+ */
+TEST(list, push_back_many)
+{
+    list_t list;
+    disposable_t* items[5];
+
+    /* initialize the list. */
+    ASSERT_EQ(0, list_init(&list));
+
+    /* pushing nothing is a no-op. */
+    ASSERT_EQ(0, list_push_back_many(&list, nullptr, 0));
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list));
+
+    /* push onto an empty list. */
+    for (int i = 0; i < 3; ++i)
+        items[i] = (disposable_t*)foo_create(i);
+    ASSERT_EQ(0, list_push_back_many(&list, items, 3));
+    EXPECT_EQ(std::vector<int>({0, 1, 2}), list_values(&list));
+
+    /* push onto a non-empty list. */
+    for (int i = 0; i < 5; ++i)
+        items[i] = (disposable_t*)foo_create(3 + i);
+    ASSERT_EQ(0, list_push_back_many(&list, items, 5));
+    EXPECT_EQ(
+        std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}), list_values(&list));
+
+    /* the list owns every value. */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(8, foo_disposer_mock_count);
+}
+
+/**
+ * Test that push_back_many carves a pooled batch from one slab.
+ */
+TEST(list, push_back_many_pool)
+{
+    pool_t pool;
+    list_t list;
+    const int count = 100;
+    disposable_t* items[count];
+
+    /* initialize a pool with small slabs. */
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 8));
+    ASSERT_EQ(0, list_init_pool(&list, &pool));
+
+    for (int i = 0; i < count; ++i)
+        items[i] = (disposable_t*)foo_create(i);
+    ASSERT_EQ(0, list_push_back_many(&list, items, count));
+
+    /* the whole batch came from a single slab. */
+    EXPECT_EQ(1U, pool.slab_count);
+    EXPECT_EQ((size_t)count, pool.live_count);
+
+    /* the nodes are laid out contiguously. */
+    int i = 0;
+    for (list_node_t* node = list.head; node != NULL; node = node->next, ++i)
+    {
+        EXPECT_EQ(i, ((foo*)node->data)->val);
+        EXPECT_EQ(
+            (unsigned char*)list.head + i * pool.object_size,
+            (unsigned char*)node);
+    }
+    EXPECT_EQ(count, i);
+
+    /* a later batch is contiguous too, even with recycled nodes about. */
+    disposable_t* popped[3];
+    for (int j = 0; j < 3; ++j)
+        ASSERT_EQ(0, list_pop_back(&list, &popped[j]));
+    EXPECT_EQ(3U, pool.free_count);
+    ASSERT_EQ(0, list_push_back_many(&list, popped, 3));
+    EXPECT_EQ(3U, pool.free_count);
+    EXPECT_EQ(
+        (unsigned char*)list.tail->prev->prev + 2 * pool.object_size,
+        (unsigned char*)list.tail);
+
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(0U, pool.live_count);
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Test that remove_range cuts runs from the head, middle, and tail.
+ */
+TEST(list, remove_range)
+{
+    list_t list, removed;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, list_init(&list));
+    ASSERT_EQ(0, list_init(&removed));
+
+    for (int i = 0; i < 10; ++i)
+        ASSERT_EQ(0, list_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* remove 3 through 5 from the middle. */
+    list_node_t* first = list_node_at(&list, 3);
+    list_node_t* last = list_node_at(&list, 5);
+    list_remove_range(&list, first, last, 3, &removed);
+
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 6, 7, 8, 9}), list_values(&list));
+    EXPECT_EQ(std::vector<int>({3, 4, 5}), list_values(&removed));
+    EXPECT_EQ(7U, list.size);
+    EXPECT_EQ(3U, removed.size);
+    EXPECT_EQ(nullptr, removed.head->prev);
+    EXPECT_EQ(nullptr, removed.tail->next);
+
+    /* disposing the removed run disposes only its values. */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&removed);
+    EXPECT_EQ(3, foo_disposer_mock_count);
+
+    /* remove the head run. */
+    ASSERT_EQ(0, list_init(&removed));
+    list_remove_range(&list, list.head, list.head->next, 2, &removed);
+    EXPECT_EQ(std::vector<int>({2, 6, 7, 8, 9}), list_values(&list));
+    EXPECT_EQ(nullptr, list.head->prev);
+    dispose((disposable_t*)&removed);
+
+    /* remove the tail run. */
+    ASSERT_EQ(0, list_init(&removed));
+    list_remove_range(&list, list.tail->prev, list.tail, 2, &removed);
+    EXPECT_EQ(std::vector<int>({2, 6, 7}), list_values(&list));
+    EXPECT_EQ(nullptr, list.tail->next);
+    dispose((disposable_t*)&removed);
+
+    /* remove everything. */
+    ASSERT_EQ(0, list_init(&removed));
+    list_remove_range(&list, list.head, list.tail, 3, &removed);
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list));
+    EXPECT_EQ(std::vector<int>({2, 6, 7}), list_values(&removed));
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&removed);
+}
+
+/**
+ * Test that move_range relinks a run within a list.
+ */
+TEST(list, move_range)
+{
+    list_t list;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, list_init(&list));
+
+    for (int i = 0; i < 6; ++i)
+        ASSERT_EQ(0, list_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* move 1 through 2 after 4. */
+    list_move_range(
+        &list, list_node_at(&list, 1), list_node_at(&list, 2),
+        list_node_at(&list, 4));
+    EXPECT_EQ(std::vector<int>({0, 3, 4, 1, 2, 5}), list_values(&list));
+
+    /* move 2 through 5 to the front. */
+    list_move_range(&list, list_node_at(&list, 4), list.tail, nullptr);
+    EXPECT_EQ(std::vector<int>({2, 5, 0, 3, 4, 1}), list_values(&list));
+    EXPECT_EQ(nullptr, list.head->prev);
+
+    /* move 2 through 5 after the tail. */
+    list_move_range(&list, list.head, list.head->next, list.tail);
+    EXPECT_EQ(std::vector<int>({0, 3, 4, 1, 2, 5}), list_values(&list));
+    EXPECT_EQ(nullptr, list.tail->next);
+
+    /* moving a run to where it already is does nothing. */
+    list_move_range(
+        &list, list_node_at(&list, 2), list_node_at(&list, 3),
+        list_node_at(&list, 1));
+    EXPECT_EQ(std::vector<int>({0, 3, 4, 1, 2, 5}), list_values(&list));
+
+    /* the size is unchanged. */
+    EXPECT_EQ(6U, list.size);
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * Test that insert_list weaves one list into another.
+ */
+TEST(list, insert_list)
+{
+    list_t list, other;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, list_init(&list));
+    ASSERT_EQ(0, list_init(&other));
+
+    /* inserting an empty list does nothing. */
+    list_insert_list(&list, nullptr, &other);
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list));
+
+    /* inserting into an empty list takes the other list. */
+    ASSERT_EQ(0, list_push_back(&other, (disposable_t*)foo_create(1)));
+    ASSERT_EQ(0, list_push_back(&other, (disposable_t*)foo_create(4)));
+    list_insert_list(&list, nullptr, &other);
+    EXPECT_EQ(std::vector<int>({1, 4}), list_values(&list));
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&other));
+
+    /* insert in the middle. */
+    ASSERT_EQ(0, list_push_back(&other, (disposable_t*)foo_create(2)));
+    ASSERT_EQ(0, list_push_back(&other, (disposable_t*)foo_create(3)));
+    list_insert_list(&list, list.tail, &other);
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), list_values(&list));
+
+    /* insert before the head. */
+    ASSERT_EQ(0, list_push_back(&other, (disposable_t*)foo_create(0)));
+    list_insert_list(&list, list.head, &other);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), list_values(&list));
+    EXPECT_EQ(nullptr, list.head->prev);
+
+    /* append at the end. */
+    ASSERT_EQ(0, list_push_back(&other, (disposable_t*)foo_create(5)));
+    list_insert_list(&list, nullptr, &other);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5}), list_values(&list));
+    EXPECT_EQ(nullptr, list.tail->next);
+    EXPECT_EQ(6U, list.size);
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&other));
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&other);
+}
+
+/**
+ * A list can be initialized with a node pool.
+ */
+TEST(list, init_pool)
+{
+    list_t list;
+    pool_t pool;
+
+    /* initialize the pool. */
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 16));
+
+    memset(&list, 0xFE, sizeof(list));
+
+    /* initialize the list. */
+    ASSERT_EQ(0, list_init_pool(&list, &pool));
+
+    /* the list is empty and uses our pool for nodes. */
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list));
+    EXPECT_EQ(&pool.alloc, list.node_alloc);
+    EXPECT_EQ(allocator_system(), list.data_alloc);
+
+    /* the list can be disposed. */
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * A pool that is too small to hold list nodes is rejected.
+ */
+TEST(list, init_pool_too_small)
+{
+    list_t list;
+    pool_t pool;
+
+    /* initialize a pool that cannot hold a list node. */
+    ASSERT_EQ(0, pool_init(&pool, sizeof(void*), 16));
+
+    /* initializing the list fails. */
+    EXPECT_NE(0, list_init_pool(&list, &pool));
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Pooled lists draw nodes from the pool and recycle them on pop and remove.
+ */
+TEST(list, pool_recycles_nodes)
+{
+    list_t list;
+    pool_t pool;
+
+    /* initialize the pool and list. */
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 16));
+    ASSERT_EQ(0, list_init_pool(&list, &pool));
+
+    /* create foo objects to place on the list. */
+    foo* f1 = foo_create(1);
+    foo* f2 = foo_create(2);
+    foo* f3 = foo_create(3);
+    foo* f4 = foo_create(4);
+
+    /* each push draws a node from the pool. */
+    ASSERT_EQ(0, list_push_back(&list, (disposable_t*)f1));
+    ASSERT_EQ(0, list_push_front(&list, (disposable_t*)f2));
+    ASSERT_EQ(0, list_insert(&list, list.tail, (disposable_t*)f3));
+    ASSERT_EQ(0, list_append(&list, list.head, (disposable_t*)f4));
+    EXPECT_EQ(4U, list.size);
+    EXPECT_EQ(4U, pool.live_count);
+    EXPECT_EQ(1U, pool.slab_count);
+
+    /* the list order is f2, f4, f3, f1. */
+    ASSERT_EQ((disposable_t*)f2, list.head->data);
+    ASSERT_EQ((disposable_t*)f4, list.head->next->data);
+    ASSERT_EQ((disposable_t*)f3, list.head->next->next->data);
+    ASSERT_EQ((disposable_t*)f1, list.tail->data);
+
+    /* popping and removing return nodes to the pool. */
+    list_node_t* removed_node = list.head->next;
+    foo* fa = nullptr;
+    ASSERT_EQ(0, list_pop_front(&list, (disposable_t**)&fa));
+    EXPECT_EQ(f2, fa);
+    foo* fb = nullptr;
+    ASSERT_EQ(0, list_remove(&list, removed_node, (disposable_t**)&fb));
+    EXPECT_EQ(f4, fb);
+    foo* fc = nullptr;
+    ASSERT_EQ(0, list_pop_back(&list, (disposable_t**)&fc));
+    EXPECT_EQ(f1, fc);
+    EXPECT_EQ(1U, list.size);
+    EXPECT_EQ(1U, pool.live_count);
+
+    /* the most recently recycled node is reused by the next push. */
+    list_node_t* recycled = (list_node_t*)pool.free_list;
+    ASSERT_EQ(0, list_push_back(&list, (disposable_t*)fc));
+    EXPECT_EQ(recycled, list.tail);
+    EXPECT_EQ(2U, pool.live_count);
+
+    /* clean up the popped values. */
+    free(fa);
+    free(fb);
+
+    /* disposing the list returns the remaining nodes to the pool. */
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(0U, pool.live_count);
+
+    /* disposing the pool releases the slab. */
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Lists sharing a pool can be split and spliced.
+ */
+TEST(list, pool_split_splice)
+{
+    list_t list1, list2;
+    pool_t pool;
+
+    /* initialize the pool and lists. */
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 2));
+    ASSERT_EQ(0, list_init_pool(&list1, &pool));
+    ASSERT_EQ(0, list_init_pool(&list2, &pool));
+
+    /* create foo objects to place on the list. */
+    foo* f1 = foo_create(1);
+    foo* f2 = foo_create(2);
+    foo* f3 = foo_create(3);
+
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f1));
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f2));
+    ASSERT_EQ(0, list_push_back(&list1, (disposable_t*)f3));
+
+    /* three nodes across two slabs. */
+    EXPECT_EQ(3U, pool.live_count);
+    EXPECT_EQ(2U, pool.slab_count);
+
+    /* split the list in the middle. */
+    list_split(&list1, list1.head->next, &list2);
+    EXPECT_EQ(1U, list1.size);
+    EXPECT_EQ(2U, list2.size);
+
+    /* splice it back together. */
+    list_splice(&list1, &list2);
+    EXPECT_EQ(3U, list1.size);
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list2));
+    ASSERT_EQ((disposable_t*)f1, list1.head->data);
+    ASSERT_EQ((disposable_t*)f2, list1.head->next->data);
+    ASSERT_EQ((disposable_t*)f3, list1.tail->data);
+
+    /* the lists can be disposed, returning all nodes to the pool. */
+    dispose((disposable_t*)&list1);
+    dispose((disposable_t*)&list2);
+    EXPECT_EQ(0U, pool.live_count);
+
+    dispose((disposable_t*)&pool);
+}
+
 static foo* foo_create(int val)
 {
     foo* ret = (foo*)malloc(sizeof(foo));
@@ -1271,6 +1751,7 @@ static foo* foo_create(int val)
 
 static void foo_disposer_mock(disposable_t* disp)
 {
+    ++foo_disposer_mock_count;
     foo_disposer_mock_called = true;
     foo_disposer_mock_param_disp = disp;
 }
@@ -1280,3 +1761,31 @@ static void foo_disposer_mock_clear()
     foo_disposer_mock_called = false;
     foo_disposer_mock_param_disp = nullptr;
 }
+
+static list_node_t* list_node_at(list_t* list, size_t index)
+{
+    list_node_t* node = list->head;
+
+    while (index--)
+        node = node->next;
+
+    return node;
+}
+
+static std::vector<int> list_values(list_t* list)
+{
+    std::vector<int> values;
+
+    /* walk forward, checking the back links along the way. */
+    list_node_t* prev = nullptr;
+    for (list_node_t* i = list->head; i != NULL; i = i->next)
+    {
+        EXPECT_EQ(prev, i->prev);
+        values.push_back(((foo*)i->data)->val);
+        prev = i;
+    }
+    EXPECT_EQ(prev, list->tail);
+    EXPECT_EQ(values.size(), list->size);
+
+    return values;
+}
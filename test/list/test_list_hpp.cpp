@@ -0,0 +1,293 @@
+/**
+ * \brief Unit tests for the typed C++ list wrapper.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <algorithm>
+#include <ej/arena.h>
+#include <ej/list.hpp>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+struct line
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static line* line_create(int val);
+static void line_disposer_mock(disposable_t* disp);
+static void ej_dispose(line* value);
+static int line_disposer_mock_count;
+static int line_dispose_count;
+static int line_static_disposer_count;
+
+/**
+ * A disposer that is called directly rather than through hdr.dispose.
+ */
+struct line_static_disposer
+{
+    void operator()(line*) const noexcept
+    {
+        ++line_static_disposer_count;
+    }
+};
+
+typedef ej::list<line> line_list;
+
+/**
+ * An ej::list starts empty and disposes its values when destroyed.
+ */
+TEST(list_hpp, raii)
+{
+    line_dispose_count = 0;
+
+    {
+        line_list list;
+
+        /* the list starts empty. */
+        EXPECT_TRUE(list.empty());
+        EXPECT_EQ(0U, list.size());
+        EXPECT_TRUE(list.begin() == list.end());
+
+        list.push_back(line_create(1));
+        list.push_back(line_create(2));
+        list.push_front(line_create(0));
+
+        EXPECT_EQ(3U, list.size());
+        EXPECT_EQ(0, list.front().val);
+        EXPECT_EQ(2, list.back().val);
+    }
+
+    /* every value was disposed by a direct call to ej_dispose. */
+    EXPECT_EQ(3, line_dispose_count);
+}
+
+/**
+ * The hdr_disposer dispatches through the value's dispose method.
+ */
+TEST(list_hpp, hdr_disposer)
+{
+    line_disposer_mock_count = 0;
+    line_dispose_count = 0;
+
+    {
+        ej::list<line, ej::hdr_disposer<line>> list;
+
+        for (int i = 0; i < 4; ++i)
+            list.push_back(line_create(i));
+    }
+
+    EXPECT_EQ(4, line_disposer_mock_count);
+    EXPECT_EQ(0, line_dispose_count);
+}
+
+/**
+ * The Disposer is called directly instead of the value's dispose method.
+ */
+TEST(list_hpp, static_disposer)
+{
+    line_dispose_count = 0;
+    line_static_disposer_count = 0;
+
+    {
+        ej::list<line, line_static_disposer> list;
+
+        for (int i = 0; i < 5; ++i)
+            list.push_back(line_create(i));
+    }
+
+    EXPECT_EQ(5, line_static_disposer_count);
+    EXPECT_EQ(0, line_dispose_count);
+}
+
+/**
+ * Iterators are bidirectional and work with standard algorithms.
+ */
+TEST(list_hpp, iterators)
+{
+    line_list list;
+
+    for (int i = 0; i < 10; ++i)
+        list.push_back(line_create(i));
+
+    /* forward traversal. */
+    int expected = 0;
+    for (line& l : list)
+        EXPECT_EQ(expected++, l.val);
+
+    /* backward traversal starting from end(). */
+    std::vector<int> reversed;
+    for (auto i = list.end(); i != list.begin(); )
+    {
+        --i;
+        reversed.push_back(i->val);
+    }
+    EXPECT_EQ(std::vector<int>({9, 8, 7, 6, 5, 4, 3, 2, 1, 0}), reversed);
+
+    /* standard algorithms work over the values. */
+    const line_list& clist = list;
+    EXPECT_EQ(
+        45,
+        std::accumulate(
+            clist.begin(), clist.end(), 0,
+            [](int sum, const line& l) { return sum + l.val; }));
+
+    auto found =
+        std::find_if(
+            list.begin(), list.end(), [](const line& l) { return 7 == l.val; });
+    ASSERT_NE(list.end(), found);
+    EXPECT_EQ(7, found->val);
+
+    std::reverse(list.begin(), list.end());
+    EXPECT_EQ(0, list.back().val);
+    EXPECT_EQ(9, list.front().val);
+
+    /* iterators convert to const iterators. */
+    line_list::const_iterator ci = list.begin();
+    EXPECT_EQ(9, ci->val);
+}
+
+/**
+ * Moving a list transfers its values and leaves the source empty.
+ */
+TEST(list_hpp, move)
+{
+    line_dispose_count = 0;
+
+    {
+        line_list a;
+        a.push_back(line_create(1));
+        a.push_back(line_create(2));
+
+        /* move construction. */
+        line_list b(std::move(a));
+        EXPECT_TRUE(a.empty());
+        EXPECT_EQ(2U, b.size());
+        EXPECT_TRUE(PROP_VALID_LIST_EMPTY(a.native()));
+
+        /* move assignment disposes the target's old values. */
+        line_list c;
+        c.push_back(line_create(3));
+        c = std::move(b);
+        EXPECT_EQ(1, line_dispose_count);
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(2U, c.size());
+        EXPECT_EQ(1, c.front().val);
+    }
+
+    EXPECT_EQ(3, line_dispose_count);
+}
+
+/**
+ * insert, erase, pop and splice keep the list consistent.
+ */
+TEST(list_hpp, modifiers)
+{
+    line_dispose_count = 0;
+
+    line_list list;
+    list.push_back(line_create(1));
+    list.push_back(line_create(3));
+
+    /* insert in the middle and at the end. */
+    auto i = list.insert(++list.begin(), line_create(2));
+    EXPECT_EQ(2, i->val);
+    i = list.insert(list.end(), line_create(4));
+    EXPECT_EQ(4, i->val);
+    EXPECT_EQ(4U, list.size());
+
+    /* erase disposes the value and returns the next position. */
+    i = list.erase(list.begin());
+    EXPECT_EQ(2, i->val);
+    EXPECT_EQ(1, line_dispose_count);
+
+    /* popping transfers ownership. */
+    line* back = list.pop_back();
+    ASSERT_NE(nullptr, back);
+    EXPECT_EQ(4, back->val);
+    free(back);
+
+    /* splice moves every value from the other list. */
+    line_list other;
+    other.push_back(line_create(5));
+    list.splice(other);
+    EXPECT_TRUE(other.empty());
+
+    std::vector<int> values;
+    for (const line& l : list)
+        values.push_back(l.val);
+    EXPECT_EQ(std::vector<int>({2, 3, 5}), values);
+
+    /* popping an empty list returns nullptr. */
+    EXPECT_EQ(nullptr, other.pop_front());
+}
+
+/**
+ * A pooled ej::list returns its nodes to the pool.
+ */
+TEST(list_hpp, pool)
+{
+    pool_t pool;
+
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 16));
+
+    {
+        line_list list(&pool);
+        for (int i = 0; i < 20; ++i)
+            list.push_back(line_create(i));
+        EXPECT_EQ(20U, pool.live_count);
+    }
+
+    EXPECT_EQ(0U, pool.live_count);
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * A list built on an allocator uses it for its nodes.
+ */
+TEST(list_hpp, allocator)
+{
+    arena_t arena;
+
+    ASSERT_EQ(0, arena_init(&arena, 1024));
+
+    {
+        line_list list(&arena.alloc);
+        list.push_back(
+            new (allocator_allocate_tagged(
+                &arena.alloc, sizeof(line), ALLOCATOR_TAG_LIST_DATA)) line());
+        EXPECT_EQ(&arena.alloc, list.native()->node_alloc);
+        EXPECT_EQ(
+            1U,
+            allocator_stats(&arena.alloc)->tag_live_count[
+                ALLOCATOR_TAG_LIST_NODE]);
+    }
+
+    dispose((disposable_t*)&arena);
+}
+
+static line* line_create(int val)
+{
+    line* ret = (line*)malloc(sizeof(line));
+
+    ret->hdr.dispose = &line_disposer_mock;
+    ret->val = val;
+
+    return ret;
+}
+
+static void line_disposer_mock(disposable_t*)
+{
+    ++line_disposer_mock_count;
+}
+
+static void ej_dispose(line*)
+{
+    ++line_dispose_count;
+}
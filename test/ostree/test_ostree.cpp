@@ -0,0 +1,367 @@
+/**
+ * \brief Unit tests for the order statistic tree.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/ostree.h>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+struct foo
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static foo* foo_create(int val);
+static void foo_disposer_mock(disposable_t* disp);
+static int foo_disposer_mock_count;
+static std::vector<int> ostree_values(const ostree_t* tree);
+static int collect_visitor(void* context, size_t index, disposable_t* data);
+static int index_visitor(void* context, size_t index, disposable_t* data);
+static size_t ostree_height(const ostree_node_t* node);
+static bool ostree_node_valid(const ostree_node_t* node);
+
+/**
+ * A tree can be initialized as an empty tree.
+ */
+TEST(ostree, init)
+{
+    ostree_t tree;
+
+    memset(&tree, 0xFE, sizeof(tree));
+
+    /* initialize the tree. */
+    ASSERT_EQ(0, ostree_init(&tree));
+
+    /* the tree is empty. */
+    EXPECT_TRUE(PROP_VALID_OSTREE_EMPTY(&tree));
+    EXPECT_EQ(0U, ostree_size(&tree));
+
+    /* the tree can be disposed. */
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * Values can be appended and found by position.
+ */
+TEST(ostree, push_back_at)
+{
+    ostree_t tree;
+    disposable_t* data;
+
+    /* initialize the tree. */
+    ASSERT_EQ(0, ostree_init(&tree));
+
+    /* an empty tree has no values. */
+    EXPECT_NE(0, ostree_at(&tree, 0, &data));
+    EXPECT_EQ(nullptr, data);
+
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(0, ostree_push_back(&tree, (disposable_t*)foo_create(i)));
+
+    EXPECT_EQ(1000U, ostree_size(&tree));
+
+    /* every position maps to its value. */
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(0, ostree_at(&tree, i, &data));
+        EXPECT_EQ((int)i, ((foo*)data)->val);
+    }
+
+    /* a position past the end is rejected. */
+    EXPECT_NE(0, ostree_at(&tree, 1000, &data));
+
+    /* disposing the tree disposes every value. */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&tree);
+    EXPECT_EQ(1000, foo_disposer_mock_count);
+}
+
+/**
+ * Sequential appends keep the tree balanced.
+ */
+TEST(ostree, balanced)
+{
+    ostree_t tree;
+
+    /* initialize the tree. */
+    ASSERT_EQ(0, ostree_init(&tree));
+
+    for (int i = 0; i < 100000; ++i)
+        ASSERT_EQ(0, ostree_push_back(&tree, (disposable_t*)foo_create(i)));
+
+    /* the height is logarithmic rather than linear. */
+    EXPECT_LT(ostree_height(tree.root), 64U);
+    EXPECT_TRUE(ostree_node_valid(tree.root));
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * Insertion past the end is rejected.
+ */
+TEST(ostree, insert_out_of_bounds)
+{
+    ostree_t tree;
+
+    /* initialize the tree. */
+    ASSERT_EQ(0, ostree_init(&tree));
+
+    foo* f = foo_create(1);
+    EXPECT_NE(0, ostree_insert(&tree, 1, (disposable_t*)f));
+    EXPECT_EQ(0U, ostree_size(&tree));
+    free(f);
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * A mix of inserts and removes matches a reference vector.
+ */
+TEST(ostree, matches_reference)
+{
+    ostree_t tree;
+    disposable_t* data;
+    std::vector<int> reference;
+    unsigned int seed = 4321;
+
+    /* initialize the tree. */
+    ASSERT_EQ(0, ostree_init(&tree));
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        unsigned int op = (seed >> 16) % 3;
+
+        if (reference.empty() || op < 2)
+        {
+            size_t index = (seed >> 4) % (reference.size() + 1);
+            ASSERT_EQ(
+                0, ostree_insert(&tree, index, (disposable_t*)foo_create(i)));
+            reference.insert(reference.begin() + index, i);
+        }
+        else
+        {
+            size_t index = (seed >> 4) % reference.size();
+            ASSERT_EQ(0, ostree_remove(&tree, index, &data));
+            EXPECT_EQ(reference[index], ((foo*)data)->val);
+            free(data);
+            reference.erase(reference.begin() + index);
+        }
+    }
+
+    /* the tree matches the reference. */
+    EXPECT_EQ(reference.size(), ostree_size(&tree));
+    EXPECT_EQ(reference, ostree_values(&tree));
+    EXPECT_TRUE(ostree_node_valid(tree.root));
+
+    /* removing past the end is rejected. */
+    EXPECT_NE(0, ostree_remove(&tree, reference.size(), &data));
+    EXPECT_EQ(nullptr, data);
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * split and splice divide and rejoin a tree at any position.
+ */
+TEST(ostree, split_splice)
+{
+    const size_t count = 100;
+
+    for (size_t at = 0; at <= count + 1; at += 9)
+    {
+        ostree_t x, y;
+
+        /* initialize the trees. */
+        ASSERT_EQ(0, ostree_init(&x));
+        ASSERT_EQ(0, ostree_init(&y));
+
+        for (size_t i = 0; i < count; ++i)
+            ASSERT_EQ(0, ostree_push_back(&x, (disposable_t*)foo_create(i)));
+
+        /* split at the given position. */
+        ostree_split(&x, at, &y);
+        size_t expected = std::min(at, count);
+        EXPECT_EQ(expected, ostree_size(&x));
+        EXPECT_EQ(count - expected, ostree_size(&y));
+        EXPECT_TRUE(ostree_node_valid(x.root));
+        EXPECT_TRUE(ostree_node_valid(y.root));
+
+        std::vector<int> ys = ostree_values(&y);
+        for (size_t i = 0; i < ys.size(); ++i)
+            EXPECT_EQ((int)(expected + i), ys[i]);
+
+        /* splicing restores the original tree. */
+        ostree_splice(&x, &y);
+        EXPECT_TRUE(PROP_VALID_OSTREE_EMPTY(&y));
+        std::vector<int> xs = ostree_values(&x);
+        ASSERT_EQ(count, xs.size());
+        for (size_t i = 0; i < count; ++i)
+            EXPECT_EQ((int)i, xs[i]);
+
+        dispose((disposable_t*)&x);
+        dispose((disposable_t*)&y);
+    }
+}
+
+/**
+ * remove_range cuts out a contiguous range of values.
+ */
+TEST(ostree, remove_range)
+{
+    ostree_t tree, removed;
+
+    /* initialize the trees. */
+    ASSERT_EQ(0, ostree_init(&tree));
+    ASSERT_EQ(0, ostree_init(&removed));
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(0, ostree_push_back(&tree, (disposable_t*)foo_create(i)));
+
+    /* ranges past the end are rejected. */
+    EXPECT_NE(0, ostree_remove_range(&tree, 90, 11, &removed));
+    EXPECT_NE(0, ostree_remove_range(&tree, 101, 0, &removed));
+    EXPECT_EQ(100U, ostree_size(&tree));
+
+    /* remove lines 10 through 29. */
+    ASSERT_EQ(0, ostree_remove_range(&tree, 10, 20, &removed));
+    EXPECT_EQ(80U, ostree_size(&tree));
+    EXPECT_EQ(20U, ostree_size(&removed));
+
+    std::vector<int> rs = ostree_values(&removed);
+    for (int i = 0; i < 20; ++i)
+        EXPECT_EQ(10 + i, rs[i]);
+
+    disposable_t* data;
+    ASSERT_EQ(0, ostree_at(&tree, 9, &data));
+    EXPECT_EQ(9, ((foo*)data)->val);
+    ASSERT_EQ(0, ostree_at(&tree, 10, &data));
+    EXPECT_EQ(30, ((foo*)data)->val);
+
+    /* disposing the removed tree disposes only the removed values. */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&removed);
+    EXPECT_EQ(20, foo_disposer_mock_count);
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * visit walks a range of values in order and can stop early.
+ */
+TEST(ostree, visit)
+{
+    ostree_t tree;
+    std::vector<int> seen;
+
+    /* initialize the tree. */
+    ASSERT_EQ(0, ostree_init(&tree));
+
+    /* visiting an empty tree does nothing. */
+    EXPECT_EQ(0, ostree_visit(&tree, 0, 10, &collect_visitor, &seen));
+    EXPECT_TRUE(seen.empty());
+
+    for (int i = 0; i < 500; ++i)
+        ASSERT_EQ(0, ostree_push_back(&tree, (disposable_t*)foo_create(i)));
+
+    /* visit a range in the middle. */
+    EXPECT_EQ(0, ostree_visit(&tree, 123, 45, &collect_visitor, &seen));
+    ASSERT_EQ(45U, seen.size());
+    for (int i = 0; i < 45; ++i)
+        EXPECT_EQ(123 + i, seen[i]);
+
+    /* each value is visited with its position. */
+    size_t visited = 0;
+    EXPECT_EQ(0, ostree_visit(&tree, 17, 300, &index_visitor, &visited));
+    EXPECT_EQ(300U, visited);
+
+    /* a range past the end is clamped. */
+    seen.clear();
+    EXPECT_EQ(0, ostree_visit(&tree, 495, 100, &collect_visitor, &seen));
+    ASSERT_EQ(5U, seen.size());
+    EXPECT_EQ(499, seen.back());
+
+    /* the visitor can stop the visit; value 250 stops it. */
+    seen.clear();
+    EXPECT_EQ(7, ostree_visit(&tree, 200, 100, &collect_visitor, &seen));
+    ASSERT_EQ(51U, seen.size());
+    EXPECT_EQ(250, seen.back());
+
+    dispose((disposable_t*)&tree);
+}
+
+static foo* foo_create(int val)
+{
+    foo* ret = (foo*)malloc(sizeof(foo));
+    memset(ret, 0, sizeof(foo));
+
+    ret->hdr.dispose = &foo_disposer_mock;
+    ret->val = val;
+
+    return ret;
+}
+
+static void foo_disposer_mock(disposable_t*)
+{
+    ++foo_disposer_mock_count;
+}
+
+static std::vector<int> ostree_values(const ostree_t* tree)
+{
+    std::vector<int> values;
+
+    ostree_visit(tree, 0, ostree_size(tree), &collect_visitor, &values);
+
+    return values;
+}
+
+static int collect_visitor(void* context, size_t, disposable_t* data)
+{
+    std::vector<int>* values = (std::vector<int>*)context;
+
+    values->push_back(((foo*)data)->val);
+
+    return (250 == ((foo*)data)->val) ? 7 : 0;
+}
+
+static int index_visitor(void* context, size_t index, disposable_t* data)
+{
+    size_t* visited = (size_t*)context;
+
+    EXPECT_EQ((int)index, ((foo*)data)->val);
+    ++*visited;
+
+    return 0;
+}
+
+static size_t ostree_height(const ostree_node_t* node)
+{
+    if (NULL == node)
+        return 0;
+
+    return 1 + std::max(ostree_height(node->left), ostree_height(node->right));
+}
+
+static bool ostree_node_valid(const ostree_node_t* node)
+{
+    if (NULL == node)
+        return true;
+
+    size_t left = node->left ? node->left->size : 0;
+    size_t right = node->right ? node->right->size : 0;
+
+    if (node->size != 1 + left + right)
+        return false;
+    if (node->left && node->left->priority > node->priority)
+        return false;
+    if (node->right && node->right->priority > node->priority)
+        return false;
+
+    return ostree_node_valid(node->left) && ostree_node_valid(node->right);
+}
@@ -0,0 +1,304 @@
+/**
+ * \brief Unit tests for the fixed-size object pool.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/pool.h>
+#include <gtest/gtest.h>
+#include <set>
+
+/**
+ * A pool can be initialized as an empty pool.
+ */
+TEST(pool, init)
+{
+    pool_t pool;
+
+    memset(&pool, 0xFE, sizeof(pool));
+
+    /* initialize the pool. */
+    ASSERT_EQ(0, pool_init(&pool, 24, 16));
+
+    /* the pool is valid. */
+    EXPECT_TRUE(PROP_VALID_POOL(&pool));
+
+    /* no slabs have been allocated yet. */
+    EXPECT_EQ(nullptr, pool.slabs);
+    EXPECT_EQ(nullptr, pool.free_list);
+    EXPECT_EQ(0U, pool.slab_count);
+    EXPECT_EQ(0U, pool.live_count);
+
+    /* the pool can be disposed. */
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Invalid pool geometries are rejected.
+ */
+TEST(pool, init_invalid)
+{
+    pool_t pool;
+
+    /* a zero object size is rejected. */
+    EXPECT_NE(0, pool_init(&pool, 0, 16));
+
+    /* a zero slab size is rejected. */
+    EXPECT_NE(0, pool_init(&pool, 24, 0));
+
+    /* a slab that cannot fit in memory is rejected. */
+    EXPECT_NE(0, pool_init(&pool, 1024, SIZE_MAX / 512));
+}
+
+/**
+ * Object sizes are rounded up to pointer alignment.
+ */
+TEST(pool, object_size_alignment)
+{
+    pool_t pool;
+
+    /* initialize the pool with an odd object size. */
+    ASSERT_EQ(0, pool_init(&pool, 3, 4));
+
+    /* the object size is large enough for a free list link and aligned. */
+    EXPECT_EQ(sizeof(void*), pool.object_size);
+
+    /* objects are pointer aligned. */
+    void* a = pool_allocate(&pool);
+    void* b = pool_allocate(&pool);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(0U, ((uintptr_t)a) % sizeof(void*));
+    EXPECT_EQ(0U, ((uintptr_t)b) % sizeof(void*));
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Objects within a slab are contiguous, and new slabs are allocated on demand.
+ */
+TEST(pool, allocate_slabs)
+{
+    pool_t pool;
+
+    /* initialize a pool with four objects per slab. */
+    ASSERT_EQ(0, pool_init(&pool, 32, 4));
+
+    /* the first four objects come from a single contiguous slab. */
+    unsigned char* first = (unsigned char*)pool_allocate(&pool);
+    ASSERT_NE(nullptr, first);
+    for (int i = 1; i < 4; ++i)
+    {
+        unsigned char* obj = (unsigned char*)pool_allocate(&pool);
+        ASSERT_NE(nullptr, obj);
+        EXPECT_EQ(first + i * 32, obj);
+    }
+
+    /* there is one slab. */
+    EXPECT_EQ(1U, pool.slab_count);
+    EXPECT_EQ(4U, pool.live_count);
+
+    /* the fifth object requires a second slab. */
+    ASSERT_NE(nullptr, pool_allocate(&pool));
+    EXPECT_EQ(2U, pool.slab_count);
+    EXPECT_EQ(5U, pool.live_count);
+
+    /* disposing the pool releases every slab. */
+    dispose((disposable_t*)&pool);
+    EXPECT_EQ(nullptr, pool.slabs);
+    EXPECT_EQ(0U, pool.slab_count);
+}
+
+/**
+ * Released objects are recycled before new objects are carved.
+ */
+TEST(pool, release_recycles)
+{
+    pool_t pool;
+
+    /* initialize the pool. */
+    ASSERT_EQ(0, pool_init(&pool, 16, 8));
+
+    void* a = pool_allocate(&pool);
+    void* b = pool_allocate(&pool);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(2U, pool.live_count);
+
+    /* release both objects. */
+    pool_release(&pool, a);
+    pool_release(&pool, b);
+    EXPECT_EQ(0U, pool.live_count);
+
+    /* the free list is LIFO. */
+    EXPECT_EQ(b, pool_allocate(&pool));
+    EXPECT_EQ(a, pool_allocate(&pool));
+
+    /* no additional slabs were needed. */
+    EXPECT_EQ(1U, pool.slab_count);
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Every live object is distinct across several slabs.
+ */
+TEST(pool, distinct_objects)
+{
+    pool_t pool;
+    std::set<void*> seen;
+
+    /* initialize the pool. */
+    ASSERT_EQ(0, pool_init(&pool, 24, 7));
+
+    /* allocate across several slabs. */
+    for (int i = 0; i < 100; ++i)
+    {
+        void* obj = pool_allocate(&pool);
+        ASSERT_NE(nullptr, obj);
+        memset(obj, 0xA5, 24);
+        EXPECT_TRUE(seen.insert(obj).second);
+    }
+
+    EXPECT_EQ(100U, pool.live_count);
+    EXPECT_EQ(15U, pool.slab_count);
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Reserving room counts recycled objects and keeps the current slab intact.
+ */
+TEST(pool, reserve)
+{
+    pool_t pool;
+
+    /* initialize a pool with four objects per slab. */
+    ASSERT_EQ(0, pool_init(&pool, 16, 4));
+
+    /* start a slab, leaving three objects in it. */
+    unsigned char* a = (unsigned char*)pool_allocate(&pool);
+    ASSERT_NE(nullptr, a);
+    EXPECT_EQ(1U, pool.slab_count);
+
+    /* a reservation that fits in the current slab allocates nothing. */
+    ASSERT_EQ(0, pool_reserve(&pool, 3));
+    EXPECT_EQ(1U, pool.slab_count);
+
+    /* recycled objects count towards a reservation. */
+    void* b = pool_allocate(&pool);
+    ASSERT_NE(nullptr, b);
+    pool_release(&pool, b);
+    EXPECT_EQ(1U, pool.free_count);
+    ASSERT_EQ(0, pool_reserve(&pool, 3));
+    EXPECT_EQ(1U, pool.slab_count);
+
+    /* a larger reservation allocates a single spare slab for the rest. */
+    ASSERT_EQ(0, pool_reserve(&pool, 10));
+    EXPECT_EQ(2U, pool.slab_count);
+
+    /* the free list and the current slab are used first, in place. */
+    EXPECT_EQ(b, pool_allocate(&pool));
+    EXPECT_EQ(a + 32, (unsigned char*)pool_allocate(&pool));
+    EXPECT_EQ(a + 48, (unsigned char*)pool_allocate(&pool));
+
+    /* the rest of the batch is contiguous in the spare. */
+    unsigned char* first = (unsigned char*)pool_allocate(&pool);
+    ASSERT_NE(nullptr, first);
+    for (int i = 1; i < 7; ++i)
+        EXPECT_EQ(first + i * 16, (unsigned char*)pool_allocate(&pool));
+
+    /* no further slabs were needed. */
+    EXPECT_EQ(2U, pool.slab_count);
+    EXPECT_EQ(11U, pool.live_count);
+    EXPECT_EQ(0U, pool.free_count);
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * A run of objects is carved from one slab, bypassing the free list.
+ */
+TEST(pool, allocate_run)
+{
+    pool_t pool;
+
+    /* initialize a pool with four objects per slab. */
+    ASSERT_EQ(0, pool_init(&pool, 16, 4));
+
+    /* recycle one object, leaving two in the current slab. */
+    unsigned char* a = (unsigned char*)pool_allocate(&pool);
+    void* b = pool_allocate(&pool);
+    ASSERT_NE(nullptr, a);
+    pool_release(&pool, b);
+
+    /* a run which fits is carved from the current slab. */
+    unsigned char* run = (unsigned char*)pool_allocate_run(&pool, 2);
+    EXPECT_EQ(a + 32, run);
+    EXPECT_EQ(1U, pool.slab_count);
+
+    /* a longer run takes a slab of its own, and the free list is kept. */
+    run = (unsigned char*)pool_allocate_run(&pool, 6);
+    ASSERT_NE(nullptr, run);
+    EXPECT_EQ(2U, pool.slab_count);
+    EXPECT_EQ(1U, pool.free_count);
+
+    /* a short run leaves the rest of a new slab as the spare. */
+    run = (unsigned char*)pool_allocate_run(&pool, 1);
+    ASSERT_NE(nullptr, run);
+    EXPECT_EQ(3U, pool.slab_count);
+    EXPECT_EQ(run + 16, (unsigned char*)pool_allocate_run(&pool, 3));
+    EXPECT_EQ(3U, pool.slab_count);
+
+    /* each object in a run is released on its own. */
+    EXPECT_EQ(13U, pool.live_count);
+    EXPECT_EQ(13U * 16U, allocator_stats(&pool.alloc)->live_bytes);
+    pool_release(&pool, run);
+    EXPECT_EQ(12U, pool.live_count);
+    EXPECT_EQ(run, (unsigned char*)pool_allocate(&pool));
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * A pool is an allocator for requests up to its object size.
+ */
+TEST(pool, allocator)
+{
+    pool_t pool;
+    allocator_t* alloc = &pool.alloc;
+
+    /* initialize the pool. */
+    ASSERT_EQ(0, pool_init(&pool, 32, 8));
+    EXPECT_TRUE(PROP_VALID_ALLOCATOR(alloc));
+
+    /* requests up to the object size come from the pool. */
+    void* a = allocator_allocate(alloc, 32);
+    void* b = allocator_allocate(alloc, 1);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(2U, pool.live_count);
+
+    /* the pool accounts for whole objects. */
+    EXPECT_EQ(64U, allocator_stats(alloc)->live_bytes);
+    EXPECT_EQ(2U, allocator_stats(alloc)->live_count);
+
+    /* larger requests fail. */
+    EXPECT_EQ(nullptr, allocator_allocate(alloc, 33));
+    EXPECT_NE(0, allocator_reserve(alloc, 33, 1));
+    EXPECT_EQ(1U, allocator_stats(alloc)->failed_count);
+
+    /* released objects are recycled. */
+    allocator_release(alloc, a);
+    EXPECT_EQ(1U, pool.live_count);
+    EXPECT_EQ(32U, allocator_stats(alloc)->live_bytes);
+    EXPECT_EQ(a, allocator_allocate(alloc, 16));
+    EXPECT_EQ(64U, allocator_stats(alloc)->high_water_bytes);
+
+    /* reservation goes through to the pool. */
+    ASSERT_EQ(0, allocator_reserve(alloc, 32, 20));
+    EXPECT_EQ(2U, pool.slab_count);
+
+    dispose((disposable_t*)alloc);
+}
@@ -0,0 +1,278 @@
+/**
+ * \brief Unit tests for the reader and the newline scanner.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/reader.h>
+#include <ej/string.h>
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/* forward decls */
+static std::vector<size_t> scan_all(simd_level_t level, const std::string& s);
+static std::vector<std::string> read_all(reader_t* reader);
+
+/**
+ * Every SIMD level finds the same newlines, including those in the tail that
+ * doesn't fill a vector.
+ */
+TEST(reader, newline_scan_levels)
+{
+    std::string text;
+    std::vector<size_t> expected;
+
+    for (int i = 0; i < 300; ++i)
+    {
+        text.append((i * 7) % 45, 'x');
+        expected.push_back(text.size());
+        text += '\n';
+    }
+    text += "tail";
+
+    for (int level = 0; level < SIMD_LEVEL_COUNT; ++level)
+    {
+        EXPECT_EQ(expected, scan_all((simd_level_t)level, text))
+            << "level " << level;
+    }
+}
+
+/**
+ * A scan stops when the ends array is full, and can be resumed.
+ */
+TEST(reader, newline_scan_resume)
+{
+    std::string text(100, '\n');
+    size_t ends[7];
+    size_t crlf = 0U;
+
+    for (int level = 0; level < SIMD_LEVEL_COUNT; ++level)
+    {
+        size_t count =
+            newline_scan_level(
+                (simd_level_t)level, text.data(), text.size(), 0, ends, 7,
+                &crlf);
+        ASSERT_EQ(7U, count);
+        EXPECT_EQ(6U, ends[6]);
+
+        count =
+            newline_scan_level(
+                (simd_level_t)level, text.data(), text.size(), ends[6] + 1U,
+                ends, 7, &crlf);
+        ASSERT_EQ(7U, count);
+        EXPECT_EQ(7U, ends[0]);
+    }
+
+    EXPECT_EQ(0U, crlf);
+}
+
+/**
+ * CRLF line endings are counted in the same pass, and stripped from lines.
+ */
+TEST(reader, crlf)
+{
+    const char* text = "one\r\ntwo\nthree\r\n\r\nfour\r";
+    reader_t reader;
+
+    ASSERT_EQ(0, reader_init_memory(&reader, text, strlen(text)));
+
+    std::vector<std::string> lines = read_all(&reader);
+    std::vector<std::string> expected = { "one", "two", "three", "", "four\r" };
+    EXPECT_EQ(expected, lines);
+    EXPECT_TRUE(reader.valid_utf8);
+    EXPECT_EQ(5U, reader.line_count);
+    EXPECT_EQ(3U, reader.crlf_count);
+
+    dispose((disposable_t*)&reader);
+}
+
+/**
+ * Lines are returned in batches.
+ */
+TEST(reader, batches)
+{
+    std::string text;
+    for (size_t i = 0; i < 2 * READER_BATCH_LINES + 3; ++i)
+        text += std::to_string(i) + "\n";
+
+    reader_t reader;
+    reader_batch_t batch;
+
+    ASSERT_EQ(0, reader_init_memory(&reader, text.data(), text.size()));
+
+    reader_next_batch(&reader, &batch);
+    ASSERT_EQ(READER_BATCH_LINES, batch.count);
+    EXPECT_EQ("0", std::string(batch.lines[0].data, batch.lines[0].length));
+    reader_next_batch(&reader, &batch);
+    ASSERT_EQ(READER_BATCH_LINES, batch.count);
+    reader_next_batch(&reader, &batch);
+    ASSERT_EQ(3U, batch.count);
+    EXPECT_EQ(
+        std::to_string(2 * READER_BATCH_LINES + 2),
+        std::string(batch.lines[2].data, batch.lines[2].length));
+    reader_next_batch(&reader, &batch);
+    EXPECT_EQ(0U, batch.count);
+
+    dispose((disposable_t*)&reader);
+}
+
+/**
+ * Contents which are not UTF-8 can only be read in batches.
+ */
+TEST(reader, invalid_utf8)
+{
+    std::string text(100, 'a');
+    text += "\n\xc3\xa9\n\xc3\n";
+    reader_t reader;
+    list_t list;
+
+    ASSERT_EQ(0, reader_init_memory(&reader, text.data(), text.size()));
+    EXPECT_FALSE(reader.valid_utf8);
+    EXPECT_EQ(104U, reader.invalid_offset);
+
+    ASSERT_EQ(0, list_init(&list));
+    EXPECT_NE(0, reader_read_lines(&reader, &list));
+    EXPECT_EQ(0U, list.size);
+
+    /* a binary-safe caller can still read the lines. */
+    EXPECT_EQ(3U, read_all(&reader).size());
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&reader);
+}
+
+/**
+ * A range reader shares its parent's contents and validation.
+ */
+TEST(reader, range)
+{
+    std::string text = "one\ntwo\n\xc3\n\xc3\n";
+    reader_t parent, range;
+
+    ASSERT_EQ(0, reader_init_memory(&parent, text.data(), text.size()));
+    EXPECT_FALSE(parent.valid_utf8);
+    EXPECT_EQ(8U, parent.invalid_offset);
+
+    /* a range before the first error is valid. */
+    ASSERT_EQ(0, reader_init_range(&range, &parent, 4U, 4U));
+    EXPECT_TRUE(range.valid_utf8);
+    EXPECT_EQ(std::vector<std::string>({"two"}), read_all(&range));
+    dispose((disposable_t*)&range);
+
+    /* a range holding the first error reports it relative to the range. */
+    ASSERT_EQ(0, reader_init_range(&range, &parent, 4U, 6U));
+    EXPECT_FALSE(range.valid_utf8);
+    EXPECT_EQ(4U, range.invalid_offset);
+    dispose((disposable_t*)&range);
+
+    /* a range after the first error is validated again. */
+    ASSERT_EQ(0, reader_init_range(&range, &parent, 10U, 2U));
+    EXPECT_FALSE(range.valid_utf8);
+    EXPECT_EQ(0U, range.invalid_offset);
+    dispose((disposable_t*)&range);
+
+    EXPECT_NE(0, reader_init_range(&range, &parent, 10U, 3U));
+
+    /* disposing a range leaves the parent's contents alone. */
+    EXPECT_EQ(text.data(), parent.data);
+    dispose((disposable_t*)&parent);
+}
+
+/**
+ * A file is read into a list of strings.
+ */
+TEST(reader, read_file_lines)
+{
+    char path[] = "/tmp/ej_reader_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+
+    std::string text;
+    for (int i = 0; i < 1500; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    ASSERT_EQ((ssize_t)text.size(), write(fd, text.data(), text.size()));
+    close(fd);
+
+    reader_t reader;
+    list_t list;
+
+    ASSERT_EQ(0, reader_init(&reader, path));
+    ASSERT_EQ(0, list_init(&list));
+    ASSERT_EQ(0, reader_read_lines(&reader, &list));
+
+    EXPECT_EQ(1500U, list.size);
+    EXPECT_STREQ("line 0", string_data((string_t*)list.head->data));
+    EXPECT_STREQ("line 1499", string_data((string_t*)list.tail->data));
+    EXPECT_EQ(0U, reader.crlf_count);
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&reader);
+
+    /* a mapped file is read into views. */
+    ASSERT_EQ(0, reader_init_mmap(&reader, path));
+    EXPECT_TRUE(reader.mapped);
+    ASSERT_EQ(0, list_init(&list));
+    ASSERT_EQ(0, reader_read_views(&reader, &list));
+
+    EXPECT_EQ(1500U, list.size);
+    string_t* last = (string_t*)list.tail->data;
+    EXPECT_TRUE(string_is_view(last));
+    EXPECT_EQ("line 1499", std::string(string_data(last), last->length));
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&reader);
+    unlink(path);
+
+    /* a missing file can't be read. */
+    EXPECT_NE(0, reader_init(&reader, path));
+    EXPECT_NE(0, reader_init_mmap(&reader, path));
+}
+
+/**
+ * Scan the whole string a few newlines at a time.
+ */
+static std::vector<size_t> scan_all(simd_level_t level, const std::string& s)
+{
+    std::vector<size_t> found;
+    size_t ends[5];
+    size_t crlf = 0U;
+    size_t start = 0U;
+    size_t count;
+
+    do
+    {
+        count =
+            newline_scan_level(
+                level, s.data(), s.size(), start, ends, 5, &crlf);
+        found.insert(found.end(), ends, ends + count);
+        if (count > 0U)
+            start = ends[count - 1] + 1U;
+    } while (5U == count);
+
+    return found;
+}
+
+/**
+ * Read every line from a reader.
+ */
+static std::vector<std::string> read_all(reader_t* reader)
+{
+    std::vector<std::string> lines;
+    reader_batch_t batch;
+
+    for (reader_next_batch(reader, &batch); batch.count > 0U;
+         reader_next_batch(reader, &batch))
+    {
+        for (size_t i = 0U; i < batch.count; ++i)
+        {
+            lines.emplace_back(batch.lines[i].data, batch.lines[i].length);
+        }
+    }
+
+    return lines;
+}
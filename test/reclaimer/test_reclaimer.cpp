@@ -0,0 +1,266 @@
+/**
+ * \brief Unit tests for the background reclaimer.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <atomic>
+#include <ej/heap.h>
+#include <ej/reclaimer.h>
+#include <ej/string.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+struct foo
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static void buffer_fill(buffer_t* buffer, int count);
+static foo* foo_create(int val);
+static void foo_disposer_mock(disposable_t* disp);
+static std::atomic<int> foo_disposer_mock_count;
+static std::atomic<bool> foo_disposer_mock_off_thread;
+static std::thread::id foo_disposer_mock_caller;
+
+/**
+ * A reclaimer can be started and stopped without any work.
+ */
+TEST(reclaimer, init)
+{
+    reclaimer_t reclaimer;
+
+    /* initialize the reclaimer. */
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+
+    /* the reclaimer is valid and idle. */
+    EXPECT_TRUE(PROP_VALID_RECLAIMER(&reclaimer));
+    EXPECT_EQ(0U, reclaimer.pending);
+
+    /* flushing an idle reclaimer returns immediately. */
+    reclaimer_flush(&reclaimer);
+
+    /* the reclaimer can be disposed. */
+    dispose((disposable_t*)&reclaimer);
+}
+
+/**
+ * Deferred data is disposed and freed on the worker thread.
+ */
+TEST(reclaimer, defer)
+{
+    reclaimer_t reclaimer;
+
+    foo_disposer_mock_count = 0;
+    foo_disposer_mock_off_thread = true;
+    foo_disposer_mock_caller = std::this_thread::get_id();
+
+    /* initialize the reclaimer. */
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+
+    for (int i = 0; i < 10; ++i)
+        ASSERT_EQ(0, reclaimer_defer(&reclaimer, (disposable_t*)foo_create(i)));
+
+    /* after a flush, everything has been reclaimed. */
+    reclaimer_flush(&reclaimer);
+    EXPECT_EQ(10, foo_disposer_mock_count);
+    EXPECT_EQ(0U, reclaimer.pending);
+
+    /* none of it happened on this thread. */
+    EXPECT_TRUE(foo_disposer_mock_off_thread);
+
+    dispose((disposable_t*)&reclaimer);
+}
+
+/**
+ * Deferring a list empties it immediately and reclaims its values later.
+ */
+TEST(reclaimer, defer_list)
+{
+    reclaimer_t reclaimer;
+    list_t list;
+
+    foo_disposer_mock_count = 0;
+    foo_disposer_mock_off_thread = true;
+    foo_disposer_mock_caller = std::this_thread::get_id();
+
+    /* initialize the reclaimer and the list. */
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+    ASSERT_EQ(0, list_init(&list));
+
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(0, list_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* the list is emptied right away. */
+    ASSERT_EQ(0, reclaimer_defer_list(&reclaimer, &list));
+    EXPECT_TRUE(PROP_VALID_LIST_EMPTY(&list));
+
+    /* the list can be reused while its old values are reclaimed. */
+    ASSERT_EQ(0, list_push_back(&list, (disposable_t*)foo_create(7)));
+
+    reclaimer_flush(&reclaimer);
+    EXPECT_EQ(1000, foo_disposer_mock_count);
+    EXPECT_TRUE(foo_disposer_mock_off_thread);
+
+    /* deferring an empty list is a no-op. */
+    list_t empty;
+    ASSERT_EQ(0, list_init(&empty));
+    ASSERT_EQ(0, reclaimer_defer_list(&reclaimer, &empty));
+    EXPECT_EQ(0U, reclaimer.pending);
+
+    dispose((disposable_t*)&empty);
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&reclaimer);
+}
+
+/**
+ * Lists backed by a pool can't be handed to another thread.
+ */
+TEST(reclaimer, defer_list_pool)
+{
+    reclaimer_t reclaimer;
+    pool_t pool;
+    list_t list;
+
+    /* initialize the reclaimer and a pooled list. */
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+    ASSERT_EQ(0, pool_init(&pool, sizeof(list_node_t), 16));
+    ASSERT_EQ(0, list_init_pool(&list, &pool));
+    ASSERT_EQ(0, list_push_back(&list, (disposable_t*)foo_create(1)));
+
+    /* the list is rejected and left alone. */
+    EXPECT_NE(0, reclaimer_defer_list(&reclaimer, &list));
+    EXPECT_EQ(1U, list.size);
+
+    dispose((disposable_t*)&list);
+    dispose((disposable_t*)&pool);
+    dispose((disposable_t*)&reclaimer);
+}
+
+/**
+ * A large buffer is handed over whole, along with the arena it owns or the
+ * heap it allocates from, and both are released on the worker thread.
+ */
+TEST(reclaimer, defer_buffer)
+{
+    reclaimer_t reclaimer;
+    buffer_t buffer;
+
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+
+    /* an arena mode buffer brings its arena along. */
+    arena_t* arena = (arena_t*)malloc(sizeof(arena_t));
+    ASSERT_NE(nullptr, arena);
+    ASSERT_EQ(0, arena_init(arena, 65536U));
+    ASSERT_EQ(0, buffer_init_arena(&buffer, arena, NULL, NULL, NULL));
+    buffer_fill(&buffer, 100000);
+    ASSERT_EQ(0, reclaimer_defer_buffer(&reclaimer, &buffer, NULL));
+
+    /* a buffer given a heap hands that heap over as its owner. */
+    heap_t* heap = (heap_t*)malloc(sizeof(heap_t));
+    ASSERT_NE(nullptr, heap);
+    ASSERT_EQ(0, heap_init(heap));
+    ASSERT_EQ(0, buffer_init(&buffer, &heap->alloc, NULL, NULL, NULL));
+    buffer_fill(&buffer, 100000);
+    ASSERT_EQ(0, reclaimer_defer_buffer(&reclaimer, &buffer, &heap->alloc));
+
+    /* so does a buffer using the system allocator, with no owner. */
+    ASSERT_EQ(0, buffer_init(&buffer, allocator_system(), NULL, NULL, NULL));
+    buffer_fill(&buffer, 1000);
+    ASSERT_EQ(0, reclaimer_defer_buffer(&reclaimer, &buffer, NULL));
+
+    reclaimer_flush(&reclaimer);
+    EXPECT_EQ(0U, reclaimer.pending);
+
+    dispose((disposable_t*)&reclaimer);
+}
+
+/**
+ * A buffer whose allocator may still be in use elsewhere is rejected.
+ */
+TEST(reclaimer, defer_buffer_shared)
+{
+    reclaimer_t reclaimer;
+    heap_t heap;
+    buffer_t buffer;
+
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, buffer_init(&buffer, &heap.alloc, NULL, NULL, NULL));
+    buffer_fill(&buffer, 10);
+
+    /* the buffer is left alone. */
+    EXPECT_NE(0, reclaimer_defer_buffer(&reclaimer, &buffer, NULL));
+    EXPECT_EQ(0U, reclaimer.pending);
+    EXPECT_EQ(10U, buffer.lines->size);
+
+    dispose((disposable_t*)&buffer);
+    dispose((disposable_t*)&heap);
+    dispose((disposable_t*)&reclaimer);
+}
+
+/**
+ * Disposing a reclaimer reclaims everything still queued.
+ */
+TEST(reclaimer, dispose_drains)
+{
+    reclaimer_t reclaimer;
+    list_t list;
+
+    foo_disposer_mock_count = 0;
+
+    /* initialize the reclaimer. */
+    ASSERT_EQ(0, reclaimer_init(&reclaimer));
+
+    for (int j = 0; j < 10; ++j)
+    {
+        ASSERT_EQ(0, list_init(&list));
+        for (int i = 0; i < 100; ++i)
+            ASSERT_EQ(0, list_push_back(&list, (disposable_t*)foo_create(i)));
+        ASSERT_EQ(0, reclaimer_defer_list(&reclaimer, &list));
+        dispose((disposable_t*)&list);
+    }
+
+    /* stopping the reclaimer waits for the queue to drain. */
+    dispose((disposable_t*)&reclaimer);
+    EXPECT_EQ(1000, foo_disposer_mock_count);
+}
+
+/**
+ * \brief Fill a buffer with count lines allocated from its allocator.
+ */
+static void buffer_fill(buffer_t* buffer, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        std::string text = "line " + std::to_string(i) + std::string(40, 'x');
+        string_t* str;
+
+        ASSERT_EQ(
+            0,
+            string_create(&str, buffer->allocator, text.data(), text.size()));
+        ASSERT_EQ(0, list_push_back(buffer->lines, (disposable_t*)str));
+    }
+}
+
+static foo* foo_create(int val)
+{
+    foo* ret = (foo*)malloc(sizeof(foo));
+
+    ret->hdr.dispose = &foo_disposer_mock;
+    ret->val = val;
+
+    return ret;
+}
+
+static void foo_disposer_mock(disposable_t*)
+{
+    if (std::this_thread::get_id() == foo_disposer_mock_caller)
+        foo_disposer_mock_off_thread = false;
+
+    ++foo_disposer_mock_count;
+}
@@ -0,0 +1,368 @@
+/**
+ * \brief Unit tests for the string type.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/heap.h>
+#include <ej/list.h>
+#include <ej/string.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+/**
+ * A short string is stored inline, without allocating.
+ */
+TEST(string, init_inline)
+{
+    heap_t heap;
+    string_t str;
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, string_init(&str, &heap.alloc, "hello", 5));
+
+    EXPECT_TRUE(PROP_VALID_STRING(&str));
+    EXPECT_TRUE(string_is_inline(&str));
+    EXPECT_STREQ("hello", string_data(&str));
+    EXPECT_EQ(5U, str.length);
+    EXPECT_EQ(5U, str.codepoints);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->total_count);
+
+    /* the string fits exactly up to the inline capacity. */
+    std::string full(STRING_INLINE_CAPACITY - 5U, 'x');
+    ASSERT_EQ(0, string_append(&str, full.data(), full.size()));
+    EXPECT_TRUE(string_is_inline(&str));
+    EXPECT_EQ(STRING_INLINE_CAPACITY, str.length);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->total_count);
+
+    dispose((disposable_t*)&str);
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * A long string moves out of line, and dispose releases its storage.
+ */
+TEST(string, out_of_line)
+{
+    heap_t heap;
+    string_t str;
+    std::string expected(STRING_INLINE_CAPACITY, 'a');
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(
+        0, string_init(&str, &heap.alloc, expected.data(), expected.size()));
+    EXPECT_TRUE(string_is_inline(&str));
+
+    /* one more byte spills to the allocator. */
+    ASSERT_EQ(0, string_append(&str, "b", 1));
+    expected += "b";
+    EXPECT_FALSE(string_is_inline(&str));
+    EXPECT_EQ(expected, string_data(&str));
+    EXPECT_EQ(1U, allocator_stats(&heap.alloc)->live_count);
+    EXPECT_EQ(
+        1U, allocator_stats(&heap.alloc)->tag_live_count[ALLOCATOR_TAG_STRING]);
+
+    /* growth is geometric. */
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(0, string_append(&str, "c", 1));
+        expected += "c";
+    }
+    EXPECT_EQ(expected, string_data(&str));
+    EXPECT_LT(allocator_stats(&heap.alloc)->total_count, 10U);
+
+    dispose((disposable_t*)&str);
+    EXPECT_EQ(0U, allocator_stats(&heap.alloc)->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * Codepoints are counted as bytes are inserted and erased.
+ */
+TEST(string, codepoints)
+{
+    string_t str;
+
+    /* "héllo wörld" has 11 codepoints in 13 bytes. */
+    const char* text = "h\xc3\xa9llo w\xc3\xb6rld";
+    ASSERT_EQ(0, string_init(&str, allocator_system(), text, strlen(text)));
+    EXPECT_EQ(13U, str.length);
+    EXPECT_EQ(11U, str.codepoints);
+
+    /* insert a three byte euro sign after the é. */
+    ASSERT_EQ(0, string_insert(&str, 3, "\xe2\x82\xac", 3));
+    EXPECT_STREQ("h\xc3\xa9\xe2\x82\xacllo w\xc3\xb6rld", string_data(&str));
+    EXPECT_EQ(16U, str.length);
+    EXPECT_EQ(12U, str.codepoints);
+
+    /* erase the é and the euro sign. */
+    ASSERT_EQ(0, string_erase(&str, 1, 5));
+    EXPECT_STREQ("hllo w\xc3\xb6rld", string_data(&str));
+    EXPECT_EQ(11U, str.length);
+    EXPECT_EQ(10U, str.codepoints);
+
+    /* out of bounds edits fail. */
+    EXPECT_NE(0, string_insert(&str, 12, "x", 1));
+    EXPECT_NE(0, string_erase(&str, 10, 2));
+    EXPECT_STREQ("hllo w\xc3\xb6rld", string_data(&str));
+
+    dispose((disposable_t*)&str);
+}
+
+/**
+ * Inserting and erasing work on out of line strings.
+ */
+TEST(string, edit_out_of_line)
+{
+    string_t str;
+    std::string expected(100, 'z');
+
+    ASSERT_EQ(
+        0,
+        string_init(
+            &str, allocator_system(), expected.data(), expected.size()));
+
+    ASSERT_EQ(0, string_insert(&str, 0, "start", 5));
+    expected.insert(0, "start");
+    ASSERT_EQ(0, string_insert(&str, 50, "middle", 6));
+    expected.insert(50, "middle");
+    ASSERT_EQ(0, string_erase(&str, 10, 80));
+    expected.erase(10, 80);
+
+    EXPECT_EQ(expected, string_data(&str));
+    EXPECT_EQ(expected.size(), str.length);
+    EXPECT_EQ(expected.size(), str.codepoints);
+
+    /* a shrunken string stays out of line. */
+    EXPECT_FALSE(string_is_inline(&str));
+
+    dispose((disposable_t*)&str);
+}
+
+/**
+ * A view is copied when it is first changed.
+ */
+TEST(string, view_copy_on_write)
+{
+    heap_t heap;
+    string_t str;
+    const char text[] = "short view|rest of the buffer";
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+
+    ASSERT_EQ(0, heap_init(&heap));
+
+    /* a view points at the bytes, which needn't be NUL terminated. */
+    string_init_view(&str, &heap.alloc, text, 10);
+    EXPECT_TRUE(PROP_VALID_STRING(&str));
+    EXPECT_TRUE(string_is_view(&str));
+    EXPECT_EQ(text, string_data(&str));
+    EXPECT_EQ(10U, str.length);
+    EXPECT_EQ(10U, str.codepoints);
+
+    /* erasing copies a short view inline. */
+    ASSERT_EQ(0, string_erase(&str, 0, 6));
+    EXPECT_TRUE(string_is_inline(&str));
+    EXPECT_STREQ("view", string_data(&str));
+    EXPECT_EQ('s', text[0]);
+    EXPECT_EQ(0U, stats->total_count);
+    dispose((disposable_t*)&str);
+
+    /* a long view is copied to storage of its own. */
+    std::string long_text(100, 'v');
+    string_init_view(&str, &heap.alloc, long_text.data(), long_text.size());
+    ASSERT_EQ(0, string_insert(&str, 50, "\xc3\xa9", 2));
+    EXPECT_FALSE(string_is_view(&str));
+    EXPECT_FALSE(string_is_inline(&str));
+    EXPECT_EQ(std::string(100, 'v'), long_text);
+    EXPECT_EQ(102U, strlen(string_data(&str)));
+    EXPECT_EQ(101U, str.codepoints);
+    EXPECT_EQ(1U, stats->tag_live_count[ALLOCATOR_TAG_STRING]);
+
+    dispose((disposable_t*)&str);
+    EXPECT_EQ(0U, stats->live_bytes);
+
+    /* disposing an unchanged view releases nothing. */
+    string_init_view(&str, &heap.alloc, text, sizeof(text) - 1);
+    dispose((disposable_t*)&str);
+
+    dispose((disposable_t*)&heap);
+}
+
+/**
+ * Invalid UTF-8 is rejected, leaving the string unchanged.
+ */
+TEST(string, rejects_invalid_utf8)
+{
+    string_t str;
+
+    EXPECT_NE(0, string_init(&str, allocator_system(), "ab\xff", 3));
+
+    ASSERT_EQ(0, string_init(&str, allocator_system(), "abc", 3));
+    EXPECT_NE(0, string_append(&str, "\xc3", 1));
+    EXPECT_NE(0, string_insert(&str, 1, "\xed\xa0\x80", 3));
+    EXPECT_STREQ("abc", string_data(&str));
+    EXPECT_EQ(3U, str.codepoints);
+
+    dispose((disposable_t*)&str);
+}
+
+/**
+ * Each SIMD level accepts valid UTF-8 of every sequence length, wherever it
+ * falls relative to the vector boundaries.
+ */
+TEST(string, utf8_validate_valid)
+{
+    const char* samples[] = {
+        "a", "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80", "\xed\x9f\xbf",
+        "\xee\x80\x80", "\xef\xbf\xbf", "\xf0\x90\x80\x80",
+        "\xf4\x8f\xbf\xbf" };
+
+    for (const char* sample : samples)
+    {
+        for (size_t pad = 0; pad < 70; ++pad)
+        {
+            std::string text(pad, 'x');
+            for (int i = 0; i < 20; ++i)
+                text += sample;
+
+            for (int level = 0; level < SIMD_LEVEL_COUNT; ++level)
+            {
+                size_t offset = 12345;
+                EXPECT_EQ(
+                    0,
+                    utf8_validate_level(
+                        (simd_level_t)level, text.data(), text.size(),
+                        &offset))
+                    << "level " << level << " pad " << pad;
+                EXPECT_EQ(12345U, offset);
+            }
+        }
+    }
+}
+
+/**
+ * Each SIMD level reports the offset of the first invalid sequence, wherever
+ * it falls relative to the vector boundaries.
+ */
+TEST(string, utf8_validate_invalid)
+{
+    /* each sample is invalid starting at its first byte. */
+    const char* samples[] = {
+        "\x80", "\xbf", "\xc0\x80", "\xc1\xbf", "\xc2", "\xc2\x41",
+        "\xe0\x80\x80", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xe1\x80",
+        "\xe1\x80\x41", "\xf0\x80\x80\x80", "\xf4\x90\x80\x80",
+        "\xf5\x80\x80\x80", "\xf1\x80\x80", "\xf1\x80\x80\x41",
+        "\xff" };
+
+    for (const char* sample : samples)
+    {
+        for (size_t pad = 0; pad < 100; ++pad)
+        {
+            /* valid multi-byte text, then the invalid sample, then more. */
+            std::string text;
+            while (text.size() + 2 <= pad)
+                text += "\xc3\xa9";
+            while (text.size() < pad)
+                text += 'x';
+            text += sample;
+            text += std::string(40, 'y');
+
+            for (int level = 0; level < SIMD_LEVEL_COUNT; ++level)
+            {
+                size_t offset = 12345;
+                EXPECT_NE(
+                    0,
+                    utf8_validate_level(
+                        (simd_level_t)level, text.data(), text.size(),
+                        &offset));
+                EXPECT_EQ(pad, offset)
+                    << "level " << level << " pad " << pad;
+            }
+
+            /* a truncated sequence at the very end is invalid too. */
+            text.resize(pad + strlen(sample));
+            size_t offset;
+            if (strlen(sample) > 1 && (unsigned char)sample[0] >= 0xc2 &&
+                (unsigned char)sample[0] < 0xf5 &&
+                (unsigned char)sample[1] >= 0x80 &&
+                (unsigned char)sample[1] < 0xc0)
+            {
+                text.pop_back();
+            }
+            EXPECT_NE(0, utf8_validate(text.data(), text.size(), &offset));
+        }
+    }
+}
+
+/**
+ * The vector levels agree with the scalar level on random bytes.
+ */
+TEST(string, utf8_validate_random)
+{
+    uint32_t seed = 2463534242U;
+    std::vector<char> buf(256);
+
+    for (int trial = 0; trial < 20000; ++trial)
+    {
+        for (char& c : buf)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+
+            /* mostly valid two and three byte sequences, with some noise. */
+            c = (seed % 64U == 0U) ? (char)(seed >> 8) : 'a' + seed % 26U;
+        }
+
+        size_t expected_offset = 0;
+        int expected =
+            utf8_validate_level(
+                SIMD_LEVEL_SCALAR, buf.data(), buf.size(), &expected_offset);
+
+        for (int level = 1; level < SIMD_LEVEL_COUNT; ++level)
+        {
+            size_t offset = 0;
+            ASSERT_EQ(
+                expected,
+                utf8_validate_level(
+                    (simd_level_t)level, buf.data(), buf.size(), &offset));
+            if (0 != expected)
+                ASSERT_EQ(expected_offset, offset);
+        }
+    }
+}
+
+/**
+ * Strings created from an allocator drop into a list using that allocator.
+ */
+TEST(string, list)
+{
+    heap_t heap;
+    list_t list;
+    const allocator_stats_t* stats = allocator_stats(&heap.alloc);
+
+    ASSERT_EQ(0, heap_init(&heap));
+    ASSERT_EQ(0, list_init_allocator(&list, &heap.alloc));
+
+    std::string long_line(200, 'q');
+    for (int i = 0; i < 10; ++i)
+    {
+        string_t* str;
+        const char* data = (i % 2) ? "short" : long_line.c_str();
+        ASSERT_EQ(0, string_create(&str, &heap.alloc, data, strlen(data)));
+        ASSERT_EQ(0, list_push_back(&list, (disposable_t*)str));
+    }
+
+    EXPECT_EQ(10U, stats->tag_live_count[ALLOCATOR_TAG_LIST_DATA]);
+    EXPECT_EQ(5U, stats->tag_live_count[ALLOCATOR_TAG_STRING]);
+    EXPECT_STREQ("short", string_data((string_t*)list.tail->data));
+
+    /* disposing the list releases the strings and their storage. */
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(0U, stats->live_bytes);
+
+    dispose((disposable_t*)&heap);
+}
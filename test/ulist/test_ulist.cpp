@@ -0,0 +1,445 @@
+/**
+ * \brief Unit tests for the unrolled list container.
+ *
+ * \copyright Justin Handville 2018.  All rights reserved.  Please see LICENSE
+ *            for licensing.
+ */
+
+#include <ej/ulist.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+struct foo
+{
+    disposable_t hdr;
+    int val;
+};
+
+/* forward decls */
+static foo* foo_create(int val);
+static void foo_disposer_mock(disposable_t* disp);
+static int foo_disposer_mock_count;
+static std::vector<int> ulist_values(ulist_t* list);
+static bool ulist_chunks_valid(ulist_t* list);
+
+/**
+ * An unrolled list can be initialized as an empty list.
+ */
+TEST(ulist, init)
+{
+    ulist_t list;
+
+    memset(&list, 0xFE, sizeof(list));
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    /* the head and tail should be NULL. */
+    EXPECT_EQ(nullptr, list.head);
+    EXPECT_EQ(nullptr, list.tail);
+
+    /* the size should be 0. */
+    EXPECT_EQ(0U, list.size);
+
+    /* the list can be disposed. */
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * push_back fills chunks completely before starting a new chunk.
+ */
+TEST(ulist, push_back_fills_chunks)
+{
+    ulist_t list;
+    const int count = 2 * ULIST_CHUNK_CAPACITY + 1;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    /* push enough values for three chunks. */
+    for (int i = 0; i < count; ++i)
+        ASSERT_EQ(0, ulist_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* the first two chunks are full, and the last holds one value. */
+    EXPECT_EQ((size_t)count, list.size);
+    ASSERT_NE(nullptr, list.head);
+    EXPECT_EQ(ULIST_CHUNK_CAPACITY, list.head->count);
+    ASSERT_NE(nullptr, list.head->next);
+    EXPECT_EQ(ULIST_CHUNK_CAPACITY, list.head->next->count);
+    EXPECT_EQ(list.tail, list.head->next->next);
+    EXPECT_EQ(1U, list.tail->count);
+
+    /* the values are in order. */
+    std::vector<int> values = ulist_values(&list);
+    for (int i = 0; i < count; ++i)
+        EXPECT_EQ(i, values[i]);
+
+    /* disposing the list disposes each value. */
+    foo_disposer_mock_count = 0;
+    dispose((disposable_t*)&list);
+    EXPECT_EQ(count, foo_disposer_mock_count);
+}
+
+/**
+ * push_front and the pop methods work as a deque.
+ */
+TEST(ulist, push_pop_deque)
+{
+    ulist_t list;
+    disposable_t* data;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    /* popping an empty list fails. */
+    EXPECT_NE(0, ulist_pop_front(&list, &data));
+    EXPECT_EQ(nullptr, data);
+    EXPECT_NE(0, ulist_pop_back(&list, &data));
+    EXPECT_EQ(nullptr, data);
+
+    /* push values on the front: 99 ... 0. */
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(0, ulist_push_front(&list, (disposable_t*)foo_create(i)));
+    EXPECT_EQ(100U, list.size);
+    EXPECT_TRUE(ulist_chunks_valid(&list));
+
+    /* pop from the front in descending order. */
+    for (int i = 99; i >= 50; --i)
+    {
+        ASSERT_EQ(0, ulist_pop_front(&list, &data));
+        EXPECT_EQ(i, ((foo*)data)->val);
+        free(data);
+    }
+
+    /* pop from the back in ascending order. */
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_EQ(0, ulist_pop_back(&list, &data));
+        EXPECT_EQ(i, ((foo*)data)->val);
+        free(data);
+    }
+
+    /* the list is empty, and every chunk has been released. */
+    EXPECT_TRUE(PROP_VALID_ULIST_EMPTY(&list));
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * ulist_at finds positions from either end and rejects bad indices.
+ */
+TEST(ulist, at)
+{
+    ulist_t list;
+    ulist_pos_t pos;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    /* an empty list has no positions. */
+    EXPECT_NE(0, ulist_at(&list, 0, &pos));
+
+    for (int i = 0; i < 200; ++i)
+        ASSERT_EQ(0, ulist_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* every index maps to its value. */
+    for (size_t i = 0; i < 200; ++i)
+    {
+        ASSERT_EQ(0, ulist_at(&list, i, &pos));
+        EXPECT_TRUE(PROP_VALID_ULIST_POS(&pos));
+        EXPECT_EQ((int)i, ((foo*)pos.chunk->data[pos.index])->val);
+    }
+
+    /* an index past the end is rejected. */
+    EXPECT_NE(0, ulist_at(&list, 200, &pos));
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * insert and append split full chunks and report the new position.
+ */
+TEST(ulist, insert_append_split_chunks)
+{
+    ulist_t list;
+    ulist_pos_t pos;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    /* fill exactly one chunk with even values. */
+    for (int i = 0; i < (int)ULIST_CHUNK_CAPACITY; ++i)
+        ASSERT_EQ(0, ulist_push_back(&list, (disposable_t*)foo_create(2 * i)));
+    EXPECT_EQ(list.head, list.tail);
+
+    /* inserting into the full chunk splits it. */
+    ASSERT_EQ(0, ulist_at(&list, 3, &pos));
+    ASSERT_EQ(0, ulist_insert(&list, &pos, (disposable_t*)foo_create(5)));
+    EXPECT_NE(list.head, list.tail);
+    EXPECT_EQ(5, ((foo*)pos.chunk->data[pos.index])->val);
+
+    /* appending after the last value of the list goes to the tail. */
+    ASSERT_EQ(0, ulist_at(&list, list.size - 1, &pos));
+    ASSERT_EQ(0, ulist_append(&list, &pos, (disposable_t*)foo_create(1000)));
+    EXPECT_EQ(list.tail, pos.chunk);
+    EXPECT_EQ(list.tail->count - 1, pos.index);
+
+    /* appending after the first value. */
+    ASSERT_EQ(0, ulist_at(&list, 0, &pos));
+    ASSERT_EQ(0, ulist_append(&list, &pos, (disposable_t*)foo_create(1)));
+
+    /* the values are in the expected order. */
+    std::vector<int> expected;
+    for (int i = 0; i < (int)ULIST_CHUNK_CAPACITY; ++i)
+        expected.push_back(2 * i);
+    expected.insert(expected.begin() + 3, 5);
+    expected.push_back(1000);
+    expected.insert(expected.begin() + 1, 1);
+    EXPECT_EQ(expected, ulist_values(&list));
+    EXPECT_EQ(expected.size(), list.size);
+    EXPECT_TRUE(ulist_chunks_valid(&list));
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * remove releases empty chunks and merges sparse neighbors.
+ */
+TEST(ulist, remove_merges_chunks)
+{
+    ulist_t list;
+    ulist_pos_t pos;
+    disposable_t* data;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    /* build three full chunks. */
+    for (int i = 0; i < 3 * (int)ULIST_CHUNK_CAPACITY; ++i)
+        ASSERT_EQ(0, ulist_push_back(&list, (disposable_t*)foo_create(i)));
+
+    /* remove every value from the middle chunk. */
+    for (size_t i = 0; i < ULIST_CHUNK_CAPACITY; ++i)
+    {
+        ASSERT_EQ(0, ulist_at(&list, ULIST_CHUNK_CAPACITY, &pos));
+        ASSERT_EQ(0, ulist_remove(&list, &pos, &data));
+        EXPECT_EQ((int)(ULIST_CHUNK_CAPACITY + i), ((foo*)data)->val);
+        free(data);
+    }
+
+    /* the middle chunk has been released. */
+    EXPECT_EQ(list.tail, list.head->next);
+    EXPECT_EQ(2 * ULIST_CHUNK_CAPACITY, list.size);
+
+    /* thin out both chunks until they are merged. */
+    while (list.head != list.tail)
+    {
+        ASSERT_EQ(0, ulist_at(&list, 0, &pos));
+        ASSERT_EQ(0, ulist_remove(&list, &pos, &data));
+        free(data);
+        ASSERT_EQ(0, ulist_at(&list, list.size - 1, &pos));
+        ASSERT_EQ(0, ulist_remove(&list, &pos, &data));
+        free(data);
+    }
+
+    /* the merged chunk holds at most half of its capacity. */
+    EXPECT_LE(list.head->count, ULIST_CHUNK_CAPACITY / 2);
+    EXPECT_EQ(list.size, list.head->count);
+    EXPECT_TRUE(ulist_chunks_valid(&list));
+
+    dispose((disposable_t*)&list);
+}
+
+/**
+ * splice joins the chunks of two lists.
+ */
+TEST(ulist, splice)
+{
+    ulist_t x, y;
+
+    /* initialize the lists. */
+    ASSERT_EQ(0, ulist_init(&x));
+    ASSERT_EQ(0, ulist_init(&y));
+
+    /* splicing two empty lists is a no-op. */
+    ulist_splice(&x, &y);
+    EXPECT_TRUE(PROP_VALID_ULIST_EMPTY(&x));
+    EXPECT_TRUE(PROP_VALID_ULIST_EMPTY(&y));
+
+    for (int i = 0; i < 40; ++i)
+        ASSERT_EQ(0, ulist_push_back(&y, (disposable_t*)foo_create(i)));
+
+    /* splicing onto an empty list takes y's chunks. */
+    ulist_splice(&x, &y);
+    EXPECT_EQ(40U, x.size);
+    EXPECT_TRUE(PROP_VALID_ULIST_EMPTY(&y));
+
+    for (int i = 40; i < 100; ++i)
+        ASSERT_EQ(0, ulist_push_back(&y, (disposable_t*)foo_create(i)));
+
+    /* splicing two non-empty lists joins them. */
+    ulist_splice(&x, &y);
+    EXPECT_EQ(100U, x.size);
+    EXPECT_TRUE(PROP_VALID_ULIST_EMPTY(&y));
+
+    std::vector<int> values = ulist_values(&x);
+    ASSERT_EQ(100U, values.size());
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i, values[i]);
+    EXPECT_TRUE(ulist_chunks_valid(&x));
+
+    dispose((disposable_t*)&x);
+    dispose((disposable_t*)&y);
+}
+
+/**
+ * split divides a list at chunk boundaries and in the middle of chunks.
+ */
+TEST(ulist, split)
+{
+    const size_t count = 3 * ULIST_CHUNK_CAPACITY;
+
+    for (size_t at = 0; at < count; at += 7)
+    {
+        ulist_t x, y;
+        ulist_pos_t pos;
+
+        /* initialize the lists. */
+        ASSERT_EQ(0, ulist_init(&x));
+        ASSERT_EQ(0, ulist_init(&y));
+
+        for (size_t i = 0; i < count; ++i)
+            ASSERT_EQ(0, ulist_push_back(&x, (disposable_t*)foo_create(i)));
+
+        /* split at the given index. */
+        ASSERT_EQ(0, ulist_at(&x, at, &pos));
+        ASSERT_EQ(0, ulist_split(&x, &pos, &y));
+
+        /* the sizes are correct. */
+        EXPECT_EQ(at, x.size);
+        EXPECT_EQ(count - at, y.size);
+        EXPECT_TRUE(PROP_VALID_ULIST(&x));
+        EXPECT_TRUE(PROP_VALID_ULIST_NOT_EMPTY(&y));
+        EXPECT_TRUE(ulist_chunks_valid(&x));
+        EXPECT_TRUE(ulist_chunks_valid(&y));
+
+        /* the values are divided at the split point. */
+        std::vector<int> xs = ulist_values(&x);
+        std::vector<int> ys = ulist_values(&y);
+        for (size_t i = 0; i < xs.size(); ++i)
+            EXPECT_EQ((int)i, xs[i]);
+        for (size_t i = 0; i < ys.size(); ++i)
+            EXPECT_EQ((int)(at + i), ys[i]);
+
+        /* splicing restores the original list. */
+        ulist_splice(&x, &y);
+        EXPECT_EQ(count, x.size);
+        xs = ulist_values(&x);
+        for (size_t i = 0; i < count; ++i)
+            EXPECT_EQ((int)i, xs[i]);
+
+        dispose((disposable_t*)&x);
+        dispose((disposable_t*)&y);
+    }
+}
+
+/**
+ * A mix of operations matches a reference vector.
+ */
+TEST(ulist, matches_reference)
+{
+    ulist_t list;
+    ulist_pos_t pos;
+    disposable_t* data;
+    std::vector<int> reference;
+    unsigned int seed = 12345;
+
+    /* initialize the list. */
+    ASSERT_EQ(0, ulist_init(&list));
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        unsigned int op = (seed >> 16) % 6;
+        size_t index = reference.empty() ? 0 : (seed >> 4) % reference.size();
+
+        if (reference.empty() || op < 2)
+        {
+            ASSERT_EQ(0, ulist_push_back(&list, (disposable_t*)foo_create(i)));
+            reference.push_back(i);
+        }
+        else if (op == 2)
+        {
+            ASSERT_EQ(0, ulist_at(&list, index, &pos));
+            ASSERT_EQ(
+                0, ulist_insert(&list, &pos, (disposable_t*)foo_create(i)));
+            reference.insert(reference.begin() + index, i);
+        }
+        else if (op == 3)
+        {
+            ASSERT_EQ(0, ulist_at(&list, index, &pos));
+            ASSERT_EQ(
+                0, ulist_append(&list, &pos, (disposable_t*)foo_create(i)));
+            reference.insert(reference.begin() + index + 1, i);
+        }
+        else
+        {
+            ASSERT_EQ(0, ulist_at(&list, index, &pos));
+            ASSERT_EQ(0, ulist_remove(&list, &pos, &data));
+            EXPECT_EQ(reference[index], ((foo*)data)->val);
+            free(data);
+            reference.erase(reference.begin() + index);
+        }
+    }
+
+    /* the list matches the reference. */
+    EXPECT_EQ(reference.size(), list.size);
+    EXPECT_EQ(reference, ulist_values(&list));
+    EXPECT_TRUE(ulist_chunks_valid(&list));
+
+    dispose((disposable_t*)&list);
+}
+
+static foo* foo_create(int val)
+{
+    foo* ret = (foo*)malloc(sizeof(foo));
+    memset(ret, 0, sizeof(foo));
+
+    ret->hdr.dispose = &foo_disposer_mock;
+    ret->val = val;
+
+    return ret;
+}
+
+static void foo_disposer_mock(disposable_t*)
+{
+    ++foo_disposer_mock_count;
+}
+
+static std::vector<int> ulist_values(ulist_t* list)
+{
+    std::vector<int> values;
+
+    for (ulist_chunk_t* i = list->head; i != NULL; i = i->next)
+        for (size_t j = 0; j < i->count; ++j)
+            values.push_back(((foo*)i->data[j])->val);
+
+    return values;
+}
+
+static bool ulist_chunks_valid(ulist_t* list)
+{
+    size_t size = 0;
+    ulist_chunk_t* prev = nullptr;
+
+    for (ulist_chunk_t* i = list->head; i != NULL; i = i->next)
+    {
+        if (i->prev != prev || 0 == i->count || i->count > ULIST_CHUNK_CAPACITY)
+            return false;
+
+        size += i->count;
+        prev = i;
+    }
+
+    return prev == list->tail && size == list->size;
+}